@@ -0,0 +1,137 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2022, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+#include "BenchmarkHelpers.hpp"
+
+#include <lbann/comm_impl.hpp>
+
+#include <chrono>
+#include <map>
+#include <utility>
+
+namespace benchmark {
+namespace utilities {
+
+namespace {
+
+/** @brief Work per iteration, indexed by benchmark name. */
+std::map<std::string, std::pair<double, std::string>>& get_work_map()
+{
+  static std::map<std::string, std::pair<double, std::string>> work;
+  return work;
+}
+
+std::vector<benchmark_result>& get_mutable_results()
+{
+  static std::vector<benchmark_result> results;
+  return results;
+}
+
+std::vector<std::pair<std::string, std::string>>& get_mutable_context()
+{
+  static std::vector<std::pair<std::string, std::string>> context;
+  return context;
+}
+
+} // namespace
+
+benchmark_config& get_config()
+{
+  static benchmark_config config;
+  return config;
+}
+
+void set_work(std::string const& name, double work, std::string unit)
+{
+  get_work_map()[name] = {work, std::move(unit)};
+}
+
+void record_result(benchmark_result result)
+{
+  auto const& work_map = get_work_map();
+  auto it = work_map.find(result.name);
+  if (it != work_map.end() && result.work_unit.empty()) {
+    result.work = it->second.first;
+    result.work_unit = it->second.second;
+  }
+  get_mutable_results().emplace_back(std::move(result));
+}
+
+std::vector<benchmark_result> const& get_results()
+{
+  return get_mutable_results();
+}
+
+void set_context(std::string const& key, std::string value)
+{
+  for (auto& entry : get_mutable_context()) {
+    if (entry.first == key) {
+      entry.second = std::move(value);
+      return;
+    }
+  }
+  get_mutable_context().emplace_back(key, std::move(value));
+}
+
+std::vector<std::pair<std::string, std::string>> const& get_context()
+{
+  return get_mutable_context();
+}
+
+bool& write_report()
+{
+  static bool write = true;
+  return write;
+}
+
+void run_mpi_benchmark(lbann::lbann_comm& comm,
+                       std::string const& name,
+                       std::function<void()> const& f)
+{
+  using clock = std::chrono::steady_clock;
+  auto const& config = get_config();
+  for (int i = 0; i < config.warmup_iterations; ++i) {
+    f();
+  }
+  benchmark_result result;
+  result.name = name;
+  result.test_case = Catch::getResultCapture().getCurrentTestName();
+  result.samples.reserve(config.timed_iterations);
+  for (int i = 0; i < config.timed_iterations; ++i) {
+    comm.global_barrier();
+    auto const start = clock::now();
+    f();
+    auto const end = clock::now();
+    double const time =
+      std::chrono::duration<double, std::nano>(end - start).count();
+    result.samples.push_back(
+      comm.allreduce(time, comm.get_world_comm(), El::mpi::MAX));
+  }
+  record_result(std::move(result));
+}
+
+} // namespace utilities
+} // namespace benchmark
@@ -0,0 +1,135 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2022, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+#ifndef LBANN_BENCHMARKS_BENCHMARK_HELPERS_HPP_INCLUDED
+#define LBANN_BENCHMARKS_BENCHMARK_HELPERS_HPP_INCLUDED
+
+#include <catch2/catch.hpp>
+
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace lbann {
+class lbann_comm;
+} // namespace lbann
+
+namespace benchmark {
+namespace utilities {
+
+/** @brief Problem sizes and harness parameters.
+ *
+ *  Set from the command line of the benchmark executables (see
+ *  BenchmarkOptions.hpp).
+ */
+struct benchmark_config
+{
+  /** @brief Mini-batch size for layer, transform, and reader benchmarks */
+  int mini_batch_size = 64;
+  /** @brief Channels in input tensor (CHW) */
+  int channels = 16;
+  /** @brief Height of input tensor (CHW) */
+  int height = 32;
+  /** @brief Width of input tensor (CHW) */
+  int width = 32;
+  /** @brief Output channels/neurons of convolution and
+   *  fully-connected layers
+   */
+  int output_size = 64;
+  /** @brief Number of samples in synthetic data files */
+  int num_samples = 4096;
+  /** @brief I/O threads for data reader benchmarks */
+  int io_threads = 1;
+  /** @brief Largest message in collective benchmarks (bytes) */
+  size_t max_message_size = size_t{1} << 24;
+  /** @brief Untimed iterations in MPI harness */
+  int warmup_iterations = 3;
+  /** @brief Timed iterations in MPI harness */
+  int timed_iterations = 20;
+};
+
+/** @brief Global benchmark configuration. */
+benchmark_config& get_config();
+
+/** @brief Measurements for a single benchmark. */
+struct benchmark_result
+{
+  std::string name;
+  std::string test_case;
+  /** @brief Time per iteration in each sample (ns) */
+  std::vector<double> samples;
+  /** @brief Amount of work per iteration (e.g. bytes or samples) */
+  double work = 0.;
+  /** @brief Unit of work, e.g. "bytes". Empty if not set. */
+  std::string work_unit;
+};
+
+/** @brief Attach amount of work per iteration to a benchmark.
+ *
+ *  Used to report throughput. Must be called before the benchmark
+ *  runs.
+ */
+void set_work(std::string const& name, double work, std::string unit);
+
+/** @brief Record measurements for output. */
+void record_result(benchmark_result result);
+
+/** @brief Results that have been recorded so far. */
+std::vector<benchmark_result> const& get_results();
+
+/** @brief Add an entry to the context written with the results,
+ *  e.g. the number of MPI ranks.
+ */
+void set_context(std::string const& key, std::string value);
+
+/** @brief Entries written with the results. */
+std::vector<std::pair<std::string, std::string>> const& get_context();
+
+/** @brief Whether this process writes the JSON report.
+ *
+ *  Disabled on all but one rank in the MPI benchmarks.
+ */
+bool& write_report();
+
+/** @brief Run a benchmark with a fixed number of iterations.
+ *
+ *  Catch2's benchmarks choose the number of iterations from timing
+ *  estimates, which differ between ranks and would deadlock
+ *  collectives. This harness runs the same number of iterations on
+ *  every rank in the world communicator, with a barrier before each
+ *  iteration. The time of each iteration is the maximum over all
+ *  ranks. Results are recorded on every rank, but should only be
+ *  written by one.
+ */
+void run_mpi_benchmark(lbann::lbann_comm& comm,
+                       std::string const& name,
+                       std::function<void()> const& f);
+
+} // namespace utilities
+} // namespace benchmark
+
+#endif // LBANN_BENCHMARKS_BENCHMARK_HELPERS_HPP_INCLUDED
@@ -0,0 +1,73 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2022, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+#ifndef LBANN_BENCHMARKS_BENCHMARK_OPTIONS_HPP_INCLUDED
+#define LBANN_BENCHMARKS_BENCHMARK_OPTIONS_HPP_INCLUDED
+
+// Clara is only available in the translation unit that defines
+// CATCH_CONFIG_RUNNER, so this must be included after catch.hpp in a
+// main() source file.
+#ifndef CATCH_CONFIG_RUNNER
+#error "BenchmarkOptions.hpp requires CATCH_CONFIG_RUNNER"
+#endif
+
+#include "BenchmarkHelpers.hpp"
+
+namespace benchmark {
+namespace utilities {
+
+/** @brief Add options for benchmark configuration to Catch2 CLI. */
+inline Catch::clara::Parser
+add_config_options(Catch::clara::Parser const& cli)
+{
+  using Catch::clara::Opt;
+  auto& config = get_config();
+  return cli
+    | Opt(config.mini_batch_size, "size")["--mini-batch-size"](
+        "Mini-batch size (default: 64)")
+    | Opt(config.channels, "channels")["--channels"](
+        "Channels in input tensor (default: 16)")
+    | Opt(config.height, "height")["--height"](
+        "Height of input tensor (default: 32)")
+    | Opt(config.width, "width")["--width"](
+        "Width of input tensor (default: 32)")
+    | Opt(config.output_size, "size")["--output-size"](
+        "Output channels/neurons of learning layers (default: 64)")
+    | Opt(config.num_samples, "samples")["--num-samples"](
+        "Samples in synthetic data files (default: 4096)")
+    | Opt(config.io_threads, "threads")["--io-threads"](
+        "I/O threads for data reader benchmarks (default: 1)")
+    | Opt(config.max_message_size, "bytes")["--max-message-size"](
+        "Largest message in collective benchmarks (default: 16 MiB)")
+    | Opt(config.warmup_iterations, "iterations")["--warmup-iterations"](
+        "Untimed iterations in MPI benchmarks (default: 3)")
+    | Opt(config.timed_iterations, "iterations")["--timed-iterations"](
+        "Timed iterations in MPI benchmarks (default: 20)");
+}
+
+} // namespace utilities
+} // namespace benchmark
+
+#endif // LBANN_BENCHMARKS_BENCHMARK_OPTIONS_HPP_INCLUDED
@@ -0,0 +1,168 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2022, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+#include "BenchmarkHelpers.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+#include <numeric>
+#include <ostream>
+
+namespace {
+
+using namespace benchmark::utilities;
+
+void write_string(std::ostream& os, std::string const& str)
+{
+  os << '"';
+  for (auto const& c : str) {
+    switch (c) {
+    case '"': os << "\\\""; break;
+    case '\\': os << "\\\\"; break;
+    case '\n': os << "\\n"; break;
+    case '\t': os << "\\t"; break;
+    default: os << c;
+    }
+  }
+  os << '"';
+}
+
+/** @brief Catch2 reporter that writes benchmark results as JSON.
+ *
+ *  Results from both Catch2 benchmarks and the MPI harness are
+ *  written when the run ends. For each benchmark, the time per
+ *  iteration (ns) is summarized by its mean, median, minimum, and
+ *  standard deviation over samples. If work per iteration has been
+ *  set, throughput in work units per second is also reported.
+ */
+class JSONReporter : public Catch::StreamingReporterBase<JSONReporter>
+{
+public:
+  using StreamingReporterBase::StreamingReporterBase;
+
+  static std::string getDescription()
+  {
+    return "Reports benchmark results as JSON";
+  }
+
+  void assertionStarting(Catch::AssertionInfo const&) override {}
+  bool assertionEnded(Catch::AssertionStats const& stats) override
+  {
+    if (!stats.assertionResult.isOk()) {
+      ++m_num_failed;
+    }
+    return true;
+  }
+
+  void benchmarkEnded(Catch::BenchmarkStats<> const& stats) override
+  {
+    benchmark_result result;
+    result.name = stats.info.name;
+    result.test_case = currentTestCaseInfo->name;
+    result.samples.reserve(stats.samples.size());
+    for (auto const& sample : stats.samples) {
+      result.samples.push_back(sample.count());
+    }
+    record_result(std::move(result));
+  }
+
+  void testRunEnded(Catch::TestRunStats const& stats) override
+  {
+    if (write_report()) {
+      write(stats);
+    }
+    StreamingReporterBase::testRunEnded(stats);
+  }
+
+private:
+  void write(Catch::TestRunStats const& stats)
+  {
+    auto const& config = get_config();
+    stream << std::setprecision(9);
+    stream << "{\n  \"context\": {\n"
+           << "    \"executable\": ";
+    write_string(stream, stats.runInfo.name);
+    for (auto const& [key, value] : get_context()) {
+      stream << ",\n    ";
+      write_string(stream, key);
+      stream << ": ";
+      write_string(stream, value);
+    }
+    stream << ",\n    \"mini_batch_size\": " << config.mini_batch_size
+           << ",\n    \"channels\": " << config.channels
+           << ",\n    \"height\": " << config.height
+           << ",\n    \"width\": " << config.width
+           << ",\n    \"output_size\": " << config.output_size
+           << ",\n    \"num_samples\": " << config.num_samples
+           << ",\n    \"io_threads\": " << config.io_threads
+           << ",\n    \"assertion_failures\": " << m_num_failed
+           << "\n  },\n  \"benchmarks\": [";
+    bool first = true;
+    for (auto const& result : get_results()) {
+      if (result.samples.empty()) {
+        continue;
+      }
+      auto samples = result.samples;
+      std::sort(samples.begin(), samples.end());
+      auto const n = static_cast<double>(samples.size());
+      auto const mean = std::accumulate(samples.begin(), samples.end(), 0.) / n;
+      double variance = 0.;
+      for (auto const& x : samples) {
+        variance += (x - mean) * (x - mean) / n;
+      }
+      auto const mid = samples.size() / 2;
+      auto const median = (samples.size() % 2 == 1
+                           ? samples[mid]
+                           : (samples[mid - 1] + samples[mid]) / 2);
+
+      stream << (first ? "\n" : ",\n") << "    {\"name\": ";
+      first = false;
+      write_string(stream, result.name);
+      stream << ", \"test_case\": ";
+      write_string(stream, result.test_case);
+      stream << ", \"samples\": " << samples.size()
+             << ", \"mean_ns\": " << mean
+             << ", \"median_ns\": " << median
+             << ", \"min_ns\": " << samples.front()
+             << ", \"stddev_ns\": " << std::sqrt(variance);
+      if (!result.work_unit.empty() && mean > 0.) {
+        stream << ", \"work\": " << result.work
+               << ", \"work_unit\": ";
+        write_string(stream, result.work_unit);
+        stream << ", \"throughput\": " << result.work / (mean * 1e-9);
+      }
+      stream << "}";
+    }
+    stream << "\n  ]\n}\n";
+  }
+
+  size_t m_num_failed = 0;
+};
+
+} // namespace
+
+CATCH_REGISTER_REPORTER("json", JSONReporter)
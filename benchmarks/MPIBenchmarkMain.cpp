@@ -0,0 +1,86 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2022, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+#define CATCH_CONFIG_RUNNER
+#include <catch2/catch.hpp>
+
+// Utilities
+#include "BenchmarkOptions.hpp"
+#include "MPITestHelpers.hpp"
+#include "ReplaceEscapes.hpp"
+
+#include <lbann/base.hpp>
+#include <lbann/utils/options.hpp>
+#include <lbann/utils/random_number_generators.hpp>
+#include <lbann/utils/system_info.hpp>
+
+#include <string>
+
+// Just stand up MPI before running all benchmarks; teardown after.
+using namespace unit_test::utilities;
+int main(int argc, char* argv[])
+{
+  lbann::construct_all_options();
+
+  // Set up the communication domain
+  auto world_comm = lbann::initialize(argc, argv);
+  lbann::init_random(13);
+  expert::register_world_comm(*world_comm);
+
+  // Initialize Catch2 with benchmark configuration
+  Catch::Session session;
+  session.cli(benchmark::utilities::add_config_options(session.cli()));
+
+  // Parse the command line
+  int return_code = session.applyCommandLine(argc, argv);
+  if (return_code != 0) // Indicates a command line error
+    return return_code;
+
+  // Manipulate output file if needed.
+  auto& config_data = session.configData();
+  auto& output_file = config_data.outputFilename;
+  if (output_file.size() > 0) {
+    lbann::utils::SystemInfo sys_info;
+    output_file = replace_escapes(output_file, sys_info);
+  }
+
+  // Results are reduced over all ranks, so only the world master
+  // writes a report
+  benchmark::utilities::write_report() = world_comm->am_world_master();
+  benchmark::utilities::set_context(
+    "num_ranks",
+    std::to_string(world_comm->get_procs_in_world()));
+
+  // Run the benchmarks, outputting to the given file.
+  int num_failed = session.run();
+
+  // Clean up the catch environment
+  expert::reset_world_comm();
+
+  // Shut down the communication domain
+  world_comm.reset(); // Force MPI_Finalize, et al, before return.
+
+  return num_failed;
+}
@@ -0,0 +1,95 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2022, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+#include <catch2/catch.hpp>
+
+#include "BenchmarkHelpers.hpp"
+#include "MPITestHelpers.hpp"
+
+#include <lbann/base.hpp>
+#include <lbann/comm_impl.hpp>
+
+#include <string>
+#include <vector>
+
+using namespace benchmark::utilities;
+
+namespace {
+
+std::string format_bytes(size_t bytes)
+{
+  if (bytes >= (size_t{1} << 20)) {
+    return std::to_string(bytes >> 20) + " MiB";
+  }
+  if (bytes >= (size_t{1} << 10)) {
+    return std::to_string(bytes >> 10) + " KiB";
+  }
+  return std::to_string(bytes) + " B";
+}
+
+} // namespace
+
+TEST_CASE("Collective benchmarks", "[benchmark][comm][mpi]")
+{
+  using DataType = lbann::DataType;
+  auto const& config = get_config();
+  auto& comm = unit_test::utilities::current_world_comm();
+  auto const& world = comm.get_world_comm();
+  int const num_procs = comm.get_procs_in_world();
+
+  for (size_t bytes = 1024; bytes <= config.max_message_size; bytes *= 4) {
+    int const count = bytes / sizeof(DataType);
+    auto const size = format_bytes(bytes);
+    lbann::CPUMat buffer;
+    El::Uniform(buffer, count, 1);
+
+    // Bytes are counted per rank, as in the data sent by each rank
+    auto const name = "allreduce " + size;
+    set_work(name, bytes, "bytes");
+    run_mpi_benchmark(comm, name, [&] { comm.allreduce(buffer, world); });
+
+    auto const nb_name = "nonblocking allreduce " + size;
+    set_work(nb_name, bytes, "bytes");
+    run_mpi_benchmark(comm, nb_name, [&] {
+      Al::request req;
+      comm.nb_allreduce(buffer, world, req);
+      comm.wait(req);
+    });
+
+    auto const bcast_name = "broadcast " + size;
+    set_work(bcast_name, bytes, "bytes");
+    run_mpi_benchmark(comm, bcast_name, [&] {
+      comm.broadcast(0, buffer.Buffer(), count, world);
+    });
+
+    std::vector<DataType> gathered(static_cast<size_t>(count) * num_procs);
+    auto const gather_name = "allgather " + size;
+    set_work(gather_name, bytes, "bytes");
+    run_mpi_benchmark(comm, gather_name, [&] {
+      comm.all_gather(buffer.LockedBuffer(), count,
+                      gathered.data(), count, world);
+    });
+  }
+}
@@ -0,0 +1,72 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2022, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+#include <catch2/catch.hpp>
+
+#include "BenchmarkHelpers.hpp"
+
+#include <lbann/base.hpp>
+#include <lbann/data_coordinator/data_packer.hpp>
+#include <lbann/data_readers/utils/input_data_type.hpp>
+
+#include <conduit/conduit_node.hpp>
+
+#include <map>
+#include <string>
+#include <vector>
+
+using namespace benchmark::utilities;
+
+TEST_CASE("Data packer benchmarks", "[benchmark][data_packer]")
+{
+  auto const& config = get_config();
+  int const mini_batch_size = config.mini_batch_size;
+  int const sample_size = config.channels * config.height * config.width;
+  int const num_labels = config.output_size;
+
+  // Synthetic samples with float32 data and one-hot int32 labels
+  std::vector<conduit::Node> samples(mini_batch_size);
+  for (int j = 0; j < mini_batch_size; ++j) {
+    auto const id = std::to_string(j);
+    std::vector<float> data(sample_size, static_cast<float>(j));
+    std::vector<int32_t> labels(num_labels, 0);
+    labels[j % num_labels] = 1;
+    samples[j][id + "/" + INPUT_DATA_TYPE_SAMPLES].set(data);
+    samples[j][id + "/" + INPUT_DATA_TYPE_LABELS].set(labels);
+  }
+
+  lbann::CPUMat X(sample_size, mini_batch_size);
+  lbann::CPUMat Y(num_labels, mini_batch_size);
+  std::map<lbann::data_field_type, lbann::CPUMat*> input_buffers = {
+    {INPUT_DATA_TYPE_SAMPLES, &X},
+    {INPUT_DATA_TYPE_LABELS, &Y}};
+
+  set_work("extract data fields", mini_batch_size, "samples");
+  BENCHMARK("extract data fields")
+  {
+    lbann::data_packer::extract_data_fields_from_samples(samples,
+                                                         input_buffers);
+  };
+}
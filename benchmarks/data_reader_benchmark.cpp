@@ -0,0 +1,150 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2022, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+#include <catch2/catch.hpp>
+
+#include "BenchmarkHelpers.hpp"
+#include "MPITestHelpers.hpp"
+
+#include <lbann/base.hpp>
+#include <lbann/comm_impl.hpp>
+#include <lbann/data_readers/data_reader_csv.hpp>
+#include <lbann/data_readers/data_reader_synthetic.hpp>
+#include <lbann/data_readers/utils/input_data_type.hpp>
+#include <lbann/utils/random_number_generators.hpp>
+#include <lbann/utils/threads/thread_pool.hpp>
+
+#include <cstdio>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <string>
+#include <unistd.h>
+
+using namespace benchmark::utilities;
+
+namespace {
+
+/** @brief Set up reader and fetch buffers for one mini-batch. */
+class reader_fixture
+{
+public:
+  reader_fixture(lbann::lbann_comm& comm,
+                 lbann::generic_data_reader& reader,
+                 int sample_size,
+                 int num_labels)
+    : m_comm(comm), m_reader(reader)
+  {
+    auto const& config = get_config();
+    m_mini_batch_size = config.mini_batch_size;
+    m_io_thread_pool = std::make_unique<lbann::thread_pool>();
+    m_io_thread_pool->launch_pinned_threads(config.io_threads, 1);
+    reader.setup(m_io_thread_pool->get_num_threads(), m_io_thread_pool.get());
+    reader.set_comm(&comm);
+    reader.set_num_parallel_readers(1);
+    reader.load();
+    reader.set_mini_batch_size(m_mini_batch_size);
+    reader.set_last_mini_batch_size(m_mini_batch_size);
+    reader.set_initial_position();
+
+    El::Zeros_seq(m_samples, sample_size, m_mini_batch_size);
+    El::Zeros_seq(m_labels, num_labels, m_mini_batch_size);
+    El::Zeros_seq(m_indices_fetched, m_mini_batch_size, 1);
+    m_buffers[INPUT_DATA_TYPE_SAMPLES] = &m_samples;
+    m_buffers[INPUT_DATA_TYPE_LABELS] = &m_labels;
+  }
+
+  void run(std::string const& name)
+  {
+    set_work(name, m_mini_batch_size, "samples");
+    run_mpi_benchmark(m_comm, name, [&] {
+      m_reader.fetch(m_buffers, m_indices_fetched, m_mini_batch_size);
+    });
+  }
+
+private:
+  lbann::lbann_comm& m_comm;
+  lbann::generic_data_reader& m_reader;
+  int m_mini_batch_size;
+  std::unique_ptr<lbann::thread_pool> m_io_thread_pool;
+  lbann::CPUMat m_samples, m_labels;
+  El::Matrix<El::Int> m_indices_fetched;
+  std::map<lbann::data_field_type, lbann::CPUMat*> m_buffers;
+};
+
+} // namespace
+
+TEST_CASE("Data reader benchmarks", "[benchmark][data_reader][mpi]")
+{
+  auto const& config = get_config();
+  auto& comm = unit_test::utilities::current_world_comm();
+  lbann::init_data_seq_random(42);
+  int const sample_size = config.channels * config.height * config.width;
+  int const num_labels = config.output_size;
+
+  SECTION("Synthetic reader")
+  {
+    lbann::data_reader_synthetic reader(
+      config.num_samples,
+      {config.channels, config.height, config.width},
+      num_labels,
+      false);
+    reader_fixture fixture(comm, reader, sample_size, num_labels);
+    fixture.run("synthetic fetch");
+  }
+
+  SECTION("CSV reader")
+  {
+    // Write synthetic file with label in first column
+    int root_pid = ::getpid();
+    comm.world_broadcast(0, root_pid);
+    std::string const file_name =
+      "lbann_benchmark_" + std::to_string(root_pid) + ".csv";
+    if (comm.am_world_master()) {
+      std::ofstream ofs("/tmp/" + file_name);
+      for (int i = 0; i < config.num_samples; ++i) {
+        ofs << i % num_labels;
+        for (int j = 0; j < sample_size; ++j) {
+          ofs << ',' << static_cast<float>((i + j) % 255) / 255.f;
+        }
+        ofs << '\n';
+      }
+    }
+    comm.global_barrier();
+
+    lbann::csv_reader reader(false);
+    reader.set_file_dir("/tmp/");
+    reader.set_data_filename(file_name);
+    reader.set_label_col(0);
+    reader.set_has_header(false);
+    reader_fixture fixture(comm, reader, sample_size, num_labels);
+    fixture.run("csv fetch");
+
+    comm.global_barrier();
+    if (comm.am_world_master()) {
+      std::remove(("/tmp/" + file_name).c_str());
+    }
+  }
+}
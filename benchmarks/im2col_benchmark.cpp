@@ -0,0 +1,63 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2022, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+#include <catch2/catch.hpp>
+
+#include "BenchmarkHelpers.hpp"
+
+#include <lbann/base.hpp>
+#include <lbann/utils/im2col.hpp>
+
+using namespace benchmark::utilities;
+
+TEST_CASE("im2col benchmarks", "[benchmark][im2col]")
+{
+  auto const& config = get_config();
+  int const channels = config.channels;
+  int const dims[2] = {config.height, config.width};
+  int const pads[2] = {1, 1};
+  int const window_dims[2] = {3, 3};
+  int const window_strides[2] = {1, 1};
+
+  lbann::CPUMat im, col;
+  El::Uniform(im, channels * dims[0] * dims[1], 1);
+  El::Zeros(col, channels * window_dims[0] * window_dims[1],
+            dims[0] * dims[1]);
+  double const col_bytes = col.Height() * col.Width() * sizeof(lbann::DataType);
+
+  set_work("im2col 3x3", col_bytes, "bytes");
+  BENCHMARK("im2col 3x3")
+  {
+    lbann::im2col<lbann::DataType>(im, col, channels, 2, dims, pads,
+                                   window_dims, window_strides);
+  };
+
+  set_work("col2im 3x3", col_bytes, "bytes");
+  BENCHMARK("col2im 3x3")
+  {
+    lbann::col2im<lbann::DataType>(col, im, channels, 2, dims, pads,
+                                   window_dims, window_strides);
+  };
+}
@@ -0,0 +1,186 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2022, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+#include <catch2/catch.hpp>
+
+#include "BenchmarkHelpers.hpp"
+#include "MPITestHelpers.hpp"
+
+#include <lbann/base.hpp>
+#include <lbann/execution_algorithms/sgd_execution_context.hpp>
+#include <lbann/layers/io/input_layer.hpp>
+#include <lbann/models/model.hpp>
+#include <lbann/objective_functions/objective_function.hpp>
+#include <lbann/proto/factories.hpp>
+#include <lbann/utils/lbann_library.hpp>
+
+#include <lbann.pb.h>
+#include <google/protobuf/text_format.h>
+
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace pb = ::google::protobuf;
+using namespace benchmark::utilities;
+
+namespace {
+
+/** @brief Model with an input layer, the layer being benchmarked
+ *  (named "layer"), and an L2 norm objective.
+ */
+std::string make_model_prototext(std::string const& layer_prototext)
+{
+  return R"ptext(
+model {
+  objective_function {
+    layer_term {
+      layer: "loss"
+    }
+  }
+  layer {
+    name: "input"
+    children: "layer"
+    data_layout: "data_parallel"
+    input {
+      data_field: "samples"
+    }
+  }
+  layer {
+    name: "layer"
+    parents: "input"
+    children: "loss"
+    data_layout: "data_parallel"
+    )ptext" + layer_prototext + R"ptext(
+  }
+  layer {
+    name: "loss"
+    parents: "layer"
+    data_layout: "data_parallel"
+    l2_norm2 {}
+  }
+}
+optimizer {
+  sgd {
+    learn_rate: 0.01
+  }
+}
+)ptext";
+}
+
+std::unique_ptr<lbann::model> make_model(lbann::lbann_comm& comm,
+                                         std::string const& layer_prototext)
+{
+  auto const& config = get_config();
+  lbann_data::LbannPB my_proto;
+  if (!pb::TextFormat::ParseFromString(make_model_prototext(layer_prototext),
+                                       &my_proto))
+    throw "Parsing protobuf failed.";
+  lbann::construct_trainer(&comm, my_proto.mutable_trainer(), my_proto);
+  lbann::DataReaderMetaData metadata;
+  metadata.data_dims[lbann::data_reader_target_mode::INPUT] = {
+    config.channels, config.height, config.width};
+  metadata.data_dims[lbann::data_reader_target_mode::CLASSIFICATION] = {
+    config.output_size};
+  auto my_model = lbann::proto::construct_model(&comm,
+                                                -1,
+                                                my_proto.optimizer(),
+                                                my_proto.trainer(),
+                                                my_proto.model());
+  my_model->setup(config.mini_batch_size, metadata, {&comm.get_trainer_grid()});
+  return my_model;
+}
+
+} // namespace
+
+TEST_CASE("Layer benchmarks", "[benchmark][layer][mpi]")
+{
+  auto const& config = get_config();
+  auto const output_size = std::to_string(config.output_size);
+  std::vector<std::pair<std::string, std::string>> const layers = {
+    {"fully_connected",
+     "fully_connected { num_neurons: " + output_size + " has_bias: true }"},
+    {"convolution 3x3",
+     "convolution { num_dims: 2 out_channels: " + output_size +
+       " kernel_size: 3 padding: 1 stride: 1 dilation: 1"
+       " groups { value: 1 } has_bias { value: true } }"},
+    {"max pooling 2x2",
+     "pooling { num_dims: 2 pool_dims_i: 2 pool_strides_i: 2"
+     " pool_mode: \"max\" }"},
+    {"batch_normalization", "batch_normalization { decay: 0.9 epsilon: 1e-5 }"},
+    {"relu", "relu {}"},
+    {"softmax", "softmax {}"}};
+  auto const& [layer_type, layer_prototext] = GENERATE_REF(from_range(layers));
+
+  auto& comm = unit_test::utilities::current_world_comm();
+  auto& g = comm.get_trainer_grid();
+  lbann::utils::grid_manager mgr(g);
+  auto model = make_model(comm, layer_prototext);
+  auto& objective = *model->get_objective_function();
+
+  // Random inputs, replicated on every rank
+  int const mini_batch_size = config.mini_batch_size;
+  int const input_size = config.channels * config.height * config.width;
+  El::DistMatrix<lbann::DataType, El::STAR, El::STAR, El::ELEMENT, El::Device::CPU>
+    samples(g);
+  El::Uniform(samples, input_size, mini_batch_size);
+
+  lbann::Layer* layer = nullptr;
+  for (int i = 0; i < model->get_num_layers(); ++i) {
+    auto& l = model->get_layer(i);
+    if (l.get_type() == "input") {
+      auto& il = dynamic_cast<lbann::input_layer<lbann::DataType>&>(l);
+      il.set_samples(samples);
+    }
+    if (l.get_name() == "layer") {
+      layer = &l;
+    }
+  }
+  REQUIRE(layer != nullptr);
+
+  auto c = lbann::SGDExecutionContext(lbann::execution_mode::training,
+                                      mini_batch_size);
+  model->reset_mode(c, lbann::execution_mode::training);
+  auto const mode = lbann::execution_mode::training;
+
+  // Populate activations before benchmarking the layer by itself
+  model->forward_prop(mode);
+
+  auto const name = layer_type + " forward";
+  set_work(name, mini_batch_size, "samples");
+  run_mpi_benchmark(comm, name, [&] { layer->forward_prop(); });
+
+  auto const step_name = layer_type + " forward/backward (model)";
+  set_work(step_name, mini_batch_size, "samples");
+  run_mpi_benchmark(comm, step_name, [&] {
+    model->clear_gradients();
+    model->forward_prop(mode);
+    objective.start_evaluation(mode, mini_batch_size);
+    objective.differentiate();
+    model->backward_prop();
+    objective.finish_evaluation(mode, mini_batch_size);
+  });
+}
@@ -0,0 +1,120 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2022, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+#include <catch2/catch.hpp>
+
+#include "BenchmarkHelpers.hpp"
+
+#include <lbann/base.hpp>
+#include <lbann/transforms/sample_normalize.hpp>
+#include <lbann/transforms/scale.hpp>
+#include <lbann/transforms/transform_pipeline.hpp>
+#include <lbann/utils/random.hpp>
+#include <lbann/utils/random_number_generators.hpp>
+
+#ifdef LBANN_HAS_OPENCV
+#include <lbann/transforms/vision/horizontal_flip.hpp>
+#include <lbann/transforms/vision/normalize_to_lbann_layout.hpp>
+#include <lbann/transforms/vision/random_resized_crop.hpp>
+#endif // LBANN_HAS_OPENCV
+
+#include <memory>
+#include <vector>
+
+using namespace benchmark::utilities;
+
+TEST_CASE("Transform pipeline benchmarks", "[benchmark][transform]")
+{
+  auto const& config = get_config();
+  size_t const mini_batch_size = config.mini_batch_size;
+  size_t const channels = config.channels;
+  size_t const height = config.height;
+  size_t const width = config.width;
+  size_t const sample_size = channels * height * width;
+
+  // Random I/O generators are used by random transforms
+  lbann::locked_io_rng_ref io_rng = lbann::set_io_generators_local_index(0);
+
+  SECTION("Scale and normalize samples")
+  {
+    lbann::transform::transform_pipeline p;
+    p.add_transform(std::make_unique<lbann::transform::scale>(2.0f));
+    p.add_transform(std::make_unique<lbann::transform::sample_normalize>());
+    std::vector<lbann::CPUMat> samples(mini_batch_size);
+    for (auto& sample : samples) {
+      El::Uniform(sample, sample_size, 1);
+    }
+    set_work("scale and normalize", mini_batch_size, "samples");
+    BENCHMARK("scale and normalize")
+    {
+      for (auto& sample : samples) {
+        std::vector<size_t> dims = {channels, height, width};
+        p.apply(sample, dims);
+      }
+    };
+  }
+
+#ifdef LBANN_HAS_OPENCV
+  SECTION("Image augmentation")
+  {
+    // Synthetic 3-channel images at twice the output resolution,
+    // stored in OpenCV's HWC layout
+    constexpr size_t image_channels = 3;
+    size_t const image_height = 2 * height;
+    size_t const image_width = 2 * width;
+    El::Matrix<uint8_t> image(image_channels * image_height * image_width, 1);
+    for (El::Int i = 0; i < image.Height(); ++i) {
+      image(i, 0) = static_cast<uint8_t>(lbann::fast_rand_int(
+        lbann::get_fast_io_generator(), 256));
+    }
+
+    lbann::transform::transform_pipeline p;
+    p.add_transform(
+      std::make_unique<lbann::transform::random_resized_crop>(height, width));
+    p.add_transform(std::make_unique<lbann::transform::horizontal_flip>(0.5f));
+    p.add_transform(
+      std::make_unique<lbann::transform::normalize_to_lbann_layout>(
+        std::vector<float>{0.485f, 0.456f, 0.406f},
+        std::vector<float>{0.229f, 0.224f, 0.225f}));
+    lbann::CPUMat out(image_channels * height * width, mini_batch_size);
+
+    set_work("random resized crop, flip, normalize",
+             mini_batch_size,
+             "samples");
+    BENCHMARK("random resized crop, flip, normalize")
+    {
+      for (size_t j = 0; j < mini_batch_size; ++j) {
+        // Transforms modify the image, so work on a copy as a data
+        // reader would on a freshly decoded image
+        El::Matrix<uint8_t> sample(image);
+        lbann::CPUMat out_v;
+        El::View(out_v, out, El::ALL, El::IR(j));
+        std::vector<size_t> dims = {image_channels, image_height, image_width};
+        p.apply(sample, out_v, dims);
+      }
+    };
+  }
+#endif // LBANN_HAS_OPENCV
+}
@@ -1,4 +1,5 @@
 import functools
+import math
 import operator
 import os
 import os.path
@@ -235,6 +236,58 @@ def construct_model(lbann):
         error_on_failure=True,
         execution_modes='test'))
 
+    # ------------------------------------------
+    # Data-parallel layout, non-transpose, bias, fused activation
+    # ------------------------------------------
+
+    # Note: Fused activations are only supported on CPU
+    activations = {
+        'relu': lambda y: np.maximum(y, 0),
+        'gelu': lambda y: 0.5 * y * (1 + np.vectorize(math.erf)(y / math.sqrt(2))),
+        'sigmoid': lambda y: 1 / (1 + np.exp(-y)),
+        'tanh': np.tanh,
+    }
+    for activation, func in activations.items():
+
+        # LBANN implementation
+        linearity_weights = lbann.Weights(
+            optimizer=lbann.SGD(),
+            initializer=lbann.ValueInitializer(
+                values=np.nditer(linearity, order='F')
+            )
+        )
+        bias_weights = lbann.Weights(
+            optimizer=lbann.SGD(),
+            initializer=lbann.ValueInitializer(
+                values=np.nditer(bias)
+            )
+        )
+        x = x_lbann
+        y = lbann.FullyConnected(x,
+                                 weights=(linearity_weights, bias_weights),
+                                 data_layout='data_parallel',
+                                 device='CPU',
+                                 num_neurons=_output_size,
+                                 has_bias=True,
+                                 transpose=False,
+                                 activation=activation)
+        z = lbann.L2Norm2(y)
+        obj.append(z)
+        metrics.append(lbann.Metric(z, name=f'fused {activation}'))
+
+        # NumPy implementation
+        x = _samples.transpose().astype(np.float64)
+        y = np.matmul(linearity.astype(np.float64), x) + bias.astype(np.float64)
+        z = tools.numpy_l2norm2(func(y)) / _num_samples
+        val = z
+        tol = 8 * val * np.finfo(np.float32).eps
+        callbacks.append(lbann.CallbackCheckMetric(
+            metric=metrics[-1].name,
+            lower_bound=val-tol,
+            upper_bound=val+tol,
+            error_on_failure=True,
+            execution_modes='test'))
+
     # ------------------------------------------
     # Gradient checking
     # ------------------------------------------
@@ -84,14 +84,6 @@ def setup_experiment(lbann, weekly):
 
     """
 
-    # Skip test on non-GPU systems
-    # Note: Test requires cuDNN (on GPU) or oneDNN (on CPU).
-    ### @todo Assume LBANN has been built with oneDNN?
-    if not tools.gpus_per_node(lbann):
-        message = f'{os.path.basename(__file__)} requires cuDNN or oneDNN'
-        print('Skip - ' + message)
-        pytest.skip(message)
-
     mini_batch_size = num_samples() // 2
     trainer = lbann.Trainer(mini_batch_size)
     model = construct_model(lbann)
@@ -28,6 +28,7 @@
 #   - FFTW_FOUND
 #   - FFTW_VERSION
 #   - FFTW_LIBRARIES
+#   - FFTW_THREADS_FOUND (threaded FFTW found for every precision)
 #
 # Creates the following imported targets:
 #   - FFTW::FFTW_FLOAT
@@ -107,12 +108,30 @@ else ()
   endif (PkgConfig_FOUND)
 endif ()
 
+# Try to find the threaded libraries (optional). The OpenMP and
+# pthreads variants provide the same interface.
+find_library(FFTW_FLOAT_THREADS_LIBRARY
+  NAMES fftw3f_omp fftw3f_threads
+  HINTS ${FFTW_DIR} $ENV{FFTW_DIR} ${PC_FFTWF_LIBRARY_DIRS}
+  PATH_SUFFIXES lib64 lib)
+find_library(FFTW_DOUBLE_THREADS_LIBRARY
+  NAMES fftw3_omp fftw3_threads
+  HINTS ${FFTW_DIR} $ENV{FFTW_DIR} ${PC_FFTW_LIBRARY_DIRS}
+  PATH_SUFFIXES lib64 lib)
+
 set(FFTW_VERSION)
 set(FOUND_OK_FFTW_LIB)
+set(FFTW_THREADS_FOUND TRUE)
 
 # Setup the float imported target
 if (FFTW_FLOAT_FOUND)
   add_library(FFTW::FFTW_FLOAT INTERFACE IMPORTED)
+  if (FFTW_FLOAT_THREADS_LIBRARY)
+    target_link_libraries(
+      FFTW::FFTW_FLOAT INTERFACE ${FFTW_FLOAT_THREADS_LIBRARY})
+  else ()
+    set(FFTW_THREADS_FOUND FALSE)
+  endif ()
   target_link_libraries(
     FFTW::FFTW_FLOAT INTERFACE ${FFTW_FLOAT_IMPORTED_LIBRARY})
   set(FOUND_OK_FFTW_LIB TRUE)
@@ -138,6 +157,12 @@ if (FFTW_DOUBLE_FOUND)
     set(FFTW_VERSION ${FFTW_DOUBLE_VERSION})
   endif ()
   add_library(FFTW::FFTW_DOUBLE INTERFACE IMPORTED)
+  if (FFTW_DOUBLE_THREADS_LIBRARY)
+    target_link_libraries(
+      FFTW::FFTW_DOUBLE INTERFACE ${FFTW_DOUBLE_THREADS_LIBRARY})
+  else ()
+    set(FFTW_THREADS_FOUND FALSE)
+  endif ()
   target_link_libraries(
     FFTW::FFTW_DOUBLE INTERFACE ${FFTW_DOUBLE_IMPORTED_LIBRARY})
   set(FOUND_OK_FFTW_LIB TRUE)
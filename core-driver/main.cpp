@@ -29,6 +29,51 @@
 #include <mpi.h>
 #include <stdio.h>
 
+#include <atomic>
+#include <chrono>
+#include <csignal>
+#include <thread>
+
+namespace {
+
+/** Set by SIGINT or SIGTERM to shut down the inference server. */
+volatile std::sig_atomic_t stop_requested = 0;
+
+void request_stop(int) { stop_requested = 1; }
+
+/** Stop the server on SIGINT or SIGTERM.
+ *  The server can't be stopped from the signal handler itself, so a
+ *  watcher thread polls the flag set by the handler. */
+class stop_on_signal {
+public:
+  stop_on_signal(lbann::inference_server& server) {
+    static struct sigaction sa;
+    sa.sa_handler = &request_stop;
+    sa.sa_flags = SA_RESTART;
+    sigemptyset(&sa.sa_mask);
+    sigaction(SIGINT, &sa, nullptr);
+    sigaction(SIGTERM, &sa, nullptr);
+    m_watcher = std::thread([this, &server] {
+      while (!m_done) {
+        if (stop_requested) {
+          server.stop();
+          return;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+      }
+    });
+  }
+  ~stop_on_signal() {
+    m_done = true;
+    m_watcher.join();
+  }
+private:
+  std::atomic<bool> m_done{false};
+  std::thread m_watcher;
+};
+
+} // namespace
+
 void construct_opts(int argc, char **argv) {
   auto& arg_parser = lbann::global_argument_parser();
   arg_parser.add_option("samples",
@@ -55,6 +100,16 @@ void construct_opts(int argc, char **argv) {
                         {"-mbs"},
                         "Number of samples in a mini-batch",
                         16);
+  arg_parser.add_option("socket",
+                        {"-s"},
+                        "Serve inference requests on this Unix socket "
+                        "instead of inferring on random samples",
+                        "");
+  arg_parser.add_option("maxdelay",
+                        {"-d"},
+                        "Max time (in microseconds) an inference request "
+                        "waits for its mini-batch to fill up",
+                        1000);
   arg_parser.add_required_argument<std::string>
                                   ("model",
                                    "Directory containing checkpointed model");
@@ -105,6 +160,25 @@ int main(int argc, char **argv) {
                                          arg_parser.get<int>("width")
                                        },
                                        {arg_parser.get<int>("labels")});
+
+  // Serve inference requests until interrupted. The server prints
+  // its batching and latency summary when it shuts down.
+  const auto socket_path = arg_parser.get<std::string>("socket");
+  if (!socket_path.empty()) {
+    lbann::inference_server server(
+      socket_path,
+      arg_parser.get<int>("minibatchsize"),
+      std::chrono::microseconds(arg_parser.get<int>("maxdelay")));
+    {
+      stop_on_signal stopper(server);
+      server.serve(m.get());
+    }
+    m.reset();
+    lbann::finalize_lbann();
+    MPI_Finalize();
+    return 0;
+  }
+
   auto samples = random_samples(lbann_comm->get_trainer_grid(),
                                 arg_parser.get<int>("samples"),
                                 arg_parser.get<int>("channels"),
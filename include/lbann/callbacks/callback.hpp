@@ -41,6 +41,7 @@
 
 #include <algorithm>
 #include <string>
+#include <vector>
 
 /** @brief A utility macro for easily adding default-constructed sub-class
  *  builders.*/
@@ -190,6 +191,14 @@ public:
   /** @brief Human-readable description. */
   virtual description get_description() const;
 
+  /** @brief Names of layers this callback looks up by name.
+   *
+   *  Model transformations that remove layers, e.g. folding
+   *  activation layers into fully-connected layers, leave these
+   *  layers in place.
+   */
+  virtual std::vector<std::string> get_layer_names() const { return {}; }
+
   ///@}
   /** @name Serialization */
   ///@{
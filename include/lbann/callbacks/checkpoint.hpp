@@ -44,7 +44,15 @@ enum class callback_phase {
   invalid
 };
 
-/** @brief Checkpoint at given interval in given directory */
+/** @brief Checkpoint at given interval in given directory
+ *
+ *  Distributed checkpoints record the number of ranks per trainer
+ *  and the layout of every distributed matrix. They can be restarted
+ *  with a different number of ranks per trainer, in which case the
+ *  weights and optimizer state are reassembled on the new grid. This
+ *  requires every rank's checkpoint directory to be readable by the
+ *  new ranks.
+ */
 class checkpoint : public callback_base {
 public:
 
@@ -78,6 +78,9 @@ public:
     return new dump_outputs(*this);
   }
   std::string name() const override { return "dump outputs"; }
+  std::vector<std::string> get_layer_names() const override {
+    return {m_layer_names.begin(), m_layer_names.end()};
+  }
 
   void on_forward_prop_end(model* m, Layer* l) override {
     do_dump_outputs(*m, *l);
@@ -29,10 +29,13 @@
 #ifndef LBANN_CALLBACKS_CALLBACK_IMCOMM_HPP_INCLUDED
 #define LBANN_CALLBACKS_CALLBACK_IMCOMM_HPP_INCLUDED
 
+#include <memory>
 #include <vector>
 #include <unordered_set>
 #include <unordered_map>
 #include "lbann/callbacks/callback.hpp"
+#include "lbann/comm.hpp"
+#include "lbann/optimizers/gradient_sharding.hpp"
 
 namespace lbann {
 
@@ -44,6 +47,21 @@ namespace callback {
 /**
  * @brief Support inter-model communication after each mini-batch to
  *        synchronize gradient updates.
+ *
+ * With the @c AVERAGE type, trainers act as data-parallel replicas
+ * and the reduction is hierarchical. Gradients are first reduced
+ * within each trainer as usual. Each process then exchanges only its
+ * chunk of the gradient with the matching processes in the other
+ * trainers, and the averaged chunks are allgathered within the
+ * trainer. This keeps most traffic within a trainer, which is
+ * typically placed on nearby nodes. The inter-trainer allreduces for
+ * all weights are launched together so they overlap.
+ *
+ * With gradient accumulation, the model runs this callback only
+ * after the last mini-batch of a step (see model::backward_prop).
+ *
+ * For averaging across trainers every few steps, or overlapped with
+ * the following steps, use the LocalSGD training algorithm instead.
  */
 class imcomm : public callback_base {
  public:
@@ -52,6 +70,7 @@ class imcomm : public callback_base {
   enum comm_type {
     NONE=0,  /** Do no gradient updates. */
     NORMAL,  /** Simply sum gradient updates. */
+    AVERAGE, /** Hierarchically average gradient updates. */
   };
 
   /**
@@ -89,13 +108,34 @@ class imcomm : public callback_base {
  private:
   /** @brief Summarize relevant statistics. */
   template <typename T>
-  void do_summary(model const& m, data_type_weights<T>& w, EvalType im_time);
+  void do_summary(model const& m,
+                  data_type_weights<T>& w,
+                  EvalType im_time,
+                  size_t bytes);
+
+  struct imcomm_params;
+  /** @brief Launch non-blocking average of gradient over trainers. */
+  void start_average(lbann_comm& comm,
+                     data_type_weights<DataType>& w,
+                     imcomm_params& params);
+  /** @brief Wait for average and write it to the gradient. */
+  void finish_average(lbann_comm& comm,
+                      El::AbstractDistMatrix<DataType>& gradient,
+                      imcomm_params& params);
 
  private:
   /** @brief Parameters for a given set of weights. */
   struct imcomm_params {
     /** @brief Type of communication done. */
     comm_type ct = NONE;
+    /** @brief Partition of gradient among processes in the trainer.
+     *  @details Only used for @c AVERAGE. Null if the gradient is not
+     *  partitioned, in which case all local entries are exchanged.
+     */
+    std::shared_ptr<const gradient_shard_layout> layout;
+    /** @brief Entries exchanged with other trainers. */
+    std::shared_ptr<El::AbstractDistMatrix<DataType>> buffer;
+    Al::request req;
   };
 
   /** @brief Default communication type. */
@@ -59,6 +59,9 @@ class monitor_io : public callback_base {
   void on_epoch_end(model *m) override;
   void on_test_end(model *m) override;
   std::string name() const override { return "monitor_io"; }
+  std::vector<std::string> get_layer_names() const override {
+    return {m_layers.begin(), m_layers.end()};
+  }
 
   /** @name Serialization */
   ///@{
@@ -30,20 +30,53 @@
 #define LBANN_CALLBACKS_PROFILER_HPP_INCLUDED
 
 #include "lbann/callbacks/callback.hpp"
+#include "lbann/utils/perf_counters.hpp"
+
+#include <memory>
+#include <string>
+#include <unordered_map>
 
 namespace lbann {
 namespace callback {
 
-/**
+/** @brief Annotate training with profiler regions.
+ *
+ *  Regions are forwarded to the external profiler (e.g. NVTX).
+ *
+ *  Optionally, per-layer performance is measured during training
+ *  and a roofline-style report is printed on the trainer master at
+ *  the end of each epoch. For each layer, the report shows the time
+ *  spent in forward and backward prop, the FLOPs and bytes moved
+ *  (as estimated by the layer), the achieved GFLOP/s and GB/s, and
+ *  the arithmetic intensity. If the machine's peak compute rate and
+ *  memory bandwidth are provided, each layer is classified as
+ *  compute- or memory-bound and its fraction of the roofline bound
+ *  is shown. Hardware counters (cycles, instructions, last-level
+ *  cache misses) can be added on Linux via perf_event. Values are
+ *  measured on the trainer master only.
  */
 class profiler : public callback_base {
  public:
-  profiler(bool sync = false, bool skip_init = false);
+  /** @param sync            Synchronize device when entering and
+   *                         leaving profile regions.
+   *  @param skip_init       Start profiling after the first epoch.
+   *  @param layer_report    Print per-layer performance report.
+   *  @param use_perf_counters Include hardware counters in report.
+   *  @param peak_gflops     Peak compute rate (GFLOP/s) for roofline.
+   *  @param peak_bandwidth  Peak memory bandwidth (GB/s) for roofline.
+   */
+  profiler(bool sync = false,
+           bool skip_init = false,
+           bool layer_report = false,
+           bool use_perf_counters = false,
+           double peak_gflops = 0.,
+           double peak_bandwidth = 0.);
   profiler(const profiler&) = default;
   profiler& operator=(const profiler&) = default;
   profiler* copy() const override {
     return new profiler(*this);
   }
+  void setup(model *m) override;
   void on_epoch_begin(model *m) override;
   void on_epoch_end(model *m) override;
   void on_validation_begin(model *m) override;
@@ -81,12 +114,48 @@ class profiler : public callback_base {
   ///@}
 
  private:
+  /** @brief Accumulated performance measurements for a layer. */
+  struct layer_stats {
+    std::string type;
+    size_t fp_calls = 0;
+    size_t bp_calls = 0;
+    double fp_time = 0.;
+    double bp_time = 0.;
+    Layer::work_estimate work;
+    perf_counters::values_type fp_counters{};
+    perf_counters::values_type bp_counters{};
+  };
+
   /** Get a color to use in the profiler for a layer. */
   int get_color(Layer *l);
+  /** Start measuring a layer's forward or backward prop. */
+  void start_layer_measurement(model* m, Layer* l);
+  /** Finish measuring a layer's forward or backward prop. */
+  void finish_layer_measurement(model* m, Layer* l, bool forward);
+  /** Print per-layer performance report and reset measurements. */
+  void print_layer_report(model* m);
+
   /** Whether to synchronize the when setting up profile regions. */
   bool m_sync;
   /** Whether to skip initial iterations. */
   bool m_skip_init;
+  /** Whether to measure and report per-layer performance. */
+  bool m_layer_report;
+  /** Whether to include hardware counters in report. */
+  bool m_perf_counters;
+  /** Peak compute rate (GFLOP/s). Not used if zero. */
+  double m_peak_gflops;
+  /** Peak memory bandwidth (GB/s). Not used if zero. */
+  double m_peak_bandwidth;
+
+  /** Hardware counters. Opened in setup and shared between copies. */
+  std::shared_ptr<perf_counters> m_counters;
+  /** Per-layer measurements, indexed by layer name. */
+  std::unordered_map<std::string, layer_stats> m_layer_stats;
+  /** Start time of current layer measurement. */
+  double m_layer_start_time = 0.;
+  /** Hardware counters at start of current layer measurement. */
+  perf_counters::values_type m_layer_start_counters{};
 };
 
 // Builder function
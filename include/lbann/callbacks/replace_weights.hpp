@@ -65,6 +65,11 @@ class replace_weights : public callback_base {
   void on_batch_end(model *m) override;
 
   std::string name() const override { return "replace weights"; }
+  std::vector<std::string> get_layer_names() const override {
+    auto names = m_src_layer_names;
+    names.insert(names.end(), m_dst_layer_names.begin(), m_dst_layer_names.end());
+    return names;
+  }
  private:
   std::vector<std::string> m_src_layer_names, m_dst_layer_names;
   std::vector<Layer*> m_src_layers, m_dst_layers;
@@ -58,6 +58,9 @@ public:
   void on_epoch_end(model *m) override;
   void on_test_end(model *m) override;
   std::string name() const override { return "save images"; }
+  std::vector<std::string> get_layer_names() const override {
+    return m_layer_names;
+  }
 
   /** @name Serialization */
   ///@{
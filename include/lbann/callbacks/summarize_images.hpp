@@ -51,6 +51,8 @@ public:
   get_image_indices(model const&) const = 0;
   virtual std::string get_tag(std::string const& layer_name,
                               El::Int index, El::Int epoch) const = 0;
+  /** @brief Names of layers this strategy looks up by name. */
+  virtual std::vector<std::string> get_layer_names() const = 0;
   virtual ~image_output_strategy() = default;
 
 }; //class image_output_strategy
@@ -91,6 +93,10 @@ public:
   std::string get_tag(std::string const& layer_name,
                       El::Int index, El::Int epoch) const final;
 
+  std::vector<std::string> get_layer_names() const final {
+    return {m_cat_accuracy_layer_name};
+  }
+
 private:
    /** @brief Tests whether image should be dumped based on criteria
     *  @returns bool Value is true if matches criteria and false otherwise
@@ -137,6 +143,10 @@ public:
   std::string get_tag(std::string const& layer_name,
                       El::Int index, El::Int epoch) const final;
 
+  std::vector<std::string> get_layer_names() const final {
+    return {m_input_layer_name};
+  }
+
 private:
 
   /** @brief Name of input layer */
@@ -184,6 +194,13 @@ public:
   /** @brief Return name of callback */
   std::string name() const override { return "summarize_images"; }
 
+  /** @brief Image layer and layers used by the strategy */
+  std::vector<std::string> get_layer_names() const override {
+    auto names = m_strategy->get_layer_names();
+    names.push_back(m_img_source_layer_name);
+    return names;
+  }
+
   /** @brief Hook to pull data from lbann run */
   void on_batch_evaluate_end(model* m) override;
 
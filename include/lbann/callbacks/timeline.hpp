@@ -31,6 +31,7 @@
 
 #include "lbann/callbacks/callback.hpp"
 #include "lbann/utils/timer.hpp"
+#include "lbann/utils/tracer.hpp"
 
 #include <unordered_map>
 #include <vector>
@@ -44,11 +45,25 @@ namespace callback {
  * The logfile is named timeline.m\<model-rank\>.\<rank\>.txt.
  * Each line is a separate event, written as name:start-time:end-time.
  * Times are relative to the beginning of training.
+ *
+ * If @c chrome_trace is set, events from layers, data readers, the
+ * data coordinator, and communication wait points are also recorded
+ * with the event tracer (see lbann/utils/tracer.hpp) and written in
+ * the Chrome trace event format to trace.m\<model-rank\>.\<rank\>.json.
+ * These can be viewed in Perfetto or chrome://tracing. Each file
+ * records the offset of the rank's clock relative to the trainer
+ * master's clock, and scripts/plotting/merge_chrome_traces.py uses it to
+ * combine the files into a single timeline.
  */
 class timeline : public callback_base {
  public:
-  timeline(std::string outdir) : callback_base(1),
-                                                m_outdir(outdir) {}
+  timeline(std::string outdir,
+           bool chrome_trace = false,
+           size_t trace_buffer_size = trace::tracer::default_buffer_size)
+    : callback_base(1),
+      m_outdir(outdir),
+      m_chrome_trace(chrome_trace),
+      m_trace_buffer_size(trace_buffer_size) {}
   timeline(const timeline&) = default;
   timeline& operator=(const timeline&) = default;
   timeline* copy() const override {
@@ -88,8 +103,22 @@ class timeline : public callback_base {
   /// Get time relative to the start time.
   EvalType get_rel_time() const { return get_time() - m_start_time; }
 
+  /** Estimate offset (ns) from the local clock to the trainer
+   *  master's clock. Must be called on every rank in the trainer.
+   *  Uses the ping-pong with the smallest round-trip time.
+   */
+  static int64_t estimate_clock_offset(const lbann_comm& comm);
+
   /// Directory to write output to.
   std::string m_outdir;
+  /// Whether to write a Chrome trace.
+  bool m_chrome_trace = false;
+  /// Number of events per thread kept by the tracer.
+  size_t m_trace_buffer_size = trace::tracer::default_buffer_size;
+  /// Offset (ns) from local clock to trainer master's clock.
+  int64_t m_clock_offset = 0;
+  /// Tracer time the current weights' optimization pass started.
+  int64_t m_opt_trace_start = 0;
   /// Time training started; all times are relative to this.
   EvalType m_start_time = EvalType(0);
   /// Time the current layer's forward pass started.
@@ -39,7 +39,9 @@
 #include "detect_El_mpi.hpp"
 
 #include <map>
+#include <memory>
 #include <typeindex>
+#include <utility>
 #include <vector>
 
 namespace lbann {
@@ -609,7 +611,8 @@ public:
                  const El::mpi::Comm& c,
                  El::mpi::Op op = El::mpi::SUM) const;
   /** Non-blocking matrix allreduce.
-   *  If LBANN has not been built with Aluminum, then this calls a
+   *  If LBANN has not been built with Aluminum, or if hierarchical
+   *  allreduces are enabled for a CPU matrix, then this calls a
    *  blocking matrix allreduce.
    */
   template <typename TensorDataType>
@@ -626,6 +629,21 @@ public:
                     const El::mpi::Comm& c,
                     Al::request& req,
                     El::mpi::Op op = El::mpi::SUM) const;
+  /** Non-blocking matrix reduce-scatter (sum).
+   *
+   *  The entries of @c send are summed over the communicator and
+   *  rank @f$ i @f$ receives @c recv_counts[i] consecutive entries
+   *  at the beginning of @c recv. Both matrices must be contiguous
+   *  and @c recv_counts must not be modified until the request is
+   *  complete. GPU matrices are reduced in stream order, so the
+   *  request is only meaningful on CPU.
+   */
+  template <typename TensorDataType>
+  void nb_reduce_scatter(const El::AbstractMatrix<TensorDataType>& send,
+                         El::AbstractMatrix<TensorDataType>& recv,
+                         const std::vector<int>& recv_counts,
+                         const El::mpi::Comm& c,
+                         Al::request& req) const;
   /** Non-blocking in-place scalar-array allreduce.
    *  If LBANN has not been built with Aluminum, then this calls a blocking
    *  allreduce.
@@ -938,6 +956,28 @@ public:
   /** throws an lbann_exception **/
   void lbann_comm_abort(std::string msg) const;
 
+  /** @brief Enable hierarchical allreduces for contiguous CPU
+   *  matrices.
+   *
+   *  Entries are first reduced within each compute node through a
+   *  shared-memory segment, then reduced across nodes among one
+   *  leader process per node, and finally read back by every process
+   *  on the node. Large matrices are processed in chunks, so that the
+   *  inter-node reduction of a chunk overlaps with the intra-node
+   *  reduction of the next one. Only applies to contiguous @c float
+   *  and @c double host matrices. Must be set consistently on all
+   *  processes.
+   */
+  void set_hierarchical_allreduce(bool enable) noexcept
+  {
+    m_hierarchical_allreduce = enable;
+  }
+  /** @brief Whether hierarchical allreduces are enabled. */
+  bool get_hierarchical_allreduce() const noexcept
+  {
+    return m_hierarchical_allreduce;
+  }
+
 private:
   /** World communicator. */
   const El::mpi::Comm m_world_comm;
@@ -991,6 +1031,18 @@ private:
   std::vector<int> m_primary_grid_ranks;
   std::vector<int> m_secondary_grid_ranks; 
 
+  /** Shared-memory state for hierarchical allreduces on a
+   *  communicator.
+   */
+  struct shm_allreduce_context;
+  /** Whether hierarchical allreduces are enabled. */
+  bool m_hierarchical_allreduce = false;
+  /** MPI attribute key for hierarchical allreduce state.
+   *  The state is cached on each communicator and freed when the
+   *  communicator is freed, so it never outlives the communicator.
+   */
+  int m_shm_allreduce_keyval = MPI_KEYVAL_INVALID;
+
   // Various statistics counters.
   mutable size_t m_num_trainer_barriers;
   mutable size_t m_num_intertrainer_barriers;
@@ -1001,6 +1053,35 @@ private:
   /** Setup communicator for processes in the same compute node. */
   void setup_node_comm();
 
+  /** Get hierarchical allreduce state for a communicator.
+   *  Collective the first time it is called for a communicator.
+   */
+  shm_allreduce_context&
+  get_shm_allreduce_context(const El::mpi::Comm& c) const;
+  /** Free hierarchical allreduce state of a communicator, if any.
+   *  Collective if the state exists.
+   */
+  void release_shm_allreduce_context(const El::mpi::Comm& c) const;
+  /** MPI attribute delete callback for hierarchical allreduce state. */
+  static int delete_shm_allreduce_context(MPI_Comm comm,
+                                          int keyval,
+                                          void* attr,
+                                          void* extra_state);
+  /** In-place hierarchical allreduce of a contiguous host buffer. */
+  template <typename T>
+  void shm_allreduce(T* data,
+                     El::Int count,
+                     const El::mpi::Comm& c,
+                     El::mpi::Op op) const;
+  /** In-place hierarchical allreduce of a host matrix.
+   *  Non-contiguous matrices are packed into a staging buffer, so
+   *  every rank takes this path regardless of its local layout.
+   */
+  template <typename T>
+  void shm_allreduce(El::Matrix<T, El::Device::CPU>& m,
+                     const El::mpi::Comm& c,
+                     El::mpi::Op op) const;
+
   /** Initialize the default number of threads per process.
    *  This is the number of OpenMP threads to use for parallel
    *  regions, provided omp_set_num_threads has not been called or the
@@ -28,6 +28,7 @@
 #define LBANN_COMM_HPP_IMPL_INCLUDED
 
 #include "lbann/comm.hpp"
+#include "lbann/utils/tracer.hpp"
 
 namespace lbann {
 
@@ -743,12 +744,14 @@ void lbann_comm::nb_allreduce(T* data,
 template <typename T>
 void lbann_comm::wait_all(std::vector<El::mpi::Request<T>>& req) const
 {
+  LBANN_TRACE_SCOPE("comm", "wait_all");
   El::mpi::WaitAll(req.size(), req.data());
 }
 
 /** Wait for a non-blocking request to complete. */
 template <typename T> void lbann_comm::wait(El::mpi::Request<T>& req) const
 {
+  LBANN_TRACE_SCOPE("comm", "wait");
   El::mpi::Wait(req);
 }
 
@@ -1086,7 +1089,13 @@ void lbann_comm::broadcast<std::string>(int root,
   extern template void lbann_comm::nb_allreduce(El::AbstractDistMatrix<T>& m,  \
                                                 const El::mpi::Comm& c,        \
                                                 Al::request& req,              \
-                                                El::mpi::Op op) const
+                                                El::mpi::Op op) const;         \
+  extern template void lbann_comm::nb_reduce_scatter(                          \
+    const El::AbstractMatrix<T>& send,                                         \
+    El::AbstractMatrix<T>& recv,                                               \
+    const std::vector<int>& recv_counts,                                       \
+    const El::mpi::Comm& c,                                                    \
+    Al::request& req) const
 
 #define LBANN_INSTANTIATE_CPU_HALF
 #define LBANN_INSTANTIATE_GPU_HALF
@@ -176,6 +176,30 @@ private:
 
   std::unordered_map<std::string, PackingGroup> m_packing_groups;
 
+  /** Instructions for loading a field from disk. Derived once from
+   *  the field's metadata, so that loading a sample does not require
+   *  any metadata lookups.
+   */
+  struct FieldPlan
+  {
+    /** Path of field within a sample */
+    std::string path;
+    /** Data type to coerce to; empty if the data type is unchanged */
+    conduit::index_t coerce_to = conduit::DataType::EMPTY_ID;
+    /** Per-channel normalization; empty if not normalized */
+    std::vector<double> scale;
+    std::vector<double> bias;
+    /** Number of interleaved channels */
+    size_t n_channels = 1;
+    /** Whether to repack an HWC image to CHW */
+    bool repack = false;
+  };
+
+  /** Filled in by build_field_plans; one entry per field that is
+   *  loaded from disk (i.e. excluding composite nodes)
+   */
+  std::vector<FieldPlan> m_field_plans;
+
   /** Name of nodes in schemas that contain instructions
    * on normalizing, packing, and casting data, etc.
    */
@@ -291,22 +315,27 @@ private:
   /** Fills in m_packing_groups data structure */
   void build_packing_map(conduit::Node& node);
 
-  /** repacks from HWC to CHW */
+  /** repacks from HWC to CHW; shares its kernel with read_field */
   void repack_image(conduit::Node& node,
                     const std::string& path,
                     const conduit::Node& metadata);
 
-  /** called from load_sample */
-  void coerce(const conduit::Node& metadata,
-              hid_t file_handle,
-              const std::string& original_path,
-              const std::string& new_pathname,
-              conduit::Node& node);
-
+  /** scales and shifts in place; shares its kernel with read_field */
   void normalize(conduit::Node& node,
                  const std::string& path,
                  const conduit::Node& metadata);
 
+  /** Constructs m_field_plans from m_useme_node_map */
+  void build_field_plans();
+
+  /** Reads a field from disk into a node. Coercion, normalization,
+   *  and image repacking are applied in a single pass.
+   */
+  void read_field(hid_t file_handle,
+                  const std::string& original_path,
+                  const FieldPlan& plan,
+                  conduit::Node& node) const;
+
   /** Constructs m_data_dims_lookup_table and m_linearized_size_lookup_table */
   void construct_linearized_size_lookup_tables();
   void construct_linearized_size_lookup_tables(conduit::Node& node);
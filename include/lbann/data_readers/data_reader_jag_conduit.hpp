@@ -347,6 +347,22 @@ class data_reader_jag_conduit : public generic_data_reader {
   /// Obtain image data
   std::vector< std::vector<DataType> > get_image_data(const size_t i, conduit::Node& sample) const;
 
+  /** @brief Path of the packed field of a preloaded sample.
+   *
+   *  A preloaded sample holds one contiguous @c DataType array per
+   *  variable type in use, already normalized and in the layout of the
+   *  mini-batch matrix, instead of the tree of raw fields in the file.
+   */
+  static std::string get_packed_field_path(int data_id, const variable_t t);
+  /// Variable types, without duplicates, used by the data and the response
+  std::vector<variable_t> get_packed_variable_types() const;
+  /** @brief Convert the raw fields of a sample into packed fields.
+   *  @param[in] data_id Sample index
+   *  @param[in] sample  Raw fields of the sample as read from file
+   *  @param[out] packed Node to hold the packed fields
+   */
+  void pack_sample(int data_id, conduit::Node& sample, conduit::Node& packed);
+
   bool data_store_active() const override {
     bool flag = generic_data_reader::data_store_active();
     return (m_data_store != nullptr && flag);
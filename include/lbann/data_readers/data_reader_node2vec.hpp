@@ -29,6 +29,9 @@
 
 #include "data_reader.hpp"
 #ifdef LBANN_HAS_LARGESCALE_NODE2VEC
+#include "lbann/utils/alias_table.hpp"
+
+#include <future>
 
 namespace lbann {
 
@@ -56,6 +59,11 @@ namespace node2vec_reader_impl {
  *  periodically recomputed based on the number of times each vertex
  *  is visited.
  *
+ *  Random walks involve communication, so they are performed once
+ *  per mini-batch before the IO threads are dispatched. Each IO
+ *  thread then fills its own mini-batch columns with cached walks and
+ *  negative samples.
+ *
  *  @warning This is experimental.
  *
  */
@@ -92,6 +100,13 @@ protected:
     El::Matrix<El::Int>& indices_fetched) override;
   bool fetch_label(CPUMat& Y, int data_id, int mb_idx) override;
 
+  /** Perform random walks and refresh the noise distribution.
+   *
+   *  Only does work for the first IO thread since the walks and noise
+   *  distribution are shared by all IO threads.
+   */
+  void preprocess_data_source(int tid) override;
+
 private:
 
   /** Perform random walks, starting from random local vertices.
@@ -103,13 +118,14 @@ private:
     size_t num_walks,
     const locked_io_rng_ref&);
 
-  /** Update noise distribution for negative sampling.
+  /** Build noise distribution for negative sampling.
    *
    *  If a vertex has been visited @f$ \text{count} @f$ times, then
    *  its probability in the noise distribution is
    *  @f$ \text{count}^{0.75} @f$.
    */
-  void update_noise_distribution();
+  static alias_table build_noise_distribution(
+    const std::vector<size_t>& visit_counts);
 
   /** HavoqGT database for distributed graph. */
   std::unique_ptr<node2vec_reader_impl::DistributedDatabase> m_distributed_database;
@@ -143,14 +159,19 @@ private:
   std::vector<size_t> m_local_vertex_visit_counts;
   /** Noise distribution for negative sampling.
    *
-   *  The values comprise a cumulative distribution function, i.e. the
-   *  values are in [0,1], they are sorted in ascending order, and the
-   *  last value is 1. To reduce communication, we only perform
+   *  Alias table over local vertices, so each negative sample is
+   *  drawn in constant time. To reduce communication, we only perform
    *  negative sampling with local vertices.
    *
-   *  Computed in @c compute_noise_distribution.
+   *  Computed in @c build_noise_distribution.
+   */
+  alias_table m_noise_distribution;
+  /** Noise distribution being built in the background.
+   *
+   *  It is launched once enough vertex visits have accumulated and it
+   *  replaces @c m_noise_distribution before the next mini-batch.
    */
-  std::vector<double> m_local_vertex_noise_distribution;
+  std::future<alias_table> m_pending_noise_distribution;
 
   /** Total number of times local vertices have been visited in random
    *  walks.
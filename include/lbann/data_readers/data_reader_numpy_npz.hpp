@@ -31,7 +31,9 @@
 
 #include "data_reader.hpp"
 #include "data_reader_numpy.hpp"
-#include <cnpy.h>
+#include "lbann/utils/npz_archive.hpp"
+
+#include <memory>
 
 namespace lbann {
   /**
@@ -39,14 +41,15 @@ namespace lbann {
    * This assumes that the file contains "data", "labels" (optional),
    * and "responses" (optional) whose the zero'th axis is the sample axis.
    * float, double, int16 data-types is accepted for "data".
+   *
+   * The file is memory-mapped and samples are read on demand, so
+   * only the labels are held in memory (see npz_archive).
    */
   class numpy_npz_reader : public generic_data_reader {
   public:
     numpy_npz_reader(const bool shuffle);
-    // These need to be explicit because of some issue with the cnpy copy
-    // constructor/assignment operator not linking correctly otherwise.
-    numpy_npz_reader(const numpy_npz_reader&);
-    numpy_npz_reader& operator=(const numpy_npz_reader&);
+    numpy_npz_reader(const numpy_npz_reader&) = default;
+    numpy_npz_reader& operator=(const numpy_npz_reader&) = default;
     ~numpy_npz_reader() override {}
 
     numpy_npz_reader* copy() const override { return new numpy_npz_reader(*this); }
@@ -66,8 +69,9 @@ namespace lbann {
     int get_linearized_label_size() const override { return m_num_labels; }
     int get_linearized_response_size() const override { return m_num_response_features; }
     const std::vector<int> get_data_dims() const override {
-      std::vector<int> dims(m_data.shape.begin() + 1,
-                            m_data.shape.end());
+      if (m_data == nullptr) { return {}; }
+      std::vector<int> dims(m_data->shape().begin() + 1,
+                            m_data->shape().end());
       return dims;
     }
 
@@ -85,11 +89,15 @@ namespace lbann {
     /// Number of features in each response.
     int m_num_response_features = 0;
     /**
-     * Underlying numpy data.
-     * Note raw data is managed with shared smart pointer semantics (relevant
-     * for copying).
+     * Underlying numpy archive.
+     * Note the archive is shared between copies of the reader.
      */
-    cnpy::NpyArray m_data, m_labels, m_responses;
+    std::shared_ptr<const npz_archive> m_npz;
+    /// Arrays in archive (owned by m_npz).
+    const npz_array *m_data = nullptr, *m_labels = nullptr,
+      *m_responses = nullptr;
+    /// Label for each sample.
+    std::vector<int> m_label_values;
 
     // A constant to be multiplied when data is converted
     // from int16 to DataType.
@@ -31,7 +31,7 @@
 
 #include "lbann/data_readers/data_reader.hpp"
 #include "conduit/conduit.hpp"
-#include <cnpy.h>
+#include <unordered_set>
 
 namespace lbann {
   /**
@@ -42,9 +42,6 @@ class numpy_npz_conduit_reader : public generic_data_reader {
 
  public:
   numpy_npz_conduit_reader(const bool shuffle);
-  // These need to be explicit because of some issue with the cnpy copy
-  // constructor/assignment operator not linking correctly otherwise.
-  // dah -- ??
   numpy_npz_conduit_reader(const numpy_npz_conduit_reader&);
   numpy_npz_conduit_reader& operator=(const numpy_npz_conduit_reader&);
   ~numpy_npz_conduit_reader() override {}
@@ -104,10 +101,11 @@ class numpy_npz_conduit_reader : public generic_data_reader {
 
     void load_conduit_node(const std::string filename, int data_id, conduit::Node &output, bool reset = true);
 
-    std::unordered_map<int, std::map<std::string, cnpy::NpyArray>> m_npz_cache;
-
     void load_npz(const std::string filename, int data_id, conduit::Node &node);
 
+    /// Copies every array in an npz file into a conduit node.
+    void read_npz_arrays(const std::string& filename, int data_id, conduit::Node &output, bool as_uint8) const;
+
 };
 
 }  // namespace lbann
@@ -0,0 +1,207 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2022, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef LBANN_INFERENCE_SERVER_HPP
+#define LBANN_INFERENCE_SERVER_HPP
+
+#include "lbann/execution_algorithms/batch_functional_inference_algorithm.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace lbann {
+
+/** @brief Long-running inference server with dynamic batching.
+ *
+ *  The trainer master listens on a Unix domain socket and queues
+ *  incoming requests. Requests are packed into mini-batches of at
+ *  most @c max_batch_size samples. A mini-batch is dispatched once it
+ *  is full or once the oldest queued request has waited for
+ *  @c max_delay, whichever comes first. Each mini-batch is broadcast
+ *  to the other ranks in the trainer, forward prop is performed on
+ *  pre-allocated input buffers, and the output layer's activations
+ *  are returned to the clients. Requests with more samples than the
+ *  maximum mini-batch size are split across mini-batches.
+ *
+ *  Wire protocol (native byte order, @c DataType values):
+ *  - Request: @c uint32 sample count @f$ n @f$, followed by
+ *    @f$ n \times \text{input size} @f$ values (one sample after
+ *    another).
+ *  - Response: @c uint32 sample count @f$ n @f$, @c uint32 output
+ *    size @f$ m @f$, followed by @f$ n \times m @f$ values.
+ *
+ *  A connection may send any number of requests. Responses on a
+ *  connection are returned in request order. Connections are
+ *  non-blocking, so requests may arrive in pieces without holding up
+ *  other clients. A connection is closed if a request would need more
+ *  than 1 GiB for its inputs and outputs, or cannot be allocated.
+ */
+class inference_server : public batch_functional_inference_algorithm {
+public:
+
+  /** @brief Request latency statistics (in seconds). */
+  struct latency_summary {
+    size_t num_requests = 0;
+    double p50 = 0.;
+    double p90 = 0.;
+    double p99 = 0.;
+    double max = 0.;
+  };
+
+  /** @brief Constructor.
+   *  @param[in] socket_path   Path of Unix domain socket. Any existing
+   *                           file at this path is removed.
+   *  @param[in] max_batch_size Maximum mini-batch size. Should not
+   *                           exceed the mini-batch size used to set
+   *                           up the model.
+   *  @param[in] max_delay     Maximum time a request is queued before
+   *                           its mini-batch is dispatched.
+   *  @param[in] output_layer  Name of layer whose activations are
+   *                           returned. Defaults to the last layer in
+   *                           the model.
+   */
+  inference_server(std::string socket_path,
+                   size_t max_batch_size,
+                   std::chrono::microseconds max_delay,
+                   std::string output_layer = "");
+  inference_server(const inference_server&) = delete;
+  inference_server& operator=(const inference_server&) = delete;
+  ~inference_server() override;
+
+  std::string get_name() const { return "inference_server"; }
+
+  std::string get_type() const { return "inference_server"; }
+
+  // ===========================================
+  // Execution
+  // ===========================================
+
+  /** @brief Serve requests until @c stop is called.
+   *
+   *  Must be called on every rank in the trainer. Prints a summary of
+   *  batching and latency statistics on the trainer master when done.
+   *
+   *  @param[in] model A trained model
+   */
+  void serve(observer_ptr<model> model);
+
+  /** @brief Make @c serve return after its current mini-batch.
+   *
+   *  Only has an effect on the trainer master. Queued requests are
+   *  dropped. Thread-safe.
+   */
+  void stop();
+
+  /** @brief Request latency percentiles so far. Thread-safe. */
+  latency_summary get_latency_summary() const;
+
+  /** @brief Number of mini-batches processed so far. Thread-safe. */
+  size_t get_num_batches() const;
+
+private:
+
+  using clock = std::chrono::steady_clock;
+
+  /** @brief Client connection. Closed when destroyed. */
+  struct connection;
+  /** @brief Inference request from a client. */
+  struct request;
+  /** @brief Contiguous samples from a request within a mini-batch. */
+  struct batch_segment {
+    std::shared_ptr<request> req;
+    /** @brief First sample within request. */
+    size_t request_offset;
+    /** @brief First sample within mini-batch. */
+    size_t batch_offset;
+    size_t count;
+  };
+
+  /** @brief Open socket and start I/O thread. */
+  void start_listening();
+  /** @brief Stop I/O thread and close socket. */
+  void stop_listening();
+  /** @brief I/O thread loop: accept connections and receive requests. */
+  void io_loop();
+  /** @brief Receive available data from a readable connection.
+   *
+   *  Reads until the socket would block or a request is complete.
+   *  Partial requests are kept in the connection.
+   *
+   *  @return Whether the connection is still open.
+   */
+  bool receive_request(const std::shared_ptr<connection>& conn);
+  /** @brief Send outputs for a completed request. */
+  bool send_response(const request& req) const;
+
+  /** @brief Wait for requests and pack them into a mini-batch.
+   *  @return Mini-batch size, or -1 if the server is stopping.
+   */
+  int form_batch(El::Matrix<DataType, El::Device::CPU>& samples,
+                 std::vector<batch_segment>& segments);
+  /** @brief Scatter outputs to requests and send finished responses. */
+  void complete_batch(const El::Matrix<DataType, El::Device::CPU>& outputs,
+                      const std::vector<batch_segment>& segments);
+
+  std::string m_socket_path;
+  size_t m_max_batch_size;
+  std::chrono::microseconds m_max_delay;
+  std::string m_output_layer;
+
+  /** @brief Size of a sample in input layer. */
+  size_t m_input_size = 0;
+  /** @brief Size of a sample in output layer. */
+  size_t m_output_size = 0;
+
+  /** @brief Listening socket (trainer master only). */
+  int m_listen_fd = -1;
+  std::thread m_io_thread;
+  std::atomic<bool> m_stop{false};
+
+  /** @brief Requests with samples that haven't been batched. */
+  std::deque<std::shared_ptr<request>> m_queue;
+  /** @brief Number of samples in queue that haven't been batched. */
+  size_t m_num_queued_samples = 0;
+  std::mutex m_queue_mutex;
+  std::condition_variable m_queue_cv;
+
+  /** @brief Latencies of completed requests (in seconds). */
+  std::vector<double> m_latencies;
+  size_t m_num_batches = 0;
+  size_t m_num_batched_samples = 0;
+  mutable std::mutex m_stats_mutex;
+
+};
+
+}  // namespace lbann
+
+#endif  // LBANN_INFERENCE_SERVER_HPP
@@ -0,0 +1,192 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2022, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef LBANN_EXECUTION_ALGORITHMS_LOCAL_SGD_HPP_INCLUDED
+#define LBANN_EXECUTION_ALGORITHMS_LOCAL_SGD_HPP_INCLUDED
+
+#include "lbann/execution_algorithms/sgd_training_algorithm.hpp"
+
+#include <google/protobuf/message.h>
+#include <memory>
+#include <vector>
+
+namespace lbann {
+
+/** @class LocalSGD
+ *  @brief SGD with periodic model averaging across trainers.
+ *
+ *  Each trainer runs SGD on its own, so gradients are only allreduced
+ *  among the processes in a trainer. Every @f$ H @f$ steps, model
+ *  weights are averaged over all trainers.
+ *
+ *  The averaging is overlapped with the next @f$ H @f$ local steps.
+ *  A copy of the weights is allreduced with a non-blocking
+ *  allreduce, and the local progress made in the meantime is kept
+ *  when it completes:
+ *  @f[ x \leftarrow x + \bar{z} - z @f]
+ *  where @f$ z @f$ is the copy and @f$ \bar{z} @f$ is its average
+ *  over trainers. At the end of training, the weights are averaged
+ *  synchronously so all trainers finish with the same model.
+ *
+ *  Trainers must take the same number of steps, so time-based
+ *  stopping criteria are not supported. All weights must have the
+ *  default @c DataType; mixed-precision models are rejected when
+ *  training starts.
+ *
+ *  Lin, Tao, et al. "Don't use large mini-batches, use local SGD."
+ *  ICLR 2020.
+ *
+ *  Wang, Jianyu, et al. "Overlap local-SGD: An algorithmic approach
+ *  to hide communication delays in distributed SGD." ICASSP 2020.
+ */
+class LocalSGD final : public SGDTrainingAlgorithm
+{
+public:
+  /** @brief Treatment of optimizer state (e.g. momentum) when
+   *  weights are averaged.
+   */
+  enum class momentum_correction {
+    /** @brief Keep each trainer's optimizer state. */
+    KEEP_LOCAL,
+    /** @brief Zero optimizer state after averaging, since it was
+     *  accumulated for the local weights.
+     */
+    RESET,
+    /** @brief Average optimizer state along with the weights. */
+    AVERAGE
+  };
+
+  /** @brief Number of steps between model averages. */
+  struct averaging_schedule {
+    /** @brief Steps between averages. */
+    size_t interval = 1;
+    /** @brief Average after every step for this many initial steps. */
+    size_t warmup_steps = 0;
+    /** @brief If positive, the interval grows linearly from
+     *  @c interval to this value over @c ramp_steps steps after
+     *  warmup.
+     */
+    size_t final_interval = 0;
+    size_t ramp_steps = 0;
+
+    /** @brief Steps between the average at @c step and the next. */
+    size_t get_interval(size_t step) const noexcept;
+  };
+
+public:
+  /** @name Life-cycle management */
+  ///@{
+  LocalSGD(std::string name,
+           std::unique_ptr<SGDTerminationCriteria> stop,
+           bool suppress_timer_output,
+           averaging_schedule schedule,
+           momentum_correction correction);
+  ~LocalSGD() noexcept = default;
+  LocalSGD(LocalSGD const& other) = delete;
+  LocalSGD& operator=(LocalSGD const&) = delete;
+  LocalSGD(LocalSGD&&) = default;
+  LocalSGD& operator=(LocalSGD&&) = default;
+  ///@}
+  /** @brief Queries */
+  ///@{
+  std::string get_type() const final { return "local_sgd"; }
+  averaging_schedule const& get_schedule() const noexcept
+  {
+    return m_schedule;
+  }
+  momentum_correction get_momentum_correction() const noexcept
+  {
+    return m_correction;
+  }
+  /** @brief Number of model averages started so far. */
+  size_t get_num_averages() const noexcept { return m_num_averages; }
+  ///@}
+  /** @name Apply interface */
+  ///@{
+  void apply(ExecutionContext& context,
+             model& m,
+             data_coordinator& dc,
+             execution_mode mode) final;
+  ///@}
+
+protected:
+  /** @brief Train on one step and average the weights if needed. */
+  bool train_mini_batch(SGDExecutionContext& c,
+                        model& model,
+                        data_coordinator& dc,
+                        ScopeTimer timer) final;
+
+private:
+  using AbsDistMatrixType = El::AbstractDistMatrix<DataType>;
+
+  /** @brief Matrix that is averaged across trainers. */
+  struct averaged_matrix {
+    /** @brief Live matrix (weights values or optimizer state). */
+    AbsDistMatrixType* target;
+    /** @brief Copy of @c target when the average started. */
+    std::unique_ptr<AbsDistMatrixType> snapshot;
+    /** @brief Sum of @c snapshot over trainers. */
+    std::unique_ptr<AbsDistMatrixType> sum;
+    Al::request req;
+  };
+
+  /** @brief Find matrices to average and allocate buffers. */
+  void setup_averaging(model& m);
+  /** @brief Make all trainers start with trainer 0's weights. */
+  void broadcast_weights(model& m) const;
+  /** @brief Launch non-blocking average of current weights. */
+  void start_averaging(model& m);
+  /** @brief Wait for average and apply it to the weights. */
+  void finish_averaging(model& m);
+
+  averaging_schedule m_schedule;
+  momentum_correction m_correction;
+
+  /** @brief Matrices that are averaged.
+   *  @details Set up at the start of training. Buffers are reused
+   *  between averages.
+   */
+  std::vector<averaged_matrix> m_averaged_matrices;
+  /** @brief Whether a non-blocking average has been started but not
+   *  applied.
+   */
+  bool m_averaging_in_progress = false;
+  /** @brief Step of most recent average. */
+  size_t m_last_average_step = 0;
+  size_t m_num_averages = 0;
+
+}; // class LocalSGD
+
+} // namespace lbann
+
+/** @brief Build the LocalSGD training algorithm from a protobuf
+ *         message.
+ */
+template <>
+std::unique_ptr<lbann::LocalSGD>
+lbann::make<lbann::LocalSGD>(google::protobuf::Message const& msg);
+
+#endif // LBANN_EXECUTION_ALGORITHMS_LOCAL_SGD_HPP_INCLUDED
@@ -103,6 +103,37 @@ public:
     m_effective_mini_batch_size = mini_batch_size;
   }
 
+  /** @brief Restrict execution to a micro-batch of the current
+   *  mini-batch.
+   *
+   *  Used in pipeline-parallel training. The current mini-batch size
+   *  should be set to the micro-batch size. Layers that read the
+   *  outputs of layers run on the full mini-batch (e.g. input layers)
+   *  view the columns starting at @c offset.
+   */
+  void set_micro_batch(size_t index, size_t offset) noexcept
+  {
+    m_has_micro_batch = true;
+    m_micro_batch_index = index;
+    m_micro_batch_offset = offset;
+  }
+  /** @brief Go back to executing the full mini-batch. */
+  void clear_micro_batch() noexcept
+  {
+    m_has_micro_batch = false;
+    m_micro_batch_index = 0;
+    m_micro_batch_offset = 0;
+  }
+  bool has_micro_batch() const noexcept { return m_has_micro_batch; }
+  size_t get_micro_batch_index() const noexcept
+  {
+    return m_micro_batch_index;
+  }
+  size_t get_micro_batch_offset() const noexcept
+  {
+    return m_micro_batch_offset;
+  }
+
   /** Checkpoint training_algorithm to given file descriptor  */
   void save_to_checkpoint_shared(persist& p) override;
   /** Restore training_algorithm by reading checkpoint from given file
@@ -162,6 +193,15 @@ private:
   execution_mode m_execution_mode;
 
   bool m_stop_early = false;
+
+  /** @brief Whether a micro-batch is being executed.
+   *  @details Not checkpointed, since it only lasts for a step.
+   */
+  bool m_has_micro_batch = false;
+  /** @brief Index of micro-batch within mini-batch. */
+  size_t m_micro_batch_index = 0;
+  /** @brief First sample of micro-batch within mini-batch. */
+  size_t m_micro_batch_offset = 0;
 };
 
 /** @brief Base class for SGD stopping. */
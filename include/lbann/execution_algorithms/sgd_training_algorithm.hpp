@@ -97,8 +97,13 @@ public:
   std::unique_ptr<SGDExecutionContext> get_new_execution_context() const;
 
 protected:
-  /** Train model on one step / mini-batch of an SGD forward pass */
-  bool
+  /** @brief Train model on one step of an SGD solver.
+   *
+   *  With gradient accumulation, a step fetches several mini-batches
+   *  and sums their gradients before a single optimization step. A
+   *  step does not cross the end of an epoch.
+   */
+  virtual bool
   train_mini_batch(SGDExecutionContext& c, model& model, data_coordinator& dc, ScopeTimer timer);
 
   /** Evaluate model on one step / mini-batch of an SGD forward pass */
@@ -148,6 +153,12 @@ private:
    */
   bool m_suppress_timer = false;
 
+  /** @brief Number of mini-batches per optimization step.
+   *  @details Set from @c --gradient_accumulation_steps at the start
+   *  of training.
+   */
+  size_t m_gradient_accumulation_steps = 1;
+
 };
 
 template <>
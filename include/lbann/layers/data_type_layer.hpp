@@ -117,6 +117,15 @@ public:
 
   void summarize_matrices(lbann_summary& summarizer, int step) override;
 
+  /** @brief Estimate work performed by forward and backward prop.
+   *
+   *  Assumes an entry-wise operation: forward prop reads the inputs
+   *  and writes the outputs with one operation per output entry, and
+   *  backward prop additionally reads the output gradients and writes
+   *  the input gradients.
+   */
+  work_estimate estimate_work() const override;
+
   /** Check that the setup is reasonable. */
   void check_setup() override;
 
@@ -129,6 +138,25 @@ public:
   /** Get error signal tensor corresponding to parent layer. */
   const InputAbsDistMatrixType& get_error_signals(const Layer& parent) const override;
 
+  // ===========================================================
+  // Pipeline-parallel exchange of tensors
+  // ===========================================================
+
+  void pack_pipeline_activations(
+    const Layer& child,
+    std::vector<El::byte>& buffer) const override;
+  void unpack_pipeline_input(
+    int parent_index,
+    size_t micro_batch,
+    El::Int mini_batch_size,
+    const std::vector<El::byte>& buffer) override;
+  void pack_pipeline_error_signals(
+    int parent_index,
+    std::vector<El::byte>& buffer) const override;
+  void unpack_pipeline_prev_error_signals(
+    const Layer& child,
+    const std::vector<El::byte>& buffer) override;
+
   /** Get temp Grad Tensor. */
   OutputAbsDistMatrixType& get_temp_grad() ;
   /** Get transfered input for each branch tag **/
@@ -415,6 +443,12 @@ private:
    */
   std::vector<std::unique_ptr<OutputAbsDistMatrixType>> m_subgrid_tensors_split;
 
+  /** @brief Input tensors received from the previous pipeline stage.
+   *  @details Indexed by parent and micro-batch. Not copied.
+   */
+  std::vector<std::vector<std::unique_ptr<InputAbsDistMatrixType>>>
+    m_pipeline_inputs;
+
   /** @brief Whether to keep persistent error signals or dynamically
    *         allocate/deallocate them.
    *
@@ -34,8 +34,9 @@ namespace lbann {
 
 /** @brief Resize image with bilinear interpolation.
  *
- *  Tensors are assumed to be image data in CHW format. Gradients are
- *  not propagated during backprop.
+ *  Tensors are assumed to be image data in CHW format. During
+ *  backprop, each output gradient is distributed to the four input
+ *  pixels used to interpolate it.
  */
 template <typename TensorDataType, data_layout Layout, El::Device Device>
 class bilinear_resize_layer : public data_type_layer<TensorDataType> {
@@ -64,6 +65,7 @@ public:
   El::Device get_device_allocation() const override { return Device; }
 
   void fp_compute() override;
+  void bp_compute() override;
 
 protected:
 
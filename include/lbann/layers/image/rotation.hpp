@@ -35,7 +35,9 @@ namespace lbann {
 /** @brief Rotate a image clockwise around its center
  *
  *  Expects two inputs: a 3D image tensor in CHW format and a scalar
- *  rotation angle.
+ *  rotation angle (in degrees). Output pixels that are rotated from
+ *  outside the image are zero. Gradients are propagated to both the
+ *  image and the angle.
  */
 template <typename TensorDataType, data_layout Layout, El::Device Device>
 class rotation_layer : public data_type_layer<TensorDataType> {
@@ -77,6 +79,7 @@ public:
   El::Device get_device_allocation() const override { return Device; }
 
   void fp_compute() override;
+  void bp_compute() override;
 
 protected:
 
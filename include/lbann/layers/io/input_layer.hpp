@@ -174,7 +174,8 @@ class input_layer : public data_type_layer<TensorDataType> {
   input_layer() : input_layer(nullptr) {}
 
   // This is to track if samples are loaded with set_samples(), if so the
-  // fp_compute() sample loading is no longer necessary
+  // fp_compute() sample loading is no longer necessary and the
+  // mini-batch size is taken from the execution context
   bool m_samples_loaded = false;
 
   data_field_type m_data_field;
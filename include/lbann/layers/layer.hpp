@@ -377,6 +377,28 @@ public:
 
   virtual description get_description() const;
 
+  /** @brief Estimated work performed by forward and backward prop.
+   *
+   *  Counts are for the local portion of the current mini-batch and
+   *  are used for performance reporting.
+   */
+  struct work_estimate {
+    /** @brief Floating-point operations in forward prop. */
+    double fp_flops = 0.;
+    /** @brief Bytes read and written in forward prop. */
+    double fp_bytes = 0.;
+    /** @brief Floating-point operations in backward prop. */
+    double bp_flops = 0.;
+    /** @brief Bytes read and written in backward prop. */
+    double bp_bytes = 0.;
+  };
+  /** @brief Estimate work performed by forward and backward prop.
+   *
+   *  The default implementation reports no work. Layers should
+   *  override this with a model of their cost.
+   */
+  virtual work_estimate estimate_work() const;
+
   /** @brief Get the parallel strategy for the layer. */
   inline ParallelStrategy& get_parallel_strategy() {
     return m_parallel_strategy;
@@ -564,6 +586,31 @@ public:
   /** @brief Get error signal tensor corresponding to parent layer. */
   virtual const BaseDistMat& get_error_signals(const Layer& parent) const = 0;
 
+  /** @brief Setup a parent's output tensor as a view into this
+   *         layer's output tensor.
+   *
+   *  Layers that assemble their output from contiguous pieces of
+   *  their inputs (e.g. concatenation along the outermost dimension)
+   *  can let their parents write directly into their output buffer,
+   *  which avoids a copy in forward prop. The parent layer calls
+   *  this when setting up its output tensors.
+   *
+   *  @param parent         The parent layer requesting the view.
+   *  @param parent_output  The parent's output tensor, which is
+   *                        set up as a view if possible.
+   *  @param alignment      Distribution the parent would otherwise
+   *                        align its output with (may be null).
+   *  @param mini_batch_size Current mini-batch size.
+   *  @returns Whether @c parent_output was set up as a view.
+   */
+  virtual bool setup_parent_output_view(
+    const Layer& parent,
+    BaseDistMat& parent_output,
+    const El::DistData* alignment,
+    El::Int mini_batch_size) {
+    return false;
+  }
+
   ///@}
   /** @name Tensor dimension access functions */
   ///@{
@@ -590,6 +637,69 @@ public:
   /** @brief Set process grid */
   void set_grid_tag(int tag);
 
+  /** @name Pipeline parallelism */
+  ///@{
+
+  /** @brief How a parent's output is obtained while a micro-batch is
+   *  executed in pipeline-parallel training.
+   */
+  enum class pipeline_parent_mode {
+    /** @brief Parent runs on the same micro-batch. */
+    LOCAL,
+    /** @brief Parent has been run on the full mini-batch (e.g. an
+     *  input layer).
+     *
+     *  The columns of the current micro-batch are viewed. Error
+     *  signals are not propagated to the parent.
+     */
+    MINI_BATCH,
+    /** @brief Parent is on the previous pipeline stage.
+     *
+     *  The input tensor is set with @c unpack_pipeline_input. Error
+     *  signals are not propagated to the parent, but are retrieved
+     *  with @c pack_pipeline_error_signals.
+     */
+    REMOTE
+  };
+  void set_pipeline_parent_mode(int parent_index, pipeline_parent_mode mode);
+  /** @details Parents are local unless set otherwise. */
+  pipeline_parent_mode get_pipeline_parent_mode(int parent_index) const;
+
+  /** @brief Pack this process's part of the output tensor
+   *  corresponding to a child on the next pipeline stage.
+   */
+  virtual void pack_pipeline_activations(
+    const Layer& child,
+    std::vector<El::byte>& buffer) const = 0;
+  /** @brief Set an input tensor received from the previous pipeline
+   *  stage.
+   *
+   *  Received tensors are kept for each micro-batch, so forward prop
+   *  can be recomputed before backprop.
+   */
+  virtual void unpack_pipeline_input(
+    int parent_index,
+    size_t micro_batch,
+    El::Int mini_batch_size,
+    const std::vector<El::byte>& buffer) = 0;
+  /** @brief Pack this process's part of the error signals for a
+   *  parent on the previous pipeline stage.
+   *  @details Must be called after backprop.
+   */
+  virtual void pack_pipeline_error_signals(
+    int parent_index,
+    std::vector<El::byte>& buffer) const = 0;
+  /** @brief Set error signals received from a child on the next
+   *  pipeline stage.
+   *  @details Must be called after forward prop on the same
+   *  micro-batch.
+   */
+  virtual void unpack_pipeline_prev_error_signals(
+    const Layer& child,
+    const std::vector<El::byte>& buffer) = 0;
+
+  ///@}
+
   /** @name Hint layer access functions */
   ///@{
 
@@ -829,6 +939,11 @@ protected:
    */
   int m_grid_tag = -1;
 
+  /** @brief Treatment of parents in pipeline-parallel execution.
+   *  @details Not copied, since it is set up by the model.
+   */
+  std::vector<pipeline_parent_mode> m_pipeline_parent_modes;
+
   // -------------------------------------------------------
   // Objects from old sub-grid parallelism implementation
   // -------------------------------------------------------
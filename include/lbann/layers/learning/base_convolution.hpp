@@ -172,6 +172,7 @@ public:
 #endif // LBANN_HAS_DNN_LIB
 
   description get_description() const override;
+  work_estimate estimate_work() const override;
   void setup_dims(DataReaderMetaData& dr_metadata) override;
 
   /** @brief Setup layer data.
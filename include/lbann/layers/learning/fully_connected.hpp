@@ -34,6 +34,11 @@
 
 namespace lbann {
 
+/** @brief Entry-wise activations that can be fused into a
+ *  fully-connected layer.
+ */
+enum class fc_activation {NONE, RELU, GELU, SIGMOID, TANH};
+
 /** @brief Affine transformation
  *
  *  Flattens the input tensor, multiplies with a weights matrix, and
@@ -51,6 +56,13 @@ namespace lbann {
  *  PyTorch's linear operation. However, it implicitly flattens
  *  multi-dimensional data. To avoid this flattening, consider the
  *  channel-wise fully-connected layer.
+ *
+ *  An entry-wise activation can optionally be fused into the layer
+ *  (currently only with data-parallel layout on CPU). It is applied
+ *  in the same pass over the output as the bias, and its derivative
+ *  is applied in the same pass that feeds the bias gradient. The
+ *  model folds an activation layer that immediately follows a
+ *  fully-connected layer if the "fuse_fc_activation" option is set.
  */
 template <typename TensorDataType, data_layout T_layout, El::Device Dev>
 class fully_connected_layer : public data_type_layer<TensorDataType> {
@@ -98,6 +110,18 @@ public:
 
   description get_description() const override;
 
+  work_estimate estimate_work() const override;
+
+  /** @brief Activation applied after the affine transformation. */
+  fc_activation get_fused_activation() const noexcept { return m_activation; }
+  /** @brief Set activation applied after the affine transformation.
+   *
+   *  Must be called before setup.
+   */
+  void set_fused_activation(fc_activation activation) {
+    m_activation = activation;
+  }
+
   /** @name Serialization */
   ///@{
 
@@ -132,6 +156,16 @@ private:
   /** Whether the transpose of the linearity matrix is applied. */
   bool m_transpose;
 
+  /** Entry-wise activation applied after bias. */
+  fc_activation m_activation = fc_activation::NONE;
+
+  /** Workspace for fused activation.
+   *  Holds the pre-activations during forward prop if they are
+   *  needed to compute the activation derivative (GELU), and the
+   *  gradient w.r.t. the pre-activations during backprop.
+   */
+  El::Matrix<TensorDataType, Dev> m_activation_workspace;
+
   /** Deallocate distributed matrices. */
   void deallocate_matrices() {
     if (m_bias_gradient != nullptr) delete m_bias_gradient;
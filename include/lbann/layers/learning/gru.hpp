@@ -54,8 +54,12 @@ namespace lbann {
  *  "ih_bias" ( @f$ 3 \text{hidden\_size} @f$ ),
  *  "hh_bias" ( @f$ 3 \text{hidden\_size} @f$ ).
  *
- *  Support is experimental and requires either cuDNN (on GPU) or
- *  oneDNN (on CPU).
+ *  Support is experimental. The GPU implementation requires cuDNN.
+ *  The CPU implementation uses oneDNN if available and otherwise
+ *  falls back to a native implementation. The native implementation
+ *  computes the input projections for the whole sequence with one
+ *  GEMM per GRU cell and applies the gate nonlinearities in a single
+ *  fused pass per timestep, parallelized over the mini-batch.
  *
  *  @todo Support bidirectional RNNs
  */
@@ -159,6 +163,36 @@ private:
   /** @brief Setup oneDNN CPU implementation */
   void setup_onednn_cpu();
 
+  ///@}
+#else
+  /** @name Native CPU implementation */
+  ///@{
+
+  /** @brief Intermediate values saved by the native CPU forward prop
+   *
+   *  Matrices have one column per (timestep, sample) pair, ordered
+   *  by timestep and then by sample.
+   */
+  struct NativeCpuWorkspace {
+    using LocalMat = El::Matrix<TensorDataType, El::Device::CPU>;
+    /** @brief Input sequence to the first GRU cell */
+    LocalMat input_sequence;
+    /** @brief Post-activation gates for each GRU cell
+     *  ( @f$ 3 \text{hidden\_size} @f$ rows, ordered
+     *  {reset, update, new} )
+     */
+    std::vector<LocalMat> gates;
+    /** @brief Hidden-hidden projection for new gate of each GRU cell,
+     *  before it is scaled by reset gate
+     */
+    std::vector<LocalMat> hh_new;
+    /** @brief Output sequence of each GRU cell */
+    std::vector<LocalMat> hidden;
+  };
+
+  /** @brief Storage for native CPU implementation */
+  std::unique_ptr<NativeCpuWorkspace> m_native_cpu_workspace;
+
   ///@}
 #endif // LBANN_GRU_LAYER_ONEDNN_CPU_SUPPORTED
 
@@ -231,14 +265,12 @@ LBANN_DEFINE_LAYER_BUILDER(gru);
 // Explicit template instantiation
 #ifndef LBANN_GRU_LAYER_INSTANTIATE
 
-#ifdef LBANN_GRU_LAYER_ONEDNN_CPU_SUPPORTED
 #define PROTO(T)                                        \
   extern template class gru_layer<                      \
     T, data_layout::DATA_PARALLEL, El::Device::CPU>;
 #define LBANN_INSTANTIATE_CPU_HALF
 #include "lbann/macros/instantiate.hpp"
 #undef PROTO
-#endif // LBANN_GRU_LAYER_ONEDNN_CPU_SUPPORTED
 
 #ifdef LBANN_GRU_LAYER_CUDNN_SUPPORTED
 #define PROTO(T)                                        \
@@ -77,6 +77,11 @@ public:
   OperatorLayer* copy() const final;
   ///@}
 
+  /** @brief Number of operators applied by this layer. */
+  size_t num_operators() const noexcept { return m_ops.size(); }
+  /** @brief Access an operator applied by this layer. */
+  OperatorType const& get_operator(size_t i) const { return *m_ops.at(i); }
+
   std::string get_type() const final;
   data_layout get_data_layout() const final;
   El::Device get_device_allocation() const final;
@@ -203,18 +203,12 @@ protected:
     const auto& height = input.Height();
     const auto& width = input.Width();
     m_mask->Resize(height, width);
-#ifdef LBANN_DETERMINISTIC
-    bernoulli_fill_procdet(*m_mask, height, width, TensorDataType(m_keep_prob));
+    {
+      // Key mask streams by layer so they do not depend on other fills
+      counter_rng_key_scope key_scope(this->get_name());
+      bernoulli_fill_procdet(*m_mask, height, width, TensorDataType(m_keep_prob));
+    }
     El::Scale(scale, *m_mask);
-#else
-    El::EntrywiseMap(*m_mask,
-                     (std::function<TensorDataType(const TensorDataType&)>)
-                     ([this,scale](const TensorDataType& z)->TensorDataType {
-                       auto& gen = get_fast_generator();
-                       std::bernoulli_distribution dist(m_keep_prob);
-                       return dist(gen) ? scale : El::TypeTraits<TensorDataType>::Zero();
-                     }));
-#endif // LBANN_DETERMINISTIC
 
     // Apply mask matrix to get activations
     El::Hadamard(input, *m_mask, output);
@@ -36,6 +36,8 @@
 #include <lbann/proto/proto_common.hpp>
 #include <layers.pb.h>
 
+#include <algorithm>
+
 namespace lbann {
 
 #ifdef LBANN_HAS_DISTCONV
@@ -84,6 +86,11 @@ public:
 
   description get_description() const override;
 
+  bool setup_parent_output_view(const Layer& parent,
+                                BaseDistMat& parent_output,
+                                const El::DistData* alignment,
+                                El::Int mini_batch_size) override;
+
 protected:
   El::SyncInfo<Device> syncSubGridCommunication = El::SyncInfo<Device>();
 
@@ -94,6 +101,7 @@ protected:
 
   void setup_pointers() override;
   void setup_dims(DataReaderMetaData& dr_metadata) override;
+  void setup_data(size_t max_mini_batch_size) override;
 
   void fp_setup_outputs(El::Int mini_batch_size) override;
   void bp_setup_gradient_wrt_inputs(El::Int mini_batch_size) override;
@@ -105,6 +113,17 @@ private:
   /** @brief Tensor dimension to concatenate along. */
   size_t m_concat_dim;
 
+  /** @brief Whether each parent may write into a view of the output.
+   *
+   *  When concatenating along the outermost dimension, each input
+   *  tensor occupies a contiguous block of rows in the output
+   *  matrix. Parents that have no other children and share this
+   *  layer's layout and device can then write directly into that
+   *  block, so forward prop does not need to copy them. Determined
+   *  in @c setup_data .
+   */
+  std::vector<bool> m_parent_output_views;
+
 #ifdef LBANN_HAS_GPU
   /** @brief Workspace buffer.
    *
@@ -131,6 +150,32 @@ private:
 
   void bp_compute_subgrid();
 
+  /** @brief Whether inputs occupy contiguous row blocks of the output.
+   *
+   *  True when concatenating along the outermost dimension outside
+   *  of sub-graph parallelism. Input gradients can then be views
+   *  into the output gradient.
+   */
+  bool is_row_block_concat() const;
+
+  /** @brief Whether any parent writes into a view of the output. */
+  bool has_parent_output_views() const;
+
+  /** @brief Allocate output tensor if it does not have the right size.
+   *
+   *  Existing buffers are kept since parents may be viewing them.
+   *
+   *  @returns Whether the output is compatible with @c alignment .
+   */
+  bool setup_output_buffer(const El::DistData* alignment,
+                           El::Int mini_batch_size);
+
+  /** @brief Concatenate by copying into row blocks of the output.
+   *
+   *  Inputs that are already views into the output are skipped.
+   */
+  void fp_compute_row_blocks();
+
 #ifdef LBANN_HAS_DISTCONV
   friend class concatenate_distconv_adapter<TensorDataType, Layout, Device>;
  protected:
@@ -260,6 +305,99 @@ void concatenate_layer<TensorDataType,Layout,Device>::setup_dims(DataReaderMetaD
 
 }
 
+template <typename TensorDataType, data_layout Layout, El::Device Device>
+void concatenate_layer<TensorDataType,Layout,Device>::setup_data(size_t max_mini_batch_size) {
+  data_type_layer<TensorDataType>::setup_data(max_mini_batch_size);
+
+  // Determine which parents can write directly into the output
+  const size_t num_parents = this->get_num_parents();
+  m_parent_output_views.assign(num_parents, false);
+  if (Layout != data_layout::DATA_PARALLEL
+      || num_parents < 2
+      || !is_row_block_concat()) {
+    return;
+  }
+#ifdef LBANN_HAS_DISTCONV
+  if (this->distconv_enabled()) { return; }
+#endif // LBANN_HAS_DISTCONV
+  const auto& parents = this->get_parent_layers();
+  for (size_t j=0; j<num_parents; ++j) {
+    const auto& parent = *parents[j];
+    m_parent_output_views[j] =
+      (parent.get_num_children() == 1
+       && parent.get_data_layout() == Layout
+       && parent.get_device_allocation() == Device
+       && std::count(parents.begin(), parents.end(), &parent) == 1);
+  }
+}
+
+template <typename TensorDataType, data_layout Layout, El::Device Device>
+bool concatenate_layer<TensorDataType,Layout,Device>::is_row_block_concat() const {
+  return (m_concat_dim == 0
+          && !(this->is_subgraph_parallelism_enabled()
+               && this->get_parallel_strategy().enable_subgraph));
+}
+
+template <typename TensorDataType, data_layout Layout, El::Device Device>
+bool concatenate_layer<TensorDataType,Layout,Device>::has_parent_output_views() const {
+  return std::any_of(m_parent_output_views.begin(),
+                     m_parent_output_views.end(),
+                     [](bool b) { return b; });
+}
+
+template <typename TensorDataType, data_layout Layout, El::Device Device>
+bool concatenate_layer<TensorDataType,Layout,Device>::setup_output_buffer(
+  const El::DistData* alignment,
+  El::Int mini_batch_size) {
+  auto& output = this->get_activations();
+  const El::Int height = this->get_output_size();
+  if (output.Viewing()
+      || output.Height() != height
+      || output.Width() != mini_batch_size) {
+    output.Empty(false);
+    if (alignment != nullptr) {
+      output.AlignWith(*alignment);
+    }
+    output.Resize(height, mini_batch_size);
+    return true;
+  }
+  return (alignment == nullptr
+          || (output.ColAlign() == alignment->colAlign
+              && output.RowAlign() == alignment->rowAlign
+              && output.Root() == alignment->root
+              && &output.Grid() == alignment->grid));
+}
+
+template <typename TensorDataType, data_layout Layout, El::Device Device>
+bool concatenate_layer<TensorDataType,Layout,Device>::setup_parent_output_view(
+  const Layer& parent,
+  BaseDistMat& parent_output,
+  const El::DistData* alignment,
+  El::Int mini_batch_size) {
+  const size_t j = this->find_parent_layer_index(parent);
+  if (j >= m_parent_output_views.size() || !m_parent_output_views[j]) {
+    return false;
+  }
+  auto* view = dynamic_cast<El::AbstractDistMatrix<TensorDataType>*>(
+    &parent_output);
+  if (view == nullptr
+      || view->DistData().colDist != El::STAR
+      || !setup_output_buffer(alignment, mini_batch_size)) {
+    return false;
+  }
+
+  // View row block corresponding to parent
+  El::Int offset = 0;
+  for (size_t i=0; i<j; ++i) {
+    offset += this->get_input_size(i);
+  }
+  auto& output = this->get_activations();
+  view->Empty(false);
+  El::View(*view, output,
+           El::IR(offset, offset+this->get_input_size(j)), El::ALL);
+  return true;
+}
+
 template <typename TensorDataType, data_layout Layout, El::Device Device>
 void concatenate_layer<TensorDataType,Layout,Device>::fp_setup_outputs(El::Int mini_batch_size) {
 #ifdef LBANN_HAS_DISTCONV
@@ -267,6 +405,12 @@ void concatenate_layer<TensorDataType,Layout,Device>::fp_setup_outputs(El::Int m
 #endif // LBANN_HAS_DISTCONV
   const auto& input0 = this->get_prev_activations(0);
   auto& output = this->get_activations();
+  if (this->get_num_parents() > 1 && has_parent_output_views()) {
+    // Keep buffer that parents are writing into
+    const auto& alignment = input0.DistData();
+    setup_output_buffer(&alignment, input0.Width());
+    return;
+  }
   output.Empty(false);
   if (this->get_num_parents() == 1) {
     El::LockedView(output, input0);
@@ -321,6 +465,27 @@ void concatenate_layer<TensorDataType,Layout,Device>::bp_compute_subgrid() {
   }
 }
 
+template <typename TensorDataType, data_layout Layout, El::Device Device>
+void concatenate_layer<TensorDataType,Layout,Device>::fp_compute_row_blocks() {
+  auto& output = this->get_activations();
+  std::unique_ptr<El::AbstractDistMatrix<TensorDataType>> output_v(
+    output.Construct(output.Grid(), output.Root()));
+  El::Int offset = 0;
+  for (int j=0; j<this->get_num_parents(); ++j) {
+    const auto& input = this->get_prev_activations(j);
+    const El::Int height = this->get_input_size(j);
+    const bool is_view = (input.LocalHeight() == height
+                          && input.LDim() == output.LDim()
+                          && input.LockedBuffer()
+                          == output.LockedBuffer(offset, 0));
+    if (!is_view) {
+      El::View(*output_v, output, El::IR(offset, offset+height), El::ALL);
+      El::Copy(input, *output_v);
+    }
+    offset += height;
+  }
+}
+
 template <typename TensorDataType, data_layout Layout, El::Device Device>
 void concatenate_layer<TensorDataType,Layout,Device>::fp_compute() {
   const auto& input_dims = this->get_input_dims();
@@ -343,6 +508,10 @@ void concatenate_layer<TensorDataType,Layout,Device>::fp_compute() {
   {
     this->fp_compute_subgrid();
   }
+  else if (has_parent_output_views())
+  {
+    this->fp_compute_row_blocks();
+  }
   else
   {
     fp_compute_impl(*this, m_concat_dim);
@@ -387,6 +556,21 @@ void bp_setup_gradient_wrt_inputs_impl(
 #endif
     El::LockedView(l.get_error_signals(0), output_grad);
   }
+  else if (l.is_row_block_concat()
+#ifdef LBANN_HAS_DISTCONV
+           && !l.distconv_enabled()
+#endif // LBANN_HAS_DISTCONV
+    ) {
+    // Input gradients are contiguous row blocks of output gradient
+    size_t offset = 0;
+    for (size_t j=0; j<num_inputs; ++j) {
+      auto& input_grad = l.get_error_signals(j);
+      const auto& input_size = l.get_input_size(j);
+      El::LockedView(input_grad, output_grad,
+                     El::IR(offset, offset+input_size), El::ALL);
+      offset += input_size;
+    }
+  }
   else {
     for (size_t j=0; j<num_inputs; ++j) {
 #ifdef LBANN_HAS_DISTCONV
@@ -429,6 +613,11 @@ void concatenate_layer<TensorDataType,Layout,Device>::bp_compute() {
   {
     this->bp_compute_subgrid();
   }
+  else if (Layout == data_layout::DATA_PARALLEL && is_row_block_concat())
+  {
+    // Tensor views have already been setup in
+    // bp_setup_gradient_wrt_inputs
+  }
   else
   {
     bp_compute_impl(*this, m_concat_dim);
@@ -82,12 +82,12 @@ private:
 
   /** Scaling factor to apply to evaluated value. */
   EvalType m_scale = 0;
-  /** Evaluated value.
+  /** Local contribution to evaluated value.
    *  The value may be stored in pinned memory.
    */
   CPUMatType m_value;
-  /** Non-blocking allreduce request. */
-  Al::request m_allreduce_req;
+  /** Slot in the model's scalar reduction buffer. */
+  size_t m_reduction_slot = 0;
 #ifdef LBANN_HAS_GPU
   /** CUDA event after a non-blocking GPU-CPU memory copy. */
   gpu_lib::event_wrapper m_copy_event;
@@ -34,6 +34,10 @@
 #include "lbann/models/model.hpp"
 #include "lbann/trainers/trainer.hpp"
 
+#include <functional>
+#include <numeric>
+#include <utility>
+
 namespace lbann {
 
 /** @brief Slice tensor along a specified dimension
@@ -99,6 +103,18 @@ protected:
   void fp_compute_subgrid();
   void bp_compute_subgrid();
 
+  /** @brief Whether outputs are contiguous row blocks of the input.
+   *
+   *  True when slicing along the outermost dimension outside of
+   *  sub-graph parallelism. The outputs can then be views into the
+   *  input tensor.
+   */
+  bool is_row_block_slice() const;
+  /** @brief Offset and stride of the row blocks in the input matrix. */
+  std::pair<size_t,size_t> get_row_block_offset_and_stride() const;
+  /** @brief Stack output gradients into row blocks of input gradient. */
+  void bp_compute_row_blocks();
+
 private:
 
   /** Tensor dimension to slice. */
@@ -265,12 +281,44 @@ void fp_setup_outputs_impl(
 
 }
 
+template <typename TensorDataType, data_layout Layout, El::Device Device>
+bool slice_layer<TensorDataType,Layout,Device>::is_row_block_slice() const {
+  return (m_slice_dim == 0
+          && !(this->is_subgraph_parallelism_enabled()
+               && this->get_parallel_strategy().enable_subgraph));
+}
+
+template <typename TensorDataType, data_layout Layout, El::Device Device>
+std::pair<size_t,size_t>
+slice_layer<TensorDataType,Layout,Device>::get_row_block_offset_and_stride() const {
+  const auto& input_dims = this->get_input_dims();
+  const size_t stride = std::accumulate(input_dims.begin()+1,
+                                        input_dims.end(),
+                                        size_t{1},
+                                        std::multiplies<size_t>());
+  return {m_slice_points.front() * stride, stride};
+}
+
 template <typename TensorDataType, El::Device Device>
 void fp_setup_outputs_impl(
   slice_layer<TensorDataType,data_layout::DATA_PARALLEL,Device>& l) {
 
   const size_t num_outputs = l.get_num_children();
   const auto& input = l.get_prev_activations();
+
+  // View row blocks of input tensor if possible
+  if (l.is_row_block_slice()) {
+    size_t offset = l.get_row_block_offset_and_stride().first;
+    for (size_t j=0; j<num_outputs; ++j) {
+      auto& output = l.get_activations(j);
+      const auto& output_size = l.get_output_size(j);
+      El::LockedView(output, input,
+                     El::IR(offset, offset+output_size), El::ALL);
+      offset += output_size;
+    }
+    return;
+  }
+
   for (size_t j=0; j<num_outputs; ++j) {
     auto& output = l.get_activations(j);
     //output.AlignWith(input);
@@ -335,6 +383,10 @@ void slice_layer<TensorDataType,Layout,Device>::fp_compute() {
   {
     fp_compute_subgrid();
   }
+  else if (Layout == data_layout::DATA_PARALLEL && is_row_block_slice())
+  {
+    // Tensor views have already been setup in fp_setup_outputs
+  }
   else
   {
     fp_compute_impl(*this);
@@ -372,6 +424,21 @@ void slice_layer<TensorDataType,Layout,Device>::bp_setup_gradient_wrt_inputs(El:
 
 }
 
+template <typename TensorDataType, data_layout Layout, El::Device Device>
+void slice_layer<TensorDataType,Layout,Device>::bp_compute_row_blocks() {
+  auto& input_grad = this->get_error_signals();
+  std::unique_ptr<El::AbstractDistMatrix<TensorDataType>> input_grad_v(
+    input_grad.Construct(input_grad.Grid(), input_grad.Root()));
+  size_t offset = get_row_block_offset_and_stride().first;
+  for (int j=0; j<this->get_num_children(); ++j) {
+    const auto& output_grad = this->get_prev_error_signals(j);
+    El::View(*input_grad_v, input_grad,
+             El::IR(offset, offset+output_grad.Height()), El::ALL);
+    El::Copy(output_grad, *input_grad_v);
+    offset += output_grad.Height();
+  }
+}
+
 template <typename TensorDataType, data_layout Layout, El::Device Device>
 void slice_layer<TensorDataType,Layout,Device>::bp_compute() {
 
@@ -382,6 +449,10 @@ void slice_layer<TensorDataType,Layout,Device>::bp_compute() {
   {
     bp_compute_subgrid();
   }
+  else if (Layout == data_layout::DATA_PARALLEL && is_row_block_slice())
+  {
+    bp_compute_row_blocks();
+  }
   else
   {
     bp_compute_impl(*this);
@@ -153,8 +153,36 @@ protected:
 
   void fp_compute() override {}
 
+  /** @brief Whether the input gradient can view the output gradient.
+   *
+   *  With a single child, there is nothing to accumulate and the
+   *  gradient can be passed through without a copy.
+   */
+  bool is_gradient_view() const {
+#ifdef LBANN_HAS_DISTCONV
+    if (this->distconv_enabled()) { return false; }
+#endif // LBANN_HAS_DISTCONV
+    return (this->get_num_children() == 1
+            && !this->get_parallel_strategy().enable_subgraph);
+  }
+
+  void bp_setup_gradient_wrt_inputs(El::Int mini_batch_size) override {
+    if (is_gradient_view()) {
+      El::LockedView(this->get_error_signals(),
+                     this->get_prev_error_signals(0));
+    }
+    else {
+      data_type_layer<TensorDataType>::bp_setup_gradient_wrt_inputs(
+        mini_batch_size);
+    }
+  }
+
   void bp_compute() override {
 
+    // Tensor views have already been setup in
+    // bp_setup_gradient_wrt_inputs
+    if (is_gradient_view()) { return; }
+
 
 #ifdef LBANN_HAS_DISTCONV
     if (this->distconv_enabled()) {
@@ -36,6 +36,7 @@
 /// Training Algorithms
 #include "lbann/execution_algorithms/training_algorithm.hpp"
 #include "lbann/execution_algorithms/batch_functional_inference_algorithm.hpp"
+#include "lbann/execution_algorithms/inference_server.hpp"
 
 /// Models
 #include "lbann/models/model.hpp"
@@ -115,6 +115,18 @@ class metric {
    */
   virtual EvalType evaluate(execution_mode mode, int mini_batch_size) = 0;
 
+  /** @brief Record a value evaluated on another process.
+   *
+   *  Used when the metric is only evaluated on some processes,
+   *  e.g. on the last stage in pipeline-parallel training. Values
+   *  are weighted by mini-batch size, as in @c evaluate.
+   */
+  void add_to_statistics(execution_mode mode,
+                         EvalType value,
+                         int mini_batch_size) {
+    m_statistics[mode].add_value(value * mini_batch_size, mini_batch_size);
+  }
+
   /** Clear all statistics. */
   void reset_statistics() {
     for (auto& stats : m_statistics) {
@@ -35,9 +35,11 @@
 #include "lbann/io/persist.hpp"
 #include "lbann/layers/layer.hpp"
 #include "lbann/metrics/metric.hpp"
+#include "lbann/models/pipeline_executor.hpp"
 #include "lbann/objective_functions/objective_function.hpp"
 #include "lbann/optimizers/optimizer.hpp"
 #include "lbann/proto/factories.hpp"
+#include "lbann/utils/scalar_reduction_buffer.hpp"
 #include "lbann/utils/summary.hpp"
 #include "lbann/utils/threads/thread_pool.hpp"
 #include "lbann/weights/weights.hpp"
@@ -133,6 +135,10 @@ public:
 
   observer_ptr<objective_function> get_objective_function() noexcept;
 
+  /** @brief Coalesced reductions for evaluation layers and
+   *  objective function terms. */
+  scalar_reduction_buffer& get_scalar_reductions();
+
   /** @brief Return the model's metrics. */
   std::vector<metric*> get_metrics();
   std::vector<metric const*> get_metrics() const;
@@ -278,6 +284,11 @@ public:
 
   ///@}
 
+  /** @brief Pipeline-parallel executor for training steps.
+   *  @details Null unless @c --pipeline_micro_batches is positive.
+   */
+  pipeline_executor* get_pipeline() noexcept { return m_pipeline.get(); }
+
 private:
   /** @brief Setup-related implementation */
   ///@{
@@ -335,6 +346,32 @@ private:
    */
   void setup_weights();
 
+  /** @brief Set up gradient allreduce bucketing.
+   *
+   *  Called in setup function. If @c --gradient_bucket_size is
+   *  positive, the optimizers of all weights share a bucket manager
+   *  that fuses their gradient allreduces.
+   */
+  void setup_gradient_buckets();
+
+  /** @brief Set up pipeline-parallel training.
+   *
+   *  Called in setup function, after the objective function and
+   *  metrics. If @c --pipeline_micro_batches is positive, layers are
+   *  split into pipeline stages by their sub-grids. Throws if there
+   *  is more than one micro-batch and a layer cannot be recomputed
+   *  (see @c pipeline_executor).
+   */
+  void setup_pipeline();
+
+  /** @brief Set up coalesced scalar reductions.
+   *
+   *  Called in setup function before layers are set up, so that
+   *  evaluation layers can register slots. The reduction interval is
+   *  set with @c --metric_reduction_interval.
+   */
+  void setup_scalar_reductions();
+
   ///@}
   /** @name Subgraph parallelism implementation */
   ///@{
@@ -396,8 +433,14 @@ public:
 
   /** @brief Forward propagation step. */
   void forward_prop(execution_mode mode);
-  /** @brief Backward propagation step. */
-  void backward_prop();
+  /** @brief Backward propagation step.
+   *
+   *  @param end_of_step Whether this is the last backward pass before
+   *  the optimization step. When gradients are accumulated over
+   *  several mini-batches, model-level backprop callbacks only run on
+   *  the last one so that they see the complete gradient.
+   */
+  void backward_prop(bool end_of_step = true);
   /** Evaluate any metrics in the model */
   void evaluate_metrics(execution_mode mode, size_t current_mini_batch_size);
   /** @brief Clear each optimizer's gradient.
@@ -518,6 +561,20 @@ private:
   /** @brief Trainable parameters. */
   std::vector<OwningWeightsPtr> m_weights;
 
+  /** @brief Fuses gradient allreduces of weights' optimizers.
+   *  @details Null if bucketing is disabled.
+   */
+  std::unique_ptr<gradient_bucket_manager> m_gradient_buckets;
+
+  /** @brief Executes training steps over pipeline stages.
+   *  @details Null if pipeline parallelism is disabled.
+   */
+  std::unique_ptr<pipeline_executor> m_pipeline;
+
+  /** @brief Scalar reductions for evaluation layers and objective
+   *  function terms, flushed together once per step. */
+  std::unique_ptr<scalar_reduction_buffer> m_scalar_reductions;
+
   /** @details If a layer needs to construct an optimizer during
    *  setup, it will make a copy of the default optimizer. This object
    *  is just used to create copies and is not actually used for
@@ -581,6 +638,21 @@ private:
    *                        newly created layers.
    */
   void add_split_layers(std::unordered_set<std::string>& layer_names);
+  /** @brief Fold activation layers into fully-connected layers.
+   *
+   *  Only done if the "fuse_fc_activation" option is set. An
+   *  activation layer is folded if it is the only child of a
+   *  data-parallel CPU fully-connected layer and it isn't referenced
+   *  by other layers, objective function terms, metrics, or (by name)
+   *  callbacks. Folded layers are removed from the model.
+   *
+   *  @param layer_set      Layers in model. Updated with any removed
+   *                        layers.
+   *  @param layer_names    Names of layers in model. Updated with any
+   *                        removed layers.
+   */
+  void fuse_fc_activation_layers(std::unordered_set<Layer*>& layer_set,
+                                 std::unordered_set<std::string>& layer_names);
 
   void ensure_input_layers_first();
 
@@ -0,0 +1,209 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2022, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef LBANN_MODELS_PIPELINE_EXECUTOR_HPP_INCLUDED
+#define LBANN_MODELS_PIPELINE_EXECUTOR_HPP_INCLUDED
+
+#include "lbann/base.hpp"
+#include "lbann/models/pipeline_schedule.hpp"
+
+#include <unordered_map>
+#include <vector>
+
+namespace lbann {
+
+// Forward declarations
+class Layer;
+class SGDExecutionContext;
+class data_coordinator;
+class model;
+class optimizer;
+
+/** @brief Pipeline-parallel training over sub-grids.
+ *
+ *  Each pipeline stage is a process sub-grid (see
+ *  @c --num-subgrids-block-order) and owns the layers with its grid
+ *  tag. Stages are ordered by where their layers first appear in the
+ *  model, and every layer must either be on the same stage as its
+ *  parents or on the stage right after. Input layers must be on the
+ *  same stage as their children.
+ *
+ *  A mini-batch is split into micro-batches that flow through the
+ *  stages according to a @c pipeline_schedule_type. Tensors that
+ *  cross a stage boundary are sent point-to-point between
+ *  corresponding processes of the two stage grids, so the stage grids
+ *  must have the same shape and boundary tensors must have the same
+ *  distribution on both sides. Gradients are accumulated over
+ *  micro-batches and allreduced once per mini-batch, during the last
+ *  backward pass.
+ *
+ *  Activations are not stashed between a micro-batch's forward and
+ *  backward passes. If a stage has processed other micro-batches in
+ *  between, its forward pass is recomputed from the received input
+ *  tensors. This keeps memory usage to one micro-batch of activations
+ *  per stage, at the cost of extra compute with the 1F1B schedule.
+ *  A recomputed forward pass must reproduce the original one, so
+ *  layers that draw random numbers or update batch statistics
+ *  (dropout, batch normalization, and the random tensor layers) are
+ *  rejected at setup when there is more than one micro-batch. With a
+ *  single micro-batch they behave as in sequential training.
+ *
+ *  Objective function terms and metrics must be computed from layers
+ *  on the last stage. Weights may not be shared between stages.
+ */
+class pipeline_executor {
+public:
+
+  pipeline_executor(model& m,
+                    pipeline_schedule_type schedule,
+                    size_t num_micro_batches);
+  pipeline_executor(const pipeline_executor&) = delete;
+  pipeline_executor& operator=(const pipeline_executor&) = delete;
+  ~pipeline_executor();
+
+  /** @brief Assign layers to stages and configure boundary tensors.
+   *
+   *  Must be called after the model's layers, weights, objective
+   *  function, and metrics are set up.
+   */
+  void setup();
+
+  /** @brief Train on the current mini-batch.
+   *
+   *  Replaces forward prop, backprop, objective function and metric
+   *  evaluation, and the optimization step. Must be called on every
+   *  process in the trainer after data has been fetched.
+   *
+   *  @returns Whether the data coordinator has finished the epoch.
+   */
+  bool train_mini_batch(SGDExecutionContext& c, data_coordinator& dc);
+
+  /** @brief Compute gradients for the current mini-batch.
+   *
+   *  Runs the pipeline schedule like @c train_mini_batch, but does
+   *  not check the data coordinator or update the weights. Input
+   *  layers must already hold the mini-batch.
+   */
+  void compute_gradients(SGDExecutionContext& c);
+
+  pipeline_schedule_type get_schedule() const noexcept { return m_schedule; }
+  size_t get_num_micro_batches() const noexcept { return m_num_micro_batches; }
+  size_t get_num_stages() const noexcept { return m_num_stages; }
+  /** @brief Pipeline stage of this process. */
+  size_t get_stage() const noexcept { return m_stage; }
+
+private:
+
+  /** @brief Tensor sent from the previous stage to the next stage. */
+  struct boundary {
+    /** @brief Layer on previous stage. */
+    Layer* parent;
+    /** @brief Layer on next stage. */
+    Layer* child;
+    /** @brief Index of @c parent in @c child's parents. */
+    int parent_index;
+    /** @brief Message tag for activations. Error signals use the
+     *  next tag.
+     */
+    int tag;
+  };
+
+  /** @brief Clear gradients and run input layers on the full
+   *  mini-batch.
+   */
+  void begin_step(SGDExecutionContext& c);
+  /** @brief Run the schedule over micro-batches and share objective
+   *  function and metric values.
+   */
+  void run_schedule(SGDExecutionContext& c);
+  /** @brief Forward prop on this stage's layers. */
+  void forward_stage(SGDExecutionContext& c, size_t micro_batch, bool recompute);
+  /** @brief Backprop on this stage's layers. */
+  void backward_stage();
+  /** @brief Evaluate objective function and metrics on last stage. */
+  void evaluate_micro_batch(size_t micro_batch, int micro_batch_size);
+  /** @brief Share objective function and metric values with all
+   *  stages.
+   */
+  void share_evaluations(const std::vector<size_t>& offsets);
+
+  /** @brief Rank in trainer of this process's counterpart in a
+   *  stage.
+   */
+  int get_peer(size_t stage) const;
+  /** @brief Get an empty buffer for a non-blocking send. */
+  std::vector<El::byte>& get_send_buffer();
+  /** @brief Send the buffer from @c get_send_buffer. */
+  void send(int rank, int tag);
+  void receive(int rank, int tag);
+  /** @brief Wait for all non-blocking sends to complete. */
+  void wait_sends();
+
+  model* m_model;
+  pipeline_schedule_type m_schedule;
+  size_t m_num_micro_batches;
+
+  size_t m_num_stages = 0;
+  size_t m_stage = 0;
+  /** @brief Rank of this process within its stage grid. */
+  int m_stage_rank = 0;
+  /** @brief Ranks in trainer of each stage's processes.
+   *  @details Indexed by stage and by rank in stage grid.
+   */
+  std::vector<std::vector<int>> m_stage_ranks;
+
+  /** @brief Input layers in all stages. */
+  std::vector<Layer*> m_input_layers;
+  /** @brief Non-input layers in this stage, in model order. */
+  std::vector<Layer*> m_stage_layers;
+  std::vector<boundary> m_boundaries;
+  /** @brief Boundaries where layer is the child. */
+  std::unordered_map<const Layer*, std::vector<size_t>> m_incoming;
+  /** @brief Boundaries where layer is the parent. */
+  std::unordered_map<const Layer*, std::vector<size_t>> m_outgoing;
+  /** @brief Optimizers of weights in this stage. */
+  std::vector<optimizer*> m_stage_optimizers;
+
+  /** @brief Communicator for boundary tensors.
+   *  @details Duplicated from the trainer communicator to avoid
+   *  message tag collisions.
+   */
+  El::mpi::Comm m_comm;
+  std::vector<std::vector<El::byte>> m_send_buffers;
+  std::vector<El::mpi::Request<El::byte>> m_send_requests;
+  size_t m_num_sends = 0;
+  std::vector<El::byte> m_recv_buffer;
+
+  /** @brief Objective function and metric values for each
+   *  micro-batch.
+   */
+  std::vector<EvalType> m_evaluations;
+
+};
+
+} // namespace lbann
+
+#endif // LBANN_MODELS_PIPELINE_EXECUTOR_HPP_INCLUDED
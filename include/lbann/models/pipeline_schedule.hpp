@@ -0,0 +1,99 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2022, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef LBANN_MODELS_PIPELINE_SCHEDULE_HPP_INCLUDED
+#define LBANN_MODELS_PIPELINE_SCHEDULE_HPP_INCLUDED
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace lbann {
+
+/** @brief Order in which pipeline stages process micro-batches. */
+enum class pipeline_schedule_type {
+  /** @brief All forward passes, then all backward passes.
+   *
+   *  Backward passes are in reverse micro-batch order, so the last
+   *  stage can start backprop with the micro-batch it just finished.
+   *  See Huang et al., "GPipe: Efficient Training of Giant Neural
+   *  Networks using Pipeline Parallelism", NeurIPS 2019.
+   */
+  GPIPE,
+  /** @brief Alternate forward and backward passes once the pipeline
+   *  is full.
+   *
+   *  Stage @f$ s @f$ of @f$ S @f$ starts with @f$ S-s-1 @f$ warmup
+   *  forward passes. This bounds the number of micro-batches in
+   *  flight on a stage by @f$ S-s @f$ instead of the number of
+   *  micro-batches. See Narayanan et al., "Memory-Efficient
+   *  Pipeline-Parallel DNN Training", ICML 2021.
+   */
+  ONE_F_ONE_B
+};
+
+std::string to_string(pipeline_schedule_type schedule);
+/** @brief Parse "gpipe" or "1f1b". */
+pipeline_schedule_type pipeline_schedule_type_from_string(const std::string& str);
+
+/** @brief Step performed by a pipeline stage. */
+struct pipeline_op {
+  enum class op_type { FORWARD, BACKWARD };
+  op_type type;
+  size_t micro_batch;
+};
+
+/** @brief Operations performed by a pipeline stage in one
+ *  mini-batch step.
+ *
+ *  Each micro-batch is processed by exactly one forward and one
+ *  backward pass. All stages process forward passes in increasing
+ *  micro-batch order and backward passes in the same order as each
+ *  other, so point-to-point messages between neighboring stages
+ *  match in order.
+ */
+std::vector<pipeline_op>
+make_pipeline_schedule(pipeline_schedule_type schedule,
+                       size_t num_stages,
+                       size_t stage,
+                       size_t num_micro_batches);
+
+/** @brief Split a mini-batch into contiguous micro-batches.
+ *
+ *  Micro-batch sizes differ by at most one. If the mini-batch has
+ *  fewer samples than requested micro-batches, each micro-batch gets
+ *  one sample.
+ *
+ *  @returns Offsets of micro-batches, followed by the mini-batch
+ *  size. Micro-batch @c i spans samples
+ *  @c [offsets[i],offsets[i+1]).
+ */
+std::vector<size_t> get_micro_batch_offsets(size_t mini_batch_size,
+                                            size_t num_micro_batches);
+
+} // namespace lbann
+
+#endif // LBANN_MODELS_PIPELINE_SCHEDULE_HPP_INCLUDED
@@ -83,6 +83,19 @@ class objective_function {
    */
   void compute_weight_regularization();
 
+  /** @brief Record a value evaluated on another process.
+   *
+   *  Used when the objective function is only evaluated on some
+   *  processes, e.g. on the last stage in pipeline-parallel training.
+   *  Values are weighted by mini-batch size, as in
+   *  @c finish_evaluation.
+   */
+  void add_to_statistics(execution_mode mode,
+                         EvalType value,
+                         int mini_batch_size) {
+    m_statistics[mode].add_value(mini_batch_size * value, mini_batch_size);
+  }
+
   /** Clear all statistics. */
   void reset_statistics() {
     for (auto& stats : m_statistics) {
@@ -132,6 +145,12 @@ class objective_function {
   /** Time spent computing the objective function gradient. */
   EvalType m_differentiation_time = EvalType(0);
 
+  /** Model's coalesced scalar reductions.
+   *  Terms contribute to it in @c start_evaluation, after which all
+   *  contributions are reduced together.
+   */
+  scalar_reduction_buffer* m_scalar_reductions = nullptr;
+
 };
 
 } // namespace lbann
@@ -33,6 +33,9 @@
 
 namespace lbann {
 
+// Forward declarations
+class scalar_reduction_buffer;
+
 /** Abstract class for objective function terms. */
 class objective_function_term {
  public:
@@ -96,6 +99,8 @@ class objective_function_term {
   std::vector<ViewingLayerPtr> m_layers;
   /** Weights used to compute objective function term. */
   std::vector<ViewingWeightsPtr> m_weights;
+  /** Model's coalesced scalar reductions. */
+  scalar_reduction_buffer* m_scalar_reductions = nullptr;
 
   /** Get LBANN communicator. */
   lbann_comm& get_comm() { return *m_comm; }
@@ -90,8 +90,8 @@ private:
   /** Contributions to evaluated value. */
   std::map<El::Device, CPUMatType> m_contributions;
 
-  /** For non-blocking allreduces. */
-  Al::request m_allreduce_req;
+  /** Slots in model's scalar reduction buffer for each device. */
+  std::map<El::Device, size_t> m_reduction_slots;
 #ifdef LBANN_HAS_GPU
   /** For non-blocking GPU-CPU memory copies. */
   gpu_lib::event_wrapper m_copy_event;
@@ -28,6 +28,7 @@
 #define LBANN_OPTIMIZERS_ADAGRAD_IMPL_HPP_INCLUDED
 
 #include "lbann/optimizers/adagrad.hpp"
+#include "lbann/optimizers/data_type_optimizer_impl.hpp"
 #include "lbann/utils/serialize.hpp"
 
 namespace lbann {
@@ -38,8 +39,8 @@ void
 adagrad<TensorDataType>
 ::serialize(Archive & ar) {
   ar(cereal::base_class<data_type_optimizer<TensorDataType>>(this),
-     CEREAL_NVP(m_eps),
-     CEREAL_NVP(m_cache));
+     CEREAL_NVP(m_eps));
+  this->serialize_state(ar, "m_cache", m_cache);
 }
 
 } // namespace lbann
@@ -28,6 +28,7 @@
 #define LBANN_OPTIMIZERS_ADAM_IMPL_HPP_INCLUDED
 
 #include "lbann/optimizers/adam.hpp"
+#include "lbann/optimizers/data_type_optimizer_impl.hpp"
 #include "lbann/utils/serialize.hpp"
 
 namespace lbann {
@@ -42,9 +43,9 @@ adam<TensorDataType>
      CEREAL_NVP(m_beta2),
      CEREAL_NVP(m_eps),
      CEREAL_NVP(m_current_beta1),
-     CEREAL_NVP(m_current_beta2),
-     CEREAL_NVP(m_moment1),
-     CEREAL_NVP(m_moment2));
+     CEREAL_NVP(m_current_beta2));
+  this->serialize_state(ar, "m_moment1", m_moment1);
+  this->serialize_state(ar, "m_moment2", m_moment2);
 }
 
 } // namespace lbann
@@ -103,6 +103,28 @@ public:
   void step() override;
   ///@}
 
+  /** @name Optimizer state sharding */
+  ///@{
+
+  /** @brief Partition optimizer state across the processes that
+   *  share the weights.
+   *
+   *  Gradients are reduce-scattered instead of allreduced, each
+   *  process updates its own chunk of the weights, and the updated
+   *  weights are allgathered. Sharding is also enabled for all
+   *  optimizers with the @c --shard_optimizer_state flag. Must be
+   *  called before setup. Only applies to data-parallel weights
+   *  (see @c make_gradient_shard_layout).
+   */
+  void set_state_sharding(bool shard) { m_shard_state = shard; }
+  /** @brief Whether optimizer state is partitioned across
+   *  processes. Only valid after setup. */
+  bool is_state_sharded() const noexcept {
+    return this->get_gradient_shard_layout() != nullptr;
+  }
+
+  ///@}
+
   /** @brief Access the scaling factor for optimization step sizes. */
   double get_learning_rate() const final;
   /** @brief Set the scaling factor for optimization step sizes. */
@@ -128,6 +150,27 @@ protected:
   virtual void step_compute(AbsDistMatrixType& values,
                             const AbsDistMatrixType& gradient) = 0;
 
+  /** @brief Objective function gradient in the layout passed to
+   *  @c step_compute.
+   *
+   *  This is the local shard of the gradient if optimizer state is
+   *  sharded and the full gradient otherwise. Optimizer state
+   *  matrices should be constructed with its distribution and
+   *  dimensions.
+   */
+  const AbsDistMatrixType& get_step_gradient();
+
+  /** @brief Checkpoint an optimizer state matrix.
+   *
+   *  Sharded state is gathered when saving and partitioned when
+   *  loading, so checkpoints always hold the full state in the
+   *  weights distribution.
+   */
+  template <class ArchiveT>
+  void serialize_state(ArchiveT& ar,
+                       const char* name,
+                       std::unique_ptr<AbsDistMatrixType>& state);
+
   /** @brief Get the info needed to construct a new gradient matrix.
    *  @return Tuple of height, width, and DistData.
    */
@@ -148,6 +191,13 @@ private:
    */
   std::unique_ptr<AbsDistMatrixType> m_gradient_v;
 
+  /** @brief Whether to partition optimizer state across processes. */
+  bool m_shard_state = false;
+  /** @brief This process's chunk of the gradient, if sharded. */
+  std::unique_ptr<AbsDistMatrixType> m_gradient_shard;
+  /** @brief This process's chunk of the weights, if sharded. */
+  std::unique_ptr<AbsDistMatrixType> m_values_shard;
+
   /** @brief Communication request object for gradient allreduce.
    *
    *  Used to synchronize non-blocking allreduce.
@@ -28,6 +28,8 @@
 #define LBANN_OPTIMIZERS_DATA_TYPE_OPTIMIZER_IMPL_HPP_INCLUDED
 
 #include "lbann/weights/data_type_weights.hpp"
+#include "lbann/utils/argument_parser.hpp"
+#include "lbann/utils/options.hpp"
 #include "lbann/utils/serialize.hpp"
 #include "lbann/utils/timer.hpp"
 
@@ -48,6 +50,11 @@ data_type_optimizer<TensorDataType>::data_type_optimizer(
     m_weights(other.m_weights),
     m_gradient(other.m_gradient ? other.m_gradient->Copy() : nullptr),
     m_gradient_v(other.m_gradient_v ? other.m_gradient_v->Copy() : nullptr),
+    m_shard_state(other.m_shard_state),
+    m_gradient_shard(other.m_gradient_shard ? other.m_gradient_shard->Copy()
+                                            : nullptr),
+    m_values_shard(other.m_values_shard ? other.m_values_shard->Copy()
+                                        : nullptr),
     m_learning_rate(other.m_learning_rate)
 {}
 
@@ -60,6 +67,11 @@ data_type_optimizer<TensorDataType>::operator=(
   m_weights = other.m_weights;
   m_gradient.reset(other.m_gradient ? other.m_gradient->Copy() : nullptr);
   m_gradient_v.reset(other.m_gradient_v ? other.m_gradient_v->Copy() : nullptr);
+  m_shard_state = other.m_shard_state;
+  m_gradient_shard.reset(other.m_gradient_shard ? other.m_gradient_shard->Copy()
+                                                : nullptr);
+  m_values_shard.reset(other.m_values_shard ? other.m_values_shard->Copy()
+                                            : nullptr);
   m_learning_rate = other.m_learning_rate;
   return *this;
 }
@@ -69,6 +81,7 @@ description data_type_optimizer<TensorDataType>::get_description() const
 {
   description desc = optimizer::get_description();
   desc.add("Learning rate", m_learning_rate);
+  desc.add("Sharded state", is_state_sharded());
   return desc;
 }
 
@@ -103,6 +116,7 @@ auto data_type_optimizer<TensorDataType>::get_gradient() -> AbsDistMatrixType&
   // Make sure gradient values are ready
   this->start_gradient_allreduce();
   this->finish_gradient_allreduce();
+  this->unshard_gradients();
 
   // Gather all gradients to the master precision
   this->accumulate_all_gradient_contributions(*m_gradient);
@@ -111,6 +125,21 @@ auto data_type_optimizer<TensorDataType>::get_gradient() -> AbsDistMatrixType&
   return *m_gradient;
 }
 
+template <typename TensorDataType>
+auto data_type_optimizer<TensorDataType>::get_step_gradient()
+  -> const AbsDistMatrixType&
+{
+  if (!is_state_sharded()) {
+    return get_gradient();
+  }
+
+  // Reduce-scatter gradients and sum local chunks
+  this->start_gradient_allreduce();
+  this->finish_gradient_allreduce();
+  this->accumulate_all_gradient_shards(*m_gradient_shard);
+  return *m_gradient_shard;
+}
+
 template <typename TensorDataType>
 void data_type_optimizer<TensorDataType>::setup(weights* w_in)
 {
@@ -154,6 +183,24 @@ void data_type_optimizer<TensorDataType>::setup_base(WeightsType* w)
     m_gradient_v->Matrix().SetMemoryMode(1); // CUB GPU memory pool
   }
 #endif // HYDROGEN_HAVE_CUB
+
+  // Partition optimizer state if needed
+  const auto& arg_parser = global_argument_parser();
+  std::shared_ptr<const gradient_shard_layout> layout;
+  if (m_shard_state || arg_parser.get<bool>(LBANN_OPTION_SHARD_OPTIMIZER_STATE)) {
+    layout = make_gradient_shard_layout(values);
+  }
+  this->set_gradient_shard_layout(layout);
+  if (layout != nullptr) {
+    m_gradient_shard.reset(AbsDistMatrixType::Instantiate(layout->dist));
+    m_values_shard.reset(AbsDistMatrixType::Instantiate(layout->dist));
+    El::Zeros(*m_gradient_shard, layout->height, 1);
+    El::Zeros(*m_values_shard, layout->height, 1);
+  }
+  else {
+    m_gradient_shard.reset();
+    m_values_shard.reset();
+  }
 }
 
 template <typename TensorDataType>
@@ -176,7 +223,17 @@ void data_type_optimizer<TensorDataType>::step()
     LBANN_ERROR("attempted to perform optimization step without weights");
   }
   const auto start_time = get_time();
-  this->step_compute(m_weights->get_values(), this->get_gradient());
+  if (const auto* layout = this->get_gradient_shard_layout()) {
+    // Update local chunk of weights and allgather
+    auto& values = m_weights->get_values();
+    const auto& gradient = this->get_step_gradient();
+    copy_to_shard(values.LockedMatrix(), m_values_shard->Matrix(), *layout);
+    this->step_compute(*m_values_shard, gradient);
+    gather_from_shard(m_values_shard->LockedMatrix(), values.Matrix(), *layout);
+  }
+  else {
+    this->step_compute(m_weights->get_values(), this->get_gradient());
+  }
   this->inc_step_time(get_time() - start_time);
 }
 
@@ -197,6 +254,37 @@ void data_type_optimizer<TensorDataType>::serialize(Archive& ar)
   ar(cereal::base_class<optimizer>(this), CEREAL_NVP(m_learning_rate));
 }
 
+template <typename TensorDataType>
+template <class ArchiveT>
+void data_type_optimizer<TensorDataType>::serialize_state(
+  ArchiveT& ar,
+  const char* name,
+  std::unique_ptr<AbsDistMatrixType>& state)
+{
+  const auto* layout = this->get_gradient_shard_layout();
+  if (layout == nullptr || state == nullptr) {
+    ar(cereal::make_nvp(name, state));
+    return;
+  }
+
+  // Convert between shard and full matrix in weights distribution
+  const auto& values = this->get_weights().get_values();
+  std::unique_ptr<AbsDistMatrixType> full(
+    AbsDistMatrixType::Instantiate(values.DistData()));
+  full->AlignWith(values);
+  full->Resize(values.Height(), values.Width());
+  if constexpr (utils::IsOutputArchive<ArchiveT>) {
+    gather_from_shard(state->LockedMatrix(), full->Matrix(), *layout);
+    ar(cereal::make_nvp(name, full));
+  }
+  else {
+    std::unique_ptr<AbsDistMatrixType> loaded;
+    ar(cereal::make_nvp(name, loaded));
+    El::Copy(*loaded, *full);
+    copy_to_shard(full->LockedMatrix(), state->Matrix(), *layout);
+  }
+}
+
 } // namespace lbann
 
 #endif // LBANN_OPTIMIZERS_DATA_TYPE_OPTIMIZER_IMPL_HPP_INCLUDED
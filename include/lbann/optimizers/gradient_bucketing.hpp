@@ -0,0 +1,161 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2022, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef LBANN_OPTIMIZERS_GRADIENT_BUCKETING_HPP_INCLUDED
+#define LBANN_OPTIMIZERS_GRADIENT_BUCKETING_HPP_INCLUDED
+
+#include "lbann/base.hpp"
+#include "lbann/comm.hpp"
+
+#include <map>
+#include <memory>
+#include <tuple>
+#include <typeindex>
+
+namespace lbann {
+
+class gradient_bucket_manager;
+
+/** @brief Group of gradients that are allreduced together.
+ *
+ *  Gradients are packed into a contiguous buffer and allreduced with
+ *  a single non-blocking collective.
+ */
+class gradient_bucket {
+public:
+  virtual ~gradient_bucket() = default;
+
+protected:
+  friend class gradient_bucket_manager;
+
+  /** @brief Launch non-blocking allreduce. Does nothing if it has
+   *  already been launched. */
+  virtual void launch() = 0;
+  /** @brief Wait for the allreduce to complete.
+   *
+   *  The results are copied back into every gradient in the bucket
+   *  the first time this is called.
+   */
+  virtual void wait() = 0;
+  virtual bool is_launched() const noexcept = 0;
+  /** @brief Number of bytes packed into bucket. */
+  virtual size_t size_bytes() const noexcept = 0;
+};
+
+/** @brief Fuse gradient allreduces into size-bounded buckets.
+ *
+ *  Many weights (e.g. biases and batchnorm scales) are tiny and
+ *  launching a separate allreduce for each is dominated by latency.
+ *  Gradients are packed into flat buffers in the order they become
+ *  ready during backprop, and a bucket's allreduce is launched as
+ *  soon as the next gradient would overflow it. Buckets are
+ *  therefore launched in backprop order, which is the order in which
+ *  the gradients become ready, and the first buckets to finish belong
+ *  to the weights closest to the output. The remaining partial
+ *  buckets are launched with @c flush at the end of backprop.
+ *
+ *  Gradients are grouped by redundant communicator, data type, and
+ *  device. Gradients that are at least as large as a bucket are
+ *  allreduced directly.
+ */
+class gradient_bucket_manager {
+public:
+
+  /** @brief Bucketing and overlap statistics. */
+  struct statistics {
+    /** @brief Number of bucket allreduces. */
+    size_t num_buckets = 0;
+    /** @brief Number of gradients packed into buckets. */
+    size_t num_gradients = 0;
+    /** @brief Number of bytes allreduced through buckets. */
+    size_t num_bytes = 0;
+    /** @brief Number of buckets whose allreduce had completed
+     *  before it was waited on. */
+    size_t num_overlapped = 0;
+    /** @brief Time spent blocking on bucket allreduces (in
+     *  seconds). */
+    double wait_time = 0.;
+    /** @brief Time between launching bucket allreduces and waiting
+     *  on them (in seconds). */
+    double overlap_time = 0.;
+  };
+
+  /** @param comm         LBANN communicator.
+   *  @param bucket_size  Maximum size of a bucket (in bytes).
+   */
+  gradient_bucket_manager(lbann_comm& comm, size_t bucket_size);
+  gradient_bucket_manager(const gradient_bucket_manager&) = delete;
+  gradient_bucket_manager& operator=(const gradient_bucket_manager&) = delete;
+
+  /** @brief Add a gradient that needs an allreduce over its
+   *  redundant communicator.
+   *
+   *  The local data is copied into a bucket immediately, so the
+   *  gradient must be fully accumulated. The gradient must not be
+   *  modified until the bucket has been waited on.
+   *
+   *  @returns Bucket containing the gradient, or a null pointer if
+   *  the gradient should be allreduced directly.
+   */
+  template <typename TensorDataType>
+  std::shared_ptr<gradient_bucket>
+  add(El::AbstractDistMatrix<TensorDataType>& gradient);
+
+  /** @brief Wait for a bucket's allreduce to complete.
+   *
+   *  The bucket is launched first if needed. Like the allreduce
+   *  itself, this must be called in the same order on every rank.
+   */
+  void wait(gradient_bucket& bucket);
+
+  /** @brief Launch allreduces for all partially filled buckets. */
+  void flush();
+
+  size_t get_bucket_size() const noexcept { return m_bucket_size; }
+
+  const statistics& get_statistics() const noexcept { return m_stats; }
+  void reset_statistics() { m_stats = statistics(); }
+
+private:
+
+  /** @brief Redundant communicator, data type, and device. */
+  using bucket_key =
+    std::tuple<const El::mpi::Comm*, std::type_index, El::Device>;
+
+  /** @brief Launch a bucket's allreduce and record statistics. */
+  void launch(gradient_bucket& bucket);
+
+  lbann_comm& m_comm;
+  size_t m_bucket_size;
+  /** @brief Buckets that have not been launched. */
+  std::map<bucket_key, std::shared_ptr<gradient_bucket>> m_open_buckets;
+  statistics m_stats;
+
+};
+
+} // namespace lbann
+
+#endif // LBANN_OPTIMIZERS_GRADIENT_BUCKETING_HPP_INCLUDED
@@ -0,0 +1,142 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2022, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef LBANN_OPTIMIZERS_GRADIENT_COMPRESSION_HPP_INCLUDED
+#define LBANN_OPTIMIZERS_GRADIENT_COMPRESSION_HPP_INCLUDED
+
+#include "lbann/base.hpp"
+#include "lbann/comm.hpp"
+
+#include <memory>
+#include <string>
+
+namespace lbann {
+
+/** @brief Lossy compression applied to gradients before they are
+ *  summed over their redundant communicator. */
+enum class gradient_compression_type {
+  /** @brief Full-precision allreduce. */
+  NONE,
+  /** @brief Sum in IEEE half precision. */
+  FP16,
+  /** @brief Sum in bfloat16. */
+  BF16,
+  /** @brief Exchange the largest-magnitude entries, with error
+   *  feedback. */
+  TOP_K,
+  /** @brief Exchange a low-rank approximation computed with one
+   *  step of power iteration, with error feedback. */
+  POWER_SGD,
+};
+
+/** @brief Human-readable name for gradient compression type. */
+std::string to_string(gradient_compression_type type);
+
+/** @brief Gradient compression settings for a weights object. */
+struct gradient_compression_config {
+  gradient_compression_type type = gradient_compression_type::NONE;
+  /** @brief Fraction of entries exchanged by top-k sparsification. */
+  double top_k_ratio = 0.01;
+  /** @brief Rank of PowerSGD approximation. */
+  El::Int power_sgd_rank = 4;
+};
+
+/** @brief Communication volume of compressed gradient allreduces. */
+struct gradient_compression_statistics {
+  /** @brief Number of gradient allreduces. */
+  size_t num_allreduces = 0;
+  /** @brief Bytes each process would have contributed without
+   *  compression. */
+  size_t uncompressed_bytes = 0;
+  /** @brief Bytes each process actually contributed. */
+  size_t compressed_bytes = 0;
+
+  /** @brief Uncompressed size divided by compressed size. */
+  double ratio() const noexcept {
+    return (compressed_bytes > 0
+            ? static_cast<double>(uncompressed_bytes) / compressed_bytes
+            : 1.);
+  }
+  gradient_compression_statistics&
+  operator+=(const gradient_compression_statistics& other) noexcept {
+    num_allreduces += other.num_allreduces;
+    uncompressed_bytes += other.uncompressed_bytes;
+    compressed_bytes += other.compressed_bytes;
+    return *this;
+  }
+};
+
+/** @brief Sums a gradient over its redundant communicator with
+ *  lossy compression.
+ *
+ *  Compression is performed on the host, so GPU gradients are staged
+ *  through host memory. Compressors with error feedback keep the part
+ *  of each process's contribution that was not exchanged and add it
+ *  to the next gradient, so a compressor must be used with a single
+ *  gradient matrix.
+ */
+template <typename TensorDataType>
+class gradient_compressor {
+public:
+  virtual ~gradient_compressor() = default;
+
+  /** @brief Blocking compressed allreduce.
+   *
+   *  Like a regular allreduce, this must be called in the same order
+   *  on every process in the redundant communicator.
+   */
+  virtual void allreduce(El::AbstractDistMatrix<TensorDataType>& gradient,
+                         lbann_comm& comm) = 0;
+
+  const gradient_compression_statistics& get_statistics() const noexcept {
+    return m_stats;
+  }
+  void reset_statistics() { m_stats = gradient_compression_statistics(); }
+
+protected:
+  /** @brief Record communication volume of an allreduce. */
+  void record(size_t uncompressed_bytes, size_t compressed_bytes) {
+    ++m_stats.num_allreduces;
+    m_stats.uncompressed_bytes += uncompressed_bytes;
+    m_stats.compressed_bytes += compressed_bytes;
+  }
+
+private:
+  gradient_compression_statistics m_stats;
+};
+
+/** @brief Construct gradient compressor.
+ *
+ *  Returns a null pointer if compression is disabled. Compression is
+ *  only supported for @c float and @c double gradients.
+ */
+template <typename TensorDataType>
+std::unique_ptr<gradient_compressor<TensorDataType>>
+make_gradient_compressor(const gradient_compression_config& config);
+
+} // namespace lbann
+
+#endif // LBANN_OPTIMIZERS_GRADIENT_COMPRESSION_HPP_INCLUDED
@@ -0,0 +1,97 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2022, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef LBANN_OPTIMIZERS_GRADIENT_SHARDING_HPP_INCLUDED
+#define LBANN_OPTIMIZERS_GRADIENT_SHARDING_HPP_INCLUDED
+
+#include "lbann/base.hpp"
+
+#include <memory>
+#include <vector>
+
+namespace lbann {
+
+/** @brief Partition of weights entries for sharded optimizer state.
+ *
+ *  The local entries of a weights matrix (in column-major order) are
+ *  split into contiguous chunks, one for each process in @c comm.
+ *  Each process reduces, stores optimizer state for, and updates only
+ *  its own chunk.
+ *
+ *  Shard matrices have distribution @c dist and size
+ *  @f$ \text{height} \times 1 @f$, so that every process holds the
+ *  largest chunk size in local entries. The first @c counts[rank]
+ *  local entries hold the process's chunk and the rest are
+ *  padding. The global layout of a shard matrix has no meaning beyond
+ *  that, but global reductions (e.g. dot products) over shard
+ *  matrices are equivalent to reductions over the full matrices.
+ */
+struct gradient_shard_layout {
+  /** @brief Processes that share the weights entries. */
+  const El::mpi::Comm* comm = nullptr;
+  /** @brief Index of this process's chunk. */
+  int rank = 0;
+  /** @brief Number of entries in each process's chunk. */
+  std::vector<int> counts;
+  /** @brief Offset of each process's chunk. */
+  std::vector<int> offsets;
+  /** @brief Distribution of shard matrices. */
+  El::DistData dist;
+  /** @brief Global height of shard matrices. */
+  El::Int height = 0;
+};
+
+/** @brief Construct layout for sharding the optimizer state of a
+ *  weights matrix.
+ *
+ *  Only data-parallel weights, i.e. @c STAR,STAR matrices with
+ *  contiguous local data on a grid with more than one process, are
+ *  supported.
+ *
+ *  @returns Shard layout, or a null pointer if the matrix cannot be
+ *  sharded.
+ */
+template <typename TensorDataType>
+std::shared_ptr<const gradient_shard_layout>
+make_gradient_shard_layout(const El::AbstractDistMatrix<TensorDataType>& values);
+
+/** @brief Copy this process's chunk of a full local matrix into a
+ *  shard's local matrix. */
+template <typename TensorDataType>
+void copy_to_shard(const El::AbstractMatrix<TensorDataType>& full,
+                   El::AbstractMatrix<TensorDataType>& shard,
+                   const gradient_shard_layout& layout);
+
+/** @brief Allgather the chunks in shards' local matrices into a full
+ *  local matrix. */
+template <typename TensorDataType>
+void gather_from_shard(const El::AbstractMatrix<TensorDataType>& shard,
+                       El::AbstractMatrix<TensorDataType>& full,
+                       const gradient_shard_layout& layout);
+
+} // namespace lbann
+
+#endif // LBANN_OPTIMIZERS_GRADIENT_SHARDING_HPP_INCLUDED
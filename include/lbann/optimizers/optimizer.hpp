@@ -37,6 +37,9 @@
 #include "lbann/utils/description.hpp"
 #include "lbann/utils/exception.hpp"
 #include "lbann/utils/memory.hpp"
+#include "lbann/optimizers/gradient_bucketing.hpp"
+#include "lbann/optimizers/gradient_compression.hpp"
+#include "lbann/optimizers/gradient_sharding.hpp"
 #include "lbann/weights/weights.hpp"
 
 #include <memory>
@@ -155,6 +158,19 @@ public:
    */
   void remove_gradient_source(const void* source);
 
+  /** @brief Hold back gradient allreduces.
+   *
+   *  While deferred, unregistering the last gradient source does not
+   *  launch the allreduce, so contributions from several backward
+   *  passes (e.g. micro-batches) are accumulated locally and reduced
+   *  once. When no longer deferred, the allreduce is launched if
+   *  there are no gradient sources remaining.
+   */
+  void set_gradient_allreduce_deferred(bool defer);
+  bool is_gradient_allreduce_deferred() const noexcept {
+    return m_defer_gradient_allreduce;
+  }
+
   /** @brief Perform optimization step. */
   virtual void step() = 0;
 
@@ -187,6 +203,29 @@ public:
     TensorDataType& in_scale,
     bool allreduce_needed = false);
 
+  /** @brief Fuse gradient allreduces into buckets.
+   *
+   *  The bucket manager is shared with other optimizers in the model
+   *  and must outlive any in-progress allreduce. A null pointer
+   *  disables bucketing.
+   */
+  void set_gradient_bucket_manager(gradient_bucket_manager* buckets) {
+    m_gradient_buckets = buckets;
+  }
+
+  /** @brief Compress gradients before summing them over their
+   *  redundant communicator.
+   *
+   *  Compressed allreduces are blocking and are not fused into
+   *  buckets. Must be set before training.
+   */
+  void set_gradient_compression(const gradient_compression_config& config) {
+    m_gradient_compression = config;
+  }
+  const gradient_compression_config& get_gradient_compression() const noexcept {
+    return m_gradient_compression;
+  }
+
   ///@}
   /** @brief Communicator access */
   ///@{
@@ -207,6 +246,10 @@ public:
   /** @brief Reset stats counters. */
   virtual void reset_counters() { m_step_time = 0; }
 
+  /** @brief Communication volume of compressed gradient allreduces. */
+  gradient_compression_statistics get_gradient_compression_statistics() const;
+  void reset_gradient_compression_statistics();
+
   ///@}
   /** @name Checkpointing */
   ///@{
@@ -225,9 +268,34 @@ protected:
     void set_status(optimizer_gradient_status s) noexcept { status_ = s; }
     virtual El::BaseDistMatrix& gradient() noexcept = 0;
     virtual El::BaseDistMatrix const& gradient() const noexcept = 0;
-    virtual void start_allreduce(lbann_comm&) = 0;
+    /** @param buckets Fuse the allreduce with other gradients, if
+     *  not null.
+     *  @param shards  If not null, reduce-scatter the gradient
+     *                 instead of allreducing it.
+     *  @param compression Compress the gradient and perform a
+     *                 blocking allreduce, if enabled. Takes
+     *                 precedence over the other options.
+     */
+    virtual void start_allreduce(lbann_comm&,
+                                 gradient_bucket_manager* buckets,
+                                 const gradient_shard_layout* shards,
+                                 const gradient_compression_config& compression) = 0;
     virtual void complete_allreduce(lbann_comm&) = 0;
+    /** @brief This process's chunk of the gradient.
+     *  @details Null unless the allreduce was started with a shard
+     *  layout.
+     */
+    virtual El::BaseDistMatrix const* shard() const noexcept = 0;
+    /** @brief Make sure the full gradient is reduced.
+     *
+     *  A reduce-scattered gradient only has valid values in the
+     *  shard, so they are allgathered into the full gradient.
+     */
+    virtual void unshard(lbann_comm&) = 0;
     virtual void clear() = 0;
+    virtual gradient_compression_statistics
+    compression_statistics() const noexcept = 0;
+    virtual void reset_compression_statistics() = 0;
   private:
     optimizer_gradient_status status_ = optimizer_gradient_status::cleared;
   };// class GradientHelper
@@ -246,15 +314,55 @@ protected:
     AbsDistMatType const& gradient() const noexcept override {
       return *gradient_;
     }
-    void start_allreduce(lbann_comm& comm) override {
+    void start_allreduce(lbann_comm& comm,
+                         gradient_bucket_manager* buckets,
+                         const gradient_shard_layout* shards,
+                         const gradient_compression_config& compression) override {
       switch (this->get_status()) {
       case optimizer_gradient_status::allreduce_needed:
-        comm.nb_allreduce(*gradient_,
-                          gradient_->RedundantComm(),
-                          allreduce_req_);
+        if (compression.type != gradient_compression_type::NONE) {
+          if (compressor_ == nullptr) {
+            compressor_ = make_gradient_compressor<TensorDataType>(compression);
+          }
+          compressor_->allreduce(*gradient_, comm);
+          this->set_status(optimizer_gradient_status::ready);
+          if (shards != nullptr) {
+            setup_shard(*shards);
+            copy_to_shard(gradient_->LockedMatrix(), shard_->Matrix(), *shards);
+          }
+          break;
+        }
+        if (shards != nullptr) {
+          setup_shard(*shards);
+          comm.nb_reduce_scatter(gradient_->LockedMatrix(),
+                                 shard_->Matrix(),
+                                 shards->counts,
+                                 *shards->comm,
+                                 allreduce_req_);
+          full_stale_ = true;
+          this->set_status(optimizer_gradient_status::allreduce_started);
+          break;
+        }
+        if (buckets != nullptr) {
+          bucket_ = buckets->add(*gradient_);
+        }
+        if (bucket_ != nullptr) {
+          bucket_manager_ = buckets;
+        }
+        else {
+          comm.nb_allreduce(*gradient_,
+                            gradient_->RedundantComm(),
+                            allreduce_req_);
+        }
         this->set_status(optimizer_gradient_status::allreduce_started);
         break;
       case optimizer_gradient_status::ready:
+        // Gradient is already reduced, so just take local chunk
+        if (shards != nullptr && shard_layout_ == nullptr) {
+          setup_shard(*shards);
+          copy_to_shard(gradient_->LockedMatrix(), shard_->Matrix(), *shards);
+        }
+        break;
       case optimizer_gradient_status::cleared:
       case optimizer_gradient_status::allreduce_started:
         break;
@@ -265,7 +373,14 @@ protected:
     void complete_allreduce(lbann_comm& comm) override {
       switch (this->get_status()) {
       case optimizer_gradient_status::allreduce_started:
-        comm.wait(allreduce_req_);
+        if (bucket_ != nullptr) {
+          bucket_manager_->wait(*bucket_);
+          bucket_.reset();
+          bucket_manager_ = nullptr;
+        }
+        else {
+          comm.wait(allreduce_req_);
+        }
         this->set_status(optimizer_gradient_status::ready);
         break;
       case optimizer_gradient_status::ready:
@@ -280,12 +395,57 @@ protected:
                     "(" + to_string(this->get_status()) + ")");
       }
     }
+    El::BaseDistMatrix const* shard() const noexcept override {
+      return shard_layout_ != nullptr ? shard_.get() : nullptr;
+    }
+    void unshard(lbann_comm&) override {
+      if (shard_layout_ != nullptr && full_stale_) {
+        gather_from_shard(shard_->LockedMatrix(),
+                          gradient_->Matrix(),
+                          *shard_layout_);
+      }
+      shard_layout_ = nullptr;
+      full_stale_ = false;
+    }
     void clear() override {
       this->set_status(optimizer_gradient_status::cleared);
+      shard_layout_ = nullptr;
+      full_stale_ = false;
+    }
+    gradient_compression_statistics
+    compression_statistics() const noexcept override {
+      return (compressor_ != nullptr
+              ? compressor_->get_statistics()
+              : gradient_compression_statistics());
+    }
+    void reset_compression_statistics() override {
+      if (compressor_ != nullptr) {
+        compressor_->reset_statistics();
+      }
     }
   private:
+    /** @brief Prepare shard buffer for this process's chunk. */
+    void setup_shard(const gradient_shard_layout& layout) {
+      if (shard_ == nullptr || shard_->Height() != layout.height) {
+        shard_.reset(AbsDistMatType::Instantiate(layout.dist));
+        El::Zeros(*shard_, layout.height, 1);
+      }
+      shard_layout_ = &layout;
+    }
     std::unique_ptr<AbsDistMatType> gradient_;
     Al::request allreduce_req_;
+    /** @brief Reduced chunk of gradient owned by this process. */
+    std::unique_ptr<AbsDistMatType> shard_;
+    /** @brief Layout of shard, if it holds valid values. */
+    const gradient_shard_layout* shard_layout_ = nullptr;
+    /** @brief Whether the full gradient is not reduced. */
+    bool full_stale_ = false;
+    /** @brief Bucket with in-progress allreduce, if any. */
+    std::shared_ptr<gradient_bucket> bucket_;
+    gradient_bucket_manager* bucket_manager_ = nullptr;
+    /** @brief Created when the first compressed allreduce is
+     *  performed. Holds error feedback for this gradient. */
+    std::unique_ptr<gradient_compressor<TensorDataType>> compressor_;
   };// class GradientHelperImpl
 
   /** @brief Copy construct/copy assign */
@@ -321,7 +481,10 @@ protected:
    */
   void start_gradient_allreduce() {
     for (auto& grad_mgr : gradients_) {
-      grad_mgr.second->start_allreduce(*m_comm);
+      grad_mgr.second->start_allreduce(*m_comm,
+                                       m_gradient_buckets,
+                                       m_shard_layout.get(),
+                                       m_gradient_compression);
     }
   }
 
@@ -335,6 +498,33 @@ protected:
       grad_mgr.second->complete_allreduce(*m_comm);
     }
   }
+
+  /** @brief Make sure full gradients are reduced if they have been
+   *  reduce-scattered. */
+  void unshard_gradients() {
+    for (auto& grad_mgr : gradients_) {
+      grad_mgr.second->unshard(*m_comm);
+    }
+  }
+
+  /** @brief Sum this process's chunks of all gradient contributions.
+   *
+   *  Gradient allreduces must have been started with a shard layout
+   *  and completed.
+   */
+  template <typename TensorDataType>
+  void accumulate_all_gradient_shards(
+    El::AbstractDistMatrix<TensorDataType>& shard);
+
+  /** @brief Reduce-scatter gradients with this layout instead of
+   *  allreducing them. A null pointer disables sharding. */
+  void set_gradient_shard_layout(
+    std::shared_ptr<const gradient_shard_layout> layout) {
+    m_shard_layout = std::move(layout);
+  }
+  const gradient_shard_layout* get_gradient_shard_layout() const noexcept {
+    return m_shard_layout.get();
+  }
 private:
 
   /** @brief LBANN communicator. */
@@ -355,6 +545,23 @@ private:
   /** @brief Status of values in objective function gradient. */
   optimizer_gradient_status m_gradient_status = optimizer_gradient_status::cleared;
 
+  /** @brief Whether gradient allreduces are held back.
+   *  @details Not copied. */
+  bool m_defer_gradient_allreduce = false;
+
+  /** @brief Fuses gradient allreduces across optimizers, if set.
+   *
+   *  Not owned. Not copied, since it belongs to a model.
+   */
+  gradient_bucket_manager* m_gradient_buckets = nullptr;
+
+  /** @brief Partition of gradient entries for sharded optimizer
+   *  state, if set. */
+  std::shared_ptr<const gradient_shard_layout> m_shard_layout;
+
+  /** @brief Lossy compression for gradient allreduces. */
+  gradient_compression_config m_gradient_compression;
+
   /** @brief Time spent in optimization step. */
   EvalType m_step_time = 0;
 
@@ -393,6 +600,7 @@ El::AbstractDistMatrix<TensorDataType>& optimizer::get_gradient_buffer(
   if (grad_mgr.get_status() == optimizer_gradient_status::allreduce_started) {
     grad_mgr.complete_allreduce(*(this->m_comm));
   }
+  grad_mgr.unshard(*(this->m_comm));
   auto& buffer = grad_mgr.gradient();
 
   // Determine scaling factor and transition state.
@@ -505,6 +713,42 @@ void optimizer::accumulate_all_gradient_contributions(
   }
 }
 
+template <typename TensorDataType>
+void optimizer::accumulate_all_gradient_shards(
+  El::AbstractDistMatrix<TensorDataType>& shard)
+{
+  using AbsDistMatType = El::AbstractDistMatrix<TensorDataType>;
+  static const TensorDataType one = TensorDataType(1.f);
+  auto const this_type_idx = std::type_index(typeid(TensorDataType));
+
+  El::Zero(shard);
+  std::unique_ptr<AbsDistMatType> tmp;
+  for (auto const& grad_mgr_v : this->gradients_) {
+    auto const& grad_mgr = *(grad_mgr_v.second);
+    if (grad_mgr.get_status() == optimizer_gradient_status::cleared) {
+      continue;
+    }
+    if (grad_mgr.get_status() != optimizer_gradient_status::ready) {
+      LBANN_ERROR("Expected ready status. Got: ",
+                  to_string(grad_mgr.get_status()));
+    }
+    auto const* contrib = grad_mgr.shard();
+    if (contrib == nullptr) {
+      LBANN_ERROR("Expected gradient contribution to be sharded");
+    }
+    if (grad_mgr_v.first == this_type_idx) {
+      El::Axpy(one, dynamic_cast<AbsDistMatType const&>(*contrib), shard);
+    }
+    else {
+      if (tmp == nullptr) {
+        tmp.reset(shard.Construct(shard.Grid(), shard.Root()));
+      }
+      El::Copy(*contrib, *tmp);
+      El::Axpy(one, *tmp, shard);
+    }
+  }
+}
+
 } // namespace lbann
 
 #endif // LBANN_OPTIMIZERS_OPTIMIZER_HPP_INCLUDED
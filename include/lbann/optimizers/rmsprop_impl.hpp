@@ -28,6 +28,7 @@
 #define LBANN_OPTIMIZERS_RMSPROP_IMPL_HPP_INCLUDED
 
 #include "lbann/optimizers/rmsprop.hpp"
+#include "lbann/optimizers/data_type_optimizer_impl.hpp"
 #include "lbann/utils/serialize.hpp"
 
 namespace lbann {
@@ -39,8 +40,8 @@ rmsprop<TensorDataType>
 ::serialize(Archive & ar) {
   ar(cereal::base_class<data_type_optimizer<TensorDataType>>(this),
      CEREAL_NVP(m_decay_rate),
-     CEREAL_NVP(m_eps),
-     CEREAL_NVP(m_cache));
+     CEREAL_NVP(m_eps));
+  this->serialize_state(ar, "m_cache", m_cache);
 }
 
 } // namespace lbann
@@ -28,6 +28,7 @@
 #define LBANN_OPTIMIZERS_SGD_IMPL_HPP_INCLUDED
 
 #include "lbann/optimizers/sgd.hpp"
+#include "lbann/optimizers/data_type_optimizer_impl.hpp"
 #include "lbann/utils/serialize.hpp"
 
 namespace lbann {
@@ -40,8 +41,8 @@ sgd<TensorDataType>
 {
   ar(::cereal::base_class<data_type_optimizer<TensorDataType>>(this),
      CEREAL_NVP(m_momentum),
-     CEREAL_NVP(m_nesterov),
-     CEREAL_NVP(m_velocity));
+     CEREAL_NVP(m_nesterov));
+  this->serialize_state(ar, "m_velocity", m_velocity);
 }
 
 } // namespace lbann
@@ -0,0 +1,126 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2022, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef LBANN_UTILS_ALIAS_TABLE_HPP_INCLUDED
+#define LBANN_UTILS_ALIAS_TABLE_HPP_INCLUDED
+
+#include "lbann/utils/exception.hpp"
+
+#include <cstddef>
+#include <vector>
+
+namespace lbann {
+
+/** @brief Walker's alias method for sampling a discrete distribution.
+ *
+ *  Construction takes @f$ O(n) @f$ time (Vose's algorithm) and each
+ *  sample takes @f$ O(1) @f$ time, independent of the shape of the
+ *  distribution. Sampling is const and may be performed concurrently
+ *  from multiple threads.
+ *
+ *  See:
+ *
+ *  Michael D. Vose. "A linear algorithm for generating random numbers
+ *  with a given distribution." IEEE Transactions on Software
+ *  Engineering 17, no. 9 (1991): 972-975.
+ */
+class alias_table
+{
+public:
+  alias_table() = default;
+
+  /** @brief Construct from unnormalized, non-negative weights. */
+  explicit alias_table(const std::vector<double>& weights)
+  {
+    const size_t n = weights.size();
+    if (n == 0) {
+      LBANN_ERROR("alias table requires at least one weight");
+    }
+    double sum = 0.;
+    for (const auto& w : weights) {
+      if (!(w >= 0.)) {
+        LBANN_ERROR("alias table weights must be non-negative");
+      }
+      sum += w;
+    }
+    if (!(sum > 0.)) {
+      LBANN_ERROR("alias table weights must not all be zero");
+    }
+
+    // Split scaled probabilities into under- and over-full bins
+    m_prob.resize(n);
+    m_alias.resize(n);
+    std::vector<size_t> small, large;
+    small.reserve(n);
+    large.reserve(n);
+    for (size_t i = 0; i < n; ++i) {
+      m_prob[i] = weights[i] * n / sum;
+      m_alias[i] = i;
+      (m_prob[i] < 1. ? small : large).push_back(i);
+    }
+
+    // Top up each under-full bin with mass from an over-full bin
+    while (!small.empty() && !large.empty()) {
+      const auto s = small.back();
+      const auto l = large.back();
+      small.pop_back();
+      m_alias[s] = l;
+      m_prob[l] -= 1. - m_prob[s];
+      if (m_prob[l] < 1.) {
+        large.pop_back();
+        small.push_back(l);
+      }
+    }
+
+    // Remaining bins are full up to round-off
+    for (const auto& i : small) { m_prob[i] = 1.; }
+    for (const auto& i : large) { m_prob[i] = 1.; }
+  }
+
+  /** @brief Number of outcomes. */
+  size_t size() const noexcept { return m_prob.size(); }
+
+  /** @brief Map a uniform random value in [0,1) to an outcome. */
+  size_t sample(double u) const noexcept
+  {
+    const double x = u * m_prob.size();
+    auto i = static_cast<size_t>(x);
+    if (i >= m_prob.size()) {
+      i = m_prob.size() - 1;
+    }
+    return (x - i < m_prob[i]) ? i : m_alias[i];
+  }
+
+private:
+  /** @brief Probability of keeping each bin's own outcome. */
+  std::vector<double> m_prob;
+  /** @brief Outcome used for the rest of each bin. */
+  std::vector<size_t> m_alias;
+};
+
+} // namespace lbann
+
+#endif // LBANN_UTILS_ALIAS_TABLE_HPP_INCLUDED
@@ -0,0 +1,145 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2022, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef LBANN_UTILS_COUNTER_RNG_HPP_INCLUDED
+#define LBANN_UTILS_COUNTER_RNG_HPP_INCLUDED
+
+#include <array>
+#include <cmath>
+#include <cstdint>
+
+namespace lbann {
+
+/** @brief Philox4x32-10 counter-based random number generator.
+ *
+ *  A bijection of a 128-bit counter, keyed by a 64-bit key. Outputs
+ *  for different counters are statistically independent, so random
+ *  values can be generated in any order and in parallel.
+ *
+ *  See:
+ *
+ *  John K. Salmon, Mark A. Moraes, Ron O. Dror, and David E. Shaw.
+ *  "Parallel random numbers: as easy as 1, 2, 3." SC'11 (2011).
+ */
+class philox4x32
+{
+public:
+  using counter_type = std::array<uint32_t, 4>;
+  using key_type = std::array<uint32_t, 2>;
+
+  static constexpr int num_rounds = 10;
+
+  static counter_type generate(counter_type ctr, key_type key) noexcept
+  {
+    for (int r = 0; r < num_rounds; ++r) {
+      if (r > 0) {
+        key[0] += weyl_0;
+        key[1] += weyl_1;
+      }
+      const uint64_t p0 = uint64_t(mult_0) * ctr[0];
+      const uint64_t p1 = uint64_t(mult_1) * ctr[2];
+      ctr = {uint32_t(p1 >> 32) ^ ctr[1] ^ key[0],
+             uint32_t(p1),
+             uint32_t(p0 >> 32) ^ ctr[3] ^ key[1],
+             uint32_t(p0)};
+    }
+    return ctr;
+  }
+
+private:
+  static constexpr uint32_t mult_0 = 0xD2511F53;
+  static constexpr uint32_t mult_1 = 0xCD9E8D57;
+  static constexpr uint32_t weyl_0 = 0x9E3779B9;
+  static constexpr uint32_t weyl_1 = 0xBB67AE85;
+};
+
+/** @brief Random values indexed by (seed, stream, element index).
+ *
+ *  Each element index maps to one Philox block, so the value for an
+ *  entry depends only on the seed, the stream (e.g. which tensor is
+ *  being filled), and the entry's global index. Fills are therefore
+ *  bit-reproducible regardless of how the entries are distributed
+ *  over threads and processes.
+ */
+class counter_rng
+{
+public:
+  counter_rng(uint64_t seed, uint64_t stream) noexcept
+    : m_key{uint32_t(seed), uint32_t(seed >> 32)}, m_stream(stream)
+  {}
+
+  /** @brief Four random 32-bit words for an element index. */
+  philox4x32::counter_type block(uint64_t index) const noexcept
+  {
+    return philox4x32::generate({uint32_t(index),
+                                 uint32_t(index >> 32),
+                                 uint32_t(m_stream),
+                                 uint32_t(m_stream >> 32)},
+                                m_key);
+  }
+
+  /** @brief Uniform random value in [0,1). */
+  template <typename T>
+  T uniform(uint64_t index) const noexcept
+  {
+    const auto r = block(index);
+    return T(to_unit_double(r[0], r[1]));
+  }
+
+  /** @brief Standard normal random value (Box-Muller transform). */
+  template <typename T>
+  T normal(uint64_t index) const noexcept
+  {
+    constexpr double two_pi = 6.283185307179586476925286766559;
+    const auto r = block(index);
+    const double u1 = 1.0 - to_unit_double(r[0], r[1]); // In (0,1]
+    const double u2 = to_unit_double(r[2], r[3]);
+    return T(std::sqrt(-2.0 * std::log(u1)) * std::cos(two_pi * u2));
+  }
+
+  /** @brief Bernoulli random value with probability @c p of true. */
+  bool bernoulli(uint64_t index, double p) const noexcept
+  {
+    return uniform<double>(index) < p;
+  }
+
+  uint64_t get_stream() const noexcept { return m_stream; }
+
+private:
+  /** @brief Convert 53 random bits to a double in [0,1). */
+  static double to_unit_double(uint32_t hi, uint32_t lo) noexcept
+  {
+    const uint64_t r = (uint64_t(hi) << 32) | uint64_t(lo);
+    return (r >> 11) * (1.0 / 9007199254740992.0);
+  }
+
+  philox4x32::key_type m_key;
+  uint64_t m_stream;
+};
+
+} // namespace lbann
+
+#endif // LBANN_UTILS_COUNTER_RNG_HPP_INCLUDED
@@ -33,6 +33,16 @@
 
 #include <fftw3.h>
 
+#include <algorithm>
+#include <cstdio>
+#include <map>
+#include <mutex>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <unistd.h>
+#include <vector>
+
 namespace lbann
 {
 
@@ -131,6 +141,167 @@ BUILD_FFTW_R2C_TRAITS(double, fftw);
 BUILD_FFTW_C2C_TRAITS(float, fftwf);
 BUILD_FFTW_C2C_TRAITS(double, fftw);
 
+/** @brief Precision-specific FFTW planner functions. */
+template <typename RealT>
+struct FFTWPlannerTraits;
+
+#ifdef LBANN_HAS_FFTW_THREADS
+#define BUILD_FFTW_PLANNER_THREADS_TRAITS(FFTW_PREFIX)                  \
+    static constexpr bool has_threads = true;                           \
+    static int init_threads() { return FFTW_PREFIX ## _init_threads(); } \
+    static void plan_with_nthreads(int n) {                             \
+      FFTW_PREFIX ## _plan_with_nthreads(n);                            \
+    }
+#else
+#define BUILD_FFTW_PLANNER_THREADS_TRAITS(FFTW_PREFIX)                  \
+    static constexpr bool has_threads = false;                          \
+    static int init_threads() { return 0; }                             \
+    static void plan_with_nthreads(int) {}
+#endif // LBANN_HAS_FFTW_THREADS
+
+#define BUILD_FFTW_PLANNER_TRAITS(REALTYPE, FFTW_PREFIX)                \
+  template <>                                                           \
+  struct FFTWPlannerTraits<REALTYPE>                                    \
+  {                                                                     \
+    using plan_type = FFTW_PREFIX ## _plan;                             \
+    static constexpr auto destroy_plan = &FFTW_PREFIX ## _destroy_plan; \
+    static constexpr auto alignment_of = &FFTW_PREFIX ## _alignment_of; \
+    static constexpr auto import_wisdom_from_filename =                 \
+      &FFTW_PREFIX ## _import_wisdom_from_filename;                     \
+    static constexpr auto export_wisdom_to_filename =                   \
+      &FFTW_PREFIX ## _export_wisdom_to_filename;                       \
+    BUILD_FFTW_PLANNER_THREADS_TRAITS(FFTW_PREFIX)                      \
+  }
+
+BUILD_FFTW_PLANNER_TRAITS(float, fftwf);
+BUILD_FFTW_PLANNER_TRAITS(double, fftw);
+
+/** @brief Process-wide cache of FFTW plans for one precision.
+ *
+ *  Plans are built once and shared by every FFTWWrapper in the
+ *  process, so they survive changes in the mini-batch size and are
+ *  not rebuilt when layers are copied. A plan is keyed on everything
+ *  that it depends on: the transform kind, the transform shape, the
+ *  number of samples, the leading dimensions, whether the transform
+ *  is in-place, and the alignments of the buffers (FFTW may only
+ *  execute a plan on arrays with the same alignment as the arrays
+ *  used for planning).
+ *
+ *  Plans use all OpenMP threads if FFTW was built with threading
+ *  support. If a wisdom file is set, it is imported once and is
+ *  updated whenever a new plan is created, so that later runs can
+ *  skip measuring.
+ *
+ *  The FFTW planner is not thread-safe, so planning is serialized.
+ *  Executing a plan is thread-safe.
+ */
+template <typename RealT>
+class PlanCache
+{
+public:
+  using TraitsType = FFTWPlannerTraits<RealT>;
+  using PlanType = typename TraitsType::plan_type;
+
+  /** @brief Transform kind, shape, number of samples, input and
+   *  output leading dimensions, in-place, input and output alignment.
+   */
+  using KeyType = std::tuple<int, std::vector<int>, int,
+                             El::Int, El::Int, bool, int, int>;
+
+  static PlanCache& instance()
+  {
+    static PlanCache cache;
+    return cache;
+  }
+
+  ~PlanCache()
+  {
+    for (auto& kv : plans_)
+      TraitsType::destroy_plan(kv.second);
+  }
+  PlanCache(PlanCache const&) = delete;
+  PlanCache& operator=(PlanCache const&) = delete;
+
+  /** @brief Get a plan, or create it with @c make_plan if it does
+   *  not exist.
+   */
+  template <typename MakePlanFunctorT>
+  PlanType get_or_create(KeyType const& key, MakePlanFunctorT make_plan)
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto const iter = plans_.find(key);
+    if (iter != plans_.end())
+      return iter->second;
+
+    TraitsType::plan_with_nthreads(num_threads_);
+    PlanType plan = make_plan();
+    if (plan == nullptr)
+      return nullptr;
+    plans_.emplace(key, plan);
+    if (!wisdom_file_.empty())
+      export_wisdom();
+    return plan;
+  }
+
+  /** @brief Get a plan, or @c nullptr if it does not exist. */
+  PlanType get(KeyType const& key) const
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto const iter = plans_.find(key);
+    return (iter == plans_.end() ? nullptr : iter->second);
+  }
+
+  /** @brief Import and persist FFTW wisdom with this file.
+   *
+   *  A missing file is not an error; it is created when the next
+   *  plan is built. Calling this again with the same file has no
+   *  effect.
+   */
+  void set_wisdom_file(std::string const& filename)
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (filename.empty() || filename == wisdom_file_)
+      return;
+    wisdom_file_ = filename;
+    TraitsType::import_wisdom_from_filename(wisdom_file_.c_str());
+  }
+
+  /** @brief Number of threads used by new plans. */
+  int get_num_threads() const noexcept { return num_threads_; }
+
+  /** @brief Number of cached plans. */
+  size_t size() const
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return plans_.size();
+  }
+
+private:
+  PlanCache()
+  {
+    if (TraitsType::has_threads && TraitsType::init_threads() != 0)
+      num_threads_ = std::max(omp_get_max_threads(), 1);
+  }
+
+  /** @brief Write wisdom to a temporary file and rename it, so
+   *  processes sharing the file never see a partial write.
+   */
+  void export_wisdom() const
+  {
+    auto const tmp_file =
+      build_string(wisdom_file_, ".", getpid(), ".tmp");
+    if (TraitsType::export_wisdom_to_filename(tmp_file.c_str()))
+      std::rename(tmp_file.c_str(), wisdom_file_.c_str());
+    else
+      std::remove(tmp_file.c_str());
+  }
+
+  mutable std::mutex mutex_;
+  std::map<KeyType, PlanType> plans_;
+  std::string wisdom_file_;
+  int num_threads_ = 1;
+};// class PlanCache
+
 /** @brief Wrapper around FFTW
  *
  *  The main constraint is that the sample data to which the DFT will
@@ -139,6 +310,9 @@ BUILD_FFTW_C2C_TRAITS(double, fftw);
  *  DFT of each feature map in a batch of N samples with C feature
  *  maps of size HxW per sample, the input matrix must have width N
  *  and each column must be CHW-packed, in the cuDNN sense.
+ *
+ *  All samples are transformed with a single batched plan. Plans are
+ *  stored in the process-wide PlanCache.
  */
 template <typename InputTypeT>
 class FFTWWrapper
@@ -158,32 +332,7 @@ public:
   using OutputMatType = El::Matrix<OutputType, El::Device::CPU>;
 
   using PlanType = typename TraitsType::plan_type;
-
-private:
-  struct InternalPlanType
-  {
-    PlanType plan_ = nullptr;
-    int num_samples_ = -1; // It's just an int in fftw
-    InternalPlanType(PlanType plan, int n)
-      : plan_{plan},
-        num_samples_{n}
-    {}
-    ~InternalPlanType()
-    {
-      if (plan_ != nullptr)
-      {
-        TraitsType::destroy_plan(plan_);
-        plan_ = nullptr;
-      }
-    }
-    InternalPlanType(InternalPlanType&& other) noexcept
-      : plan_{other.plan_},
-        num_samples_{other.num_samples_}
-    {
-      other.plan_ = nullptr;
-      other.num_samples_ = -1;
-    }
-  };// struct InternalPlanType
+  using PlanCacheType = PlanCache<RealType>;
 
 public:
   FFTWWrapper() = default;
@@ -202,7 +351,8 @@ public:
                      OutputMatType& out,
                      std::vector<int> const& full_dims)
   {
-    setup_common(in, out, full_dims, fwd_plans_,
+    fwd_dims_ = full_dims;
+    setup_common(in, out, /*backward=*/false,
                  TraitsType::plan_many_fwd,
                  TraitsType::plan_guru_fwd);
   }
@@ -230,7 +380,8 @@ public:
                       InputMatType& out,
                       std::vector<int> const& full_dims)
   {
-    setup_common(in, out, full_dims, bwd_plans_,
+    bwd_dims_ = full_dims;
+    setup_common(in, out, /*backward=*/true,
                  TraitsType::plan_many_bwd,
                  TraitsType::plan_guru_bwd);
   }
@@ -249,19 +400,10 @@ public:
 
   void compute_forward(InputMatType& in, OutputMatType& out) const
   {
-    auto const num_samples = in.Width();
-    auto const good_plan =
-      std::find_if(cbegin(fwd_plans_), cend(fwd_plans_),
-                   [num_samples](InternalPlanType const& a) {
-                     return a.num_samples_ == num_samples;
-                   });
-    if (good_plan == cend(fwd_plans_))
-      LBANN_ERROR("No valid FFTW plan found.");
-
     // Initial tests suggest there's no performance reason to *not*
     // use the "new-array" interface.
     TraitsType::execute_plan_fwd(
-      good_plan->plan_,
+      get_plan(in, out, /*backward=*/false),
       AsFFTWType(in.Buffer()),
       AsFFTWType(out.Buffer()));
   }
@@ -273,19 +415,10 @@ public:
 
   void compute_backward(OutputMatType& in, InputMatType& out) const
   {
-    auto const num_samples = in.Width();
-    auto const good_plan =
-      std::find_if(cbegin(bwd_plans_), cend(bwd_plans_),
-                   [num_samples](InternalPlanType const& a) {
-                     return a.num_samples_ == num_samples;
-                   });
-    if (good_plan == cend(bwd_plans_))
-      LBANN_ERROR("No valid FFTW plan found.");
-
     // Initial tests suggest there's no performance reason to *not*
     // use the "new-array" interface.
     TraitsType::execute_plan_bwd(
-      good_plan->plan_,
+      get_plan(in, out, /*backward=*/true),
       AsFFTWType(in.Buffer()),
       AsFFTWType(out.Buffer()));
   }
@@ -297,12 +430,41 @@ public:
 
 private:
 
+  template <typename InMatT, typename OutMatT>
+  typename PlanCacheType::KeyType make_key(InMatT& in,
+                                           OutMatT& out,
+                                           bool backward) const
+  {
+    constexpr int complex_input =
+      std::is_same<InputType, ComplexType>::value ? 2 : 0;
+    auto const in_buf = reinterpret_cast<RealType*>(in.Buffer());
+    auto const out_buf = reinterpret_cast<RealType*>(out.Buffer());
+    return typename PlanCacheType::KeyType{
+      complex_input + (backward ? 1 : 0),
+      backward ? bwd_dims_ : fwd_dims_,
+      static_cast<int>(in.Width()),
+      (in.Contiguous() && out.Contiguous()) ? El::Int(-1) : in.LDim(),
+      (in.Contiguous() && out.Contiguous()) ? El::Int(-1) : out.LDim(),
+      static_cast<void*>(in_buf) == static_cast<void*>(out_buf),
+      PlanCacheType::TraitsType::alignment_of(in_buf),
+      PlanCacheType::TraitsType::alignment_of(out_buf)};
+  }
+
+  template <typename InMatT, typename OutMatT>
+  PlanType get_plan(InMatT& in, OutMatT& out, bool backward) const
+  {
+    auto const plan =
+      PlanCacheType::instance().get(make_key(in, out, backward));
+    if (plan == nullptr)
+      LBANN_ERROR("No valid FFTW plan found.");
+    return plan;
+  }
+
   template <typename InMatT, typename OutMatT,
             typename SetupManyFunctorT, typename SetupGuruFunctorT>
   void setup_common(InMatT& in,
                     OutMatT& out,
-                    std::vector<int> const& full_dims,
-                    std::vector<InternalPlanType>& plans,
+                    bool backward,
                     SetupManyFunctorT many_functor,
                     SetupGuruFunctorT guru_functor)
   {
@@ -310,25 +472,18 @@ private:
     using out_data_type = typename OutMatT::value_type;
     using Dims = fft::DimsHelper<in_data_type, out_data_type>;
 
-    // Look for an acceptable plan
+    auto const& full_dims = (backward ? bwd_dims_ : fwd_dims_);
     int const num_samples = in.Width();
-    auto const good_plan =
-      std::find_if(cbegin(plans), cend(plans),
-                   [num_samples](InternalPlanType const& a) {
-                     return a.num_samples_ == num_samples;
-                   });
-
-    // We don't have a plan for this yet; let's create one!
-    if (good_plan == cend(plans))
-    {
-      PlanType plan;
+    bool const contiguous_samples =
+      (in.Contiguous()) && (out.Contiguous());
 
+    // Look for an acceptable plan. If we don't have a plan for this
+    // yet, let's create one!
+    auto make_plan = [&]() -> PlanType {
       auto const& input_dims = Dims::input_dims(full_dims);
       auto const& output_dims = Dims::output_dims(full_dims);
       int const num_feature_maps = full_dims.front();
       int const feature_map_ndims = full_dims.size()-1;
-      bool const contiguous_samples =
-        (in.Contiguous()) && (out.Contiguous());
 
       // Handle the easy case
       if (contiguous_samples)
@@ -338,59 +493,57 @@ private:
           = get_linear_size(feature_map_ndims, input_dims.data() + 1);
         int const output_feature_map_size
           = get_linear_size(feature_map_ndims, output_dims.data() + 1);
-        plan = many_functor(
+        return many_functor(
           feature_map_ndims, full_dims.data()+1, num_transforms,
           AsFFTWType(in.Buffer()), nullptr, 1, input_feature_map_size,
           AsFFTWType(out.Buffer()), nullptr, 1, output_feature_map_size,
-          /*flags=*/0);//FFTW_PRESERVE_INPUT);
+          FFTW_MEASURE);
       }
-      else
+
+      using IODimType = typename TraitsType::iodim_type;
+
+      std::vector<IODimType> dims(feature_map_ndims), how_many(2);
+
+      auto input_strides = get_packed_strides(input_dims);
+      auto output_strides = get_packed_strides(output_dims);
+
+      // Setup the "dims"
+      for (int d = 0; d < feature_map_ndims; ++d)
       {
-        using IODimType = typename TraitsType::iodim_type;
-
-        std::vector<IODimType> dims(feature_map_ndims), how_many(2);
-
-        auto input_strides = get_packed_strides(input_dims);
-        auto output_strides = get_packed_strides(output_dims);
-
-        // Setup the "dims"
-        for (int d = 0; d < feature_map_ndims; ++d)
-        {
-          dims[d].n = full_dims[d+1];
-          dims[d].is = input_strides[d+1];
-          dims[d].os = output_strides[d+1];
-        }
-
-        // Setup the "howmany"
-        how_many[0].n = num_feature_maps;
-        how_many[0].is = input_strides.front();
-        how_many[0].os = output_strides.front();
-
-        how_many[1].n = num_samples;
-        how_many[1].is = in.LDim();
-        how_many[1].os = out.LDim();
-
-        plan = guru_functor(
-          dims.size(), dims.data(),
-          how_many.size(), how_many.data(),
-          AsFFTWType(in.Buffer()), AsFFTWType(out.Buffer()),
-          /*flags=*/0);//FFTW_PRESERVE_INPUT);
+        dims[d].n = full_dims[d+1];
+        dims[d].is = input_strides[d+1];
+        dims[d].os = output_strides[d+1];
       }
 
-      if (plan == nullptr)
-        LBANN_ERROR(__PRETTY_FUNCTION__,
-                    ": FFTW plan construction failed.\n"
-                    "  contiguous: ", contiguous_samples);
-
-      plans.emplace_back(plan, num_samples);
-    }
+      // Setup the "howmany"
+      how_many[0].n = num_feature_maps;
+      how_many[0].is = input_strides.front();
+      how_many[0].os = output_strides.front();
+
+      how_many[1].n = num_samples;
+      how_many[1].is = in.LDim();
+      how_many[1].os = out.LDim();
+
+      return guru_functor(
+        dims.size(), dims.data(),
+        how_many.size(), how_many.data(),
+        AsFFTWType(in.Buffer()), AsFFTWType(out.Buffer()),
+        FFTW_MEASURE);
+    };
+
+    auto const plan = PlanCacheType::instance().get_or_create(
+      make_key(in, out, backward), make_plan);
+    if (plan == nullptr)
+      LBANN_ERROR(__PRETTY_FUNCTION__,
+                  ": FFTW plan construction failed.\n"
+                  "  contiguous: ", contiguous_samples);
   }
 
 private:
-  // These are likely to be so few in number that a linear search is
-  // going to be fine.
-  std::vector<InternalPlanType> fwd_plans_;
-  std::vector<InternalPlanType> bwd_plans_;
+  /** @brief Dimensions of the forward transform. */
+  std::vector<int> fwd_dims_;
+  /** @brief Dimensions of the backward transform. */
+  std::vector<int> bwd_dims_;
 
 };// class FFTWWrapper
 
@@ -0,0 +1,236 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2022, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef LBANN_UTILS_NPZ_ARCHIVE_HPP_INCLUDED
+#define LBANN_UTILS_NPZ_ARCHIVE_HPP_INCLUDED
+
+#include <cstddef>
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace lbann {
+
+class npz_archive;
+
+/** @brief Array stored in an NPZ archive.
+ *
+ *  Only the NPY header is parsed when the archive is opened. Array
+ *  data is accessed lazily: uncompressed members are read in place
+ *  from the memory-mapped archive and compressed members are inflated
+ *  on demand (see @c npz_archive ).
+ *
+ *  Arrays are interpreted as a sequence of rows along the first
+ *  dimension, which is the sample dimension for LBANN data
+ *  readers. Fortran-ordered arrays are only supported if they are
+ *  1D.
+ */
+class npz_array {
+public:
+
+  /** @brief Name of array within archive (without ".npy"). */
+  const std::string& name() const noexcept { return m_name; }
+  /** @brief Array dimensions. */
+  const std::vector<size_t>& shape() const noexcept { return m_shape; }
+  /** @brief Size of an array entry in bytes. */
+  size_t word_size() const noexcept { return m_word_size; }
+  /** @brief NumPy type kind (e.g. 'f', 'i', 'u', 'b'). */
+  char type_kind() const noexcept { return m_type_kind; }
+  /** @brief Whether array is stored in column-major order. */
+  bool fortran_order() const noexcept { return m_fortran_order; }
+  /** @brief Number of array entries. */
+  size_t num_vals() const noexcept;
+  /** @brief Number of rows along the first dimension. */
+  size_t num_rows() const noexcept;
+  /** @brief Size of a row in bytes. */
+  size_t row_size() const noexcept;
+  /** @brief Whether array data is deflate-compressed. */
+  bool is_compressed() const noexcept { return m_compressed; }
+
+  /** @brief Pointer to a row in the memory-mapped archive.
+   *
+   *  Returns a null pointer if the array is compressed, in which case
+   *  @c read_rows must be used instead.
+   */
+  const void* row_ptr(size_t row) const;
+
+  /** @brief Copy contiguous rows into a buffer.
+   *
+   *  @c dst must have space for <tt>num_rows * row_size()</tt>
+   *  bytes. Thread-safe.
+   */
+  void read_rows(size_t first_row, size_t num_rows, void* dst) const;
+
+  /** @brief Copy all array data into a buffer. */
+  void read_all(void* dst) const { read_rows(0, num_rows(), dst); }
+
+private:
+  friend class npz_archive;
+
+  npz_array(const npz_archive& archive, std::string name);
+
+  /** @brief Copy bytes from array data region. */
+  void read_bytes(size_t offset, size_t size, void* dst) const;
+
+  const npz_archive* m_archive;
+  std::string m_name;
+  std::vector<size_t> m_shape;
+  size_t m_word_size = 0;
+  char m_type_kind = 0;
+  bool m_fortran_order = false;
+
+  /** @brief Whether member is deflate-compressed. */
+  bool m_compressed = false;
+  /** @brief Offset of member data in archive file. */
+  size_t m_file_offset = 0;
+  /** @brief Size of member data in archive file. */
+  size_t m_compressed_size = 0;
+  /** @brief Size of member data after decompression. */
+  size_t m_uncompressed_size = 0;
+  /** @brief Offset of array data after the NPY header. */
+  size_t m_data_offset = 0;
+  /** @brief Index of member in archive's decompression index. */
+  size_t m_member_index = 0;
+};
+
+/** @brief Read-only access to NumPy NPZ archives.
+ *
+ *  The archive file is memory-mapped and its zip central directory
+ *  is parsed to locate the arrays, so opening an archive does not
+ *  read any array data. Uncompressed (@c np.savez ) members are
+ *  accessed in place. Compressed (@c np.savez_compressed ) members are
+ *  inflated on demand through a cache of fixed-size chunks whose
+ *  total size is bounded. Random access into deflate streams is
+ *  supported by recording inflate access points while decompressing
+ *  (see zran.c in the zlib distribution), so reading a row only
+ *  decompresses from the nearest preceding access point.
+ *
+ *  Zip64 archives are supported, which is required for NPZ files
+ *  larger than 4 GB.
+ */
+class npz_archive {
+public:
+
+  /** @brief Default bound on the size of decompressed data cache. */
+  static constexpr size_t default_cache_size = 256ul * 1024 * 1024;
+
+  /** @brief Open archive.
+   *
+   *  @param filename    Path to NPZ file.
+   *  @param cache_size  Maximum size of decompressed data cache in
+   *                     bytes.
+   */
+  npz_archive(std::string filename,
+              size_t cache_size = default_cache_size);
+  ~npz_archive();
+  npz_archive(const npz_archive&) = delete;
+  npz_archive& operator=(const npz_archive&) = delete;
+
+  /** @brief Path to NPZ file. */
+  const std::string& filename() const noexcept { return m_filename; }
+
+  /** @brief Whether the archive contains an array. */
+  bool has_array(const std::string& name) const;
+  /** @brief Access array by name (without ".npy"). */
+  const npz_array& get_array(const std::string& name) const;
+  /** @brief Names of arrays in archive. */
+  std::vector<std::string> get_array_names() const;
+
+private:
+  friend class npz_array;
+
+  /** @brief Inflate access point within a deflate stream. */
+  struct access_point {
+    /** @brief Offset in uncompressed data. */
+    size_t out = 0;
+    /** @brief Offset in compressed data. */
+    size_t in = 0;
+    /** @brief Number of bits from byte before @c in , if any. */
+    int bits = 0;
+    /** @brief Last 32 KB of uncompressed data before @c out . */
+    std::vector<unsigned char> window;
+  };
+
+  /** @brief Decompression index for a compressed member. */
+  struct member_index {
+    /** @brief Access points sorted by uncompressed offset. */
+    std::vector<access_point> points;
+  };
+
+  /** @brief Parse zip central directory and NPY headers. */
+  void parse_central_directory();
+  /** @brief Parse the NPY header at the beginning of a member. */
+  void parse_npy_header(npz_array& array) const;
+
+  /** @brief Copy bytes from a member's uncompressed data. */
+  void read_member(const npz_array& array,
+                   size_t offset,
+                   size_t size,
+                   void* dst) const;
+  /** @brief Get a decompressed chunk, inflating it if needed. */
+  std::shared_ptr<const std::vector<unsigned char>>
+  get_chunk(const npz_array& array, size_t chunk_index) const;
+  /** @brief Inflate a range of a compressed member.
+   *
+   *  Starts from the closest access point and records new access
+   *  points while inflating past the indexed region.
+   */
+  void inflate_range(const npz_array& array,
+                     size_t begin,
+                     size_t end,
+                     unsigned char* dst) const;
+
+  std::string m_filename;
+  /** @brief Memory-mapped archive file. */
+  const unsigned char* m_file_data = nullptr;
+  size_t m_file_size = 0;
+
+  std::map<std::string, std::unique_ptr<npz_array>> m_arrays;
+
+  /** @brief Maximum size of decompressed data cache. */
+  size_t m_cache_size;
+  /** @brief Decompression indices for compressed members. */
+  mutable std::vector<member_index> m_indices;
+  /** @brief Decompressed chunks in least-recently-used order. */
+  mutable std::list<std::pair<std::pair<size_t,size_t>,
+                              std::shared_ptr<const std::vector<unsigned char>>>>
+    m_cache;
+  /** @brief Map from (member, chunk) to position in cache. */
+  mutable std::map<std::pair<size_t,size_t>,
+                   decltype(m_cache)::iterator> m_cache_map;
+  /** @brief Current size of decompressed data cache. */
+  mutable size_t m_cache_used = 0;
+  /** @brief Protects decompression indices and cache. */
+  mutable std::mutex m_cache_mutex;
+
+};
+
+} // namespace lbann
+
+#endif // LBANN_UTILS_NPZ_ARCHIVE_HPP_INCLUDED
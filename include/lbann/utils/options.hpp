@@ -41,7 +41,9 @@ namespace lbann {
 #define LBANN_OPTION_DISABLE_CUDA "disable_cuda"
 #define LBANN_OPTION_DISABLE_SIGNAL_HANDLER "disable_signal_handler"
 #define LBANN_OPTION_EXIT_AFTER_SETUP "exit_after_setup"
+#define LBANN_OPTION_FUSE_FC_ACTIVATION "fuse_fc_activation"
 #define LBANN_OPTION_GENERATE_MULTI_PROTO "generate_multi_proto"
+#define LBANN_OPTION_HIERARCHICAL_ALLREDUCE "hierarchical_allreduce"
 #define LBANN_OPTION_LOAD_MODEL_WEIGHTS_DIR_IS_COMPLETE                        \
   "load_model_weights_dir_is_complete"
 // Deprecated -- "LTFB Callback"
@@ -55,7 +57,9 @@ namespace lbann {
 #define LBANN_OPTION_NO_IM_COMM "no_im_comm"
 #define LBANN_OPTION_PRELOAD_DATA_STORE "preload_data_store"
 #define LBANN_OPTION_PRINT_AFFINITY "print_affinity"
+#define LBANN_OPTION_PRINT_SETUP_TIMES "print_setup_times"
 #define LBANN_OPTION_SERIALIZE_IO "serialize_io"
+#define LBANN_OPTION_SHARD_OPTIMIZER_STATE "shard_optimizer_state"
 #define LBANN_OPTION_ST_ON "st_on"
 #define LBANN_OPTION_ST_FULL_TRACE "st_full_trace"
 #define LBANN_OPTION_STACK_TRACE_TO_FILE "stack_trace_to_file"
@@ -69,16 +73,22 @@ namespace lbann {
 
 // Input options
 #define LBANN_OPTION_CKPT_DIR "ckpt_dir"
+#define LBANN_OPTION_FFTW_WISDOM "fftw_wisdom"
+#define LBANN_OPTION_GRADIENT_ACCUMULATION_STEPS "gradient_accumulation_steps"
+#define LBANN_OPTION_GRADIENT_BUCKET_SIZE "gradient_bucket_size"
 #define LBANN_OPTION_HYDROGEN_BLOCK_SIZE "hydrogen_block_size"
 #define LBANN_OPTION_LOAD_MODEL_WEIGHTS_DIR "load_model_weights_dir"
 #define LBANN_OPTION_MAX_RNG_SEEDS_DISPLAY "RNG seeds per trainer to display"
 #define LBANN_OPTION_METADATA "metadata"
+#define LBANN_OPTION_METRIC_REDUCTION_INTERVAL "metric_reduction_interval"
 #define LBANN_OPTION_MINI_BATCH_SIZE "mini_batch_size"
 #define LBANN_OPTION_MODEL "model"
 #define LBANN_OPTION_NUM_EPOCHS "num_epochs"
 #define LBANN_OPTION_NUM_IO_THREADS "Num. IO threads"
 #define LBANN_OPTION_NUM_PARALLEL_READERS "num_parallel_readers"
 #define LBANN_OPTION_OPTIMIZER "optimizer"
+#define LBANN_OPTION_PIPELINE_MICRO_BATCHES "pipeline_micro_batches"
+#define LBANN_OPTION_PIPELINE_SCHEDULE "pipeline_schedule"
 #define LBANN_OPTION_PROCS_PER_TRAINER "Processes per trainer"
 #define LBANN_OPTION_PROTOTEXT "prototext"
 #define LBANN_OPTION_RANDOM_SEED "random_seed"
@@ -129,6 +139,7 @@ namespace lbann {
 #define LBANN_OPTION_LABEL_FILENAME_TRAIN "label_filename_train"
 #define LBANN_OPTION_LABEL_FILENAME_VALIDATE "label_filename_validate"
 #define LBANN_OPTION_NORMALIZATION "normalization"
+#define LBANN_OPTION_NPZ_CACHE_SIZE "npz_cache_size"
 #define LBANN_OPTION_PILOT2_READ_FILE_SIZES "pilot2_read_file_sizes"
 #define LBANN_OPTION_PILOT2_SAVE_FILE_SIZES "pilot2_save_file_sizes"
 #define LBANN_OPTION_SAMPLE_LIST_TEST "sample_list_test"
@@ -0,0 +1,79 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2022, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef LBANN_UTILS_PERF_COUNTERS_HPP_INCLUDED
+#define LBANN_UTILS_PERF_COUNTERS_HPP_INCLUDED
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace lbann {
+
+/** @brief Hardware performance counters.
+ *
+ *  Uses the Linux perf_event interface to count user-space CPU
+ *  cycles, instructions, and last-level cache misses. Counters are
+ *  opened on each thread of the OpenMP thread pool and their values
+ *  are summed, so work in parallel regions is included. Threads that
+ *  are created after construction (e.g. I/O threads) are counted with
+ *  the thread that created them.
+ *
+ *  If a counter can't be opened (e.g. on non-Linux systems or due to
+ *  a restrictive perf_event_paranoid setting), it always reads as
+ *  zero.
+ */
+class perf_counters {
+public:
+  enum counter : size_t { CYCLES = 0, INSTRUCTIONS, CACHE_MISSES, NUM_COUNTERS };
+  using values_type = std::array<uint64_t, NUM_COUNTERS>;
+
+  perf_counters();
+  ~perf_counters();
+  perf_counters(const perf_counters&) = delete;
+  perf_counters& operator=(const perf_counters&) = delete;
+
+  /** @brief Whether a counter was opened successfully on any thread. */
+  bool is_available(counter c) const noexcept;
+  /** @brief Whether any counter was opened successfully. */
+  bool is_available() const noexcept;
+
+  /** @brief Current counter values, summed over threads. */
+  values_type read() const;
+
+  /** @brief Human-readable counter name. */
+  static std::string get_name(counter c);
+
+private:
+  /** @brief perf_event file descriptors for each OpenMP thread
+   *  (negative if unavailable). */
+  std::vector<std::array<int, NUM_COUNTERS>> m_fds;
+};
+
+} // namespace lbann
+
+#endif // LBANN_UTILS_PERF_COUNTERS_HPP_INCLUDED
@@ -121,9 +121,9 @@ inline T random_uniform(Generator& g) {
 /**
  * Make mat into an m x n matrix where each entry is independently drawn from
  * a Gaussian distribution with given mean and standard deviation.
- * Unless selected so at compile-time, this ensures the entries of the matrix do
- * not change as the grid it is distributed over changes; that is, it will have
- * the same entries when mat spans any number of processes.
+ * This ensures the entries of the matrix do not change as the grid it is
+ * distributed over changes; that is, it will have the same entries when mat
+ * spans any number of processes or threads.
  */
 template <typename TensorDataType>
 void gaussian_fill(El::AbstractDistMatrix<TensorDataType>& mat, El::Int m, El::Int n, TensorDataType mean = 0.0,
@@ -149,6 +149,11 @@ void uniform_fill(El::AbstractDistMatrix<TensorDataType>& mat, El::Int m, El::In
  * a Gaussian distribution with given mean and standard deviation.
  * This always ensures that the entries of the matrix do not change as the grid
  * it is distributed over changes.
+ * Entries are generated with a counter-based RNG (see @c make_counter_rng),
+ * keyed by their global index. Each process generates its local entries in
+ * parallel, without communication. Every process in the trainer must call
+ * this function in the same order, unless streams are keyed with a
+ * @c counter_rng_key_scope.
  */
 template <typename TensorDataType>
 void gaussian_fill_procdet(El::AbstractDistMatrix<TensorDataType>& mat, El::Int m, El::Int n,
@@ -183,6 +188,20 @@ void gaussian_fill_parallel(
   TensorDataType mean = 0.0,
   TensorDataType stddev = 1.0);
 
+/**
+ * Make mat into an m x n matrix where each entry is independently
+ * uniformly sampled from a ball with the given center and radius.
+ * Entries are generated in parallel, so there are no guarantees of
+ * thread/process indendence.
+ */
+template <typename TensorDataType>
+void uniform_fill_parallel(
+  El::AbstractDistMatrix<TensorDataType>& mat,
+  El::Int m,
+  El::Int n,
+  TensorDataType center = 0.0,
+  TensorDataType radius = 1.0);
+
 bool save_rng_to_checkpoint_shared(persist& p, lbann_comm* comm);
 bool save_rng_to_checkpoint_distributed(persist& p, lbann_comm* comm);
 bool load_rng_from_checkpoint(persist& p, const lbann_comm* comm);
@@ -231,7 +250,8 @@ void rng_bernoulli(const float p, DistMat *m) {
   extern template void gaussian_fill_procdet<T>(El::AbstractDistMatrix<T>& mat, El::Int m, El::Int n, T mean, T stddev); \
   extern template void bernoulli_fill_procdet<T>(El::AbstractDistMatrix<T>& mat, El::Int m, El::Int n, double p);        \
   extern template void uniform_fill_procdet<T>(El::AbstractDistMatrix<T>& mat, El::Int m, El::Int n, T center, T radius); \
-  extern template void gaussian_fill_parallel<T>(El::AbstractDistMatrix<T>& mat, El::Int m, El::Int n, T mean, T stddev)
+  extern template void gaussian_fill_parallel<T>(El::AbstractDistMatrix<T>& mat, El::Int m, El::Int n, T mean, T stddev); \
+  extern template void uniform_fill_parallel<T>(El::AbstractDistMatrix<T>& mat, El::Int m, El::Int n, T center, T radius)
 
 #define LBANN_INSTANTIATE_CPU_HALF
 #define LBANN_INSTANTIATE_GPU_HALF
@@ -28,10 +28,14 @@
 #define LBANN_UTILS_RNG_HPP
 
 #include "lbann/comm.hpp"
+#include "lbann/utils/counter_rng.hpp"
 #include "lbann/utils/exception.hpp"
 #include <random>
 #include <atomic>
+#include <string>
 #include <thread>
+#include <utility>
+#include <vector>
 
 namespace lbann {
 
@@ -122,7 +126,73 @@ rng_gen& get_io_generator();
  */
 fast_rng_gen& get_fast_io_generator();
 
+/** @brief Seed for counter-based random number generation.
+ *
+ *  Identical on every process in a trainer.
+ */
+uint64_t get_counter_rng_seed();
+
+/** @brief Number of unkeyed counter-based streams handed out so far. */
+uint64_t get_counter_rng_stream();
+
+/** @brief Reset counter-based RNG state, e.g. from a checkpoint. */
+void set_counter_rng_state(uint64_t seed, uint64_t stream);
+
+/** @brief Number of streams drawn so far for each stream key.
+ *
+ *  Saved in checkpoints along with the seed and stream counter.
+ */
+std::vector<std::pair<uint64_t,uint64_t>> get_counter_rng_key_counts();
+
+/** @brief Reset per-key stream counts, e.g. from a checkpoint. */
+void set_counter_rng_key_counts(
+  const std::vector<std::pair<uint64_t,uint64_t>>& counts);
+
+/** @brief Counter-based RNG with a stream derived from a stable key.
+ *
+ *  The n-th call with a given key gets the stream
+ *  <tt>hash_combine(key, n)</tt>. The result does not depend on
+ *  draws made for other keys, e.g. on the order in which weights are
+ *  set up.
+ */
+counter_rng make_counter_rng(uint64_t key);
+
+/** @brief Counter-based RNG with a new stream.
+ *
+ *  If a @c counter_rng_key_scope is active on the calling thread,
+ *  this is @c make_counter_rng(key) with the scope's key. Otherwise
+ *  streams are handed out in order, so every process in a trainer
+ *  must make the same sequence of calls (e.g. from within collective
+ *  fill functions).
+ */
+counter_rng make_counter_rng();
+
+/** @brief Key counter-based streams on the calling thread.
+ *
+ *  While this object is alive, @c make_counter_rng() (and so the
+ *  counter-based fill functions) derive streams from @c key. Scopes
+ *  may be nested.
+ */
+class counter_rng_key_scope {
+public:
+  explicit counter_rng_key_scope(uint64_t key);
+  /** @brief Key with a hash of a name, e.g. of a weights object. */
+  explicit counter_rng_key_scope(const std::string& name);
+  ~counter_rng_key_scope();
+  counter_rng_key_scope(const counter_rng_key_scope&) = delete;
+  counter_rng_key_scope& operator=(const counter_rng_key_scope&) = delete;
+private:
+  /** @brief Key that was active when this scope was entered. */
+  const uint64_t* m_prev_key;
+  uint64_t m_key;
+};
+
 /** @brief Initialize the random number generator (with optional seed).
+ *
+ *  The counter-based RNG is seeded with @c seed directly, without
+ *  mixing in the process rank. If no seed is given, a random seed is
+ *  broadcast from the trainer master, or from rank 0 of the MPI world
+ *  if there is no communicator, so all ranks agree on it.
  *
  *  @param seed Seed value for the random number generator
  *  @param num_io_RNGs The number of RNGs for I/O.
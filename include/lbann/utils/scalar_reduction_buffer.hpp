@@ -0,0 +1,149 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2022, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef LBANN_UTILS_SCALAR_REDUCTION_BUFFER_HPP_INCLUDED
+#define LBANN_UTILS_SCALAR_REDUCTION_BUFFER_HPP_INCLUDED
+
+#include "lbann/base.hpp"
+#include "lbann/comm.hpp"
+
+#include <functional>
+#include <vector>
+
+namespace lbann {
+
+/** @brief Coalesces scalar allreduces within a mini-batch step.
+ *
+ *  Evaluation layers and objective function terms each produce a
+ *  scalar that must be summed over processes. Rather than issuing
+ *  one latency-bound allreduce per scalar, each of them registers a
+ *  slot during setup and contributes its local value during the
+ *  step. All contributed slots that share a communicator are then
+ *  reduced with a single non-blocking allreduce.
+ *
+ *  The reduction can also be skipped on most steps (e.g. when
+ *  training metrics are only logged). On those steps, @c get returns
+ *  the value from the most recent reduction.
+ */
+class scalar_reduction_buffer {
+public:
+
+  /** @brief Deferred local value.
+   *  @details Called once the reduction starts, e.g. to wait for a
+   *  device-to-host copy.
+   */
+  using value_function = std::function<EvalType()>;
+
+  /** @param interval Reduce on every @c interval -th step in
+   *  training mode. */
+  scalar_reduction_buffer(lbann_comm& comm, size_t interval = 1);
+  /** @brief Copy slots, but not the state of the current step. */
+  scalar_reduction_buffer(const scalar_reduction_buffer& other);
+  scalar_reduction_buffer& operator=(const scalar_reduction_buffer& other);
+  ~scalar_reduction_buffer();
+
+  /** @brief Register a scalar that is summed over @c comm.
+   *  @returns Slot index.
+   */
+  size_t add_slot(const El::mpi::Comm& comm);
+  /** @brief Remove all slots. */
+  void clear_slots();
+  size_t get_num_slots() const noexcept { return m_slots.size(); }
+
+  size_t get_interval() const noexcept { return m_interval; }
+  void set_interval(size_t interval);
+
+  /** @brief Prepare for a new mini-batch step.
+   *
+   *  Completes any outstanding reduction and discards contributions
+   *  from the previous step.
+   *
+   *  @param mode Execution mode. Only training steps can skip the
+   *              reduction.
+   *  @param step Step within the current execution mode.
+   */
+  void begin_step(execution_mode mode, size_t step);
+
+  /** @brief Set the local value of a slot. */
+  void contribute(size_t slot, EvalType local_value);
+  /** @brief Set the local value of a slot once the reduction starts. */
+  void contribute(size_t slot, value_function local_value);
+
+  /** @brief Start reducing contributed slots.
+   *  @details Does nothing if already started.
+   */
+  void start();
+
+  /** @brief Sum of a slot's local values over its communicator.
+   *
+   *  Starts and completes the reduction if needed.
+   */
+  EvalType get(size_t slot);
+
+  /** @brief Number of allreduces launched since construction. */
+  size_t get_num_allreduces() const noexcept { return m_num_allreduces; }
+
+private:
+
+  struct slot_info {
+    /** @brief Index of group that shares the slot's communicator. */
+    size_t group;
+    /** @brief Position within group buffer. */
+    size_t index;
+    bool contributed = false;
+    value_function deferred;
+  };
+
+  /** @brief Slots that share a communicator. */
+  struct group_info {
+    const El::mpi::Comm* comm;
+    std::vector<EvalType> local;
+    std::vector<EvalType> reduced;
+    Al::request req;
+    bool started = false;
+  };
+
+  /** @brief Wait for reductions and copy results. */
+  void finish();
+
+  lbann_comm* m_comm;
+  size_t m_interval;
+
+  std::vector<slot_info> m_slots;
+  std::vector<group_info> m_groups;
+
+  /** @brief Whether contributions are reduced in this step. */
+  bool m_reduce_step = true;
+  /** @brief Whether the reduction of this step has been started. */
+  bool m_started = false;
+
+  size_t m_num_allreduces = 0;
+
+};
+
+} // namespace lbann
+
+#endif // LBANN_UTILS_SCALAR_REDUCTION_BUFFER_HPP_INCLUDED
@@ -0,0 +1,291 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2022, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+#pragma once
+#ifndef LBANN_UTILS_SERIALIZATION_ELASTIC_CHECKPOINT_HPP_
+#define LBANN_UTILS_SERIALIZATION_ELASTIC_CHECKPOINT_HPP_
+
+#include <lbann/utils/exception.hpp>
+
+#include <El.hpp>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace lbann
+{
+namespace utils
+{
+
+/** @brief How a rank's local matrix maps into a distributed matrix.
+ *
+ *  Recorded alongside distributed checkpoints so that the local
+ *  matrices in a checkpoint can be scattered back to their global
+ *  positions when restarting on a different number of ranks.
+ */
+struct dist_matrix_layout
+{
+  El::Int height = 0;
+  El::Int width = 0;
+  El::Int col_shift = 0;
+  El::Int col_stride = 1;
+  El::Int row_shift = 0;
+  El::Int row_stride = 1;
+  /** @brief Index of this rank among ranks holding the same entries. */
+  int redundant_rank = 0;
+  /** @brief Number of ranks holding the same entries. */
+  int redundant_size = 1;
+
+  dist_matrix_layout() = default;
+  template <typename T>
+  dist_matrix_layout(El::AbstractDistMatrix<T> const& mat)
+    : height{mat.Height()},
+      width{mat.Width()},
+      col_shift{mat.ColShift()},
+      col_stride{mat.ColStride()},
+      row_shift{mat.RowShift()},
+      row_stride{mat.RowStride()},
+      redundant_rank{mat.RedundantRank()},
+      redundant_size{mat.RedundantSize()}
+  {}
+
+  template <typename ArchiveT>
+  void serialize(ArchiveT& ar)
+  {
+    ar(height, width,
+       col_shift, col_stride,
+       row_shift, row_stride,
+       redundant_rank, redundant_size);
+  }
+};
+
+/** @brief RAII recording of distributed matrix layouts.
+ *
+ *  While one of these is alive, every distributed matrix saved to a
+ *  binary archive has its layout appended, in save order.
+ */
+class dist_matrix_layout_recorder
+{
+public:
+  dist_matrix_layout_recorder();
+  ~dist_matrix_layout_recorder();
+  dist_matrix_layout_recorder(dist_matrix_layout_recorder const&) = delete;
+  dist_matrix_layout_recorder&
+  operator=(dist_matrix_layout_recorder const&) = delete;
+
+  void record(dist_matrix_layout const& layout)
+  {
+    m_layouts.push_back(layout);
+  }
+  std::vector<dist_matrix_layout> const& get_layouts() const noexcept
+  {
+    return m_layouts;
+  }
+
+private:
+  std::vector<dist_matrix_layout> m_layouts;
+  dist_matrix_layout_recorder* m_parent;
+};
+
+/** @brief Get the active layout recorder, if any. */
+dist_matrix_layout_recorder* get_dist_matrix_layout_recorder() noexcept;
+
+/** @brief Record a matrix layout if a recorder is active. */
+template <typename T>
+void record_dist_matrix_layout(El::AbstractDistMatrix<T> const& mat)
+{
+  if (auto* recorder = get_dist_matrix_layout_recorder())
+    recorder->record(dist_matrix_layout(mat));
+}
+
+/** @brief Old rank whose files a new rank reads in one pass of an
+ *         elastic restart.
+ */
+struct elastic_restart_source
+{
+  int rank = 0;
+  /** @brief Whether the entries read are accumulated. */
+  bool contribute = false;
+};
+
+/** @brief Number of passes to read a checkpoint written by
+ *         @c old_num_procs ranks on @c num_procs ranks.
+ */
+int get_elastic_restart_num_passes(int old_num_procs, int num_procs) noexcept;
+
+/** @brief Old rank read by new rank @c rank in pass @c pass.
+ *
+ *  See @c elastic_restart_context. A rank without an old rank left
+ *  to read re-reads a file without contributing.
+ */
+elastic_restart_source get_elastic_restart_source(int pass,
+                                                  int rank,
+                                                  int num_procs,
+                                                  int old_num_procs) noexcept;
+
+/** @brief RAII state for restarting a distributed checkpoint on a
+ *         different number of ranks.
+ *
+ *  Rank @f$ r @f$ of a trainer with @f$ N @f$ ranks wrote its local
+ *  matrices to its own checkpoint directory. When restarting on
+ *  @f$ N' \neq N @f$ ranks, the checkpoint is read in
+ *  @f$ \lceil N / N' \rceil @f$ passes. In pass @f$ k @f$, new rank
+ *  @f$ r' @f$ reads the files of old rank @f$ k N' + r' @f$ (or, if
+ *  there is no such rank, re-reads a file without contributing so
+ *  that the model can still be deserialized). Each distributed
+ *  matrix read during a pass is scattered into a global accumulator
+ *  according to the layout recorded at save time. Once the last pass
+ *  completes, the accumulators are copied into the deserialized
+ *  matrices, which have the distributions of the new grid.
+ *
+ *  Entries held redundantly by several old ranks are contributed by
+ *  exactly one of them. Matrices must be deserialized in the same
+ *  order in every pass.
+ */
+class elastic_restart_context
+{
+public:
+  elastic_restart_context(int old_num_procs, std::string primary_dir);
+  ~elastic_restart_context();
+  elastic_restart_context(elastic_restart_context const&) = delete;
+  elastic_restart_context&
+  operator=(elastic_restart_context const&) = delete;
+
+  /** @brief Begin reading the checkpoint of an old rank.
+   *  @param source_rank Old rank whose files are read.
+   *  @param source_dir  Checkpoint directory of that rank.
+   *  @param contribute  Whether that rank's entries are accumulated.
+   *  @param last_pass   Whether this is the final pass.
+   */
+  void begin_pass(int source_rank,
+                  std::string source_dir,
+                  bool contribute,
+                  bool last_pass);
+
+  /** @brief Provide the layouts recorded by the source rank. */
+  void set_layouts(int old_num_procs,
+                   std::vector<dist_matrix_layout> layouts);
+
+  int get_old_num_procs() const noexcept { return m_old_num_procs; }
+  int get_source_rank() const noexcept { return m_source_rank; }
+  std::string const& get_source_dir() const noexcept { return m_source_dir; }
+  /** @brief Checkpoint directory of the old trainer master. */
+  std::string const& get_primary_dir() const noexcept { return m_primary_dir; }
+  bool is_last_pass() const noexcept { return m_last_pass; }
+
+  /** @brief Accumulate a local matrix read from the source rank.
+   *
+   *  Collective over the grid of @c mat. On the last pass, @c mat is
+   *  filled with the reassembled global matrix.
+   */
+  template <typename T>
+  void redistribute(El::Matrix<T, El::Device::CPU> const& local,
+                    El::Int height,
+                    El::Int width,
+                    El::AbstractDistMatrix<T>& mat);
+
+private:
+  int m_old_num_procs;
+  std::string m_primary_dir;
+  int m_source_rank = -1;
+  std::string m_source_dir;
+  bool m_contribute = false;
+  bool m_last_pass = false;
+  /** @brief Layouts of the source rank's matrices, in save order. */
+  std::vector<dist_matrix_layout> m_layouts;
+  /** @brief Matrices read so far in the current pass. */
+  size_t m_num_loaded = 0;
+  /** @brief Global accumulators, in load order. */
+  std::vector<std::unique_ptr<El::BaseDistMatrix>> m_accumulators;
+};
+
+/** @brief Get the active elastic restart context, if any. */
+elastic_restart_context* get_elastic_restart_context() noexcept;
+
+template <typename T>
+void elastic_restart_context::redistribute(
+  El::Matrix<T, El::Device::CPU> const& local,
+  El::Int height,
+  El::Int width,
+  El::AbstractDistMatrix<T>& mat)
+{
+  using AccMatType =
+    El::DistMatrix<T, El::STAR, El::VC, El::ELEMENT, El::Device::CPU>;
+
+  auto const index = m_num_loaded++;
+  if (index >= m_layouts.size()) {
+    LBANN_ERROR("elastic restart found more distributed matrices (",
+                index + 1, ") than recorded layouts (", m_layouts.size(),
+                ") in ", m_source_dir);
+  }
+  auto const& layout = m_layouts[index];
+  if (layout.height != height || layout.width != width
+      || local.Height() != El::Length(height, layout.col_shift,
+                                      layout.col_stride)
+      || local.Width() != El::Length(width, layout.row_shift,
+                                     layout.row_stride)) {
+    LBANN_ERROR("layout of distributed matrix ", index,
+                " in ", m_source_dir, " does not match its data");
+  }
+
+  // Accumulators are created on the first pass and reused after
+  if (index == m_accumulators.size()) {
+    auto acc = std::make_unique<AccMatType>(mat.Grid(), mat.Root());
+    El::Zeros(*acc, height, width);
+    m_accumulators.emplace_back(std::move(acc));
+  }
+  auto* acc = dynamic_cast<AccMatType*>(m_accumulators[index].get());
+  if (acc == nullptr || acc->Height() != height || acc->Width() != width) {
+    LBANN_ERROR("distributed matrix ", index, " in ", m_source_dir,
+                " does not match the matrix read in a previous pass");
+  }
+
+  // Scatter local entries to their global positions
+  if (m_contribute) {
+    acc->Reserve(local.Height() * local.Width());
+    for (El::Int j = 0; j < local.Width(); ++j) {
+      El::Int const gj = layout.row_shift + j * layout.row_stride;
+      for (El::Int i = 0; i < local.Height(); ++i) {
+        El::Int const gi = layout.col_shift + i * layout.col_stride;
+        if ((gi + gj * height) % layout.redundant_size
+            == layout.redundant_rank) {
+          acc->QueueUpdate(gi, gj, local.CRef(i, j));
+        }
+      }
+    }
+  }
+  acc->ProcessQueues();
+
+  mat.Resize(height, width);
+  if (m_last_pass) {
+    El::Copy(*acc, mat);
+    m_accumulators[index].reset();
+  }
+}
+
+}// namespace utils
+}// namespace lbann
+#endif // LBANN_UTILS_SERIALIZATION_ELASTIC_CHECKPOINT_HPP_
@@ -28,6 +28,7 @@
 #define LBANN_UTILS_SERIALIZATION_SERIALIZE_MATRICES_IMPL_HPP_
 
 #include "lbann/utils/serialization/serialize_matrices.hpp"
+#include "lbann/utils/serialization/elastic_checkpoint.hpp"
 
 #include <El/blas_like/level1/Copy/TranslateBetweenGrids.hpp>
 #include <El/blas_like/level1/Copy/Translate.hpp>
@@ -225,6 +226,7 @@ template <typename ArchiveT, typename T,
 void save(ArchiveT& ar, ::El::AbstractDistMatrix<T> const& mat)
 {
   LBANN_ASSERT(!mat.Viewing());
+  lbann::utils::record_dist_matrix_layout(mat);
   // Binary archives don't use NVPs, so there's no point in making
   // them here.
   ar(mat.Height(),
@@ -239,6 +241,16 @@ void load(ArchiveT& ar, ::El::AbstractDistMatrix<T>& mat)
   LBANN_ASSERT(!mat.Viewing());
   ::El::Int global_height, global_width;
   ar(global_height, global_width);
+
+  // Restarting on a different number of ranks: the local matrix in
+  // the archive belongs to a rank of the old grid.
+  if (auto* elastic = lbann::utils::get_elastic_restart_context()) {
+    ::El::Matrix<T, ::El::Device::CPU> mat_cpu;
+    ar(mat_cpu);
+    elastic->redistribute(mat_cpu, global_height, global_width, mat);
+    return;
+  }
+
   mat.Resize(global_height, global_width);
 #ifdef LBANN_DEBUG
   ::El::Matrix<T, ::El::Device::CPU> mat_cpu;
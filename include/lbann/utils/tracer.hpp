@@ -0,0 +1,168 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2022, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef LBANN_UTILS_TRACER_HPP_INCLUDED
+#define LBANN_UTILS_TRACER_HPP_INCLUDED
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace lbann {
+namespace trace {
+
+/** @brief Interval recorded by the tracer. */
+struct event {
+  /** @brief Start time (ns on the local steady clock). */
+  int64_t start;
+  /** @brief Duration (ns). */
+  int64_t duration;
+  /** @brief Event category. Must be a string literal. */
+  const char* category;
+  /** @brief Event name (truncated, null-terminated). */
+  char name[48];
+};
+
+/** @brief Process-wide low-overhead event tracer.
+ *
+ *  Each thread appends events to its own fixed-size ring buffer, so
+ *  recording an event takes no locks; once a ring buffer is full the
+ *  oldest events are overwritten. A mutex is only taken the first
+ *  time a thread records an event after the tracer is enabled.
+ *
+ *  Events are written in the Chrome trace event format, which can
+ *  be viewed in Perfetto or chrome://tracing. Writing should only
+ *  be done when no other threads are recording events.
+ */
+class tracer {
+public:
+  /** @brief Default number of events per thread. */
+  static constexpr size_t default_buffer_size = 1 << 16;
+
+  /** @brief Process-wide tracer. */
+  static tracer& instance();
+
+  /** @brief Start recording events.
+   *
+   *  Discards any previously recorded events.
+   */
+  void enable(size_t buffer_size = default_buffer_size);
+  /** @brief Stop recording events. Recorded events are kept. */
+  void disable() noexcept;
+  bool is_enabled() const noexcept {
+    return m_enabled.load(std::memory_order_relaxed);
+  }
+
+  /** @brief Current time (ns on the local steady clock). */
+  static int64_t now() noexcept;
+
+  /** @brief Record an interval on the calling thread. */
+  void record(const char* category,
+              const char* name,
+              int64_t start,
+              int64_t end);
+
+  /** @brief Set display name of the calling thread. */
+  void set_thread_name(std::string name);
+
+  /** @brief Number of recorded events that are still buffered. */
+  size_t get_num_events() const;
+
+  /** @brief Write buffered events in Chrome trace format.
+   *
+   *  @param path          Output file.
+   *  @param pid           Process ID to use in trace (e.g. MPI rank).
+   *  @param clock_offset  Offset (ns) to add to local times to obtain
+   *                       times on a reference clock. Stored in the
+   *                       trace metadata for merging traces.
+   */
+  void write_chrome_trace(const std::string& path,
+                          int pid,
+                          int64_t clock_offset = 0) const;
+
+private:
+  struct thread_buffer;
+  /** @brief Ring buffer owned by calling thread. */
+  struct thread_state {
+    std::shared_ptr<thread_buffer> buffer;
+    /** @brief Tracer generation when buffer was allocated. */
+    uint64_t generation = 0;
+  };
+
+  tracer() = default;
+  static thread_state& get_thread_state();
+  /** @brief Ring buffer for calling thread. */
+  thread_buffer& get_thread_buffer();
+
+  std::atomic<bool> m_enabled{false};
+  /** @brief Incremented whenever thread buffers are reallocated. */
+  std::atomic<uint64_t> m_generation{0};
+  size_t m_buffer_size = default_buffer_size;
+
+  /** @brief Protects thread buffer list and thread names. */
+  mutable std::mutex m_mutex;
+  std::vector<std::shared_ptr<thread_buffer>> m_buffers;
+  std::unordered_map<std::thread::id, std::string> m_thread_names;
+};
+
+/** @brief Record the lifetime of an object as a trace event.
+ *
+ *  Does nothing if the tracer is disabled when the object is
+ *  constructed.
+ */
+class scope {
+public:
+  scope(const char* category, const char* name) noexcept;
+  scope(const char* category, const std::string& name) noexcept
+    : scope(category, name.c_str()) {}
+  ~scope();
+  scope(const scope&) = delete;
+  scope& operator=(const scope&) = delete;
+
+private:
+  const char* m_category;
+  int64_t m_start = -1;
+  char m_name[sizeof(event::name)];
+};
+
+} // namespace trace
+} // namespace lbann
+
+#define LBANN_TRACE_CONCAT_IMPL(a, b) a##b
+#define LBANN_TRACE_CONCAT(a, b) LBANN_TRACE_CONCAT_IMPL(a, b)
+
+/** @brief Trace the remainder of the enclosing scope. */
+#define LBANN_TRACE_SCOPE(category, name)                               \
+  ::lbann::trace::scope LBANN_TRACE_CONCAT(lbann_trace_scope_, __LINE__)( \
+    category, name)
+
+#endif // LBANN_UTILS_TRACER_HPP_INCLUDED
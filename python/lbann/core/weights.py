@@ -27,12 +27,14 @@ class Weights:
 
     global_count = 0  # Static counter, used for default names
 
-    def __init__(self, initializer=None, optimizer=None, name=None, datatype=None):
+    def __init__(self, initializer=None, optimizer=None, name=None, datatype=None,
+                 gradient_compression=None):
         Weights.global_count += 1
         self.name = name if name else 'weights{0}'.format(Weights.global_count)
         self.initializer = initializer
         self.optimizer = optimizer
         self.datatype = datatype
+        self.gradient_compression = gradient_compression
 
     def export_proto(self):
         """Construct and return a protobuf message."""
@@ -53,4 +55,8 @@ class Weights:
         if self.datatype:
             proto.datatype = self.datatype
 
+        # Set gradient compression if needed
+        if self.gradient_compression:
+            proto.gradient_compression.CopyFrom(self.gradient_compression)
+
         return proto
@@ -0,0 +1,63 @@
+#!/usr/bin/env python3
+"""Merge per-rank Chrome traces written by LBANN's timeline callback.
+
+Each rank writes trace.m<trainer>.<rank>.json with timestamps from its
+local clock, along with the estimated offset from its clock to the
+trainer master's clock. This script shifts each trace by its offset so
+that events from all ranks are aligned in a single timeline, which can
+be opened in Perfetto (https://ui.perfetto.dev) or chrome://tracing.
+"""
+
+import argparse
+import glob
+import json
+import os.path
+
+# Parse command-line arguments
+parser = argparse.ArgumentParser(
+    description='Merge per-rank Chrome traces from LBANN\'s timeline callback.')
+parser.add_argument(
+    'input', action='store', type=str, nargs='+',
+    help='trace files or directories containing trace.m*.json files')
+parser.add_argument(
+    '-o', '--output', action='store', default='trace.json', type=str,
+    help='merged trace file (default: trace.json)', metavar='FILE')
+parser.add_argument(
+    '--no-align', action='store_true',
+    help='ignore clock offsets recorded in traces')
+args = parser.parse_args()
+
+# Find trace files
+files = []
+for path in args.input:
+    if os.path.isdir(path):
+        files.extend(sorted(glob.glob(os.path.join(path, 'trace.m*.json'))))
+    else:
+        files.append(path)
+if not files:
+    raise RuntimeError('no trace files found')
+
+# Shift events onto the reference clock
+events = []
+for path in files:
+    with open(path, 'r') as f:
+        trace = json.load(f)
+    offset = 0.0
+    if not args.no_align:
+        offset = trace.get('otherData', {}).get('clock_offset_us', 0.0)
+    for event in trace['traceEvents']:
+        if 'ts' in event:
+            event['ts'] += offset
+        events.append(event)
+
+# Make times relative to first event
+timed_events = [event for event in events if 'ts' in event]
+if timed_events:
+    start = min(event['ts'] for event in timed_events)
+    for event in timed_events:
+        event['ts'] = round(event['ts'] - start, 3)
+
+with open(args.output, 'w') as f:
+    json.dump({'displayTimeUnit': 'ms', 'traceEvents': events}, f)
+print('Merged {} traces ({} events) into {}'
+      .format(len(files), len(events), args.output))
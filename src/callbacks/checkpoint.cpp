@@ -32,9 +32,11 @@
 #include "lbann/execution_algorithms/sgd_execution_context.hpp"
 #include "lbann/models/model.hpp"
 #include "lbann/utils/serialize.hpp"
+#include "lbann/utils/serialization/elastic_checkpoint.hpp"
 
 #include <callbacks.pb.h>
 
+#include <fstream>
 #include <memory>
 #include <string>
 
@@ -59,6 +61,33 @@ get_current_execution_context_with_training_override(model& m, trainer& t)
   return c;
 }
 
+/** @brief Name of file recording how many ranks per trainer wrote a
+ *         distributed checkpoint. Written by the trainer master. */
+constexpr char const* distributed_manifest_filename = "procs_per_trainer";
+
+void write_distributed_manifest(std::string const& epochdir,
+                                int procs_per_trainer)
+{
+  std::ofstream ofs(epochdir + distributed_manifest_filename);
+  if (!ofs) {
+    LBANN_ERROR("Failed to open ", epochdir, distributed_manifest_filename);
+  }
+  ofs << procs_per_trainer << std::endl;
+}
+
+/** @brief Checkpoints written before the manifest existed are assumed
+ *         to match the current number of ranks. */
+int read_distributed_manifest(std::string const& epochdir,
+                              int default_procs_per_trainer)
+{
+  std::ifstream ifs(epochdir + distributed_manifest_filename);
+  int procs_per_trainer = default_procs_per_trainer;
+  if (ifs) {
+    ifs >> procs_per_trainer;
+  }
+  return procs_per_trainer;
+}
+
 /**
  * When generating a checkpoint for non-training execution phases, the epoch
  * number should be pulled from the training context to provide a proper
@@ -399,20 +428,66 @@ bool checkpoint::open_latest_checkpoint(
   }
 
   std::string epochdir;
+  // Note on resharding, added to the restart summary
+  std::string reshard_note;
   // Create dir to restart from based off last recorded checkpoint (or overriden values in last.shared[distributed].checkpoint
   if(!shared){
-    epochdir = get_distributed_checkpoint_dirname(trainer_name,
-                                                  alg_name,
-                                                  comm.get_rank_in_trainer(),
-                                                  dir, hook, mode, epoch, step);
-    if(!file::directory_exists(epochdir)) {
-      LBANN_WARNING(epochdir + " does not exist");
-      return false;
+    // Check whether the checkpoint was written with a different
+    // number of ranks per trainer
+    auto const primary_dir = get_distributed_checkpoint_dirname(
+      trainer_name, alg_name, 0, dir, hook, mode, epoch, step);
+    int const num_procs = comm.get_procs_per_trainer();
+    int old_num_procs = num_procs;
+    if (comm.am_trainer_master()) {
+      old_num_procs = read_distributed_manifest(primary_dir, num_procs);
+    }
+    comm.trainer_broadcast(0, old_num_procs);
+
+    if (old_num_procs == num_procs) {
+      epochdir = get_distributed_checkpoint_dirname(trainer_name,
+                                                    alg_name,
+                                                    comm.get_rank_in_trainer(),
+                                                    dir, hook, mode, epoch, step);
+      if(!file::directory_exists(epochdir)) {
+        LBANN_WARNING(epochdir + " does not exist");
+        return false;
+      }
+      p.open_restart(epochdir.c_str());
+      if (!reload_distributed_ckpt(p))
+        LBANN_WARNING("Unable to reload distributed checkpoint ", epochdir);
+      p.close_restart();
+    }
+    else {
+      // Elastic restart: read the old ranks' files in passes and
+      // reassemble the distributed matrices on the new grid. Ranks
+      // without an old rank left to read in a pass re-read a file
+      // without contributing, since the reload is collective.
+      int const rank = comm.get_rank_in_trainer();
+      int const num_passes =
+        utils::get_elastic_restart_num_passes(old_num_procs, num_procs);
+      reshard_note = build_string(", resharded from ", old_num_procs,
+                                  " to ", num_procs, " ranks in ",
+                                  num_passes,
+                                  (num_passes == 1 ? " pass" : " passes"));
+      utils::elastic_restart_context elastic(old_num_procs, primary_dir);
+      for (int pass = 0; pass < num_passes; ++pass) {
+        auto const source = utils::get_elastic_restart_source(
+          pass, rank, num_procs, old_num_procs);
+        epochdir = get_distributed_checkpoint_dirname(trainer_name,
+                                                      alg_name,
+                                                      source.rank,
+                                                      dir, hook, mode, epoch, step);
+        if(!file::directory_exists(epochdir)) {
+          LBANN_ERROR(epochdir, " does not exist");
+        }
+        elastic.begin_pass(source.rank, epochdir, source.contribute,
+                           pass == num_passes - 1);
+        p.open_restart(epochdir.c_str());
+        if (!reload_distributed_ckpt(p))
+          LBANN_WARNING("Unable to reload distributed checkpoint ", epochdir);
+        p.close_restart();
+      }
     }
-    p.open_restart(epochdir.c_str());
-    if (!reload_distributed_ckpt(p))
-      LBANN_WARNING("Unable to reload distributed checkpoint ", epochdir);
-    p.close_restart();
   }
   else {
     epochdir = get_shared_checkpoint_dirname(trainer_name,
@@ -452,7 +527,7 @@ bool checkpoint::open_latest_checkpoint(
               << " complete: Epoch=" << epoch
               << " Step=" << step
               << " (" << secs << " secs, " << bytes_count << " bytes, "
-              << bw << " MB/sec)" << std::endl;
+              << bw << " MB/sec" << reshard_note << ")" << std::endl;
     fflush(stdout);
   }
   p.reset_bytes();
@@ -557,6 +632,12 @@ void checkpoint::do_distributed_checkpoint(
   // Make sure that the master has had a chance to create the directories
   comm.trainer_barrier();
 
+  // Record the number of ranks so the checkpoint can be restarted
+  // with a different one
+  if (comm.am_trainer_master()) {
+    write_distributed_manifest(epochdir, comm.get_procs_per_trainer());
+  }
+
   // Call top level save to checkpoint function in model, in turn
   // calls save to checkpoint functions for other model classes
   // (weights, layers)
@@ -29,6 +29,7 @@
 #include "lbann/comm_impl.hpp"
 #include "lbann/callbacks/imcomm.hpp"
 
+#include "lbann/optimizers/data_type_optimizer.hpp"
 #include "lbann/utils/exception.hpp"
 #include "lbann/utils/summary_impl.hpp"
 #include "lbann/utils/timer.hpp"
@@ -80,6 +81,26 @@ void imcomm::setup(model *m) {
           w->get_name(), ", which has no optimizer");
       }
     }
+
+    // Allocate buffer for hierarchical average
+    params.layout.reset();
+    params.buffer.reset();
+    if (params.ct == AVERAGE) {
+      auto const& values =
+        dynamic_cast<data_type_weights<DataType>&>(*w).get_values();
+      params.layout = make_gradient_shard_layout(values);
+      if (params.layout != nullptr) {
+        params.buffer.reset(
+          El::AbstractDistMatrix<DataType>::Instantiate(params.layout->dist));
+        El::Zeros(*params.buffer, params.layout->height, 1);
+      }
+      else {
+        params.buffer.reset(
+          El::AbstractDistMatrix<DataType>::Instantiate(values.DistData()));
+        params.buffer->AlignWith(values);
+        El::Zeros(*params.buffer, values.Height(), values.Width());
+      }
+    }
   }
 }
 
@@ -103,6 +124,17 @@ void imcomm::on_backward_prop_end(model *m) {
       c.get_execution_mode() != execution_mode::training) {
     return;  // No point with only one model.
   }
+
+  // Launch averages together so they overlap with each other
+  for (weights *w : m->get_weights()) {
+    imcomm_params& params = m_weights_params[w];
+    if (params.ct == AVERAGE && w->has_optimizer()) {
+      start_average(*comm,
+                    dynamic_cast<data_type_weights<DataType>&>(*w),
+                    params);
+    }
+  }
+
   for (weights *w : m->get_weights()) {
     auto& real_w = dynamic_cast<data_type_weights<DataType>&>(*w);
     EvalType start_time = get_time();
@@ -114,9 +146,17 @@ void imcomm::on_backward_prop_end(model *m) {
     auto& real_opt = dynamic_cast<data_type_optimizer<DataType>&>(*opt);
     auto gradient = to_unique_ptr(real_opt.get_gradient().Copy());
     auto& local_gradients = gradient->Matrix();
+    size_t bytes = 0;
     switch (params.ct) {
     case NORMAL:
       comm->intertrainer_sum_matrix(local_gradients);
+      bytes = sizeof(DataType) * local_gradients.Height()
+        * local_gradients.Width();
+      break;
+    case AVERAGE:
+      finish_average(*comm, *gradient, params);
+      bytes = sizeof(DataType) * params.buffer->LocalHeight()
+        * params.buffer->LocalWidth();
       break;
     default:
       LBANN_ERROR("imcomm: unknown comm type");
@@ -124,14 +164,49 @@ void imcomm::on_backward_prop_end(model *m) {
     real_opt.clear_gradient();
     real_opt.add_to_gradient(*gradient);
     EvalType im_time = get_time() - start_time;
-    do_summary(*m, real_w, im_time);
+    do_summary(*m, real_w, im_time, bytes);
+  }
+}
+
+void imcomm::start_average(lbann_comm& comm,
+                           data_type_weights<DataType>& w,
+                           imcomm_params& params) {
+  auto& opt = dynamic_cast<data_type_optimizer<DataType>&>(*w.get_optimizer());
+  auto const& gradient = opt.get_gradient();
+  if (params.layout != nullptr) {
+    copy_to_shard(gradient.LockedMatrix(),
+                  params.buffer->Matrix(),
+                  *params.layout);
+  }
+  else {
+    El::Copy(gradient.LockedMatrix(), params.buffer->Matrix());
+  }
+  comm.nb_allreduce(params.buffer->Matrix(),
+                    comm.get_intertrainer_comm(),
+                    params.req);
+}
+
+void imcomm::finish_average(lbann_comm& comm,
+                            El::AbstractDistMatrix<DataType>& gradient,
+                            imcomm_params& params) {
+  comm.wait(params.req);
+  El::Scale(DataType(1) / DataType(comm.get_num_trainers()),
+            params.buffer->Matrix());
+  if (params.layout != nullptr) {
+    gather_from_shard(params.buffer->LockedMatrix(),
+                      gradient.Matrix(),
+                      *params.layout);
+  }
+  else {
+    El::Copy(params.buffer->LockedMatrix(), gradient.Matrix());
   }
 }
 
 template <typename TensorDataType>
 void imcomm::do_summary(model const& m,
                         data_type_weights<TensorDataType>& w,
-                        EvalType im_time) {
+                        EvalType im_time,
+                        size_t bytes) {
   if (m_summarizer == nullptr) {
     return;
   }
@@ -140,17 +215,10 @@ void imcomm::do_summary(model const& m,
   m_summarizer->reduce_scalar(prefix + "time",
                               im_time, c.get_step());
   // Use the same approximation the comm layer does.
-  auto const& local_gradients =
-    static_cast<const El::Matrix<TensorDataType, El::Device::CPU>&>(
-      w.get_optimizer()->get_gradient().LockedMatrix());
-  size_t bytes_sent =
-    sizeof(DataType) * local_gradients.Height() * local_gradients.Width();
-  size_t bytes_received =
-    sizeof(DataType) * local_gradients.Height() * local_gradients.Width();
   m_summarizer->reduce_scalar(prefix + "bytes_sent",
-                              bytes_sent, c.get_step());
+                              bytes, c.get_step());
   m_summarizer->reduce_scalar(prefix + "bytes_received",
-                              bytes_received, c.get_step());
+                              bytes, c.get_step());
 }
 
 /* Returns a string representation of the weight_initialization */
@@ -158,6 +226,7 @@ std::string get_comm_type_name(typename imcomm::comm_type m) {
   switch (m) {
   case imcomm::NONE: return "none";
   case imcomm::NORMAL: return "normal";
+  case imcomm::AVERAGE: return "average";
   default:
     LBANN_ERROR("Unknown value for comm_type");
   }
@@ -175,6 +244,8 @@ build_imcomm_callback_from_pbuf(
     type = imcomm::comm_type::NONE;
   } else if (type_str == "normal") {
     type = imcomm::comm_type::NORMAL;
+  } else if (type_str == "average") {
+    type = imcomm::comm_type::AVERAGE;
   } else {
     LBANN_ERROR("invalid inter-model communication type (", type_str, ")");
   }
@@ -29,6 +29,8 @@
 #include "lbann/callbacks/learning_rate.hpp"
 #include "lbann/optimizers/data_type_optimizer.hpp"
 #include "lbann/proto/proto_common.hpp"
+#include "lbann/utils/argument_parser.hpp"
+#include "lbann/utils/options.hpp"
 #include "lbann/weights/data_type_weights.hpp"
 
 #include "callback_helpers.hpp"
@@ -263,14 +265,23 @@ poly_learning_rate::poly_learning_rate(
 
 /**
  * Check if the maximum number of iterations is set. If not, compute it by the
- * number of epochs and the number of iterations per epoch.
+ * number of epochs and the number of optimization steps per epoch. With
+ * gradient accumulation, a step spans several mini-batches and ends at
+ * the end of an epoch.
  */
 void poly_learning_rate::setup(model *m) {
   learning_rate::setup(m);
   m_start_lr = get_current_global_learning_rate();
   if (m_max_iter == 0ull) {
     data_coordinator& dc = get_trainer().get_data_coordinator();
-    m_max_iter = m_num_epochs * dc.get_num_iterations_per_epoch(execution_mode::training);
+    const size_t num_mini_batches =
+      dc.get_num_iterations_per_epoch(execution_mode::training);
+    const size_t accumulation_steps = std::max(
+      global_argument_parser().get<size_t>(
+        LBANN_OPTION_GRADIENT_ACCUMULATION_STEPS),
+      size_t{1});
+    m_max_iter = m_num_epochs * ((num_mini_batches + accumulation_steps - 1)
+                                 / accumulation_steps);
   }
 }
 
@@ -27,8 +27,11 @@
 ///////////////////////////////////////////////////////////////////////////////
 
 #include "lbann/callbacks/profiler.hpp"
+#include "lbann/layers/layer.hpp"
+#include "lbann/models/model.hpp"
 #include "lbann/utils/profiling.hpp"
 #include "lbann/utils/serialize.hpp"
+#include "lbann/utils/timer.hpp"
 
 #include <callbacks.pb.h>
 
@@ -40,13 +43,28 @@
 #endif
 
 #include <algorithm>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
 #include <string>
+#include <vector>
 
 namespace lbann {
 namespace callback {
 
-profiler::profiler(bool sync, bool skip_init) :
-    callback_base(), m_sync(sync), m_skip_init(skip_init) {
+profiler::profiler(bool sync,
+                   bool skip_init,
+                   bool layer_report,
+                   bool use_perf_counters,
+                   double peak_gflops,
+                   double peak_bandwidth) :
+    callback_base(),
+    m_sync(sync),
+    m_skip_init(skip_init),
+    m_layer_report(layer_report),
+    m_perf_counters(use_perf_counters),
+    m_peak_gflops(peak_gflops),
+    m_peak_bandwidth(peak_bandwidth) {
 #ifdef LBANN_NVPROF
   nvtxNameCudaStreamA(hydrogen::cuda::GetDefaultStream(), "Hydrogen");
 #endif
@@ -61,7 +79,23 @@ void profiler::serialize(Archive & ar) {
        "BaseCallback",
        ::cereal::base_class<callback_base>(this)),
      CEREAL_NVP(m_sync),
-     CEREAL_NVP(m_skip_init));
+     CEREAL_NVP(m_skip_init),
+     CEREAL_NVP(m_layer_report),
+     CEREAL_NVP(m_perf_counters),
+     CEREAL_NVP(m_peak_gflops),
+     CEREAL_NVP(m_peak_bandwidth));
+}
+
+void profiler::setup(model *m) {
+  m_layer_stats.clear();
+  if (m_layer_report && m_perf_counters && m_counters == nullptr
+      && m->get_comm()->am_trainer_master()) {
+    m_counters = std::make_shared<perf_counters>();
+    if (!m_counters->is_available()) {
+      LBANN_WARNING("profiler callback could not open hardware counters "
+                    "(check /proc/sys/kernel/perf_event_paranoid)");
+    }
+  }
 }
 
 void profiler::on_epoch_begin(model *m) {
@@ -78,6 +112,9 @@ void profiler::on_epoch_end(model *m) {
   const auto& c = static_cast<SGDExecutionContext&>(m->get_execution_context());
   prof_region_end(("epoch " + std::to_string(c.get_epoch())).c_str(),
                   m_sync);
+  if (m_layer_report) {
+    print_layer_report(m);
+  }
 }
 
 void profiler::on_validation_begin(model *m) {
@@ -187,11 +224,156 @@ int profiler::get_color(Layer *l) {
   return prof_colors[idx % num_prof_colors];
 }
 
+void profiler::start_layer_measurement(model *m, Layer *l) {
+  if (!m_layer_report || !m->get_comm()->am_trainer_master()) {
+    return;
+  }
+#ifdef LBANN_HAS_GPU
+  if (l->get_device_allocation() == El::Device::GPU) {
+    hydrogen::gpu::SynchronizeDevice();
+  }
+#endif // LBANN_HAS_GPU
+  if (m_counters != nullptr) {
+    m_layer_start_counters = m_counters->read();
+  }
+  m_layer_start_time = get_time();
+}
+
+void profiler::finish_layer_measurement(model *m, Layer *l, bool forward) {
+  if (!m_layer_report || !m->get_comm()->am_trainer_master()) {
+    return;
+  }
+#ifdef LBANN_HAS_GPU
+  if (l->get_device_allocation() == El::Device::GPU) {
+    hydrogen::gpu::SynchronizeDevice();
+  }
+#endif // LBANN_HAS_GPU
+  const double elapsed = get_time() - m_layer_start_time;
+  auto& stats = m_layer_stats[l->get_name()];
+  stats.type = l->get_type();
+  const auto work = l->estimate_work();
+  auto& counters = forward ? stats.fp_counters : stats.bp_counters;
+  if (m_counters != nullptr) {
+    const auto end_counters = m_counters->read();
+    for (size_t i = 0; i < counters.size(); ++i) {
+      counters[i] += end_counters[i] - m_layer_start_counters[i];
+    }
+  }
+  if (forward) {
+    stats.fp_calls++;
+    stats.fp_time += elapsed;
+    stats.work.fp_flops += work.fp_flops;
+    stats.work.fp_bytes += work.fp_bytes;
+  }
+  else {
+    stats.bp_calls++;
+    stats.bp_time += elapsed;
+    stats.work.bp_flops += work.bp_flops;
+    stats.work.bp_bytes += work.bp_bytes;
+  }
+}
+
+void profiler::print_layer_report(model *m) {
+  if (m_layer_stats.empty()) {
+    return;
+  }
+  const auto& c = static_cast<SGDExecutionContext&>(m->get_execution_context());
+
+  // Sort layers by total time
+  std::vector<std::pair<std::string, const layer_stats*>> layers;
+  double total_time = 0.;
+  for (const auto& entry : m_layer_stats) {
+    layers.emplace_back(entry.first, &entry.second);
+    total_time += entry.second.fp_time + entry.second.bp_time;
+  }
+  std::sort(layers.begin(), layers.end(),
+            [](const auto& a, const auto& b) {
+              return (a.second->fp_time + a.second->bp_time
+                      > b.second->fp_time + b.second->bp_time);
+            });
+
+  // Roofline ridge point (FLOP/byte)
+  const bool has_roofline = (m_peak_gflops > 0. && m_peak_bandwidth > 0.);
+  const double ridge = has_roofline ? m_peak_gflops / m_peak_bandwidth : 0.;
+  const bool has_counters = (m_counters != nullptr
+                             && m_counters->is_available());
+
+  std::ostringstream ss;
+  ss << std::fixed;
+  ss << "model \"" << m->get_name() << "\" layer performance "
+     << "(epoch " << c.get_epoch() << ", trainer master";
+  if (has_roofline) {
+    ss << ", peak " << m_peak_gflops << " GFLOP/s, "
+       << m_peak_bandwidth << " GB/s";
+  }
+  ss << ")\n";
+  ss << std::left << std::setw(24) << "layer"
+     << std::setw(20) << "type" << std::right
+     << std::setw(10) << "time (s)"
+     << std::setw(7) << "%"
+     << std::setw(10) << "GFLOP"
+     << std::setw(10) << "GB"
+     << std::setw(10) << "GFLOP/s"
+     << std::setw(10) << "GB/s"
+     << std::setw(10) << "FLOP/B";
+  if (has_roofline) {
+    ss << std::setw(9) << "bound" << std::setw(8) << "% roof";
+  }
+  if (has_counters) {
+    ss << std::setw(8) << "IPC" << std::setw(14) << "LLC miss/KiB";
+  }
+  ss << "\n";
+  for (const auto& entry : layers) {
+    const auto& stats = *entry.second;
+    const double time = stats.fp_time + stats.bp_time;
+    const double flops = stats.work.fp_flops + stats.work.bp_flops;
+    const double bytes = stats.work.fp_bytes + stats.work.bp_bytes;
+    const double gflops = time > 0. ? flops / time / 1e9 : 0.;
+    const double bandwidth = time > 0. ? bytes / time / 1e9 : 0.;
+    const double intensity = bytes > 0. ? flops / bytes : 0.;
+    ss << std::left << std::setw(24) << entry.first.substr(0, 23)
+       << std::setw(20) << stats.type.substr(0, 19) << std::right
+       << std::setprecision(4) << std::setw(10) << time
+       << std::setprecision(1) << std::setw(7)
+       << (total_time > 0. ? 100 * time / total_time : 0.)
+       << std::setprecision(3)
+       << std::setw(10) << flops / 1e9
+       << std::setw(10) << bytes / 1e9
+       << std::setprecision(2)
+       << std::setw(10) << gflops
+       << std::setw(10) << bandwidth
+       << std::setw(10) << intensity;
+    if (has_roofline) {
+      const double roof = std::min(m_peak_gflops, intensity * m_peak_bandwidth);
+      ss << std::setw(9) << (intensity >= ridge ? "compute" : "memory")
+         << std::setprecision(1) << std::setw(8)
+         << (roof > 0. ? 100 * gflops / roof : 0.);
+    }
+    if (has_counters) {
+      using counter = perf_counters::counter;
+      const auto cycles = stats.fp_counters[counter::CYCLES]
+        + stats.bp_counters[counter::CYCLES];
+      const auto instructions = stats.fp_counters[counter::INSTRUCTIONS]
+        + stats.bp_counters[counter::INSTRUCTIONS];
+      const auto misses = stats.fp_counters[counter::CACHE_MISSES]
+        + stats.bp_counters[counter::CACHE_MISSES];
+      ss << std::setprecision(2)
+         << std::setw(8) << (cycles > 0 ? double(instructions) / cycles : 0.)
+         << std::setw(14) << (bytes > 0. ? misses / (bytes / 1024) : 0.);
+    }
+    ss << "\n";
+  }
+  std::cout << ss.str() << std::flush;
+  m_layer_stats.clear();
+}
+
 void profiler::on_forward_prop_begin(model *m, Layer *l) {
   prof_region_begin(("fw " + l->get_name()).c_str(), get_color(l), m_sync);
+  start_layer_measurement(m, l);
 }
 
 void profiler::on_forward_prop_end(model *m, Layer *l) {
+  finish_layer_measurement(m, l, true);
   prof_region_end(("fw " + l->get_name()).c_str(), m_sync);
 }
 
@@ -205,9 +387,11 @@ void profiler::on_evaluate_forward_prop_end(model *m, Layer *l) {
 
 void profiler::on_backward_prop_begin(model *m, Layer *l) {
   prof_region_begin(("bw " + l->get_name()).c_str(), get_color(l), m_sync);
+  start_layer_measurement(m, l);
 }
 
 void profiler::on_backward_prop_end(model *m, Layer *l) {
+  finish_layer_measurement(m, l, false);
   prof_region_end(("bw " + l->get_name()).c_str(), m_sync);
 }
 
@@ -225,7 +409,11 @@ build_profiler_callback_from_pbuf(
   const auto& params =
     dynamic_cast<const lbann_data::Callback::CallbackProfiler&>(proto_msg);
   return std::make_unique<profiler>(params.sync(),
-                                              params.skip_init());
+                                    params.skip_init(),
+                                    params.layer_report(),
+                                    params.perf_counters(),
+                                    params.peak_gflops(),
+                                    params.peak_bandwidth());
 }
 
 } // namespace callback
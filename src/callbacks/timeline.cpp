@@ -28,6 +28,7 @@
 
 #include "lbann/callbacks/timeline.hpp"
 
+#include "lbann/comm_impl.hpp"
 #include "lbann/utils/memory.hpp"
 #include "lbann/utils/timer.hpp"
 #include "lbann/utils/serialize.hpp"
@@ -35,6 +36,7 @@
 #include <callbacks.pb.h>
 
 #include <fstream>
+#include <limits>
 #include <string>
 #include <utility>
 #include <vector>
@@ -52,6 +54,10 @@ void timeline::serialize(Archive & ar) {
        "BaseCallback",
        ::cereal::base_class<callback_base>(this)),
      CEREAL_NVP(m_outdir),
+     CEREAL_NVP(m_chrome_trace),
+     CEREAL_NVP(m_trace_buffer_size),
+     CEREAL_NVP(m_clock_offset),
+     CEREAL_NVP(m_opt_trace_start),
      CEREAL_NVP(m_start_time),
      CEREAL_NVP(m_fp_start_time),
      CEREAL_NVP(m_bp_start_time),
@@ -70,12 +76,66 @@ void timeline::on_train_begin(model *m) {
   for (const auto& w : m->get_weights()) {
     m_opt_times.emplace(w->get_name(), std::vector<std::pair<EvalType,EvalType>>());
   }
+  if (m_chrome_trace) {
+    m_clock_offset = estimate_clock_offset(*m->get_comm());
+    trace::tracer::instance().set_thread_name("main");
+    trace::tracer::instance().enable(m_trace_buffer_size);
+  }
   // Ensure the model is synchronized at the start.
   m->get_comm()->trainer_barrier();
   m_start_time = get_time();
 }
 
+int64_t timeline::estimate_clock_offset(const lbann_comm& comm) {
+  // Clock times are exchanged as doubles, which are exact for
+  // steady clock times of up to ~100 days in ns.
+  constexpr int num_pings = 8;
+  const int trainer = comm.get_trainer_rank();
+  const int root = comm.get_trainer_master();
+  const int num_procs = comm.get_procs_per_trainer();
+  int64_t offset = 0;
+  if (comm.am_trainer_master()) {
+    // Reply to pings from each rank in turn
+    for (int rank = 0; rank < num_procs; ++rank) {
+      if (rank == root) { continue; }
+      for (int i = 0; i < num_pings; ++i) {
+        double ping;
+        comm.recv(&ping, 1, trainer, rank);
+        const auto pong = static_cast<double>(trace::tracer::now());
+        comm.send(&pong, 1, trainer, rank);
+      }
+    }
+  }
+  else {
+    auto min_rtt = std::numeric_limits<int64_t>::max();
+    for (int i = 0; i < num_pings; ++i) {
+      const auto start = trace::tracer::now();
+      const auto ping = static_cast<double>(start);
+      double pong;
+      comm.send(&ping, 1, trainer, root);
+      comm.recv(&pong, 1, trainer, root);
+      const auto end = trace::tracer::now();
+      // Assume the root's time corresponds to the midpoint
+      if (end - start < min_rtt) {
+        min_rtt = end - start;
+        offset = static_cast<int64_t>(pong) - (start + (end - start) / 2);
+      }
+    }
+  }
+  return offset;
+}
+
 void timeline::on_train_end(model *m) {
+  if (m_chrome_trace) {
+    auto& tracer = trace::tracer::instance();
+    tracer.disable();
+    const std::string trace_path = m_outdir + "/trace.m" +
+      std::to_string(m->get_comm()->get_trainer_rank()) + "." +
+      std::to_string(m->get_comm()->get_rank_in_trainer()) + ".json";
+    tracer.write_chrome_trace(trace_path,
+                              m->get_comm()->get_rank_in_world(),
+                              m_clock_offset);
+  }
   const std::string path = m_outdir + "/timeline.m" +
     std::to_string(m->get_comm()->get_trainer_rank()) + "." +
     std::to_string(m->get_comm()->get_rank_in_trainer()) + ".txt";
@@ -120,11 +180,20 @@ void timeline::on_backward_prop_end(model *m, Layer *l) {
 
 void timeline::on_optimize_begin(model *m, weights *w) {
   m_opt_start_time = get_rel_time();
+  if (m_chrome_trace) {
+    m_opt_trace_start = trace::tracer::now();
+  }
 }
 
 void timeline::on_optimize_end(model *m, weights *w) {
   EvalType end = get_rel_time();
   m_opt_times[w->get_name()].emplace_back(m_opt_start_time, end);
+  if (m_chrome_trace) {
+    trace::tracer::instance().record("opt",
+                                     w->get_name().c_str(),
+                                     m_opt_trace_start,
+                                     trace::tracer::now());
+  }
 }
 
 std::unique_ptr<callback_base>
@@ -132,7 +201,13 @@ build_timeline_callback_from_pbuf(
   const google::protobuf::Message& proto_msg, std::shared_ptr<lbann_summary> const&) {
   const auto& params =
     dynamic_cast<const lbann_data::Callback::CallbackTimeline&>(proto_msg);
-  return std::make_unique<timeline>(params.directory());
+  const auto trace_buffer_size =
+    (params.trace_buffer_size() > 0
+     ? static_cast<size_t>(params.trace_buffer_size())
+     : trace::tracer::default_buffer_size);
+  return std::make_unique<timeline>(params.directory(),
+                                    params.chrome_trace(),
+                                    trace_buffer_size);
 }
 
 } // namespace callback
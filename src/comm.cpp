@@ -32,10 +32,14 @@
 #include "lbann/utils/gpu/helpers.hpp"
 #include "lbann/utils/memory.hpp"
 #include "lbann/utils/timer.hpp"
+#include "lbann/utils/tracer.hpp"
 #include "mpi.h"
 #include "omp.h"
+#include <algorithm>
+#include <numeric>
 #include <sstream>
 #include <thread>
+#include <type_traits>
 
 namespace lbann {
 
@@ -69,6 +73,13 @@ lbann_comm::lbann_comm(int ppm, El::mpi::Comm world)
   char** argv_dummy = nullptr;
   ::Al::Initialize(argc_dummy, argv_dummy);
 #endif
+  // Hierarchical allreduce state is attached to communicators and
+  // freed along with them
+  checkMPI(MPI_Comm_create_keyval(MPI_COMM_NULL_COPY_FN,
+                                  &lbann_comm::delete_shm_allreduce_context,
+                                  &m_shm_allreduce_keyval,
+                                  nullptr));
+
   // Set up the initial trainer split
   split_trainers(m_procs_per_trainer);
 
@@ -83,10 +94,12 @@ lbann_comm::lbann_comm(int ppm, El::mpi::Comm world)
 
 lbann_comm::~lbann_comm()
 {
+  release_shm_allreduce_context(m_world_comm);
   m_grid.reset();
   El::mpi::Free(m_trainer_comm);
   El::mpi::Free(m_intertrainer_comm);
   El::mpi::Free(m_node_comm);
+  MPI_Comm_free_keyval(&m_shm_allreduce_keyval);
 #ifdef LBANN_HAS_ALUMINUM
   ::Al::Finalize();
 #endif
@@ -117,6 +130,10 @@ void lbann_comm::split_trainers(
                 world_size);
   }
 
+  // Communicators are replaced
+  release_shm_allreduce_context(m_trainer_comm);
+  release_shm_allreduce_context(m_intertrainer_comm);
+
   m_num_trainers = world_size / m_procs_per_trainer;
   m_trainer_rank = El::mpi::Rank(get_world_comm()) / m_procs_per_trainer;
   m_rank_in_trainer = El::mpi::Rank(get_world_comm()) % m_procs_per_trainer;
@@ -145,6 +162,9 @@ void lbann_comm::split_trainer_grid(
   const int world_size = El::mpi::Size(m_trainer_comm);
   m_create_two_models = create_two_models;
 
+  // Trainer communicator may be replaced
+  release_shm_allreduce_context(m_trainer_comm);
+
   // If primary grid size is not given then split resources equally between
   // primary and secondary grid
   if (num_process_primary_grid == 0){
@@ -473,6 +493,230 @@ void nb_allreduce_impl(El::Matrix<T, El::Device::GPU>& m,
 #endif // defined(LBANN_HAS_GPU) && defined(LBANN_HAS_ALUMINUM)
 } // namespace
 
+// ===========================================
+// Hierarchical allreduce
+// ===========================================
+
+namespace {
+/** Size of each shared-memory chunk buffer (in bytes). */
+constexpr size_t shm_allreduce_chunk_bytes = 1 << 20;
+/** Types reduced through shared memory. Others, e.g. half precision
+ *  with user-defined MPI types and ops, use the regular allreduce.
+ */
+template <typename T>
+constexpr bool is_shm_allreduce_type =
+  std::is_same_v<T, float> || std::is_same_v<T, double>;
+} // namespace
+
+struct lbann_comm::shm_allreduce_context
+{
+  /** Processes in the communicator that share memory. */
+  MPI_Comm local_comm = MPI_COMM_NULL;
+  /** First process on each node (null on other processes). */
+  MPI_Comm leader_comm = MPI_COMM_NULL;
+  int local_rank = 0;
+  int local_size = 1;
+  int num_leaders = 1;
+  /** Shared window with two chunk buffers per local process. */
+  MPI_Win win = MPI_WIN_NULL;
+  /** Start of each local process's segment in the window. */
+  std::vector<unsigned char*> segments;
+
+  ~shm_allreduce_context()
+  {
+    if (win != MPI_WIN_NULL) {
+      MPI_Win_unlock_all(win);
+      MPI_Win_free(&win);
+    }
+    if (leader_comm != MPI_COMM_NULL) {
+      MPI_Comm_free(&leader_comm);
+    }
+    if (local_comm != MPI_COMM_NULL) {
+      MPI_Comm_free(&local_comm);
+    }
+  }
+
+  /** Make shared-memory writes visible to all local processes. */
+  void node_sync() const
+  {
+    MPI_Win_sync(win);
+    MPI_Barrier(local_comm);
+    MPI_Win_sync(win);
+  }
+
+  /** Chunk buffer of a local process. */
+  template <typename T>
+  T* buffer(int rank, El::Int chunk) const
+  {
+    return reinterpret_cast<T*>(segments[rank] +
+                                (chunk % 2) * shm_allreduce_chunk_bytes);
+  }
+};
+
+lbann_comm::shm_allreduce_context&
+lbann_comm::get_shm_allreduce_context(const El::mpi::Comm& c) const
+{
+  const auto comm = c.GetMPIComm();
+  void* attr = nullptr;
+  int found = 0;
+  checkMPI(MPI_Comm_get_attr(comm, m_shm_allreduce_keyval, &attr, &found));
+  if (found) {
+    return *static_cast<shm_allreduce_context*>(attr);
+  }
+
+  // Split communicator into compute nodes and node leaders
+  auto ctx = std::make_unique<shm_allreduce_context>();
+  const int rank = El::mpi::Rank(c);
+  checkMPI(MPI_Comm_split_type(comm,
+                               MPI_COMM_TYPE_SHARED,
+                               rank,
+                               MPI_INFO_NULL,
+                               &ctx->local_comm));
+  checkMPI(MPI_Comm_rank(ctx->local_comm, &ctx->local_rank));
+  checkMPI(MPI_Comm_size(ctx->local_comm, &ctx->local_size));
+  checkMPI(MPI_Comm_split(comm,
+                          ctx->local_rank == 0 ? 0 : MPI_UNDEFINED,
+                          rank,
+                          &ctx->leader_comm));
+  if (ctx->leader_comm != MPI_COMM_NULL) {
+    checkMPI(MPI_Comm_size(ctx->leader_comm, &ctx->num_leaders));
+  }
+
+  // Allocate shared-memory segments
+  unsigned char* base = nullptr;
+  checkMPI(MPI_Win_allocate_shared(2 * shm_allreduce_chunk_bytes,
+                                   1,
+                                   MPI_INFO_NULL,
+                                   ctx->local_comm,
+                                   &base,
+                                   &ctx->win));
+  ctx->segments.resize(ctx->local_size);
+  for (int r = 0; r < ctx->local_size; ++r) {
+    MPI_Aint size;
+    int disp_unit;
+    void* ptr;
+    checkMPI(MPI_Win_shared_query(ctx->win, r, &size, &disp_unit, &ptr));
+    ctx->segments[r] = static_cast<unsigned char*>(ptr);
+  }
+  checkMPI(MPI_Win_lock_all(MPI_MODE_NOCHECK, ctx->win));
+
+  // The communicator owns the state from here on
+  checkMPI(MPI_Comm_set_attr(comm, m_shm_allreduce_keyval, ctx.get()));
+  return *ctx.release();
+}
+
+void lbann_comm::release_shm_allreduce_context(const El::mpi::Comm& c) const
+{
+  const auto comm = c.GetMPIComm();
+  if (comm == MPI_COMM_NULL) {
+    return;
+  }
+  void* attr = nullptr;
+  int found = 0;
+  checkMPI(MPI_Comm_get_attr(comm, m_shm_allreduce_keyval, &attr, &found));
+  if (found) {
+    checkMPI(MPI_Comm_delete_attr(comm, m_shm_allreduce_keyval));
+  }
+}
+
+int lbann_comm::delete_shm_allreduce_context(MPI_Comm /*comm*/,
+                                             int /*keyval*/,
+                                             void* attr,
+                                             void* /*extra_state*/)
+{
+  delete static_cast<shm_allreduce_context*>(attr);
+  return MPI_SUCCESS;
+}
+
+template <typename T>
+void lbann_comm::shm_allreduce(T* data,
+                               El::Int count,
+                               const El::mpi::Comm& c,
+                               El::mpi::Op op) const
+{
+  LBANN_TRACE_SCOPE("comm", "shm_allreduce");
+  const auto& ctx = get_shm_allreduce_context(c);
+  const auto type = El::mpi::TypeMap<T>();
+  const El::Int chunk_size = shm_allreduce_chunk_bytes / sizeof(T);
+  const El::Int num_chunks = (count + chunk_size - 1) / chunk_size;
+  const bool internode = (ctx.leader_comm != MPI_COMM_NULL
+                          && ctx.num_leaders > 1);
+
+  // Wait for inter-node reduction of a chunk and read it back
+  MPI_Request internode_req = MPI_REQUEST_NULL;
+  auto finish_chunk = [&](El::Int chunk) {
+    if (internode) {
+      MPI_Wait(&internode_req, MPI_STATUS_IGNORE);
+    }
+    ctx.node_sync();
+    const El::Int offset = chunk * chunk_size;
+    const El::Int size = std::min(chunk_size, count - offset);
+    std::copy_n(ctx.buffer<T>(0, chunk), size, data + offset);
+    // Chunk buffers are reused two chunks later
+    ctx.node_sync();
+  };
+
+  for (El::Int chunk = 0; chunk < num_chunks; ++chunk) {
+    const El::Int offset = chunk * chunk_size;
+    const El::Int size = std::min(chunk_size, count - offset);
+
+    // Stage local contribution in shared memory
+    std::copy_n(data + offset, size, ctx.buffer<T>(ctx.local_rank, chunk));
+    ctx.node_sync();
+
+    // Each local process reduces a slice of the chunk into the
+    // leader's buffer
+    const El::Int slice_size = (size + ctx.local_size - 1) / ctx.local_size;
+    const El::Int slice_begin = std::min(size, ctx.local_rank * slice_size);
+    const El::Int slice_end = std::min(size, slice_begin + slice_size);
+    if (slice_end > slice_begin) {
+      auto* dst = ctx.buffer<T>(0, chunk) + slice_begin;
+      for (int r = 1; r < ctx.local_size; ++r) {
+        checkMPI(MPI_Reduce_local(ctx.buffer<T>(r, chunk) + slice_begin,
+                                  dst,
+                                  slice_end - slice_begin,
+                                  type,
+                                  op.op));
+      }
+    }
+    ctx.node_sync();
+
+    // Node leaders reduce the chunk across nodes while the next chunk
+    // is reduced within the node
+    if (chunk > 0) {
+      finish_chunk(chunk - 1);
+    }
+    if (internode) {
+      checkMPI(MPI_Iallreduce(MPI_IN_PLACE,
+                              ctx.buffer<T>(0, chunk),
+                              size,
+                              type,
+                              op.op,
+                              ctx.leader_comm,
+                              &internode_req));
+    }
+  }
+  if (num_chunks > 0) {
+    finish_chunk(num_chunks - 1);
+  }
+}
+
+template <typename T>
+void lbann_comm::shm_allreduce(El::Matrix<T, El::Device::CPU>& m,
+                               const El::mpi::Comm& c,
+                               El::mpi::Op op) const
+{
+  const El::Int height = m.Height();
+  const El::Int width = m.Width();
+  if (height == m.LDim() || width == 1) {
+    return shm_allreduce(m.Buffer(), height * width, c, op);
+  }
+  El::Matrix<T, El::Device::CPU> staging;
+  El::Copy(m, staging);
+  shm_allreduce(staging.Buffer(), height * width, c, op);
+  El::Copy(staging, m);
+}
+
 template <typename TensorDataType>
 void lbann_comm::allreduce(El::AbstractMatrix<TensorDataType>& m,
                            const El::mpi::Comm& c,
@@ -488,6 +732,16 @@ void lbann_comm::allreduce(El::AbstractMatrix<TensorDataType>& m,
 
   switch (m.GetDevice()) {
   case El::Device::CPU:
+    if constexpr (is_shm_allreduce_type<TensorDataType>) {
+      // Note: The choice of path must not depend on the local layout,
+      // since the shared-memory allreduce is collective.
+      if (m_hierarchical_allreduce) {
+        return shm_allreduce(
+          static_cast<El::Matrix<TensorDataType, El::Device::CPU>&>(m),
+          c,
+          op);
+      }
+    }
     return allreduce_impl(
       static_cast<El::Matrix<TensorDataType, El::Device::CPU>&>(m),
       c,
@@ -526,6 +780,16 @@ void lbann_comm::nb_allreduce(El::AbstractMatrix<TensorDataType>& m,
 
   switch (m.GetDevice()) {
   case El::Device::CPU:
+    if constexpr (is_shm_allreduce_type<TensorDataType>) {
+      // Note: The choice of path must not depend on the local layout,
+      // since the shared-memory allreduce is collective.
+      if (m_hierarchical_allreduce) {
+        return shm_allreduce(
+          static_cast<El::Matrix<TensorDataType, El::Device::CPU>&>(m),
+          c,
+          op);
+      }
+    }
     return nb_allreduce_impl(
       static_cast<El::Matrix<TensorDataType, El::Device::CPU>&>(m),
       c,
@@ -551,8 +815,73 @@ void lbann_comm::nb_allreduce(El::AbstractDistMatrix<TensorDataType>& m,
   nb_allreduce(m.Matrix(), c, req, op);
 }
 
+template <typename TensorDataType>
+void lbann_comm::nb_reduce_scatter(
+  const El::AbstractMatrix<TensorDataType>& send,
+  El::AbstractMatrix<TensorDataType>& recv,
+  const std::vector<int>& recv_counts,
+  const El::mpi::Comm& c,
+  Al::request& req) const
+{
+  const int rank = El::mpi::Rank(c);
+  const int num_procs = El::mpi::Size(c);
+  if (recv_counts.size() != static_cast<size_t>(num_procs)) {
+    LBANN_ERROR("reduce-scatter over ",
+                num_procs,
+                " processes got ",
+                recv_counts.size(),
+                " receive counts");
+  }
+  const El::Int total_count =
+    std::accumulate(recv_counts.begin(), recv_counts.end(), El::Int{0});
+  if (send.Height() * send.Width() != total_count
+      || recv.Height() * recv.Width() < recv_counts[rank]) {
+    LBANN_ERROR("reduce-scatter buffers do not match receive counts");
+  }
+  if ((send.Width() > 1 && send.Height() != send.LDim())
+      || (recv.Width() > 1 && recv.Height() != recv.LDim())) {
+    LBANN_ERROR("reduce-scatter requires contiguous buffers");
+  }
+  if (send.GetDevice() != recv.GetDevice()) {
+    LBANN_ERROR("reduce-scatter buffers are on different devices");
+  }
+
+  m_bytes_sent += sizeof(TensorDataType) * (total_count - recv_counts[rank]);
+  m_bytes_received +=
+    sizeof(TensorDataType) * recv_counts[rank] * (num_procs - 1);
+
+  switch (send.GetDevice()) {
+  case El::Device::CPU: {
+    const El::mpi::Op op = El::mpi::SUM;
+    MPI_Ireduce_scatter(send.LockedBuffer(),
+                        recv.Buffer(),
+                        recv_counts.data(),
+                        El::mpi::TypeMap<TensorDataType>(),
+                        op.op,
+                        c.GetMPIComm(),
+                        &(req.raw_mpi_req));
+    break;
+  }
+#ifdef LBANN_HAS_GPU
+  case El::Device::GPU: {
+    auto& recv_gpu =
+      static_cast<El::Matrix<TensorDataType, El::Device::GPU>&>(recv);
+    El::mpi::ReduceScatter(send.LockedBuffer(),
+                           recv.Buffer(),
+                           recv_counts.data(),
+                           c,
+                           El::SyncInfoFromMatrix(recv_gpu));
+    break;
+  }
+#endif // LBANN_HAS_GPU
+  default:
+    LBANN_ERROR("invalid device");
+  }
+}
+
 void lbann_comm::wait(Al::request& req) const
 {
+  LBANN_TRACE_SCOPE("comm", "wait");
 #ifdef LBANN_HAS_ALUMINUM
   if (req.mpi_req != Al::mpi_null_req) {
     ::Al::Wait<::Al::MPIBackend>(req.mpi_req);
@@ -639,7 +968,11 @@ void lbann_comm::global_barrier() const
   barrier(get_world_comm());
 }
 
-void lbann_comm::barrier(const El::mpi::Comm& c) const { El::mpi::Barrier(c); }
+void lbann_comm::barrier(const El::mpi::Comm& c) const
+{
+  LBANN_TRACE_SCOPE("comm", "barrier");
+  El::mpi::Barrier(c);
+}
 
 void lbann_comm::send(const AbsMat& mat,
                       const int trainer,
@@ -867,7 +1200,13 @@ int get_rank_in_world()
   template void lbann_comm::nb_allreduce(El::AbstractDistMatrix<T>& m,         \
                                          const El::mpi::Comm& c,               \
                                          Al::request& req,                     \
-                                         El::mpi::Op op) const
+                                         El::mpi::Op op) const;                \
+  template void lbann_comm::nb_reduce_scatter(                                 \
+    const El::AbstractMatrix<T>& send,                                         \
+    El::AbstractMatrix<T>& recv,                                               \
+    const std::vector<int>& recv_counts,                                       \
+    const El::mpi::Comm& c,                                                    \
+    Al::request& req) const
 
 #define LBANN_INSTANTIATE_CPU_HALF
 #define LBANN_INSTANTIATE_GPU_HALF
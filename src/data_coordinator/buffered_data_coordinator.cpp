@@ -37,6 +37,7 @@
 #include "lbann/utils/distconv.hpp"
 #include "lbann/utils/serialize.hpp"
 #include "lbann/utils/tensor_impl.hpp"
+#include "lbann/utils/tracer.hpp"
 #include "lbann/io/persist_impl.hpp"
 
 namespace lbann {
@@ -190,6 +191,7 @@ void buffered_data_coordinator<TensorDataType>::fp_setup_data(data_buffer<IOData
 
 template <typename TensorDataType>
 void buffered_data_coordinator<TensorDataType>::fetch_data_in_background(int future_active_buffer, execution_mode mode) {
+  LBANN_TRACE_SCOPE("io", "fetch_data_in_background");
   int active_buffer_idx = future_active_buffer % m_data_buffers.size();
   data_buffer_map_t& buffer_map = m_data_buffers[active_buffer_idx];
   std::lock_guard<std::mutex> guard(dr_mutex);
@@ -202,6 +204,7 @@ void buffered_data_coordinator<TensorDataType>::fetch_data_in_background(int fut
 /// Check for each buffer if there is an outstanding fetch request
 template <typename TensorDataType>
 void buffered_data_coordinator<TensorDataType>::collect_background_data_fetch(execution_mode mode) {
+  LBANN_TRACE_SCOPE("io", "collect_background_data_fetch");
   for(auto& buffer_map : m_data_buffers) {
     typename data_buffer_map_t::const_iterator it = buffer_map.find(mode);
     if (it != buffer_map.end()) {
@@ -216,6 +219,7 @@ void buffered_data_coordinator<TensorDataType>::collect_background_data_fetch(ex
 
 template <typename TensorDataType>
 void buffered_data_coordinator<TensorDataType>::fetch_data(execution_mode mode) {
+  LBANN_TRACE_SCOPE("io", "fetch_data");
 
   increment_active_buffer_idx(mode);
 
@@ -359,6 +363,7 @@ void buffered_data_coordinator<TensorDataType>::distribute_from_local_matrix(
   data_field_type const data_field,
   AbsDistMatrixType& input_buffer)
 {
+  LBANN_TRACE_SCOPE("io", "distribute_from_local_matrix");
   prof_region_begin("distribute_from_local_matrix", prof_colors[3], false);
   data_buffer<IODataType>& buf = get_active_buffer(mode);
   if (buf.m_input_buffers.find(data_field) == buf.m_input_buffers.end()) {
@@ -36,6 +36,7 @@
 #include "lbann/utils/serialize.hpp"
 #include "lbann/utils/threads/thread_pool.hpp"
 #include "lbann/utils/timer.hpp"
+#include "lbann/utils/tracer.hpp"
 
 #include "conduit/conduit_node.hpp"
 
@@ -299,6 +300,7 @@ bool lbann::generic_data_reader::fetch_data_block(
   El::Int mb_size,
   El::Matrix<El::Int>& indices_fetched)
 {
+  LBANN_TRACE_SCOPE("io", "fetch_data_block");
   locked_io_rng_ref io_rng = set_io_generators_local_index(block_offset);
 
   //  CPUMat& X
@@ -377,6 +379,7 @@ bool lbann::generic_data_reader::fetch_data_block_conduit(
   El::Int mb_size,
   El::Matrix<El::Int>& indices_fetched)
 {
+  LBANN_TRACE_SCOPE("io", "fetch_data_block_conduit");
   locked_io_rng_ref io_rng = set_io_generators_local_index(block_offset);
 
   if (static_cast<size_t>(mb_size) > samples.size()) {
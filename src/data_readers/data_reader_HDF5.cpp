@@ -35,83 +35,33 @@
 namespace lbann {
 namespace {
 
-/** @brief Copy a floating point array into a new floating point array.
- *  @tparam ToType The new data type.
- *  @tparam FromType (Inferred) The old data type.
- *  @param data_in The type of the input data.
- *  @param num_elements The number of elements in the input array.
- *  @returns A clean copy of the input data with a new type.
+/** @brief Convert, normalize, and optionally repack from HWC to CHW,
+ *  in one pass.
+ *  @param scale Per-channel scale; no normalization if empty.
  */
 template <typename ToType, typename FromType>
-std::vector<ToType> do_coerce(FromType const* const data_in,
-                              size_t const num_elements)
-{
-  return std::vector<ToType>{data_in, data_in + num_elements};
-}
-
-template <typename T>
-void do_normalize(T* const data,
-                  double const scale,
-                  double const bias,
-                  size_t const n_elts)
-{
-  std::for_each(data, data + n_elts, [scale, bias](auto& x) {
-    x = x * scale + bias;
-  });
-}
-
-template <typename T>
-void do_normalize(T* const data,
-                  const double* scale,
-                  const double* bias,
-                  size_t const n_elts,
-                  size_t const n_channels)
-{
-  size_t const n_elts_per_channel = n_elts / n_channels;
-  for (size_t j = 0; j < n_elts_per_channel; j++) {
-    for (size_t k = 0; k < n_channels; k++) {
-      size_t const idx = j * n_channels + k;
-      data[idx] = (data[idx] * scale[k] + bias[k]);
-    }
-  }
-}
-
-template <typename T>
-void do_repack_image(T* const src_buf,
-                     size_t const n_elts,
-                     size_t const n_rows,
-                     size_t const n_cols,
-                     int const n_channels)
-{
-  size_t const size = n_rows * n_cols;
-  std::vector<T> work;
-  work.reserve(n_elts);
-  T* const dst_buf = work.data();
-  for (size_t row = 0; row < n_rows; ++row) {
-    for (size_t col = 0; col < n_cols; ++col) {
-      int N = n_channels;
-      // Multiply by N because there are N channels.
-      const size_t src_base = N * (row + col * n_rows);
-      const size_t dst_base = row + col * n_rows;
-      switch (N) {
-      case 4:
-        dst_buf[dst_base + 3 * size] = src_buf[src_base + 3];
-        [[fallthrough]];
-      case 3:
-        dst_buf[dst_base + 2 * size] = src_buf[src_base + 2];
-        [[fallthrough]];
-      case 2:
-        dst_buf[dst_base + size] = src_buf[src_base + 1];
-        [[fallthrough]];
-      case 1:
-        dst_buf[dst_base] = src_buf[src_base];
-        break;
-      default:
-        LBANN_ERROR("Unsupported number of channels");
+void do_convert(FromType const* const src,
+                ToType* const dst,
+                size_t const n_elts,
+                std::vector<double> const& scale,
+                std::vector<double> const& bias,
+                size_t const n_channels,
+                bool const repack)
+{
+  size_t const n_pixels = n_elts / n_channels;
+  bool const normalize = !scale.empty();
+  for (size_t p = 0; p < n_pixels; ++p) {
+    for (size_t k = 0; k < n_channels; ++k) {
+      size_t const src_idx = p * n_channels + k;
+      size_t const dst_idx = repack ? k * n_pixels + p : src_idx;
+      if (normalize) {
+        dst[dst_idx] = static_cast<ToType>(src[src_idx] * scale[k] + bias[k]);
+      }
+      else {
+        dst[dst_idx] = static_cast<ToType>(src[src_idx]);
       }
     }
   }
-  std::copy_n(dst_buf, n_elts, src_buf);
 }
 
 } // namespace
@@ -198,6 +148,7 @@ void hdf5_data_reader::copy_members(const hdf5_data_reader& rhs)
   m_experiment_schema = rhs.m_experiment_schema;
   m_data_schema = rhs.m_data_schema;
   m_useme_node_map = rhs.m_useme_node_map;
+  m_field_plans = rhs.m_field_plans;
   // m_data_map should not be copied, as it contains pointers, and is only
   // needed for setting up other structures during load
 
@@ -332,68 +283,184 @@ void hdf5_data_reader::load_sample(conduit::Node& node,
                                    bool ignore_failure)
 {
   auto [file_handle,sample_name] = data_reader_sample_list::open_file(index);
-  // load data for the field names specified in the user's experiment-schema
-  for (auto& [pathname, path_node] : m_useme_node_map) {
-    // do not load a "packed" field, as it doesn't exist on disk!
-    if (!is_composite_node(path_node)) {
+  const std::string sample_prefix = "/" + sample_name + "/";
+  const std::string index_prefix = LBANN_DATA_ID_STR(index) + '/';
 
-      // check that the requested data (pathname) exists on disk
-      const std::string original_path = "/" + sample_name + "/" + pathname;
-      if (!conduit::relay::io::hdf5_has_path(file_handle, original_path)) {
-        if (ignore_failure) {
-          continue;
-        }
-        LBANN_ERROR("hdf5_has_path failed for path: ", original_path);
+  // load data for the field names specified in the user's experiment-schema
+  // note: a missing path is detected by the read itself, rather than
+  // by querying the file for every field of every sample
+  for (const auto& plan : m_field_plans) {
+    const std::string original_path = sample_prefix + plan.path;
+    const std::string new_pathname = index_prefix + plan.path;
+    try {
+      read_field(file_handle, original_path, plan, node[new_pathname]);
+    }
+    catch (conduit::Error const& e) {
+      if (ignore_failure) {
+        node.remove(new_pathname);
+        continue;
       }
+      LBANN_ERROR("failed to read path: ", original_path, "; ", e.what());
+    }
+  }
 
-      // get the new path-name (prepend the index)
-      std::ostringstream ss2;
-      ss2 << LBANN_DATA_ID_STR(index) << '/' << pathname;
-      const std::string new_pathname(ss2.str());
+  pack(node, index);
+}
 
-      // note: this will throw an exception if the child node doesn't exist
-      const conduit::Node& metadata = path_node.child(s_metadata_node_name);
+void hdf5_data_reader::read_field(hid_t file_handle,
+                                  const std::string& original_path,
+                                  const FieldPlan& plan,
+                                  conduit::Node& node) const
+{
+  // Read directly into the output node if no processing is needed
+  const bool normalize = !plan.scale.empty();
+  if (plan.coerce_to == conduit::DataType::EMPTY_ID && !normalize &&
+      !plan.repack) {
+    conduit::relay::io::hdf5_read(file_handle, original_path, node);
+    return;
+  }
+
+  // Read into a reusable buffer
+  thread_local conduit::Node tmp;
+  conduit::relay::io::hdf5_read(file_handle, original_path, tmp);
+  const size_t n_elts = tmp.dtype().number_of_elements();
+  const auto from_id = tmp.dtype().id();
+  if (from_id != conduit::DataType::FLOAT32_ID &&
+      from_id != conduit::DataType::FLOAT64_ID) {
+    LBANN_ERROR("Only float and double are currently supported for "
+                "coercion, normalization, and image repacking; ",
+                original_path,
+                " has type ",
+                tmp.dtype().name());
+  }
+  if (n_elts % plan.n_channels != 0) {
+    LBANN_ERROR(original_path,
+                " has ",
+                n_elts,
+                " entries, which is not divisible by the number of channels (",
+                plan.n_channels,
+                ")");
+  }
+
+  // Convert into the output node
+  const auto to_id = (plan.coerce_to == conduit::DataType::EMPTY_ID
+                        ? from_id
+                        : plan.coerce_to);
+  node.set(conduit::DataType(to_id, n_elts));
+  const auto convert = [&](auto const* src) {
+    if (to_id == conduit::DataType::FLOAT32_ID) {
+      do_convert(src, node.as_float32_ptr(), n_elts,
+                 plan.scale, plan.bias, plan.n_channels, plan.repack);
+    }
+    else {
+      do_convert(src, node.as_float64_ptr(), n_elts,
+                 plan.scale, plan.bias, plan.n_channels, plan.repack);
+    }
+  };
+  if (from_id == conduit::DataType::FLOAT32_ID) {
+    convert(tmp.as_float32_ptr());
+  }
+  else {
+    convert(tmp.as_float64_ptr());
+  }
+}
 
-      // optionally coerce the data, e.g, from double to float, per settings
-      // in the experiment_schema
-      if (metadata.has_child(s_coerce_name)) {
-        coerce(metadata, file_handle, original_path, new_pathname, node);
+void hdf5_data_reader::build_field_plans()
+{
+  m_field_plans.clear();
+  for (const auto& [pathname, path_node] : m_useme_node_map) {
+    // do not load a "packed" field, as it doesn't exist on disk!
+    if (is_composite_node(path_node)) {
+      continue;
+    }
+    const conduit::Node& metadata = path_node.child(s_metadata_node_name);
+    FieldPlan plan;
+    plan.path = pathname;
+
+    // optionally coerce the data, e.g, from double to float, per settings
+    // in the experiment_schema
+    if (metadata.has_child(s_coerce_name)) {
+      // conduit includes quotes around the string, so strip them off
+      const std::string& cc = metadata[s_coerce_name].to_string();
+      const std::string& coerce_to = cc.substr(1, cc.size() - 2);
+      if (coerce_to == "float") {
+        plan.coerce_to = conduit::DataType::FLOAT32_ID;
+      }
+      else if (coerce_to == "double") {
+        plan.coerce_to = conduit::DataType::FLOAT64_ID;
       }
       else {
-        conduit::relay::io::hdf5_read(file_handle,
-                                      original_path,
-                                      node[new_pathname]);
+        LBANN_ERROR("Un-implemented type requested for coercion: ",
+                    coerce_to,
+                    "; you need to update the data reader to support this");
       }
+    }
 
-      // optionally normalize
-      if (metadata.has_child("scale")) {
-        normalize(node, new_pathname, metadata);
+    // multi-channel images are interleaved (HWC) on disk
+    if (metadata.has_child("channels")) {
+      plan.n_channels = metadata["channels"].to_int64();
+      if (plan.n_channels > 1) {
+        if (!metadata.has_child("hwc")) {
+          LBANN_ERROR("we only currently know how to deal with HWC input "
+                      "images; field: ",
+                      pathname);
+        }
+        if (!metadata.has_child("dims")) {
+          LBANN_ERROR("your metadata is missing 'dims' for an image; field: ",
+                      pathname);
+        }
+        plan.repack = true;
       }
+    }
 
-      // for images
-      if (metadata.has_child("channels") &&
-          metadata["channels"].as_int64() > 1) {
-        repack_image(node, new_pathname, metadata);
+    // optionally normalize
+    if (metadata.has_child("scale")) {
+      if (metadata.has_child("channels")) {
+        const conduit::Node& scale = metadata["scale"];
+        if (scale.dtype().number_of_elements() != conduit::index_t(plan.n_channels)) {
+          LBANN_ERROR("field ",
+                      pathname,
+                      " has ",
+                      plan.n_channels,
+                      " channels, but ",
+                      scale.dtype().number_of_elements(),
+                      " scale values");
+        }
+        const double* scale_ptr = scale.as_double_ptr();
+        plan.scale.assign(scale_ptr, scale_ptr + plan.n_channels);
+        plan.bias.assign(plan.n_channels, 0.);
+        if (metadata.has_child("bias")) {
+          const double* bias_ptr = metadata["bias"].as_double_ptr();
+          plan.bias.assign(bias_ptr, bias_ptr + plan.n_channels);
+        }
+      }
+      else {
+        plan.scale.assign(1, metadata["scale"].to_float64());
+        plan.bias.assign(1, 0.);
+        if (metadata.has_child("bias")) {
+          plan.bias[0] = metadata["bias"].to_float64();
+        }
       }
     }
-  }
 
-  pack(node, index);
+    m_field_plans.emplace_back(std::move(plan));
+  }
 }
 
 void hdf5_data_reader::normalize(conduit::Node& node,
                                  const std::string& path,
                                  const conduit::Node& metadata)
 {
-  void* vals = node[path].element_ptr(0);
   size_t n_elements = node[path].dtype().number_of_elements();
+  std::vector<double> scale, bias;
+  size_t n_channels = 1;
 
   // treat this as a multi-channel image
   if (metadata.has_child("channels")) {
 
     // get number of channels, with sanity checking
-    int64_t n_channels = metadata["channels"].value();
-    int sanity = metadata["scale"].dtype().number_of_elements();
+    n_channels = metadata["channels"].to_int64();
+    size_t sanity = metadata["scale"].dtype().number_of_elements();
     if (sanity != n_channels) {
       LBANN_ERROR("sanity: ",
                   sanity,
@@ -409,48 +476,37 @@ void hdf5_data_reader::normalize(conduit::Node& node,
     }
 
     // get the scale and bias arrays
-    const double* scale = metadata["scale"].as_double_ptr();
-    std::vector<double> b(n_channels, 0);
-    const double* bias = b.data();
+    const double* scale_ptr = metadata["scale"].as_double_ptr();
+    scale.assign(scale_ptr, scale_ptr + n_channels);
+    bias.assign(n_channels, 0.);
     if (metadata.has_child("bias")) {
-      bias = metadata["bias"].as_double_ptr();
-    }
-
-    // perform the normalization
-    if (node[path].dtype().is_float32()) {
-      float* data = reinterpret_cast<float*>(vals);
-      do_normalize(data, scale, bias, n_elements, n_channels);
-    }
-    else if (node[path].dtype().is_float64()) {
-      double* data = reinterpret_cast<double*>(vals);
-      do_normalize(data, scale, bias, n_elements, n_channels);
-    }
-    else {
-      LBANN_ERROR(
-        "Only float and double are currently supported for normalization");
+      const double* bias_ptr = metadata["bias"].as_double_ptr();
+      bias.assign(bias_ptr, bias_ptr + n_channels);
     }
   }
 
   // 1D case
   else {
-    double scale = metadata["scale"].value();
-    double bias = 0;
+    scale.assign(1, metadata["scale"].to_float64());
+    bias.assign(1, 0.);
     if (metadata.has_child("bias")) {
-      bias = metadata["bias"].value();
+      bias[0] = metadata["bias"].to_float64();
     }
+  }
 
-    if (node[path].dtype().is_float32()) {
-      float* data = reinterpret_cast<float*>(vals);
-      do_normalize(data, scale, bias, n_elements);
-    }
-    else if (node[path].dtype().is_float64()) {
-      double* data = reinterpret_cast<double*>(vals);
-      do_normalize(data, scale, bias, n_elements);
-    }
-    else {
-      LBANN_ERROR(
-        "Only float and double are currently supported for normalization");
-    }
+  // perform the normalization in place, with the same kernel as
+  // read_field
+  if (node[path].dtype().is_float32()) {
+    float* data = node[path].as_float32_ptr();
+    do_convert(data, data, n_elements, scale, bias, n_channels, false);
+  }
+  else if (node[path].dtype().is_float64()) {
+    double* data = node[path].as_float64_ptr();
+    do_convert(data, data, n_elements, scale, bias, n_channels, false);
+  }
+  else {
+    LBANN_ERROR(
+      "Only float and double are currently supported for normalization");
   }
 }
 
@@ -502,6 +558,7 @@ void hdf5_data_reader::parse_schemas()
   }
 
   construct_linearized_size_lookup_tables();
+  build_field_plans();
 }
 
 // recursive
@@ -728,53 +785,6 @@ void hdf5_data_reader::adjust_metadata(conduit::Node* node)
   }
 }
 
-void hdf5_data_reader::coerce(const conduit::Node& metadata,
-                              hid_t file_handle,
-                              const std::string& original_path,
-                              const std::string& new_pathname,
-                              conduit::Node& node)
-{
-  conduit::Node tmp;
-  conduit::relay::io::hdf5_read(file_handle, original_path, tmp);
-
-  // yay! I finally get to use a void*
-  void* vals = tmp.element_ptr(0);
-  size_t num_elements = tmp.dtype().number_of_elements();
-
-  // get data type for data from disk
-  bool from_is_float = tmp.dtype().is_float32();
-  bool from_is_double = tmp.dtype().is_float64();
-  if (!(from_is_float || from_is_double)) {
-    LBANN_ERROR(
-      "source data is not float or data; please update the data reader");
-  }
-
-  // I don't know why, but conduit includes quotes around the string,
-  // even when they're not in the json file -- so need to strip them off
-  const std::string& cc = metadata[s_coerce_name].to_string();
-  const std::string& coerce_to = cc.substr(1, cc.size() - 2);
-
-  // this is just ugly, but I don't know how to make it better; would
-  // like to have a single call to do_coerce<>
-  if (coerce_to == "float") {
-    node[new_pathname] =
-      (from_is_float
-         ? do_coerce<float>(reinterpret_cast<float*>(vals), num_elements)
-         : do_coerce<float>(reinterpret_cast<double*>(vals), num_elements));
-  }
-  else if (coerce_to == "double") {
-    node[new_pathname] =
-      (from_is_float
-         ? do_coerce<double>(reinterpret_cast<float*>(vals), num_elements)
-         : do_coerce<double>(reinterpret_cast<double*>(vals), num_elements));
-  }
-  else {
-    LBANN_ERROR("Un-implemented type requested for coercion: ",
-                coerce_to,
-                "; you need to update the data reader to support this");
-  }
-}
-
 void hdf5_data_reader::repack_image(conduit::Node& node,
                                     const std::string& path,
                                     const conduit::Node& metadata)
@@ -794,21 +804,28 @@ void hdf5_data_reader::repack_image(conduit::Node& node,
   }
   // ==== end: sanity checking
 
-  void* vals = node[path].element_ptr(0);
-  size_t n_bytes = node[path].dtype().number_of_elements() *
-                   node[path].dtype().element_bytes();
-  int64_t n_channels = metadata["channels"].value();
+  size_t n_elts = node[path].dtype().number_of_elements();
+  size_t n_channels = metadata["channels"].to_int64();
   const conduit::int64* dims = metadata["dims"].as_int64_ptr();
-  const int row_dim = dims[0];
-  const int col_dim = dims[1];
-
+  if (n_elts != static_cast<size_t>(dims[0] * dims[1]) * n_channels) {
+    LBANN_ERROR(path,
+                " has ",
+                n_elts,
+                " entries, but its dims and channels give ",
+                dims[0] * dims[1] * n_channels);
+  }
+
+  // repack from a copy, with the same kernel as read_field
+  const auto repack = [&](auto* data) {
+    using T = std::remove_pointer_t<decltype(data)>;
+    const std::vector<T> src(data, data + n_elts);
+    do_convert(src.data(), data, n_elts, {}, {}, n_channels, true);
+  };
   if (node[path].dtype().is_float32()) {
-    float* data = reinterpret_cast<float*>(vals);
-    do_repack_image(data, n_bytes, row_dim, col_dim, n_channels);
+    repack(node[path].as_float32_ptr());
   }
   else if (node[path].dtype().is_float64()) {
-    double* data = reinterpret_cast<double*>(vals);
-    do_repack_image(data, n_bytes, row_dim, col_dim, n_channels);
+    repack(node[path].as_float64_ptr());
   }
   else {
     LBANN_ERROR(
@@ -791,6 +791,36 @@ void data_reader_jag_conduit::preload_helper(const hid_t& h, const std::string &
   read_node(h, path, node[key2]);
 }
 
+std::string data_reader_jag_conduit::get_packed_field_path(int data_id, const variable_t t) {
+  return '/' + LBANN_DATA_ID_STR(data_id) + "/packed/" + to_string(t);
+}
+
+std::vector<data_reader_jag_conduit::variable_t>
+data_reader_jag_conduit::get_packed_variable_types() const {
+  std::vector<variable_t> types;
+  for (const auto& vars : {m_independent, m_dependent}) {
+    for (const auto t : vars) {
+      if (std::find(types.cbegin(), types.cend(), t) == types.cend()) {
+        types.push_back(t);
+      }
+    }
+  }
+  return types;
+}
+
+void data_reader_jag_conduit::pack_sample(int data_id, conduit::Node& sample, conduit::Node& packed) {
+  for (const auto t : get_packed_variable_types()) {
+    const size_t n = get_linearized_size(t);
+    conduit::Node& field = packed[get_packed_field_path(data_id, t)];
+    field.set(std::vector<DataType>(n));
+    DataType* buf = field.value();
+    // Reuse the regular fetch path so the packed values match the
+    // ones fetched from the raw fields exactly
+    CPUMat X(n, 1, buf, n);
+    fetch(X, data_id, sample, 0, 0, t, "preload");
+  }
+}
+
 void data_reader_jag_conduit::do_preload_data_store() {
   conduit::Node work;
   const std::string key; // key = "" is intentional
@@ -815,12 +845,16 @@ void data_reader_jag_conduit::do_preload_data_store() {
       auto h = m_sample_list.get_samples_file_handle(id);
       conduit::Node & node = m_data_store->get_empty_node(index);
 
-      preload_helper(h, sample_name, m_output_scalar_prefix, index, node);
-      preload_helper(h, sample_name, m_input_prefix, index, node);
+      // Read the raw fields, then keep only the packed selections in
+      // the data store
+      work.reset();
+      preload_helper(h, sample_name, m_output_scalar_prefix, index, work);
+      preload_helper(h, sample_name, m_input_prefix, index, work);
       for (auto t : m_emi_image_keys) {
         const std::string field_name = m_output_image_prefix + t;
-        preload_helper(h, sample_name, field_name, index, node);
+        preload_helper(h, sample_name, field_name, index, work);
       }
+      pack_sample(index, work, node);
       m_data_store->set_preloaded_conduit_node(index, node);
     } catch (conduit::Error const& e) {
       LBANN_ERROR(" :: trying to load the node " + std::to_string(index) + " with key " + key + " and got " + e.what());
@@ -1354,6 +1388,21 @@ data_reader_jag_conduit::create_datum_views(CPUMat& X, const std::vector<size_t>
 
 bool data_reader_jag_conduit::fetch(CPUMat& X, int data_id, conduit::Node& sample, int mb_idx, int tid,
   const data_reader_jag_conduit::variable_t vt, const std::string tag) {
+  // Preloaded samples are already packed in the layout of X
+  const std::string packed_path = get_packed_field_path(data_id, vt);
+  if (sample.has_path(packed_path)) {
+    const conduit::Node& field = sample[packed_path];
+    const size_t n = get_linearized_size(vt);
+    if (static_cast<size_t>(field.dtype().number_of_elements()) != n) {
+      LBANN_ERROR(_CN_, ":: fetch_", tag, "() : packed field ", packed_path,
+                  " has ", field.dtype().number_of_elements(),
+                  " entries, but expected ", n);
+    }
+    const DataType* buf = field.value();
+    std::copy(buf, buf + n, X.Buffer(0, mb_idx));
+    return true;
+  }
+
   switch (vt) {
     case JAG_Image: {
       const size_t num_images = get_num_img_srcs();
@@ -34,7 +34,9 @@
 #include <havoqgt/delegate_partitioned_graph.hpp>
 
 #include <algorithm>
+#include <cmath>
 #include <numeric>
+#include <unordered_set>
 
 namespace lbann {
 
@@ -92,6 +94,9 @@ node2vec_reader::node2vec_reader(
 
 node2vec_reader::~node2vec_reader() {
   // Deallocate objects in right order
+  if (m_pending_noise_distribution.valid()) {
+    m_pending_noise_distribution.wait();
+  }
   m_random_walker.reset();
   m_edge_weight_data.reset();
   m_distributed_database.reset();
@@ -130,46 +135,27 @@ bool node2vec_reader::fetch_data_block(
   // Acquire IO RNG objects
   const auto io_rng = set_io_generators_local_index(block_offset);
 
-  // Only run on first IO thread
-  if (block_offset != 0) { return true; }
-  const size_t mb_size_ = mb_size;
-
-  // Perform random walks and add to cache
-  auto walks = run_walker(mb_size, io_rng);
-  const auto max_cache_size = std::max(mb_size_, m_walks_cache.size());
-  for (auto& walk : walks) {
-    if (m_walks_cache.size() >= max_cache_size) {
-      m_walks_cache.pop_front();
-    }
-    m_walks_cache.emplace_back(std::move(walk));
-  }
-
-  // Recompute noise distribution if there are enough vertex visits
-  if (m_total_visit_count > 2*m_noise_visit_count) {
-    update_noise_distribution();
-  }
-
   // Populate output tensor with negative samples and walk
-  /// @todo Parallelize
-  for (size_t j=0; j<mb_size_; ++j) {
+  // Note: Walks and noise distribution are prepared in
+  // preprocess_data_source, so IO threads only read shared state.
+  const size_t num_local_vertices = m_local_vertex_global_indices.size();
+  std::unordered_set<size_t> walk_set;
+  for (El::Int j=block_offset; j<mb_size; j+=block_stride) {
     const auto& walk = m_walks_cache[j % m_walks_cache.size()];
 
     // Negative samples
     // Note: Make sure negative samples are not repeated or in the walk
-    std::unordered_set<size_t> walk_set(walk.begin(), walk.end());
+    walk_set.clear();
+    walk_set.insert(walk.begin(), walk.end());
     for (size_t i=0; i<m_num_negative_samples; ++i) {
       size_t global_index;
       do {
-        const auto local_index = std::distance(
-          m_local_vertex_noise_distribution.begin(),
-          std::lower_bound(
-            m_local_vertex_noise_distribution.begin(),
-            m_local_vertex_noise_distribution.end(),
-            random_uniform<double>(get_io_generator())));
+        const auto local_index = m_noise_distribution.sample(
+          random_uniform<double>(get_io_generator()));
         global_index = m_local_vertex_global_indices[local_index];
       } while (!walk_set.insert(global_index).second);
       X(i,j) = static_cast<float>(global_index);
-      if (walk_set.size() >= m_local_vertex_noise_distribution.size()) {
+      if (walk_set.size() >= num_local_vertices) {
         walk_set.clear();
       }
     }
@@ -184,6 +170,39 @@ bool node2vec_reader::fetch_data_block(
   return true;
 }
 
+void node2vec_reader::preprocess_data_source(int tid) {
+  if (tid != 0) { return; }
+
+  // Perform random walks and add to cache
+  const auto io_rng = set_io_generators_local_index(0);
+  const size_t mb_size = get_loaded_mini_batch_size();
+  auto walks = run_walker(mb_size, io_rng);
+  const auto max_cache_size = std::max(mb_size, m_walks_cache.size());
+  for (auto& walk : walks) {
+    if (m_walks_cache.size() >= max_cache_size) {
+      m_walks_cache.pop_front();
+    }
+    m_walks_cache.emplace_back(std::move(walk));
+  }
+
+  // Use noise distribution that was built during the previous
+  // mini-batch
+  if (m_pending_noise_distribution.valid()) {
+    m_noise_distribution = m_pending_noise_distribution.get();
+  }
+
+  // Rebuild noise distribution in the background if there are enough
+  // vertex visits
+  if (m_total_visit_count > 2*m_noise_visit_count) {
+    m_noise_visit_count = m_total_visit_count;
+    m_pending_noise_distribution = std::async(
+      std::launch::async,
+      &node2vec_reader::build_noise_distribution,
+      m_local_vertex_visit_counts);
+  }
+
+}
+
 bool node2vec_reader::fetch_label(CPUMat& Y, int data_id, int col) {
   return true;
 }
@@ -248,7 +267,15 @@ void node2vec_reader::load() {
   }
 
   // Compute noise distribution for negative sampling
-  update_noise_distribution();
+  if (m_pending_noise_distribution.valid()) {
+    m_pending_noise_distribution.wait();
+    m_pending_noise_distribution = {};
+  }
+  m_noise_distribution = build_noise_distribution(m_local_vertex_visit_counts);
+  m_total_visit_count = std::accumulate(m_local_vertex_visit_counts.begin(),
+                                        m_local_vertex_visit_counts.end(),
+                                        size_t{0});
+  m_noise_visit_count = m_total_visit_count;
 
   // Make sure walks cache has at least one walk
   const auto io_rng = set_io_generators_local_index(0);
@@ -317,32 +344,17 @@ std::vector<std::vector<size_t>> node2vec_reader::run_walker(
 
 }
 
-/// @todo Parallelize
-void node2vec_reader::update_noise_distribution() {
-
-  // Count number of times each local vertex has been visited
+alias_table node2vec_reader::build_noise_distribution(
+  const std::vector<size_t>& visit_counts) {
   // Note: Distribution is proportional to count^0.75
-  const size_t num_local_vertices = m_local_vertex_global_indices.size();
-  m_local_vertex_noise_distribution.resize(num_local_vertices);
-  m_noise_visit_count = 0;
-  for (size_t i=0; i<num_local_vertices; ++i) {
-    const auto& count = m_local_vertex_visit_counts[i];
-    m_local_vertex_noise_distribution[i] = std::pow(count, 0.75);
-    m_noise_visit_count += count;
-  }
-  m_total_visit_count = m_noise_visit_count;
-
-  // Compute CDF by computing cumsum and normalizing
-  /// @todo If numerical error becomes a problem, use Kahan summation
-  std::partial_sum(m_local_vertex_noise_distribution.begin(),
-                   m_local_vertex_noise_distribution.end(),
-                   m_local_vertex_noise_distribution.begin());
-  const double scale = 1. / m_local_vertex_noise_distribution.back();
-  std::transform(m_local_vertex_noise_distribution.begin(),
-                 m_local_vertex_noise_distribution.end(),
-                 m_local_vertex_noise_distribution.begin(),
-                 [&scale](const double& x) -> double { return scale*x; });
-
+  std::vector<double> weights(visit_counts.size());
+  std::transform(visit_counts.begin(),
+                 visit_counts.end(),
+                 weights.begin(),
+                 [](const size_t& count) -> double {
+                   return std::pow(count, 0.75);
+                 });
+  return alias_table(weights);
 }
 
 } // namespace lbann
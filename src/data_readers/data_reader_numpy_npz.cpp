@@ -28,10 +28,11 @@
 ////////////////////////////////////////////////////////////////////////////////
 
 #include "lbann/data_readers/data_reader_numpy_npz.hpp"
+#include "lbann/utils/argument_parser.hpp"
+#include "lbann/utils/options.hpp"
 #include <cstdio>
 #include <string>
 #include <unordered_set>
-#include <cnpy.h>
 
 namespace lbann {
   const std::string numpy_npz_reader::NPZ_KEY_DATA = "data";
@@ -44,30 +45,6 @@ namespace lbann {
       m_num_features(0),
       m_num_response_features(0) {}
 
-  numpy_npz_reader::numpy_npz_reader(const numpy_npz_reader& other) :
-    generic_data_reader(other),
-    m_num_samples(other.m_num_samples),
-    m_num_features(other.m_num_features),
-    m_num_labels(other.m_num_labels),
-    m_num_response_features(other.m_num_response_features),
-    m_data(other.m_data),
-    m_labels(other.m_labels),
-    m_responses(other.m_responses),
-    m_scaling_factor_int16(other.m_scaling_factor_int16) {}
-
-  numpy_npz_reader& numpy_npz_reader::operator=(const numpy_npz_reader& other) {
-    generic_data_reader::operator=(other);
-    m_num_samples = other.m_num_samples;
-    m_num_features = other.m_num_features;
-    m_num_labels = other.m_num_labels;
-    m_num_response_features = other.m_num_response_features;
-    m_data = other.m_data;
-    m_labels = other.m_labels;
-    m_responses = other.m_responses;
-    m_scaling_factor_int16 = other.m_scaling_factor_int16;
-    return *this;
-  }
-
   void numpy_npz_reader::load() {
     std::string infile = get_data_filename();
     // Ensure the file exists.
@@ -78,9 +55,14 @@ namespace lbann {
     }
     ifs.close();
 
-    const cnpy::npz_t npz = cnpy::npz_load(infile);
+    // Open the archive. Array data is read lazily.
+    auto& arg_parser = global_argument_parser();
+    m_npz = std::make_shared<npz_archive>(
+      infile,
+      arg_parser.get<size_t>(LBANN_OPTION_NPZ_CACHE_SIZE));
+    m_data = m_labels = m_responses = nullptr;
 
-    std::vector<std::tuple<const bool, const std::string, cnpy::NpyArray &> > npyLoadList;
+    std::vector<std::tuple<const bool, const std::string, const npz_array *&> > npyLoadList;
     npyLoadList.push_back(std::forward_as_tuple(true,            NPZ_KEY_DATA,      m_data));
     npyLoadList.push_back(
       std::forward_as_tuple(m_supported_input_types[INPUT_DATA_TYPE_LABELS],
@@ -96,12 +78,11 @@ namespace lbann {
         continue;
       }
 
-      // Load the tensor.
+      // Find the tensor.
       const std::string key = std::get<1>(npyLoad);
-      cnpy::NpyArray &ary = std::get<2>(npyLoad);
-      const auto i = npz.find(key);
-      if(i != npz.end()) {
-        ary = i->second;
+      const npz_array *&ary = std::get<2>(npyLoad);
+      if(m_npz->has_array(key)) {
+        ary = &m_npz->get_array(key);
       } else {
         throw lbann_exception(std::string{} + __FILE__ + " " + std::to_string(__LINE__) +
                               " numpy_npz_reader::load() - can't find npz key : " + key);
@@ -109,40 +90,36 @@ namespace lbann {
 
       // Check whether the labels/responses has the same number of samples.
       if(key == NPZ_KEY_DATA) {
-        m_num_samples = m_data.shape[0];
-      } else if(m_num_samples != (int) ary.shape[0]) {
+        m_num_samples = m_data->num_rows();
+      } else if(m_num_samples != (int) ary->num_rows()) {
         throw lbann_exception(std::string{} + __FILE__ + " " + std::to_string(__LINE__) +
                               " numpy_npz_reader::load() - the number of samples of data and " + key + " do not match : "
-                              + std::to_string(m_num_samples) + " vs. " + std::to_string(ary.shape[0]));
+                              + std::to_string(m_num_samples) + " vs. " + std::to_string(ary->num_rows()));
       }
     }
 
-    m_num_features = std::accumulate(m_data.shape.begin() + 1,
-                                     m_data.shape.end(),
-                                     (unsigned) 1,
-                                     std::multiplies<unsigned>());
+    m_num_features = m_data->row_size() / m_data->word_size();
     if (m_supported_input_types[INPUT_DATA_TYPE_RESPONSES]) {
-      m_num_response_features = std::accumulate(m_responses.shape.begin() + 1,
-                                                m_responses.shape.end(),
-                                                (unsigned) 1,
-                                                std::multiplies<unsigned>());
+      m_num_response_features = m_responses->row_size() / m_responses->word_size();
     }
 
     // Ensure we understand the word size.
-    if (!(m_data.word_size == 2 || m_data.word_size == 4 || m_data.word_size == 8)) {
-      throw lbann_exception("numpy_npz_reader: word size " + std::to_string(m_data.word_size) +
+    if (!(m_data->word_size() == 2 || m_data->word_size() == 4 || m_data->word_size() == 8)) {
+      throw lbann_exception("numpy_npz_reader: word size " + std::to_string(m_data->word_size()) +
                             " not supported");
     }
 
+    m_label_values.clear();
     if (m_supported_input_types[INPUT_DATA_TYPE_LABELS]) {
       // Determine number of label classes.
       std::unordered_set<int> label_classes;
-      if (m_labels.word_size != 4) {
+      if (m_labels->word_size() != 4) {
         throw lbann_exception("numpy_npz_reader: label numpy array should be in int32");
       }
-      int *data = m_labels.data<int>();
+      m_label_values.resize(m_num_samples);
+      m_labels->read_all(m_label_values.data());
       for (int i = 0; i < m_num_samples; ++i) {
-        label_classes.insert((int) data[i]);
+        label_classes.insert(m_label_values[i]);
       }
 
       // Sanity checks.
@@ -167,9 +144,15 @@ namespace lbann {
   bool numpy_npz_reader::fetch_datum(Mat& X, int data_id, int mb_idx) {
     Mat X_v = El::View(X, El::IR(0, X.Height()), El::IR(mb_idx, mb_idx+1));
 
-    if (m_data.word_size == 2) {
+    if (m_data->word_size() == 2) {
       // Convert int16 to DataType.
-      const short *data = m_data.data<short>() + data_id * m_num_features;
+      std::vector<short> buffer;
+      const short *data = static_cast<const short*>(m_data->row_ptr(data_id));
+      if (data == nullptr) {
+        buffer.resize(m_num_features);
+        m_data->read_rows(data_id, 1, buffer.data());
+        data = buffer.data();
+      }
       DataType *dest = X_v.Buffer();
 
       // OPTIMIZE
@@ -178,13 +161,8 @@ namespace lbann {
           dest[j] = data[j] * m_scaling_factor_int16;
 
     } else {
-      void *data = NULL;
-      if (m_data.word_size == 4) {
-        data = (void *) (m_data.data<float>() + data_id * m_num_features);
-      } else if (m_data.word_size == 8) {
-        data = (void *) (m_data.data<double>() + data_id * m_num_features);
-      }
-      std::memcpy(X_v.Buffer(), data, m_num_features * m_data.word_size);
+      // Copy directly from file (or decompression cache) into sample.
+      m_data->read_rows(data_id, 1, X_v.Buffer());
     }
     return true;
   }
@@ -193,7 +171,7 @@ namespace lbann {
     if (!m_supported_input_types[INPUT_DATA_TYPE_LABELS]) {
       throw lbann_exception("numpy_npz_reader: do not have labels");
     }
-    const int label = m_labels.data<int>()[data_id];
+    const int label = m_label_values[data_id];
     Y(label, mb_idx) = 1;
     return true;
   }
@@ -204,9 +182,15 @@ namespace lbann {
     }
 
     Mat Y_v = El::View(Y, El::IR(0, Y.Height()), El::IR(mb_idx, mb_idx + 1));
-    if(m_responses.word_size == 2) {
+    if(m_responses->word_size() == 2) {
       // Convert int16 to DataType.
-      const short *data = m_responses.data<short>() + data_id * m_num_response_features;
+      std::vector<short> buffer;
+      const short *data = static_cast<const short*>(m_responses->row_ptr(data_id));
+      if (data == nullptr) {
+        buffer.resize(m_num_response_features);
+        m_responses->read_rows(data_id, 1, buffer.data());
+        data = buffer.data();
+      }
       DataType *dest = Y_v.Buffer();
       // OPTIMIZE
       LBANN_OMP_PARALLEL_FOR
@@ -215,16 +199,7 @@ namespace lbann {
       return true;
     }
 
-    void *responses = NULL;
-    if (m_responses.word_size == 4) {
-      responses = (void *) (m_responses.data<float>()
-                            + data_id * m_num_response_features);
-    } else if (m_responses.word_size == 8) {
-      responses = (void *) (m_responses.data<double>()
-                            + data_id * m_num_response_features);
-    }
-    std::memcpy(Y_v.Buffer(), responses,
-                m_num_response_features * m_responses.word_size);
+    m_responses->read_rows(data_id, 1, Y_v.Buffer());
     return true;
   }
 
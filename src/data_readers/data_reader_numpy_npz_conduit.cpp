@@ -34,6 +34,9 @@
 #include "lbann/utils/timer.hpp"
 #include "lbann/trainers/trainer.hpp"
 #include "lbann/utils/lbann_library.hpp"
+#include "lbann/utils/argument_parser.hpp"
+#include "lbann/utils/npz_archive.hpp"
+#include "lbann/utils/options.hpp"
 
 namespace lbann {
 
@@ -431,73 +434,53 @@ void numpy_npz_conduit_reader::fill_in_metadata() {
 }
 
 void numpy_npz_conduit_reader::load_conduit_node(const std::string filename, int data_id, conduit::Node &output, bool reset) {
-
-  try {
-    if (reset) {
-      output.reset();
-    }
-
-    std::vector<size_t> shape;
-    std::map<std::string, cnpy::NpyArray> a = cnpy::npz_load(filename);
-
-    for (auto &&t : a) {
-      cnpy::NpyArray &b = t.second;
-      if (b.shape[0] != 1) {
-        LBANN_ERROR("lbann currently only supports one sample per npz file; this file appears to contain " + std::to_string(b.shape[0]) + " samples; (", filename);
-      }
-      output[LBANN_DATA_ID_STR(data_id) + "/" + t.first + "/word_size"] = b.word_size;
-      output[LBANN_DATA_ID_STR(data_id) + "/" + t.first + "/fortran_order"] = b.fortran_order;
-      output[LBANN_DATA_ID_STR(data_id) + "/" + t.first + "/num_vals"] = b.num_vals;
-      output[LBANN_DATA_ID_STR(data_id) + "/" + t.first + "/shape"] = b.shape;
-
-      if (b.data_holder->size() / b.word_size != b.num_vals) {
-        LBANN_ERROR("b.data_holder->size() / b.word_size (" + std::to_string(b.data_holder->size()) + " / " + std::to_string(b.word_size) + ") != b.num_vals (" + std::to_string(b.num_vals));
-      }
-
-      // conduit makes a copy of the data, hence owns the data, hence it
-      // will be properly deleted when then conduit::Node is deleted
-      char *data = b.data_holder->data();
-      output[LBANN_DATA_ID_STR(data_id) + "/" + t.first + "/data"].set_char_ptr(data, b.word_size*b.num_vals);
-    }
-  } catch (...) {
-    //note: npz_load throws std::runtime_error, but I don't want to assume
-    //      that won't change in the future
-    LBANN_ERROR("failed to open " + filename + " during cnpy::npz_load");
+  if (reset) {
+    output.reset();
   }
+  read_npz_arrays(filename, data_id, output, false);
 }
 
 void numpy_npz_conduit_reader::load_npz(const std::string filename, int data_id, conduit::Node &output) {
+  output.reset();
+  read_npz_arrays(filename, data_id, output, true);
+}
 
-  try {
-    output.reset();
-
-    std::vector<size_t> shape;
-    m_npz_cache[data_id] = cnpy::npz_load(filename);
-    std::map<std::string, cnpy::NpyArray> &a = m_npz_cache[data_id];
-
-    for (auto &&t : a) {
-      cnpy::NpyArray &b = t.second;
-      if (b.shape[0] != 1) {
-        LBANN_ERROR("lbann currently only supports one sample per npz file; this file appears to contain " + std::to_string(b.shape[0]) + " samples; (", filename);
-      }
-      output[LBANN_DATA_ID_STR(data_id) + "/" + t.first + "/word_size"] = b.word_size;
-      output[LBANN_DATA_ID_STR(data_id) + "/" + t.first + "/fortran_order"] = b.fortran_order;
-      output[LBANN_DATA_ID_STR(data_id) + "/" + t.first + "/num_vals"] = b.num_vals;
-      output[LBANN_DATA_ID_STR(data_id) + "/" + t.first + "/shape"] = b.shape;
+void numpy_npz_conduit_reader::read_npz_arrays(const std::string& filename, int data_id, conduit::Node &output, bool as_uint8) const {
 
-      if (b.data_holder->size() / b.word_size != b.num_vals) {
-        LBANN_ERROR("b.data_holder->size() / b.word_size (" + std::to_string(b.data_holder->size()) + " / " + std::to_string(b.word_size) + ") != b.num_vals (" + std::to_string(b.num_vals));
-      }
+  // Only the NPY headers are parsed here; array data is read (and
+  // inflated, if needed) directly into the conduit node
+  std::unique_ptr<npz_archive> npz;
+  try {
+    auto& arg_parser = global_argument_parser();
+    npz = std::make_unique<npz_archive>(
+      filename,
+      arg_parser.get<size_t>(LBANN_OPTION_NPZ_CACHE_SIZE));
+  } catch (const std::exception& e) {
+    LBANN_ERROR("failed to open " + filename + " (", e.what(), ")");
+  }
 
-      conduit::uint8 *data = reinterpret_cast<conduit::uint8*>(b.data_holder->data());
-      output[LBANN_DATA_ID_STR(data_id) + "/" + t.first + "/data"].set_external_uint8_ptr(data, b.word_size*b.num_vals);
+  for (const auto& name : npz->get_array_names()) {
+    const npz_array& b = npz->get_array(name);
+    if (b.num_rows() != 1) {
+      LBANN_ERROR("lbann currently only supports one sample per npz file; this file appears to contain " + std::to_string(b.num_rows()) + " samples; (", filename);
     }
-  } catch (...) {
-    //note: npz_load throws std::runtime_error, but I don't want to assume
-    //      that won't change in the future
-    LBANN_ERROR("failed to open " + filename + " during cnpy::npz_load");
+    const std::string key = LBANN_DATA_ID_STR(data_id) + "/" + name;
+    output[key + "/word_size"] = b.word_size();
+    output[key + "/fortran_order"] = b.fortran_order();
+    output[key + "/num_vals"] = b.num_vals();
+    output[key + "/shape"] = b.shape();
+
+    // conduit owns the data, hence it will be properly deleted when
+    // the conduit::Node is deleted
+    const size_t size = b.word_size() * b.num_vals();
+    conduit::Node& data = output[key + "/data"];
+    if (as_uint8) {
+      data.set(conduit::DataType::uint8(size));
+    } else {
+      data.set(conduit::DataType::c_char(size));
+    }
+    b.read_all(data.data_ptr());
   }
 }
 
-
 }  // namespace lbann
@@ -130,6 +130,10 @@ public:
     return x.parse_schemas();
   }
 
+  const auto& get_field_plans(lbann::hdf5_data_reader& x) {
+    return x.m_field_plans;
+  }
+
   conduit::Node& get_data_schema(lbann::hdf5_data_reader& x) {
     return x.m_data_schema;
   }
@@ -233,6 +237,47 @@ TEST_CASE("hdf5 data reader transform tests",
   }
 }
 
+TEST_CASE("hdf5 data reader field plan test",
+          "[data_reader][hdf5][hrrl]")
+{
+  // initialize stuff (boilerplate)
+  lbann::init_random(0, 2);
+  lbann::init_data_seq_random(42);
+
+  auto hdf5_dr = std::make_unique<lbann::hdf5_data_reader>();
+  DataReaderHDF5WhiteboxTester white_box_tester;
+
+  hdf5_dr->set_role("train");
+  conduit::Node& data_schema = white_box_tester.get_data_schema(*hdf5_dr);
+  data_schema.parse(hdf5_hrrl_data_schema_test, "yaml");
+  conduit::Node& experiment_schema = white_box_tester.get_experiment_schema(*hdf5_dr);
+  experiment_schema.parse(hdf5_hrrl_experiment_schema, "yaml");
+  white_box_tester.parse_schemas(*hdf5_dr);
+
+  // Check that the per-field metadata has been resolved
+  const auto& plans = white_box_tester.get_field_plans(*hdf5_dr);
+  CHECK(plans.size() == 6);
+  for (const auto& plan : plans) {
+    INFO("Field: " << plan.path);
+    CHECK_FALSE(plan.repack);
+    CHECK(plan.n_channels == 1);
+    REQUIRE(plan.scale.size() == 1);
+    REQUIRE(plan.bias.size() == 1);
+    if (plan.path == "Image") {
+      CHECK(plan.coerce_to == conduit::DataType::FLOAT32_ID);
+      CHECK(plan.scale[0] == 1.5259021896696422e-05);
+      CHECK(plan.bias[0] == -1.5259021896696422e-05);
+    }
+    else {
+      CHECK(plan.coerce_to == conduit::DataType::EMPTY_ID);
+    }
+    if (plan.path == "Epmax") {
+      CHECK(plan.scale[0] == 0.1);
+      CHECK(plan.bias[0] == -1.0);
+    }
+  }
+}
+
 TEST_CASE("hdf5 data reader pack test",
           "[data_reader][hdf5][hrrl][pack]")
 {
@@ -0,0 +1,549 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2022, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+#include "lbann/execution_algorithms/inference_server.hpp"
+#include "lbann/comm_impl.hpp"
+#include "lbann/utils/exception.hpp"
+#include "lbann/utils/typename.hpp"
+
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <new>
+#include <sstream>
+
+namespace lbann {
+
+namespace {
+
+/** @brief Interval for I/O thread to check whether to stop. */
+constexpr int poll_timeout_ms = 100;
+
+/** @brief Longest time a response may wait for a client to read. */
+constexpr int write_timeout_ms = 10000;
+
+/** @brief Largest request accepted from a client, counting the
+ *  memory for its inputs and outputs.
+ *
+ *  Protects the server from allocating a huge buffer for a malformed
+ *  request.
+ */
+constexpr size_t max_request_bytes = size_t{1} << 30;
+
+/** @brief Put a socket in non-blocking mode. */
+bool set_nonblocking(int fd) {
+  const int flags = ::fcntl(fd, F_GETFL, 0);
+  return flags >= 0 && ::fcntl(fd, F_SETFL, flags | O_NONBLOCK) == 0;
+}
+
+/** @brief Write exactly @c size bytes to a non-blocking socket.
+ *  Returns false on error or if the client stops reading.
+ */
+bool write_full(int fd, const void* buffer, size_t size) {
+  const auto* ptr = static_cast<const char*>(buffer);
+  while (size > 0) {
+    const auto count = ::send(fd, ptr, size, MSG_NOSIGNAL);
+    if (count < 0 && errno == EINTR) { continue; }
+    if (count < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+      pollfd pfd = {fd, POLLOUT, 0};
+      const int ret = ::poll(&pfd, 1, write_timeout_ms);
+      if (ret < 0 && errno == EINTR) { continue; }
+      if (ret <= 0 || !(pfd.revents & POLLOUT)) { return false; }
+      continue;
+    }
+    if (count <= 0) { return false; }
+    ptr += count;
+    size -= count;
+  }
+  return true;
+}
+
+/** @brief Value at a percentile in a sorted list. */
+double percentile(const std::vector<double>& sorted, double p) {
+  if (sorted.empty()) { return 0.; }
+  const auto pos = static_cast<size_t>(p * (sorted.size() - 1) + 0.5);
+  return sorted[std::min(pos, sorted.size() - 1)];
+}
+
+} // namespace <anon>
+
+struct inference_server::connection {
+  explicit connection(int fd_) : fd(fd_) {}
+  ~connection() { ::close(fd); }
+  const int fd;
+  /** @brief Prevents interleaved responses. */
+  std::mutex write_mutex;
+
+  // Partially received request. Only accessed by the I/O thread.
+  /** @brief Sample count from request header. */
+  uint32_t header = 0;
+  size_t header_bytes = 0;
+  /** @brief Request whose inputs are being received.
+   *  @details Not attached to the connection until it is complete.
+   */
+  std::shared_ptr<request> pending;
+  size_t input_bytes = 0;
+};
+
+struct inference_server::request {
+  std::shared_ptr<connection> conn;
+  size_t num_samples = 0;
+  std::vector<DataType> inputs;
+  std::vector<DataType> outputs;
+  /** @brief Number of samples assigned to a mini-batch. */
+  size_t num_batched = 0;
+  /** @brief Number of samples with outputs. */
+  size_t num_finished = 0;
+  clock::time_point arrival;
+};
+
+inference_server::inference_server(std::string socket_path,
+                                   size_t max_batch_size,
+                                   std::chrono::microseconds max_delay,
+                                   std::string output_layer)
+  : m_socket_path(std::move(socket_path)),
+    m_max_batch_size(max_batch_size),
+    m_max_delay(max_delay),
+    m_output_layer(std::move(output_layer)) {
+  if (m_max_batch_size == 0) {
+    LBANN_ERROR("mini-batch size must be larger than 0");
+  }
+}
+
+inference_server::~inference_server() {
+  stop();
+  stop_listening();
+}
+
+void inference_server::stop() {
+  {
+    std::lock_guard<std::mutex> lock(m_queue_mutex);
+    m_stop = true;
+  }
+  m_queue_cv.notify_all();
+}
+
+// =========================================================
+// Execution
+// =========================================================
+
+void inference_server::serve(observer_ptr<model> model) {
+  auto& comm = *model->get_comm();
+  const int root = comm.get_trainer_master();
+  const bool is_root = comm.am_trainer_master();
+
+  // Find input and output layers
+  Layer* input = nullptr;
+  data_type_layer<DataType>* output = nullptr;
+  for (auto* l : model->get_layers()) {
+    if (l->get_type() == "input") {
+      input = l;
+      break;
+    }
+  }
+  if (m_output_layer.empty()) {
+    // Default to the last layer
+    if (!model->get_layers().empty()) {
+      output = dynamic_cast<data_type_layer<DataType>*>(
+        model->get_layers().back());
+    }
+  }
+  else {
+    for (auto* l : model->get_layers()) {
+      if (l->get_name() == m_output_layer) {
+        output = dynamic_cast<data_type_layer<DataType>*>(l);
+        break;
+      }
+    }
+  }
+  if (input == nullptr) {
+    LBANN_ERROR("could not find input layer in model \"",
+                model->get_name(),"\"");
+  }
+  if (output == nullptr) {
+    LBANN_ERROR("could not find output layer ",
+                "\"",m_output_layer,"\" with data type ",
+                TypeName<DataType>()," in model \"",model->get_name(),"\"");
+  }
+  m_input_size = input->get_output_size();
+  m_output_size = output->get_output_size();
+
+  // Pre-allocate input and output buffers
+  // Note: Each rank holds a copy of the mini-batch samples. Outputs
+  // are gathered to the trainer master.
+  const auto& grid = comm.get_trainer_grid();
+  El::DistMatrix<DataType, El::STAR, El::STAR, El::ELEMENT, El::Device::CPU>
+    samples(m_input_size, m_max_batch_size, grid);
+  El::DistMatrix<DataType, El::CIRC, El::CIRC, El::ELEMENT, El::Device::CPU>
+    outputs(m_output_size, m_max_batch_size, grid, root);
+  if (samples.LDim() != static_cast<El::Int>(m_input_size)) {
+    LBANN_ERROR("expected input buffer to be contiguous");
+  }
+
+  // Create an SGD_execution_context so that layer.forward_prop can get the
+  // mini_batch_size
+  auto c = SGDExecutionContext(execution_mode::inference, m_max_batch_size);
+  model->reset_mode(c, execution_mode::inference);
+
+  if (is_root) {
+    start_listening();
+  }
+
+  // Process mini-batches until stopped
+  std::vector<batch_segment> segments;
+  while (true) {
+    int batch_size = -1;
+    if (is_root) {
+      batch_size = form_batch(samples.Matrix(), segments);
+    }
+    comm.trainer_broadcast(root, batch_size);
+    if (batch_size < 0) { break; }
+    comm.trainer_broadcast(root, samples.Buffer(), m_input_size * batch_size);
+
+    // Note: A batch made up only of empty requests is answered
+    // without running the model.
+    if (batch_size > 0) {
+      c.set_current_mini_batch_size(batch_size);
+      infer_mini_batch(*model,
+                       El::LockedView(samples, El::ALL, El::IR(0, batch_size)));
+      El::Copy(output->get_activations(), outputs);
+    }
+
+    if (is_root) {
+      complete_batch(outputs.LockedMatrix(), segments);
+    }
+  }
+
+  // Report statistics
+  if (is_root) {
+    stop_listening();
+    const auto latency = get_latency_summary();
+    std::ostringstream msg;
+    msg << std::setprecision(3) << std::fixed
+        << get_name() << " (" << m_socket_path << "): "
+        << latency.num_requests << " requests in "
+        << get_num_batches() << " mini-batches";
+    {
+      std::lock_guard<std::mutex> lock(m_stats_mutex);
+      if (m_num_batches > 0) {
+        msg << " (mean size "
+            << double(m_num_batched_samples) / m_num_batches << ")";
+      }
+    }
+    msg << ", latency p50=" << latency.p50 * 1e3 << "ms"
+        << " p90=" << latency.p90 * 1e3 << "ms"
+        << " p99=" << latency.p99 * 1e3 << "ms"
+        << " max=" << latency.max * 1e3 << "ms"
+        << std::endl;
+    std::cout << msg.str();
+  }
+
+}
+
+int inference_server::form_batch(El::Matrix<DataType, El::Device::CPU>& samples,
+                                 std::vector<batch_segment>& segments) {
+  segments.clear();
+  std::unique_lock<std::mutex> lock(m_queue_mutex);
+
+  // Wait until mini-batch is full or oldest request reaches deadline
+  m_queue_cv.wait(lock, [this] { return m_stop || !m_queue.empty(); });
+  if (m_stop) { return -1; }
+  const auto deadline = m_queue.front()->arrival + m_max_delay;
+  m_queue_cv.wait_until(lock, deadline, [this] {
+    return m_stop || m_num_queued_samples >= m_max_batch_size;
+  });
+  if (m_stop) { return -1; }
+
+  // Take samples from requests in arrival order
+  size_t batch_size = 0;
+  while (!m_queue.empty() && batch_size < m_max_batch_size) {
+    const auto& req = m_queue.front();
+    const size_t count = std::min(req->num_samples - req->num_batched,
+                                  m_max_batch_size - batch_size);
+    segments.push_back({req, req->num_batched, batch_size, count});
+    req->num_batched += count;
+    batch_size += count;
+    m_num_queued_samples -= count;
+    if (req->num_batched == req->num_samples) {
+      m_queue.pop_front();
+    }
+  }
+  lock.unlock();
+
+  // Copy samples into input buffer
+  for (const auto& s : segments) {
+    std::memcpy(samples.Buffer(0, s.batch_offset),
+                s.req->inputs.data() + s.request_offset * m_input_size,
+                s.count * m_input_size * sizeof(DataType));
+  }
+  return batch_size;
+
+}
+
+void inference_server::complete_batch(
+  const El::Matrix<DataType, El::Device::CPU>& outputs,
+  const std::vector<batch_segment>& segments) {
+  const auto now = clock::now();
+  std::vector<double> latencies;
+  size_t batch_size = 0;
+  for (const auto& s : segments) {
+    auto& req = *s.req;
+    for (size_t j = 0; j < s.count; ++j) {
+      std::memcpy(req.outputs.data() + (s.request_offset + j) * m_output_size,
+                  outputs.LockedBuffer(0, s.batch_offset + j),
+                  m_output_size * sizeof(DataType));
+    }
+    req.num_finished += s.count;
+    batch_size += s.count;
+    if (req.num_finished == req.num_samples) {
+      send_response(req);
+      latencies.push_back(
+        std::chrono::duration<double>(now - req.arrival).count());
+    }
+  }
+  std::lock_guard<std::mutex> lock(m_stats_mutex);
+  m_latencies.insert(m_latencies.end(), latencies.begin(), latencies.end());
+  if (batch_size > 0) {
+    ++m_num_batches;
+    m_num_batched_samples += batch_size;
+  }
+}
+
+// =========================================================
+// Statistics
+// =========================================================
+
+auto inference_server::get_latency_summary() const -> latency_summary {
+  std::vector<double> latencies;
+  {
+    std::lock_guard<std::mutex> lock(m_stats_mutex);
+    latencies = m_latencies;
+  }
+  std::sort(latencies.begin(), latencies.end());
+  latency_summary summary;
+  summary.num_requests = latencies.size();
+  summary.p50 = percentile(latencies, 0.50);
+  summary.p90 = percentile(latencies, 0.90);
+  summary.p99 = percentile(latencies, 0.99);
+  summary.max = latencies.empty() ? 0. : latencies.back();
+  return summary;
+}
+
+size_t inference_server::get_num_batches() const {
+  std::lock_guard<std::mutex> lock(m_stats_mutex);
+  return m_num_batches;
+}
+
+// =========================================================
+// Socket I/O
+// =========================================================
+
+void inference_server::start_listening() {
+  sockaddr_un addr;
+  std::memset(&addr, 0, sizeof(addr));
+  addr.sun_family = AF_UNIX;
+  if (m_socket_path.empty()
+      || m_socket_path.size() >= sizeof(addr.sun_path)) {
+    LBANN_ERROR("invalid Unix socket path (",m_socket_path,")");
+  }
+  std::strncpy(addr.sun_path, m_socket_path.c_str(), sizeof(addr.sun_path)-1);
+
+  m_listen_fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+  if (m_listen_fd < 0) {
+    LBANN_ERROR("could not create Unix socket (",std::strerror(errno),")");
+  }
+  ::unlink(m_socket_path.c_str());
+  if (!set_nonblocking(m_listen_fd)
+      || ::bind(m_listen_fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0
+      || ::listen(m_listen_fd, SOMAXCONN) != 0) {
+    const int err = errno;
+    ::close(m_listen_fd);
+    m_listen_fd = -1;
+    LBANN_ERROR("could not listen on Unix socket ",m_socket_path," ",
+                "(",std::strerror(err),")");
+  }
+  m_io_thread = std::thread(&inference_server::io_loop, this);
+}
+
+void inference_server::stop_listening() {
+  if (m_io_thread.joinable()) {
+    m_io_thread.join();
+  }
+  if (m_listen_fd >= 0) {
+    ::close(m_listen_fd);
+    ::unlink(m_socket_path.c_str());
+    m_listen_fd = -1;
+  }
+  std::lock_guard<std::mutex> lock(m_queue_mutex);
+  m_queue.clear();
+  m_num_queued_samples = 0;
+}
+
+void inference_server::io_loop() {
+  std::vector<std::shared_ptr<connection>> conns, open_conns;
+  std::vector<pollfd> fds;
+  while (!m_stop) {
+
+    // Wait for connections or requests
+    fds.clear();
+    fds.push_back({m_listen_fd, POLLIN, 0});
+    for (const auto& conn : conns) {
+      fds.push_back({conn->fd, POLLIN, 0});
+    }
+    const int ret = ::poll(fds.data(), fds.size(), poll_timeout_ms);
+    if (ret < 0 && errno != EINTR) {
+      LBANN_WARNING("poll failed in ",get_name()," ",
+                    "(",std::strerror(errno),")");
+      break;
+    }
+    if (ret <= 0) { continue; }
+
+    // Receive requests and drop closed connections
+    // Note: Queued requests keep their connection alive.
+    open_conns.clear();
+    for (size_t i = 0; i < conns.size(); ++i) {
+      const auto revents = fds[i+1].revents;
+      if (!(revents & (POLLIN | POLLHUP | POLLERR))
+          || receive_request(conns[i])) {
+        open_conns.push_back(conns[i]);
+      }
+    }
+    conns.swap(open_conns);
+
+    // Accept new connection
+    // Note: Connections are non-blocking so a slow client cannot
+    // stall the I/O thread in the middle of a request.
+    if (fds[0].revents & POLLIN) {
+      const int fd = ::accept(m_listen_fd, nullptr, nullptr);
+      if (fd >= 0) {
+        auto conn = std::make_shared<connection>(fd);
+        if (set_nonblocking(fd)) {
+          conns.push_back(std::move(conn));
+        }
+      }
+    }
+
+  }
+}
+
+bool inference_server::receive_request(const std::shared_ptr<connection>& conn) {
+  auto& c = *conn;
+  while (true) {
+
+    // Read whatever is available of the header or the inputs
+    char* ptr = nullptr;
+    size_t size = 0;
+    if (c.pending == nullptr) {
+      ptr = reinterpret_cast<char*>(&c.header) + c.header_bytes;
+      size = sizeof(c.header) - c.header_bytes;
+    }
+    else {
+      ptr = reinterpret_cast<char*>(c.pending->inputs.data()) + c.input_bytes;
+      size = c.pending->inputs.size() * sizeof(DataType) - c.input_bytes;
+    }
+    ssize_t count = 0;
+    if (size > 0) {
+      count = ::read(c.fd, ptr, size);
+      if (count < 0 && errno == EINTR) { continue; }
+      if (count < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+        return true;
+      }
+      if (count <= 0) { return false; }
+    }
+
+    // Allocate request once header is complete
+    if (c.pending == nullptr) {
+      c.header_bytes += count;
+      if (c.header_bytes < sizeof(c.header)) { continue; }
+      c.header_bytes = 0;
+      const size_t num_samples = c.header;
+      const size_t request_bytes =
+        num_samples * (m_input_size + m_output_size) * sizeof(DataType);
+      if (request_bytes > max_request_bytes) {
+        LBANN_WARNING(get_name()," received request with ",num_samples," ",
+                      "samples (",request_bytes," bytes, max ",
+                      max_request_bytes,"), closing connection");
+        return false;
+      }
+      try {
+        auto req = std::make_shared<request>();
+        req->num_samples = num_samples;
+        req->arrival = clock::now();
+        req->inputs.resize(num_samples * m_input_size);
+        req->outputs.resize(num_samples * m_output_size);
+        c.pending = std::move(req);
+      }
+      catch (const std::bad_alloc&) {
+        LBANN_WARNING(get_name()," could not allocate request with ",
+                      num_samples," samples, closing connection");
+        return false;
+      }
+      c.input_bytes = 0;
+      continue;
+    }
+
+    // Queue request once inputs are complete
+    c.input_bytes += count;
+    if (c.input_bytes < c.pending->inputs.size() * sizeof(DataType)) {
+      continue;
+    }
+    auto req = std::move(c.pending);
+    c.pending = nullptr;
+    c.input_bytes = 0;
+    req->conn = conn;
+    // Note: Empty requests are queued too, so that responses are sent
+    // in arrival order.
+    {
+      std::lock_guard<std::mutex> lock(m_queue_mutex);
+      m_num_queued_samples += req->num_samples;
+      m_queue.push_back(std::move(req));
+    }
+    m_queue_cv.notify_one();
+    return true;
+
+  }
+}
+
+bool inference_server::send_response(const request& req) const {
+  const uint32_t header[2] = {static_cast<uint32_t>(req.num_samples),
+                              static_cast<uint32_t>(m_output_size)};
+  std::lock_guard<std::mutex> lock(req.conn->write_mutex);
+  return (write_full(req.conn->fd, header, sizeof(header))
+          && write_full(req.conn->fd,
+                        req.outputs.data(),
+                        req.outputs.size() * sizeof(DataType)));
+}
+
+}  // namespace lbann
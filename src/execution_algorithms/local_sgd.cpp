@@ -0,0 +1,304 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2022, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+#include "lbann/execution_algorithms/local_sgd.hpp"
+
+#include "lbann/base.hpp"
+#include "lbann/comm_impl.hpp"
+#include "lbann/models/model.hpp"
+#include "lbann/optimizers/adam.hpp"
+#include "lbann/optimizers/sgd.hpp"
+#include "lbann/utils/exception.hpp"
+#include "lbann/utils/memory.hpp"
+#include "lbann/weights/data_type_weights.hpp"
+
+#include <training_algorithm.pb.h>
+
+#include <algorithm>
+#include <cmath>
+
+namespace lbann {
+
+namespace {
+
+/** @brief Optimizer state that is tied to the local weights. */
+std::vector<El::AbstractDistMatrix<DataType>*>
+get_optimizer_state(optimizer* opt)
+{
+  std::vector<El::AbstractDistMatrix<DataType>*> state;
+  if (auto* sgd_opt = dynamic_cast<sgd<DataType>*>(opt)) {
+    if (sgd_opt->get_momentum() != DataType(0)) {
+      state.push_back(&sgd_opt->get_velocity());
+    }
+  }
+  else if (auto* adam_opt = dynamic_cast<adam<DataType>*>(opt)) {
+    state.push_back(&adam_opt->get_moment1());
+    state.push_back(&adam_opt->get_moment2());
+  }
+  return state;
+}
+
+/** @brief Weights in the data type that LocalSGD averages.
+ *
+ *  Averaging buffers and non-blocking allreduces are set up for
+ *  @c DataType only, so weights in other precisions are rejected.
+ */
+data_type_weights<DataType>& get_averaged_weights(weights& w)
+{
+  auto* dtw = dynamic_cast<data_type_weights<DataType>*>(&w);
+  if (dtw == nullptr) {
+    LBANN_ERROR("LocalSGD only supports weights with data type ",
+                El::TypeName<DataType>(),
+                ", but weights \"", w.get_name(),
+                "\" have a different data type");
+  }
+  return *dtw;
+}
+
+} // namespace
+
+size_t
+LocalSGD::averaging_schedule::get_interval(size_t step) const noexcept
+{
+  if (step < warmup_steps) {
+    return 1;
+  }
+  double h = interval;
+  if (final_interval > 0) {
+    const auto progress =
+      (ramp_steps > 0
+       ? std::min(double(step - warmup_steps) / ramp_steps, 1.)
+       : 1.);
+    h += (double(final_interval) - double(interval)) * progress;
+  }
+  return std::max(static_cast<size_t>(std::lround(h)), size_t{1});
+}
+
+LocalSGD::LocalSGD(std::string name,
+                   std::unique_ptr<SGDTerminationCriteria> stop,
+                   bool suppress_timer_output,
+                   averaging_schedule schedule,
+                   momentum_correction correction)
+  : SGDTrainingAlgorithm{std::move(name),
+                         std::move(stop),
+                         suppress_timer_output},
+    m_schedule{schedule},
+    m_correction{correction}
+{}
+
+void LocalSGD::apply(ExecutionContext& context,
+                     model& m,
+                     data_coordinator& dc,
+                     execution_mode mode)
+{
+  if (mode != execution_mode::training) {
+    SGDTrainingAlgorithm::apply(context, m, dc, mode);
+    return;
+  }
+  auto const& c = dynamic_cast<SGDExecutionContext const&>(context);
+  const bool averaging = (m.get_comm()->get_num_trainers() > 1);
+
+  // Trainers start from the same model. When resuming, the weights
+  // are averaged since every trainer has made progress.
+  if (averaging) {
+    setup_averaging(m);
+    if (c.get_step() == 0) {
+      broadcast_weights(m);
+    }
+    else {
+      start_averaging(m);
+      finish_averaging(m);
+    }
+  }
+  m_last_average_step = c.get_step();
+
+  SGDTrainingAlgorithm::apply(context, m, dc, mode);
+
+  // Trainers finish with the same model
+  if (averaging) {
+    finish_averaging(m);
+    start_averaging(m);
+    finish_averaging(m);
+    m_averaged_matrices.clear();
+  }
+}
+
+bool LocalSGD::train_mini_batch(SGDExecutionContext& c,
+                                model& m,
+                                data_coordinator& dc,
+                                ScopeTimer timer)
+{
+  const bool finished =
+    SGDTrainingAlgorithm::train_mini_batch(c,
+                                           m,
+                                           dc,
+                                           ScopeTimer{timer, "local step"});
+
+  // Apply the previous average and start the next one
+  const size_t step = c.get_step();
+  if (!m_averaged_matrices.empty()
+      && step - m_last_average_step
+           >= m_schedule.get_interval(m_last_average_step)) {
+    ScopeTimer _{timer, "model averaging"};
+    finish_averaging(m);
+    start_averaging(m);
+    m_last_average_step = step;
+  }
+  return finished;
+}
+
+void LocalSGD::setup_averaging(model& m)
+{
+  m_averaged_matrices.clear();
+  m_averaging_in_progress = false;
+  for (auto* w : m.get_weights()) {
+    auto& dtw = get_averaged_weights(*w);
+    std::vector<AbsDistMatrixType*> targets = {&dtw.get_values()};
+    if (m_correction == momentum_correction::AVERAGE) {
+      for (auto* state : get_optimizer_state(dtw.get_optimizer())) {
+        targets.push_back(state);
+      }
+    }
+    for (auto* target : targets) {
+      m_averaged_matrices.push_back({target,
+                                     to_unique_ptr(target->Copy()),
+                                     to_unique_ptr(target->Copy()),
+                                     Al::request{}});
+    }
+  }
+}
+
+void LocalSGD::broadcast_weights(model& m) const
+{
+  auto& comm = *m.get_comm();
+  for (auto* w : m.get_weights()) {
+    auto& dtw = get_averaged_weights(*w);
+    comm.intertrainer_broadcast_matrix(dtw.get_values(), 0);
+  }
+}
+
+void LocalSGD::start_averaging(model& m)
+{
+  auto& comm = *m.get_comm();
+  for (auto& entry : m_averaged_matrices) {
+    El::Copy(entry.target->LockedMatrix(), entry.snapshot->Matrix());
+    El::Copy(entry.target->LockedMatrix(), entry.sum->Matrix());
+    comm.nb_allreduce(entry.sum->Matrix(),
+                      comm.get_intertrainer_comm(),
+                      entry.req);
+  }
+  m_averaging_in_progress = true;
+  ++m_num_averages;
+}
+
+void LocalSGD::finish_averaging(model& m)
+{
+  if (!m_averaging_in_progress) {
+    return;
+  }
+  auto& comm = *m.get_comm();
+  const auto scale = DataType(1) / DataType(comm.get_num_trainers());
+  for (auto& entry : m_averaged_matrices) {
+    comm.wait(entry.req);
+
+    // Keep local progress since the snapshot:
+    //   x <- x + (sum / num_trainers - snapshot)
+    auto& correction = entry.sum->Matrix();
+    El::Scale(scale, correction);
+    El::Axpy(DataType(-1), entry.snapshot->LockedMatrix(), correction);
+    El::Axpy(DataType(1), correction, entry.target->Matrix());
+  }
+  if (m_correction == momentum_correction::RESET) {
+    for (auto* w : m.get_weights()) {
+      for (auto* state : get_optimizer_state(w->get_optimizer())) {
+        El::Zero(*state);
+      }
+    }
+  }
+  m_averaging_in_progress = false;
+}
+
+} // namespace lbann
+
+template <>
+std::unique_ptr<lbann::LocalSGD>
+lbann::make<lbann::LocalSGD>(google::protobuf::Message const& msg_in)
+{
+  auto const& msg = dynamic_cast<lbann_data::TrainingAlgorithm const&>(msg_in);
+
+  // Extract the solver parameters.
+  lbann_data::LocalSGD params;
+  LBANN_ASSERT(msg.parameters().UnpackTo(&params));
+
+  // SGD parameters
+  auto const& sgd_params = params.sgd();
+  auto const& stopping_criteria = sgd_params.stopping_criteria();
+  std::unique_ptr<SGDTerminationCriteria> stopping;
+  switch (stopping_criteria.criterion_case()) {
+  case lbann_data::SGD::TerminationCriteria::kMaxBatches:
+    stopping = std::make_unique<BatchTerminationCriteria>(
+      stopping_criteria.max_batches());
+    break;
+  case lbann_data::SGD::TerminationCriteria::kMaxEpochs:
+    stopping = std::make_unique<EpochTerminationCriteria>(
+      stopping_criteria.max_epochs());
+    break;
+  case lbann_data::SGD::TerminationCriteria::kMaxSeconds:
+    LBANN_ERROR("local SGD requires trainers to take the same number of "
+                "steps, so time-based stopping criteria are not supported");
+    break;
+  default:
+    LBANN_ERROR("No stopping criteria specified.");
+  }
+
+  // Averaging schedule
+  LocalSGD::averaging_schedule schedule;
+  schedule.interval = std::max(params.averaging_interval(), uint64_t{1});
+  schedule.warmup_steps = params.warmup_steps();
+  schedule.final_interval = params.final_averaging_interval();
+  schedule.ramp_steps = params.interval_ramp_steps();
+
+  LocalSGD::momentum_correction correction;
+  switch (params.momentum_correction()) {
+  case lbann_data::LocalSGD::KEEP_LOCAL:
+    correction = LocalSGD::momentum_correction::KEEP_LOCAL;
+    break;
+  case lbann_data::LocalSGD::RESET:
+    correction = LocalSGD::momentum_correction::RESET;
+    break;
+  case lbann_data::LocalSGD::AVERAGE:
+    correction = LocalSGD::momentum_correction::AVERAGE;
+    break;
+  default:
+    LBANN_ERROR("invalid momentum correction for local SGD");
+  }
+
+  return std::make_unique<LocalSGD>(msg.name(),
+                                    std::move(stopping),
+                                    sgd_params.suppress_timer_output(),
+                                    schedule,
+                                    correction);
+}
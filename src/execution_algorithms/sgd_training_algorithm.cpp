@@ -30,18 +30,47 @@
 #include "lbann/callbacks/callback.hpp"
 #include "lbann/execution_algorithms/sgd_execution_context.hpp"
 #include "lbann/models/model.hpp"
+#include "lbann/utils/argument_parser.hpp"
 #include "lbann/utils/exception.hpp"
 #include "lbann/utils/memory.hpp"
+#include "lbann/utils/options.hpp"
 #include "lbann/utils/timer_map.hpp"
 
 #include <training_algorithm.pb.h>
 
+#include <algorithm>
 #include <iostream>
 #include <memory>
 #include <string>
 
 namespace lbann {
 
+namespace {
+
+/** @brief Number of samples in the next mini-batches of the current
+ *  epoch, starting with the current one.
+ */
+size_t count_upcoming_samples(const data_coordinator& dc,
+                              execution_mode mode,
+                              size_t num_mini_batches)
+{
+  const size_t num_steps = dc.get_num_iterations_per_epoch(mode);
+  const size_t first_step = dc.get_current_step_in_epoch(mode);
+  size_t num_samples = 0;
+  for (size_t step = first_step; step < first_step + num_mini_batches; ++step) {
+    if (step + 1 == num_steps) {
+      num_samples += dc.get_last_mini_batch_size(mode)
+                     + dc.get_world_master_mini_batch_adjustment(mode);
+    }
+    else {
+      num_samples += dc.get_mini_batch_size(mode);
+    }
+  }
+  return num_samples;
+}
+
+} // namespace
+
 SGDTrainingAlgorithm::SGDTrainingAlgorithm(
   std::string name,
   std::unique_ptr<SGDTerminationCriteria> stop,
@@ -101,6 +130,18 @@ void SGDTrainingAlgorithm::train(SGDExecutionContext& c,
   evaluation_context.set_effective_mini_batch_size(
     dc.get_mini_batch_size(execution_mode::validation));
 
+  m_gradient_accumulation_steps = global_argument_parser().get<size_t>(
+    LBANN_OPTION_GRADIENT_ACCUMULATION_STEPS);
+  if (m_gradient_accumulation_steps == 0) {
+    LBANN_ERROR("gradient accumulation requires at least one "
+                "mini-batch per step");
+  }
+  if (m_gradient_accumulation_steps > 1 && model.get_pipeline() != nullptr) {
+    LBANN_ERROR("gradient accumulation is not supported with "
+                "pipeline-parallel training, which already accumulates "
+                "gradients over micro-batches");
+  }
+
   // Initialize some state so it knows we're training now.
   c.set_execution_mode(execution_mode::training);
   model.reset_mode(c, execution_mode::training);
@@ -188,42 +229,94 @@ bool SGDTrainingAlgorithm::train_mini_batch(SGDExecutionContext& c,
 
   dc.fetch_data(execution_mode::training);
 
+  // Pipeline-parallel training performs the whole step over its
+  // stages
+  if (auto* pipeline = model.get_pipeline()) {
+    {
+      ScopeTimer _{timer, "pipeline step*"};
+      finished = pipeline->train_mini_batch(c, dc);
+    }
+    c.inc_step();
+    do_batch_end_cbs(model,
+                     execution_mode::training,
+                     ScopeTimer{timer, "batch_end callbacks"});
+    return finished;
+  }
+
+  // Gradients of several mini-batches may be summed before the
+  // optimization step, but not across the end of an epoch
+  const auto mode = execution_mode::training;
+  const size_t num_steps = dc.get_num_iterations_per_epoch(mode);
+  const size_t step_in_epoch = dc.get_current_step_in_epoch(mode);
+  const size_t num_mini_batches =
+    (step_in_epoch < num_steps
+     ? std::min(m_gradient_accumulation_steps, num_steps - step_in_epoch)
+     : 1);
+  const size_t num_samples =
+    (num_mini_batches > 1
+     ? count_upcoming_samples(dc, mode, num_mini_batches)
+     : 0);
+
 #if defined(LBANN_HAVE_OMP_TASKLOOP)
   LBANN_OMP_PARALLEL
   {
 #pragma omp single
     {
 #endif
-      // Forward prop step
       model.clear_gradients();
-      {
-        ScopeTimer _{timer, "forward prop*"};
-        model.forward_prop(execution_mode::training);
-      }
-
-      // check if the data coordinator has finished the epoch and kickoff
-      // background I/O
-      finished = dc.epoch_complete(execution_mode::training);
-
-      // Result is not needed until the end of the mini-batch.
-      model.get_objective_function()->start_evaluation(
-        execution_mode::training,
-        c.get_current_mini_batch_size());
-
-      // Backward prop step
-      model.get_objective_function()->differentiate();
-      {
-        ScopeTimer _{timer, "back prop*"};
-        model.backward_prop();
+      for (size_t i = 0; i < num_mini_batches; ++i) {
+        const bool is_last_mini_batch = (i + 1 == num_mini_batches);
+        if (i > 0) {
+          dc.fetch_data(mode);
+        }
+
+        // Forward prop step
+        {
+          ScopeTimer _{timer, "forward prop*"};
+          model.forward_prop(mode);
+        }
+
+        // check if the data coordinator has finished the epoch and kickoff
+        // background I/O
+        finished = dc.epoch_complete(mode);
+
+        // Accumulate gradients locally until the last mini-batch. The
+        // objective function gradient is averaged over all samples in
+        // the step.
+        if (num_mini_batches > 1) {
+          c.set_effective_mini_batch_size(c.get_effective_mini_batch_size()
+                                          * num_samples
+                                          / c.get_current_mini_batch_size());
+          for (auto* w : model.get_weights()) {
+            auto* opt = w->get_optimizer();
+            if (opt != nullptr) {
+              opt->set_gradient_allreduce_deferred(!is_last_mini_batch);
+            }
+          }
+        }
+
+        // Result is not needed until the end of the mini-batch.
+        model.get_objective_function()->start_evaluation(
+          mode,
+          c.get_current_mini_batch_size());
+
+        // Backward prop step. Callbacks that read gradients (e.g. to
+        // exchange them between trainers) only see the summed gradient.
+        model.get_objective_function()->differentiate();
+        {
+          ScopeTimer _{timer, "back prop*"};
+          model.backward_prop(is_last_mini_batch);
+        }
+        if (is_last_mini_batch) {
+          model.get_objective_function()->compute_weight_regularization();
+        }
+
+        // Finish evaluation.
+        model.get_objective_function()->finish_evaluation(
+          mode,
+          c.get_current_mini_batch_size());
+        model.evaluate_metrics(mode, c.get_current_mini_batch_size());
       }
-      model.get_objective_function()->compute_weight_regularization();
-
-      // Finish evaluation.
-      model.get_objective_function()->finish_evaluation(
-        execution_mode::training,
-        c.get_current_mini_batch_size());
-      model.evaluate_metrics(execution_mode::training,
-                             c.get_current_mini_batch_size());
 
       // Update step
       model.update_weights();
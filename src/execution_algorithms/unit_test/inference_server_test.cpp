@@ -0,0 +1,239 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2022, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+#include <catch2/catch.hpp>
+
+#include "TestHelpers.hpp"
+#include "MPITestHelpers.hpp"
+
+#include <lbann/base.hpp>
+#include <lbann/execution_algorithms/inference_server.hpp>
+#include <lbann/models/model.hpp>
+#include <lbann/utils/lbann_library.hpp>
+
+#include <lbann.pb.h>
+#include <google/protobuf/text_format.h>
+
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <thread>
+
+namespace pb = ::google::protobuf;
+
+namespace {
+// This model is just an input layer into a softmax layer, so the
+// outputs are easy to verify
+std::string const model_prototext = R"ptext(
+model {
+  layer {
+    name: "layer1"
+    children: "layer2"
+    input {
+      data_field: "samples"
+    }
+  }
+  layer {
+    name: "layer2"
+    parents: "layer1"
+    softmax {
+    }
+  }
+}
+)ptext";
+
+auto mock_datareader_metadata(int class_n)
+{
+  lbann::DataReaderMetaData md;
+  auto& md_dims = md.data_dims;
+  md_dims[lbann::data_reader_target_mode::CLASSIFICATION] = {class_n};
+  md_dims[lbann::data_reader_target_mode::INPUT] = {1,1,class_n};
+  return md;
+}
+
+auto make_model(lbann::lbann_comm& comm, int class_n, size_t mbs)
+{
+  lbann_data::LbannPB my_proto;
+  if (!pb::TextFormat::ParseFromString(model_prototext, &my_proto))
+    throw "Parsing protobuf failed.";
+  lbann::construct_trainer(&comm, my_proto.mutable_trainer(), my_proto);
+  auto metadata = mock_datareader_metadata(class_n);
+  auto my_model = lbann::proto::construct_model(&comm,
+                                                -1,
+                                                my_proto.optimizer(),
+                                                my_proto.trainer(),
+                                                my_proto.model());
+  my_model->setup(mbs, metadata, {&comm.get_trainer_grid()});
+  return my_model;
+}
+
+int connect_to_server(const std::string& path)
+{
+  sockaddr_un addr;
+  std::memset(&addr, 0, sizeof(addr));
+  addr.sun_family = AF_UNIX;
+  std::strncpy(addr.sun_path, path.c_str(), sizeof(addr.sun_path)-1);
+  for (int attempt = 0; attempt < 500; ++attempt) {
+    const int fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    if (::connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) == 0) {
+      return fd;
+    }
+    ::close(fd);
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+  return -1;
+}
+
+bool read_full(int fd, void* buffer, size_t size)
+{
+  auto* ptr = static_cast<char*>(buffer);
+  while (size > 0) {
+    const auto count = ::read(fd, ptr, size);
+    if (count <= 0) { return false; }
+    ptr += count;
+    size -= count;
+  }
+  return true;
+}
+
+bool write_bytes(int fd, const void* buffer, size_t size)
+{
+  return ::write(fd, buffer, size) == ssize_t(size);
+}
+
+} // namespace <anon>
+
+TEST_CASE("Test inference_server", "[inference][mpi]")
+{
+  using DataType = lbann::DataType;
+  constexpr int class_n = 4;
+  constexpr size_t mbs = 4;
+
+  auto& comm = unit_test::utilities::current_world_comm();
+  auto model = make_model(comm, class_n, mbs);
+  int root_pid = ::getpid();
+  comm.trainer_broadcast(comm.get_trainer_master(), root_pid);
+  const std::string socket_path =
+    "/tmp/lbann_inference_server_test_" + std::to_string(root_pid) + ".sock";
+  lbann::inference_server server(socket_path,
+                                 mbs,
+                                 std::chrono::milliseconds(5));
+
+  // One-hot samples: the softmax of e_k is e / (e + 3) at k and
+  // 1 / (e + 3) elsewhere
+  const DataType big = std::exp(DataType(1)) / (std::exp(DataType(1)) + 3);
+  const DataType small = DataType(1) / (std::exp(DataType(1)) + 3);
+
+  std::thread client;
+  bool responses_ok = false;
+  bool oversized_closed = false;
+  if (comm.am_trainer_master()) {
+    client = std::thread([&] {
+      const uint32_t n = 6;
+      std::vector<DataType> inputs(n * class_n, DataType(0));
+      for (uint32_t i = 0; i < n; ++i) {
+        inputs[i * class_n + i % class_n] = DataType(1);
+      }
+      auto check_response = [&](int fd, uint32_t num_samples) {
+        uint32_t header[2] = {0, 0};
+        bool ok = read_full(fd, header, sizeof(header));
+        ok = ok && header[0] == num_samples && header[1] == class_n;
+        std::vector<DataType> outputs(num_samples * class_n);
+        ok = ok && read_full(fd, outputs.data(), outputs.size() * sizeof(DataType));
+        for (uint32_t i = 0; ok && i < num_samples; ++i) {
+          for (int j = 0; j < class_n; ++j) {
+            const auto expected = (j == int(i % class_n)) ? big : small;
+            ok = ok && std::abs(outputs[i * class_n + j] - expected) < 1e-5;
+          }
+        }
+        return ok;
+      };
+
+      // Slow client that stops partway through its header and then
+      // partway through its inputs
+      const uint32_t slow_n = 2;
+      const size_t slow_bytes = slow_n * class_n * sizeof(DataType);
+      const auto* slow_header = reinterpret_cast<const char*>(&slow_n);
+      const auto* slow_inputs = reinterpret_cast<const char*>(inputs.data());
+      const int slow_fd = connect_to_server(socket_path);
+      bool ok = (slow_fd >= 0);
+      ok = ok && write_bytes(slow_fd, slow_header, 2);
+      std::this_thread::sleep_for(std::chrono::milliseconds(20));
+      ok = ok && write_bytes(slow_fd, slow_header + 2, sizeof(slow_n) - 2);
+      ok = ok && write_bytes(slow_fd, slow_inputs, slow_bytes / 2);
+
+      // Request that is too large to allocate closes its connection
+      const int big_fd = connect_to_server(socket_path);
+      const uint32_t big_n = 0xFFFFFFFF;
+      uint32_t unused = 0;
+      oversized_closed = (big_fd >= 0
+                          && write_bytes(big_fd, &big_n, sizeof(big_n))
+                          && !read_full(big_fd, &unused, sizeof(unused)));
+      if (big_fd >= 0) { ::close(big_fd); }
+
+      // Request with more samples than the mini-batch size, then an
+      // empty request, while the slow client is still incomplete.
+      // Both are sent before reading, so the responses must come back
+      // in the order of the requests.
+      const int fd = connect_to_server(socket_path);
+      ok = ok && (fd >= 0);
+      for (const uint32_t num_samples : {n, uint32_t(0)}) {
+        ok = ok && write_bytes(fd, &num_samples, sizeof(num_samples));
+        const size_t bytes = num_samples * class_n * sizeof(DataType);
+        ok = ok && write_bytes(fd, inputs.data(), bytes);
+      }
+      ok = ok && check_response(fd, n);
+      ok = ok && check_response(fd, 0);
+      if (fd >= 0) { ::close(fd); }
+
+      // Slow client finishes its request
+      ok = ok && write_bytes(slow_fd,
+                             slow_inputs + slow_bytes / 2,
+                             slow_bytes - slow_bytes / 2);
+      ok = ok && check_response(slow_fd, slow_n);
+      if (slow_fd >= 0) { ::close(slow_fd); }
+
+      responses_ok = ok;
+      server.stop();
+    });
+  }
+
+  server.serve(model.get());
+
+  if (comm.am_trainer_master()) {
+    client.join();
+    CHECK(responses_ok);
+    CHECK(oversized_closed);
+    const auto latency = server.get_latency_summary();
+    CHECK(latency.num_requests == 3);
+    CHECK(server.get_num_batches() == 3);
+    CHECK(latency.p50 <= latency.max);
+  }
+}
@@ -23,6 +23,7 @@
 // implied. See the License for the specific language governing
 // permissions and limitations under the license.
 ////////////////////////////////////////////////////////////////////////////////
+#include "lbann/execution_algorithms/local_sgd.hpp"
 #include "lbann/execution_algorithms/sgd_training_algorithm.hpp"
 #include "lbann/execution_algorithms/training_algorithm.hpp"
 #include "lbann/utils/exception.hpp"
@@ -142,6 +143,50 @@ TEST_CASE("Building training algorithm from the factory",
     REQUIRE(sgd->get_name() == "my sgd algo");
   }
 
+  SECTION("Building LocalSGD works fine.")
+  {
+    lbann_data::LocalSGD local_sgd_msg;
+    local_sgd_msg.mutable_sgd()->mutable_stopping_criteria()->set_max_epochs(2);
+    local_sgd_msg.set_averaging_interval(4);
+    local_sgd_msg.set_warmup_steps(10);
+    local_sgd_msg.set_final_averaging_interval(16);
+    local_sgd_msg.set_interval_ramp_steps(100);
+    local_sgd_msg.set_momentum_correction(lbann_data::LocalSGD::RESET);
+
+    lbann_data::TrainingAlgorithm algo_msg;
+    algo_msg.set_name("my local sgd algo");
+    algo_msg.mutable_parameters()->PackFrom(local_sgd_msg);
+
+    auto algo = lbann::make_abstract<lbann::TrainingAlgorithm>(algo_msg);
+    REQUIRE(algo->get_type() == "local_sgd");
+    REQUIRE(algo->get_name() == "my local sgd algo");
+
+    auto const& local_sgd = dynamic_cast<lbann::LocalSGD const&>(*algo);
+    CHECK(local_sgd.get_momentum_correction()
+          == lbann::LocalSGD::momentum_correction::RESET);
+    auto const& schedule = local_sgd.get_schedule();
+    CHECK(schedule.interval == 4);
+    CHECK(schedule.get_interval(0) == 1);
+    CHECK(schedule.get_interval(9) == 1);
+    CHECK(schedule.get_interval(10) == 4);
+    CHECK(schedule.get_interval(60) == 10);
+    CHECK(schedule.get_interval(110) == 16);
+    CHECK(schedule.get_interval(1000) == 16);
+  }
+
+  SECTION("Building LocalSGD with a time limit fails")
+  {
+    lbann_data::LocalSGD local_sgd_msg;
+    local_sgd_msg.mutable_sgd()->mutable_stopping_criteria()->set_max_seconds(
+      60.);
+
+    lbann_data::TrainingAlgorithm algo_msg;
+    algo_msg.set_name("my bad local sgd algo");
+    algo_msg.mutable_parameters()->PackFrom(local_sgd_msg);
+
+    REQUIRE_THROWS(lbann::make_abstract<lbann::TrainingAlgorithm>(algo_msg));
+  }
+
   SECTION("Building with an invalid message type fails")
   {
     lbann_data::SGD::TerminationCriteria wrong_msg_type;
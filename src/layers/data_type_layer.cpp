@@ -38,6 +38,7 @@
 #include "lbann/utils/summary_impl.hpp"
 #include "lbann/utils/tensor_impl.hpp"
 #include "lbann/utils/timer.hpp"
+#include "lbann/utils/tracer.hpp"
 
 namespace {
 template <typename MatrixPtrT>
@@ -49,6 +50,54 @@ std::vector<MatrixPtrT> copy_all(std::vector<MatrixPtrT> const& in)
     out.emplace_back(m ? m->Copy() : nullptr);
   return out;
 }
+
+/** Copy local matrix entries to contiguous host memory. */
+template <typename T>
+void pack_local_matrix(const El::AbstractMatrix<T>& local,
+                       std::vector<El::byte>& buffer)
+{
+  const auto height = local.Height();
+  const auto width = local.Width();
+  buffer.resize(height * width * sizeof(T));
+  if (height > 0 && width > 0) {
+    El::Matrix<T, El::Device::CPU> packed;
+    packed.Attach(height, width, reinterpret_cast<T*>(buffer.data()), height);
+    El::Copy(local, packed);
+  }
+}
+
+/** Copy contiguous host memory into an already resized local matrix. */
+template <typename T>
+void unpack_local_matrix(const std::vector<El::byte>& buffer,
+                         El::AbstractMatrix<T>& local,
+                         const std::string& layer_name)
+{
+  const auto height = local.Height();
+  const auto width = local.Width();
+  if (buffer.size() != size_t(height * width) * sizeof(T)) {
+    LBANN_ERROR("layer \"", layer_name, "\" expected ",
+                height * width * sizeof(T), " bytes "
+                "(", height, " x ", width, " local entries) "
+                "from the neighboring pipeline stage, "
+                "but received ", buffer.size());
+  }
+  if (height > 0 && width > 0) {
+    El::Matrix<T, El::Device::CPU> packed;
+    packed.LockedAttach(height, width,
+                        reinterpret_cast<const T*>(buffer.data()), height);
+    El::Copy(packed, local);
+  }
+}
+
+/** Micro-batch context, if the model is executing one. */
+const lbann::SGDExecutionContext* get_micro_batch_context(const lbann::model& m)
+{
+  if (!m.has_valid_execution_context()) { return nullptr; }
+  const auto* c = dynamic_cast<const lbann::SGDExecutionContext*>(
+    &m.get_execution_context());
+  return (c != nullptr && c->has_micro_batch()) ? c : nullptr;
+}
+
 } // namespace
 
 namespace lbann {
@@ -77,12 +126,14 @@ operator=(data_type_layer const& other) {
   m_outputs = copy_all(other.m_outputs);
   m_gradient_wrt_outputs = copy_all(other.m_gradient_wrt_outputs);
   m_gradient_wrt_inputs = copy_all(other.m_gradient_wrt_inputs);
+  m_pipeline_inputs.clear();
   m_persistent_error_signals = other.m_persistent_error_signals;
   return *this;
 }
 
 template <typename InputTensorDataType, typename OutputTensorDataType>
 void data_type_layer<InputTensorDataType, OutputTensorDataType>::forward_prop() {
+  LBANN_TRACE_SCOPE("fp", this->get_name());
   const auto fp_start = get_time();
 
   // Setup weights proxies
@@ -751,6 +802,27 @@ void data_type_layer<InputTensorDataType, OutputTensorDataType>::bp_compute() {
   }
 }
 
+template <typename InputTensorDataType, typename OutputTensorDataType>
+auto data_type_layer<InputTensorDataType, OutputTensorDataType>::estimate_work() const
+  -> work_estimate {
+  double input_bytes = 0., output_bytes = 0., output_entries = 0.;
+  for (int i = 0; i < get_num_parents(); ++i) {
+    const auto& x = get_local_prev_activations(i);
+    input_bytes += double(x.Height()) * x.Width() * sizeof(InputTensorDataType);
+  }
+  for (int i = 0; i < get_num_children(); ++i) {
+    const auto& y = get_local_activations(i);
+    output_entries += double(y.Height()) * y.Width();
+  }
+  output_bytes = output_entries * sizeof(OutputTensorDataType);
+  work_estimate work;
+  work.fp_flops = output_entries;
+  work.fp_bytes = input_bytes + output_bytes;
+  work.bp_flops = 2 * output_entries;
+  work.bp_bytes = 2 * (input_bytes + output_bytes);
+  return work;
+}
+
 template <typename InputTensorDataType, typename OutputTensorDataType>
 void data_type_layer<InputTensorDataType, OutputTensorDataType>::check_setup() {
   Layer::check_setup();
@@ -812,6 +884,9 @@ void data_type_layer<InputTensorDataType, OutputTensorDataType>::
 fp_setup_inputs(El::Int mini_batch_size) {
   if (get_num_parents() < 1) { return; }
 
+  // Micro-batch in pipeline-parallel training
+  const auto* micro_batch = get_micro_batch_context(*m_model);
+
   // Iterate through input tensors
   for (int i = 0; i < get_num_parents(); ++i) {
 
@@ -825,7 +900,42 @@ fp_setup_inputs(El::Int mini_batch_size) {
     const auto& parent_output = parent.get_activations(*this);
     auto& input = *m_inputs[i];
     input.Empty(false);
-    view_or_copy_tensor(parent_output, input);
+    const auto parent_mode = (micro_batch != nullptr
+                              ? get_pipeline_parent_mode(i)
+                              : pipeline_parent_mode::LOCAL);
+    if (parent_mode == pipeline_parent_mode::REMOTE) {
+      // Input was received from previous pipeline stage
+      const auto index = micro_batch->get_micro_batch_index();
+      if (m_pipeline_inputs.size() <= size_t(i)
+          || m_pipeline_inputs[i].size() <= index
+          || m_pipeline_inputs[i][index] == nullptr) {
+        LBANN_ERROR("layer \"", get_name(), "\" has not received "
+                    "input ", i, " of micro-batch ", index, " "
+                    "from the previous pipeline stage");
+      }
+      El::LockedView(input, *m_pipeline_inputs[i][index]);
+    }
+    else if (parent_mode == pipeline_parent_mode::MINI_BATCH) {
+      // View current micro-batch in parent's full mini-batch
+      const auto* full =
+        dynamic_cast<const InputAbsDistMatrixType*>(&parent_output);
+      if (full == nullptr) {
+        LBANN_ERROR("layer \"", get_name(), "\" can't view a micro-batch "
+                    "of the output of layer \"", parent.get_name(), "\" "
+                    "since they have different data types");
+      }
+      const El::Int offset = micro_batch->get_micro_batch_offset();
+      std::unique_ptr<InputAbsDistMatrixType> columns(
+        full->Construct(full->Grid(), full->Root()));
+      El::LockedView(*columns,
+                     *full,
+                     El::ALL,
+                     El::IR(offset, offset + mini_batch_size));
+      view_or_copy_tensor(*columns, input);
+    }
+    else {
+      view_or_copy_tensor(parent_output, input);
+    }
 
     // Check input matrix dimensions
     const auto& height = get_input_size(i);
@@ -861,6 +971,16 @@ fp_setup_outputs(El::Int mini_batch_size) {
     if (!keep_original_outputs(i)) continue;
 #endif // LBANN_HAS_DISTCONV
     auto& output = get_activations(i);
+
+    // Write directly into the child's output buffer if it allows it
+    auto& child = const_cast<Layer&>(get_child_layer(i));
+    if (child.setup_parent_output_view(
+          *this, output,
+          (align_outputs ? &alignment_dist : nullptr),
+          mini_batch_size)) {
+      continue;
+    }
+
     output.Empty(false);
     if (align_outputs) {
       output.AlignWith(alignment_dist);
@@ -1009,9 +1129,23 @@ void deep_copy_error_signal(
 template <typename InputTensorDataType, typename OutputTensorDataType>
 void data_type_layer<InputTensorDataType, OutputTensorDataType>::
 propagate_error_signals_to_parents_() {
+  const auto* micro_batch = get_micro_batch_context(*m_model);
   for (int i=0; i<get_num_parents(); ++i) {
     auto& parent = const_cast<Layer&>(get_parent_layer(i));
 
+    // Parents outside the current pipeline micro-batch don't receive
+    // error signals. Signals for a parent on the previous stage are
+    // kept until they are packed, so views must be deep-copied before
+    // the previous error signals are cleared.
+    if (micro_batch != nullptr
+        && get_pipeline_parent_mode(i) != pipeline_parent_mode::LOCAL) {
+      if (get_pipeline_parent_mode(i) == pipeline_parent_mode::REMOTE
+          && m_gradient_wrt_inputs[i]->Viewing()) {
+        m_gradient_wrt_inputs[i].reset(m_gradient_wrt_inputs[i]->Copy());
+      }
+      continue;
+    }
+
     // If my error signals persist, my parent can always view them,
     // assuming the distdata is right. Otherwise, my views and my data
     // will be released. Views must be copied and owned data can
@@ -1027,6 +1161,66 @@ propagate_error_signals_to_parents_() {
   }
 }
 
+template <typename InputTensorDataType, typename OutputTensorDataType>
+void data_type_layer<InputTensorDataType, OutputTensorDataType>::
+pack_pipeline_activations(
+  const Layer& child,
+  std::vector<El::byte>& buffer) const {
+  pack_local_matrix(get_activations(child).LockedMatrix(), buffer);
+}
+
+template <typename InputTensorDataType, typename OutputTensorDataType>
+void data_type_layer<InputTensorDataType, OutputTensorDataType>::
+unpack_pipeline_input(
+  int parent_index,
+  size_t micro_batch,
+  El::Int mini_batch_size,
+  const std::vector<El::byte>& buffer) {
+  if (parent_index < 0 || parent_index >= get_num_parents()) {
+    LBANN_ERROR("attempted to set input ", parent_index, " "
+                "of layer \"", get_name(), "\", "
+                "which has ", get_num_parents(), " parents");
+  }
+  m_pipeline_inputs.resize(get_num_parents());
+  auto& received = m_pipeline_inputs[parent_index];
+  if (received.size() <= micro_batch) {
+    received.resize(micro_batch + 1);
+  }
+  auto& input = received[micro_batch];
+  if (input == nullptr) {
+    const auto& ref = *m_inputs[parent_index];
+    input.reset(ref.Construct(ref.Grid(), ref.Root()));
+  }
+  input->Empty(false);
+  input->Resize(get_input_size(parent_index), mini_batch_size);
+  unpack_local_matrix(buffer, input->Matrix(), get_name());
+}
+
+template <typename InputTensorDataType, typename OutputTensorDataType>
+void data_type_layer<InputTensorDataType, OutputTensorDataType>::
+pack_pipeline_error_signals(
+  int parent_index,
+  std::vector<El::byte>& buffer) const {
+  pack_local_matrix(get_error_signals(parent_index).LockedMatrix(), buffer);
+}
+
+template <typename InputTensorDataType, typename OutputTensorDataType>
+void data_type_layer<InputTensorDataType, OutputTensorDataType>::
+unpack_pipeline_prev_error_signals(
+  const Layer& child,
+  const std::vector<El::byte>& buffer) {
+  const int child_index = find_child_layer_index(child);
+  const auto& output = *m_outputs[child_index];
+  auto& signal = m_gradient_wrt_outputs[child_index];
+  if (signal == nullptr) {
+    signal.reset(output.Construct(output.Grid(), output.Root()));
+  }
+  signal->Empty(false);
+  signal->AlignWith(output);
+  signal->Resize(get_output_size(child_index), output.Width());
+  unpack_local_matrix(buffer, signal->Matrix(), get_name());
+}
+
 template <typename InputTensorDataType, typename OutputTensorDataType>
 void data_type_layer<InputTensorDataType, OutputTensorDataType>::
 allocate_new_gradients_() {
@@ -27,15 +27,58 @@
 #define LBANN_BILINEAR_RESIZE_LAYER_INSTANTIATE
 #include "lbann/layers/image/bilinear_resize.hpp"
 
+#include <vector>
+
 namespace lbann {
 
+namespace {
+
+/** @brief Bilinear interpolation coefficients along one dimension.
+ *
+ *  For each output index, stores the two nearest input indices and
+ *  the weight of the second one. Input indices are clamped to the
+ *  input image.
+ */
+template <typename TensorDataType>
+struct interpolation_table {
+  std::vector<El::Int> index0;
+  std::vector<El::Int> index1;
+  std::vector<TensorDataType> weight1;
+};
+
+template <typename TensorDataType>
+interpolation_table<TensorDataType>
+make_interpolation_table(El::Int input_size, El::Int output_size) {
+  // Note: Coordinates are computed in double precision, independent
+  // of DataType, and only the weights are converted to TensorDataType.
+  constexpr double half = 0.5;
+  const double stride = static_cast<double>(input_size) / output_size;
+  interpolation_table<TensorDataType> table;
+  table.index0.resize(output_size);
+  table.index1.resize(output_size);
+  table.weight1.resize(output_size);
+  for (El::Int i = 0; i < output_size; ++i) {
+
+    // Interpolation point
+    const auto x = (i + half) * stride;
+
+    // Input pixels near interpolation point
+    const auto j = static_cast<El::Int>(std::floor(x - half));
+    table.index0[i] = std::max(j, El::Int(0));
+    table.index1[i] = std::min(j+1, input_size-1);
+
+    // Interpolation point relative to input pixel centers
+    table.weight1[i] = El::To<TensorDataType>(x - (j + half));
+
+  }
+  return table;
+}
+
+} // namespace <anon>
+
 template <typename TensorDataType, data_layout Layout, El::Device Device>
 void bilinear_resize_layer<TensorDataType, Layout, Device>::fp_compute() {
 
-  // Useful constants
-  constexpr DataType half = 0.5;
-  constexpr DataType one = 1;
-
   // Matrices
   const auto& local_input = this->get_local_prev_activations();
   auto& local_output = this->get_local_activations();
@@ -50,60 +93,108 @@ void bilinear_resize_layer<TensorDataType, Layout, Device>::fp_compute() {
                                                std::multiplies<int>());
   const El::Int input_height = input_dims[num_dims-2];
   const El::Int input_width = input_dims[num_dims-1];
-
-  // Perform bilinear interpolation for each output pixel
-  const auto& x_stride = static_cast<DataType>(input_width) / this->m_width;
-  const auto& y_stride = static_cast<DataType>(input_height) / this->m_height;
-  LBANN_OMP_PARALLEL_FOR_COLLAPSE4
+  const El::Int output_height = this->m_height;
+  const El::Int output_width = this->m_width;
+
+  // Interpolation coefficients are shared by all images
+  const auto rows = make_interpolation_table<TensorDataType>(input_height,
+                                                             output_height);
+  const auto cols = make_interpolation_table<TensorDataType>(input_width,
+                                                             output_width);
+  const El::Int* __restrict__ col0 = cols.index0.data();
+  const El::Int* __restrict__ col1 = cols.index1.data();
+  const TensorDataType* __restrict__ col_weight = cols.weight1.data();
+
+  // Perform bilinear interpolation for each image
+  LBANN_OMP_PARALLEL_FOR_COLLAPSE2
   for (El::Int sample = 0; sample < num_samples; ++sample) {
     for (El::Int channel = 0; channel < num_channels; ++channel) {
-      for (El::Int output_row = 0; output_row < this->m_height; ++output_row) {
-        for (El::Int output_col = 0; output_col < this->m_width; ++output_col) {
-
-          // Interpolation point
-          const auto& x = (output_col + half) * x_stride;
-          const auto& y = (output_row + half) * y_stride;
-
-          // Find input pixels near interpolation point
-          const auto input_col = static_cast<El::Int>(std::floor(x - half));
-          const auto& input_col0 = std::max(input_col, El::Int(0));
-          const auto& input_col1 = std::min(input_col+1, input_width-1);
-          const auto input_row = static_cast<El::Int>(std::floor(y - half));
-          const auto& input_row0 = std::max(input_row, El::Int(0));
-          const auto& input_row1 = std::min(input_row+1, input_height-1);
-
-          // Interpolation point relative to input pixel centers
-          const auto& unit_x = x - (input_col + half);
-          const auto& unit_y = y - (input_row + half);
-
-          // Input and output pixels
-          const auto& pixel00 = local_input(channel * input_height * input_width
-                                            + input_row0 * input_width
-                                            + input_col0,
-                                            sample);
-          const auto& pixel01 = local_input(channel * input_height * input_width
-                                            + input_row0 * input_width
-                                            + input_col1,
-                                            sample);
-          const auto& pixel10 = local_input(channel * input_height * input_width
-                                            + input_row1 * input_width
-                                            + input_col0,
-                                            sample);
-          const auto& pixel11 = local_input(channel * input_height * input_width
-                                            + input_row1 * input_width
-                                            + input_col1,
-                                            sample);
-          auto& result = local_output(channel * this->m_height * this->m_width
-                                      + output_row * this->m_width
-                                      + output_col,
-                                      sample);
-
-          // Bilinear interpolation
-          result = (pixel00 * (one - unit_x) * (one - unit_y)
-                    + pixel01 * unit_x * (one - unit_y)
-                    + pixel10 * (one - unit_x) * unit_y
-                    + pixel11 * unit_x * unit_y);
+      const auto* __restrict__ input
+        = local_input.LockedBuffer(channel * input_height * input_width,
+                                   sample);
+      auto* __restrict__ output
+        = local_output.Buffer(channel * output_height * output_width,
+                              sample);
+      for (El::Int output_row = 0; output_row < output_height; ++output_row) {
+        const auto* __restrict__ input_row0
+          = &input[rows.index0[output_row] * input_width];
+        const auto* __restrict__ input_row1
+          = &input[rows.index1[output_row] * input_width];
+        const auto& row_weight = rows.weight1[output_row];
+        auto* __restrict__ output_row_buf = &output[output_row * output_width];
+        for (El::Int output_col = 0; output_col < output_width; ++output_col) {
+          const auto& c0 = col0[output_col];
+          const auto& c1 = col1[output_col];
+          const auto& w = col_weight[output_col];
+          const auto top = input_row0[c0] + w * (input_row0[c1] - input_row0[c0]);
+          const auto bottom = input_row1[c0] + w * (input_row1[c1] - input_row1[c0]);
+          output_row_buf[output_col] = top + row_weight * (bottom - top);
+        }
+      }
+    }
+  }
+
+}
+
+template <typename TensorDataType, data_layout Layout, El::Device Device>
+void bilinear_resize_layer<TensorDataType, Layout, Device>::bp_compute() {
+
+  // Useful constants
+  const auto one = El::TypeTraits<TensorDataType>::One();
+
+  // Matrices
+  const auto& local_output_grad = this->get_local_prev_error_signals();
+  auto& local_input_grad = this->get_local_error_signals();
 
+  // Dimensions
+  const auto& input_dims = this->get_input_dims();
+  const auto& num_dims = input_dims.size();
+  const auto& num_samples = local_output_grad.Width();
+  const El::Int num_channels = std::accumulate(input_dims.begin(),
+                                               input_dims.end()-2,
+                                               1,
+                                               std::multiplies<int>());
+  const El::Int input_height = input_dims[num_dims-2];
+  const El::Int input_width = input_dims[num_dims-1];
+  const El::Int output_height = this->m_height;
+  const El::Int output_width = this->m_width;
+
+  // Interpolation coefficients are shared by all images
+  const auto rows = make_interpolation_table<TensorDataType>(input_height,
+                                                             output_height);
+  const auto cols = make_interpolation_table<TensorDataType>(input_width,
+                                                             output_width);
+  const El::Int* __restrict__ col0 = cols.index0.data();
+  const El::Int* __restrict__ col1 = cols.index1.data();
+  const TensorDataType* __restrict__ col_weight = cols.weight1.data();
+
+  // Distribute each output gradient to its four input pixels
+  El::Zero(local_input_grad);
+  LBANN_OMP_PARALLEL_FOR_COLLAPSE2
+  for (El::Int sample = 0; sample < num_samples; ++sample) {
+    for (El::Int channel = 0; channel < num_channels; ++channel) {
+      const auto* __restrict__ output_grad
+        = local_output_grad.LockedBuffer(channel * output_height * output_width,
+                                         sample);
+      auto* __restrict__ input_grad
+        = local_input_grad.Buffer(channel * input_height * input_width,
+                                  sample);
+      for (El::Int output_row = 0; output_row < output_height; ++output_row) {
+        auto* input_grad_row0 = &input_grad[rows.index0[output_row] * input_width];
+        auto* input_grad_row1 = &input_grad[rows.index1[output_row] * input_width];
+        const auto& row_weight = rows.weight1[output_row];
+        const auto* __restrict__ output_grad_row
+          = &output_grad[output_row * output_width];
+        for (El::Int output_col = 0; output_col < output_width; ++output_col) {
+          const auto& c0 = col0[output_col];
+          const auto& c1 = col1[output_col];
+          const auto& w = col_weight[output_col];
+          const auto bottom = output_grad_row[output_col] * row_weight;
+          const auto top = output_grad_row[output_col] - bottom;
+          input_grad_row0[c0] += top * (one - w);
+          input_grad_row0[c1] += top * w;
+          input_grad_row1[c0] += bottom * (one - w);
+          input_grad_row1[c1] += bottom * w;
         }
       }
     }
@@ -112,6 +112,76 @@ __global__ void fp_kernel(El::Int num_samples,
 
 }
 
+template <int block_size, typename TensorDataType>
+__global__ void bp_kernel(El::Int num_samples,
+                          El::Int num_channels,
+                          El::Int input_height,
+                          El::Int input_width,
+                          TensorDataType* __restrict__ input_grad,
+                          El::Int input_grad_ldim,
+                          El::Int output_height,
+                          El::Int output_width,
+                          const TensorDataType* __restrict__ output_grad,
+                          El::Int output_grad_ldim) {
+
+  // Useful constants
+  const TensorDataType half = 0.5;
+  const TensorDataType one = 1.;
+  const El::Int gid = threadIdx.x + blockIdx.x * blockDim.x;
+  const El::Int num_threads = blockDim.x * gridDim.x;
+
+  // Stride between interpolation points
+  const auto& x_stride = TensorDataType(input_width) / TensorDataType(output_width);
+  const auto& y_stride = TensorDataType(input_height) / TensorDataType(output_height);
+
+  const auto& size = (num_samples * num_channels
+                      * output_height * output_width);
+  for (El::Int pos = gid; pos < size; pos += num_threads) {
+
+    // Indices
+    const auto& sample = pos / (num_channels * output_height * output_width);
+    const auto& channel = (pos / (output_height * output_width)) % num_channels;
+    const auto& output_row = (pos / output_width) % output_height;
+    const auto& output_col = pos % output_width;
+
+    // Interpolation point
+    const auto& x = (TensorDataType(output_col) + half) * x_stride;
+    const auto& y = (TensorDataType(output_row) + half) * y_stride;
+
+    // Find input pixels near interpolation point
+    const auto input_col = static_cast<El::Int>(gpu_lib::floor(x - half));
+    const auto& input_col0 = gpu_lib::max(input_col, El::Int(0));
+    const auto& input_col1 = gpu_lib::min(input_col+1, input_width-1);
+    const auto input_row = static_cast<El::Int>(gpu_lib::floor(y - half));
+    const auto& input_row0 = gpu_lib::max(input_row, El::Int(0));
+    const auto& input_row1 = gpu_lib::min(input_row+1, input_height-1);
+
+    // Interpolation point relative to input pixel centers
+    const auto& unit_x = x - (TensorDataType(input_col) + half);
+    const auto& unit_y = y - (TensorDataType(input_row) + half);
+
+    // Output gradient
+    const auto& dy = output_grad[sample * output_grad_ldim
+                                 + channel * output_height * output_width
+                                 + output_row * output_width
+                                 + output_col];
+
+    // Distribute gradient to input pixels
+    auto* dx = &input_grad[sample * input_grad_ldim
+                           + channel * input_height * input_width];
+    gpu_lib::atomic_add(&dx[input_row0 * input_width + input_col0],
+                        dy * (one - unit_x) * (one - unit_y));
+    gpu_lib::atomic_add(&dx[input_row0 * input_width + input_col1],
+                        dy * unit_x * (one - unit_y));
+    gpu_lib::atomic_add(&dx[input_row1 * input_width + input_col0],
+                        dy * (one - unit_x) * unit_y);
+    gpu_lib::atomic_add(&dx[input_row1 * input_width + input_col1],
+                        dy * unit_x * unit_y);
+
+  }
+
+}
+
 }
 
 
@@ -161,6 +231,50 @@ void bilinear_resize_layer<TensorDataType, Layout, Device>::fp_compute() {
 
 }
 
+template <typename TensorDataType, data_layout Layout, El::Device Device>
+void bilinear_resize_layer<TensorDataType, Layout, Device>::bp_compute() {
+
+  // Matrices
+  const auto& local_output_grad = this->get_local_prev_error_signals();
+  auto& local_input_grad = this->get_local_error_signals();
+
+  // Dimensions
+  const auto& input_dims = this->get_input_dims();
+  const auto& num_dims = input_dims.size();
+  const auto& num_samples = local_output_grad.Width();
+  const El::Int num_channels = std::accumulate(input_dims.begin(),
+                                               input_dims.end()-2,
+                                               1,
+                                               std::multiplies<int>());
+  const El::Int input_height = input_dims[num_dims-2];
+  const El::Int input_width = input_dims[num_dims-1];
+
+  // Get GPU grid dimensions
+  const El::Int size = local_output_grad.Height() * local_output_grad.Width();
+  constexpr El::Int block_dim = 256;
+  El::Int grid_dim = (size + block_dim - 1) / block_dim;
+  if (sizeof(El::Int) > sizeof(uint32_t)
+      && grid_dim > std::numeric_limits<uint32_t>::max()) {
+    grid_dim = std::numeric_limits<uint32_t>::max();
+  }
+
+  // Launch GPU kernel
+  El::Zero(local_input_grad);
+  if (grid_dim > 0) {
+    auto multisync = El::MakeMultiSync(gpu::get_sync_info(local_input_grad),
+                                       gpu::get_sync_info(local_output_grad));
+    hydrogen::gpu::LaunchKernel(
+      bp_kernel<block_dim, TensorDataType>,
+      grid_dim, block_dim, 0, multisync,
+      num_samples, num_channels,
+      input_height, input_width,
+      local_input_grad.Buffer(), local_input_grad.LDim(),
+      this->m_height, this->m_width,
+      local_output_grad.LockedBuffer(), local_output_grad.LDim());
+  }
+
+}
+
 #define PROTO(T)                                      \
   template class bilinear_resize_layer<T, data_layout::DATA_PARALLEL, El::Device::GPU>
 
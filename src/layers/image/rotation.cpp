@@ -28,9 +28,15 @@
 #include "lbann/layers/image/rotation.hpp"
 
 #include <math.h>
+#include <vector>
 
 namespace lbann {
 
+// Note: The point rotated onto an output pixel is an affine function
+// of the pixel position. Within an output row, both input coordinates
+// change by a fixed increment per column, so the trigonometry is
+// computed once per sample and the per-row offsets once per row.
+
 template <typename TensorDataType, data_layout Layout, El::Device Device>
 void rotation_layer<TensorDataType, Layout, Device>::fp_compute() {
 
@@ -51,85 +57,203 @@ void rotation_layer<TensorDataType, Layout, Device>::fp_compute() {
   const El::Int input_height = input_dims[1];
   const El::Int input_width = input_dims[2];
 
-  // Get rotation angle
+  // Get center pixel for rotation
+  const El::Int col_center = input_width/2;
+  const El::Int row_center = input_height/2;
+
+  // Get rotation angle for each sample
   const auto& angles = this->get_local_prev_activations(1);
+  std::vector<DataType> sin_angles(num_samples), cos_angles(num_samples);
+  for (El::Int sample = 0; sample < num_samples; ++sample) {
+    const DataType angle_rad = angles(0, sample) * Pi / degree;
+    sin_angles[sample] = sin(angle_rad);
+    cos_angles[sample] = cos(angle_rad);
+  }
 
-  // Perform rotation for each input pixel based on the center pixel
-  LBANN_OMP_PARALLEL_FOR_COLLAPSE4
+  // Perform rotation for each image
+  LBANN_OMP_PARALLEL_FOR_COLLAPSE2
   for (El::Int sample = 0; sample < num_samples; ++sample) {
     for (El::Int channel = 0; channel < num_channels; ++channel) {
+      const auto& sin_angle = sin_angles[sample];
+      const auto& cos_angle = cos_angles[sample];
+      const auto* __restrict__ input
+        = local_input.LockedBuffer(channel * input_height * input_width,
+                                   sample);
+      auto* __restrict__ output
+        = local_output.Buffer(channel * input_height * input_width,
+                              sample);
       for (El::Int output_row = 0; output_row < input_height; ++output_row) {
-        for (El::Int output_col = 0; output_col < input_width; ++output_col) {
 
-          // Convert to rad
-          const auto& angle = angles.Get(0, sample);
-          const auto& angle_rad = angle * Pi / degree;
+        // Rotated point for first pixel in row
+        const DataType row_offset = output_row - row_center;
+        const DataType row_col0 = (row_offset * sin_angle
+                                   - col_center * cos_angle
+                                   + col_center);
+        const DataType row_row0 = (row_offset * cos_angle
+                                   + col_center * sin_angle
+                                   + row_center);
 
-          // Get center pixel for rotation
-          const El::Int col_center = input_width/2;
-          const El::Int row_center = input_height/2;
+        auto* __restrict__ output_row_buf = &output[output_row * input_width];
+        for (El::Int output_col = 0; output_col < input_width; ++output_col) {
 
           // Rotate point relative to input pixel centers
-          const auto& rotated_col = (output_row - row_center) * sin(angle_rad) + (output_col - col_center) * cos(angle_rad) + col_center;
-          const auto& rotated_row =  (output_row - row_center) * cos(angle_rad) - (output_col - col_center) * sin(angle_rad) + row_center;
+          const DataType rotated_col = row_col0 + output_col * cos_angle;
+          const DataType rotated_row = row_row0 - output_col * sin_angle;
 
           // Find input pixels near rotation point
           const auto input_col = static_cast<El::Int>(std::floor(rotated_col));
           const auto input_row = static_cast<El::Int>(std::floor(rotated_row));
+          if (input_col >= 0 && input_col < input_width-1
+              && input_row >= 0 && input_row < input_height-1) {
+
+            // Rotation point relative to input pixel centers
+            const DataType unit_col = rotated_col - input_col;
+            const DataType unit_row = rotated_row - input_row;
+
+            // Bilinear interpolation
+            const auto* pixel0 = &input[input_row * input_width + input_col];
+            const auto* pixel1 = pixel0 + input_width;
+            output_row_buf[output_col]
+              = (pixel0[0] * (one - unit_col) * (one - unit_row)
+                 + pixel0[1] * unit_col * (one - unit_row)
+                 + pixel1[0] * (one - unit_col) * unit_row
+                 + pixel1[1] * unit_col * unit_row);
+
+          }
+          else {
+            output_row_buf[output_col] = zero;
+          }
+
+        }
+      }
+    }
+  }
+
+}
+
+template <typename TensorDataType, data_layout Layout, El::Device Device>
+void rotation_layer<TensorDataType, Layout, Device>::bp_compute() {
+
+  // Useful constants
+  constexpr DataType Pi = M_PI;
+  constexpr DataType degree = 180;
+  constexpr DataType one = 1;
+
+  // Input and output tensors
+  const auto& local_input = this->get_local_prev_activations();
+  const auto& local_output_grad = this->get_local_prev_error_signals();
+  auto& local_input_grad = this->get_local_error_signals(0);
+  auto& local_angle_grad = this->get_local_error_signals(1);
 
-          // Input and output pixels
-          auto& pixel_output = local_output(channel * input_height * input_width
-                                                + output_row * input_width
-                                                + output_col,
-                                                sample);
+  // Tensor dimensions
+  const auto& input_dims = this->get_input_dims(0);
+  const auto& num_samples = local_input.Width();
+  const El::Int num_channels = input_dims[0];
+  const El::Int input_height = input_dims[1];
+  const El::Int input_width = input_dims[2];
+
+  // Get center pixel for rotation
+  const El::Int col_center = input_width/2;
+  const El::Int row_center = input_height/2;
 
-	  if((input_col >= 0 && input_col < input_width-1) && (input_row >= 0 && input_row < input_height-1)){
+  // Get rotation angle for each sample
+  const auto& angles = this->get_local_prev_activations(1);
+  std::vector<DataType> sin_angles(num_samples), cos_angles(num_samples);
+  for (El::Int sample = 0; sample < num_samples; ++sample) {
+    const DataType angle_rad = angles(0, sample) * Pi / degree;
+    sin_angles[sample] = sin(angle_rad);
+    cos_angles[sample] = cos(angle_rad);
+  }
+
+  // Contributions to angle gradient from each image
+  std::vector<DataType> partial_angle_grad(num_channels * num_samples);
+
+  // Distribute each output gradient to its four input pixels
+  El::Zero(local_input_grad);
+  LBANN_OMP_PARALLEL_FOR_COLLAPSE2
+  for (El::Int sample = 0; sample < num_samples; ++sample) {
+    for (El::Int channel = 0; channel < num_channels; ++channel) {
+      const auto& sin_angle = sin_angles[sample];
+      const auto& cos_angle = cos_angles[sample];
+      const auto* __restrict__ input
+        = local_input.LockedBuffer(channel * input_height * input_width,
+                                   sample);
+      const auto* __restrict__ output_grad
+        = local_output_grad.LockedBuffer(channel * input_height * input_width,
+                                         sample);
+      auto* __restrict__ input_grad
+        = local_input_grad.Buffer(channel * input_height * input_width,
+                                  sample);
+      DataType angle_grad = 0;
+      for (El::Int output_row = 0; output_row < input_height; ++output_row) {
 
-          	const El::Int input_col0 = std::max(input_col, El::Int(0));
-          	const El::Int input_col1 = std::min(input_col+1, input_width-1);
+        // Rotated point for first pixel in row
+        const DataType row_offset = output_row - row_center;
+        const DataType row_col0 = (row_offset * sin_angle
+                                   - col_center * cos_angle
+                                   + col_center);
+        const DataType row_row0 = (row_offset * cos_angle
+                                   + col_center * sin_angle
+                                   + row_center);
 
-         	const El::Int input_row0 = std::max(input_row, El::Int(0));
-         	const El::Int input_row1 = std::min(input_row+1, input_height-1);
+        const auto* __restrict__ output_grad_row
+          = &output_grad[output_row * input_width];
+        for (El::Int output_col = 0; output_col < input_width; ++output_col) {
 
-          	// Rotation point relative to input pixel centers
-         	const auto& unit_col = rotated_col - input_col;
-          	const auto& unit_row = rotated_row - input_row;
+          // Rotate point relative to input pixel centers
+          const DataType rotated_col = row_col0 + output_col * cos_angle;
+          const DataType rotated_row = row_row0 - output_col * sin_angle;
 
-          	auto& pixel00 = local_input(channel * input_height * input_width
-                                           	+ input_row0 * input_width
-                                            	+ input_col0,
-                                            	sample);
+          // Find input pixels near rotation point
+          const auto input_col = static_cast<El::Int>(std::floor(rotated_col));
+          const auto input_row = static_cast<El::Int>(std::floor(rotated_row));
+          if (input_col >= 0 && input_col < input_width-1
+              && input_row >= 0 && input_row < input_height-1) {
 
-          	auto& pixel01 = local_input(channel * input_height * input_width
-                                            	+ input_row0 * input_width
-                                            	+ input_col1,
-                                           	 sample);
+            // Rotation point relative to input pixel centers
+            const DataType unit_col = rotated_col - input_col;
+            const DataType unit_row = rotated_row - input_row;
+            const DataType dy = output_grad_row[output_col];
 
-          	auto& pixel10 = local_input(channel * input_height * input_width
-                                            	+ input_row1 * input_width
-                                            	+ input_col0,
-                                            	sample);
+            // Gradient w.r.t. input pixels
+            const auto offset = input_row * input_width + input_col;
+            input_grad[offset] += dy * (one - unit_col) * (one - unit_row);
+            input_grad[offset+1] += dy * unit_col * (one - unit_row);
+            input_grad[offset+input_width] += dy * (one - unit_col) * unit_row;
+            input_grad[offset+input_width+1] += dy * unit_col * unit_row;
 
-          	auto& pixel11 = local_input(channel * input_height * input_width
-                                           	+ input_row1 * input_width
-                                            	+ input_col1,
-                                            	sample);
+            // Gradient w.r.t. rotation point
+            const DataType pixel00 = input[offset];
+            const DataType pixel01 = input[offset+1];
+            const DataType pixel10 = input[offset+input_width];
+            const DataType pixel11 = input[offset+input_width+1];
+            const auto dcol = ((one - unit_row) * (pixel01 - pixel00)
+                               + unit_row * (pixel11 - pixel10));
+            const auto drow = ((one - unit_col) * (pixel10 - pixel00)
+                               + unit_col * (pixel11 - pixel01));
 
+            // Derivatives of rotation point w.r.t. angle (in rad) are
+            // (rotated_row - row_center) and -(rotated_col - col_center)
+            angle_grad += dy * (dcol * (rotated_row - row_center)
+                                - drow * (rotated_col - col_center));
 
-          	// Bilinear interpolation
-         	pixel_output = (pixel00 * (one - unit_col) * (one - unit_row)
-                       	+ pixel01 * unit_col * (one - unit_row)
-                       	+ pixel10 * (one - unit_col) * unit_row
-                       	+ pixel11 * unit_col * unit_row);
+          }
 
-	  }
-	  else {
-          	pixel_output = zero;
-	  }
         }
       }
+      partial_angle_grad[channel + sample * num_channels] = angle_grad;
     }
   }
+
+  // Gradient w.r.t. angle (in degrees)
+  for (El::Int sample = 0; sample < num_samples; ++sample) {
+    DataType angle_grad = 0;
+    for (El::Int channel = 0; channel < num_channels; ++channel) {
+      angle_grad += partial_angle_grad[channel + sample * num_channels];
+    }
+    local_angle_grad(0, sample) = angle_grad * Pi / degree;
+  }
+
 }
 
 #define PROTO(T) \
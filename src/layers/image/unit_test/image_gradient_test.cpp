@@ -0,0 +1,317 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2022, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+#include <catch2/catch.hpp>
+
+#include "TestHelpers.hpp"
+#include "MPITestHelpers.hpp"
+
+#include <lbann/base.hpp>
+#include <lbann/execution_algorithms/sgd_execution_context.hpp>
+#include <lbann/layers/io/input_layer.hpp>
+#include <lbann/models/model.hpp>
+#include <lbann/objective_functions/objective_function.hpp>
+#include <lbann/optimizers/data_type_optimizer.hpp>
+#include <lbann/proto/factories.hpp>
+#include <lbann/trainers/trainer.hpp>
+#include <lbann/utils/lbann_library.hpp>
+#include <lbann/weights/data_type_weights.hpp>
+
+#include <lbann.pb.h>
+#include <google/protobuf/text_format.h>
+
+#include <cmath>
+
+namespace pb = ::google::protobuf;
+
+namespace {
+
+using DataType = lbann::DataType;
+using StarMatType =
+  El::DistMatrix<DataType, El::STAR, El::STAR, El::ELEMENT, El::Device::CPU>;
+
+constexpr size_t mbs = 2;
+constexpr auto mode = lbann::execution_mode::training;
+
+/** Comma-separated list of @c n smoothly varying values. */
+std::string make_values(int n)
+{
+  std::string values;
+  for (int i = 0; i < n; ++i) {
+    values += (i > 0 ? ", " : "") + std::to_string(std::sin(0.7 * i + 0.3));
+  }
+  return values;
+}
+
+std::string make_dims(std::vector<int> const& dims)
+{
+  std::string out;
+  for (auto const& d : dims) {
+    out += " dims: " + std::to_string(d);
+  }
+  return out;
+}
+
+/** Image from the input layer plus trainable image weights, fed to
+ *  the layer under test and reduced with a squared L2 norm. The
+ *  weights make the image a model parameter, so its gradient can be
+ *  compared against finite differences of the objective. If
+ *  @c angle is non-empty, a second trainable scalar is passed to
+ *  the layer as its second input. */
+std::string make_prototext(std::vector<int> const& image_dims,
+                           std::string const& layer_params,
+                           std::string const& device,
+                           std::string const& angle = "")
+{
+  const int image_size = image_dims[0] * image_dims[1] * image_dims[2];
+  std::string angle_layer, angle_weights;
+  if (!angle.empty()) {
+    angle_layer = R"ptext(
+  layer {
+    name: "angle"
+    children: "test"
+    weights: "angle_w"
+    weights_layer { dims: 1 }
+  })ptext";
+    angle_weights = R"ptext(
+  weights {
+    name: "angle_w"
+    initializer {
+      constant_initializer {
+        value: )ptext" + angle + R"ptext(
+      }
+    }
+  })ptext";
+  }
+  return R"ptext(
+model {
+  objective_function {
+    layer_term {
+      scale_factor: 1.0
+      layer: "loss"
+    }
+  }
+  layer {
+    name: "x"
+    children: "sum"
+    input {
+      data_field: "samples"
+    }
+  }
+  layer {
+    name: "image"
+    children: "sum"
+    weights: "image_w"
+    weights_layer {)ptext" + make_dims(image_dims) + R"ptext( }
+  }
+  layer {
+    name: "sum"
+    parents: "x"
+    parents: "image"
+    children: "test"
+    sum {}
+  })ptext" + angle_layer + R"ptext(
+  layer {
+    name: "test"
+    parents: "sum"
+)ptext" + (angle.empty() ? "" : "    parents: \"angle\"\n") + R"ptext(    children: "loss"
+    device_allocation: ")ptext" + device + R"ptext("
+    )ptext" + layer_params + R"ptext(
+  }
+  layer {
+    name: "loss"
+    parents: "test"
+    l2_norm2 {}
+  }
+  weights {
+    name: "image_w"
+    initializer {
+      value_initializer {
+        values: [)ptext" + make_values(image_size) + R"ptext(]
+      }
+    }
+  })ptext" + angle_weights + R"ptext(
+}
+optimizer {
+  sgd {
+    learn_rate: 0.1
+  }
+}
+)ptext";
+}
+
+auto make_model(lbann::lbann_comm& comm,
+                std::string const& prototext,
+                std::vector<int> const& image_dims)
+{
+  lbann_data::LbannPB my_proto;
+  if (!pb::TextFormat::ParseFromString(prototext, &my_proto))
+    throw "Parsing protobuf failed.";
+  lbann::construct_trainer(&comm, my_proto.mutable_trainer(), my_proto);
+  lbann::DataReaderMetaData md;
+  md.data_dims[lbann::data_reader_target_mode::INPUT] = image_dims;
+  auto my_model = lbann::proto::construct_model(&comm,
+                                                -1,
+                                                my_proto.optimizer(),
+                                                my_proto.trainer(),
+                                                my_proto.model());
+  my_model->setup(mbs, md, lbann::get_trainer().get_grids());
+  lbann::SGDExecutionContext c(mode, mbs);
+  my_model->reset_mode(c, mode);
+
+  // Deterministic samples that differ between mini-batch columns
+  lbann::input_layer<DataType>* input = nullptr;
+  for (int l = 0; l < my_model->get_num_layers(); ++l) {
+    if (my_model->get_layer(l).get_type() == "input") {
+      input = dynamic_cast<lbann::input_layer<DataType>*>(
+        &my_model->get_layer(l));
+    }
+  }
+  REQUIRE(input != nullptr);
+  StarMatType samples(image_dims[0] * image_dims[1] * image_dims[2],
+                      mbs,
+                      input->get_activations().Grid());
+  for (El::Int jl = 0; jl < samples.LocalWidth(); ++jl)
+    for (El::Int il = 0; il < samples.LocalHeight(); ++il) {
+      const auto i = samples.GlobalRow(il);
+      const auto j = samples.GlobalCol(jl);
+      samples.SetLocal(il, jl, DataType(0.25 * std::cos(0.3 * i + 1.1 * j)));
+    }
+  input->set_samples(samples);
+
+  return my_model;
+}
+
+lbann::data_type_weights<DataType>& get_weights(lbann::model& m,
+                                                std::string const& name)
+{
+  for (auto* w : m.get_weights()) {
+    if (w->get_name() == name) {
+      return dynamic_cast<lbann::data_type_weights<DataType>&>(*w);
+    }
+  }
+  throw "Weights not found.";
+}
+
+lbann::EvalType evaluate(lbann::model& m)
+{
+  auto& obj = *m.get_objective_function();
+  m.forward_prop(mode);
+  obj.start_evaluation(mode, mbs);
+  return obj.finish_evaluation(mode, mbs);
+}
+
+/** Check each entry of the named weights' gradient against a central
+ *  difference of the objective function. */
+void check_gradient(lbann::model& m, std::string const& name, DataType step)
+{
+  auto& w = get_weights(m, name);
+
+  // Gradient from backprop
+  auto& obj = *m.get_objective_function();
+  m.clear_gradients();
+  m.forward_prop(mode);
+  obj.start_evaluation(mode, mbs);
+  obj.differentiate();
+  m.backward_prop();
+  obj.finish_evaluation(mode, mbs);
+  auto& opt =
+    dynamic_cast<lbann::data_type_optimizer<DataType>&>(*w.get_optimizer());
+  StarMatType grad(opt.get_gradient());
+  StarMatType values(w.get_values());
+
+  // Finite differences
+  for (El::Int i = 0; i < values.Height(); ++i) {
+    const auto x = values.GetLocal(i, 0);
+    const auto index = static_cast<size_t>(i);
+    w.set_value(x + step, index);
+    const auto f_plus = evaluate(m);
+    w.set_value(x - step, index);
+    const auto f_minus = evaluate(m);
+    w.set_value(x, index);
+    const auto expected = (f_plus - f_minus) / (2 * step);
+    INFO("Weights " << name << ", entry " << i);
+    CHECK(grad.GetLocal(i, 0) == Approx(expected).epsilon(1e-2).margin(1e-3));
+  }
+}
+
+} // namespace <anon>
+
+TEST_CASE("Bilinear resize gradients match finite differences",
+          "[mpi][layer][image]")
+{
+  auto& comm = unit_test::utilities::current_world_comm();
+
+  std::vector<std::string> devices = {"cpu"};
+#ifdef LBANN_HAS_GPU
+  devices.push_back("gpu");
+#endif // LBANN_HAS_GPU
+
+  // Non-integer upsampling and downsampling, so interpolation points
+  // fall between pixels and are clamped at the image borders
+  struct resize_case
+  {
+    std::vector<int> input_dims;
+    int height;
+    int width;
+  };
+  std::vector<resize_case> const cases = {{{2, 3, 4}, 5, 7},
+                                          {{2, 5, 7}, 3, 4}};
+
+  for (auto const& device : devices) {
+    for (auto const& rc : cases) {
+      INFO("Device " << device << ", output " << rc.height << " x "
+                     << rc.width);
+      const std::string params =
+        "bilinear_resize { height: " + std::to_string(rc.height)
+        + " width: " + std::to_string(rc.width) + " }";
+      auto model =
+        make_model(comm, make_prototext(rc.input_dims, params, device),
+                   rc.input_dims);
+      // The objective is quadratic in the image, so the central
+      // difference is exact up to rounding for any step
+      check_gradient(*model, "image_w", 0.25);
+    }
+  }
+}
+
+TEST_CASE("Rotation gradients match finite differences",
+          "[mpi][layer][image]")
+{
+  auto& comm = unit_test::utilities::current_world_comm();
+
+  // The rotation layer is only implemented on CPU. At 28 degrees,
+  // several output pixels of a 5 x 6 image come from outside the
+  // image and others from its last row and column, and no rotated
+  // pixel center is within 0.05 pixels of a pixel boundary, so the
+  // perturbed angles below do not cross a kink in the interpolation.
+  const std::vector<int> image_dims = {2, 5, 6};
+  auto model = make_model(comm,
+                          make_prototext(image_dims, "rotation {}", "cpu",
+                                         "28.0"),
+                          image_dims);
+  check_gradient(*model, "image_w", 0.25);
+  check_gradient(*model, "angle_w", 0.25);
+}
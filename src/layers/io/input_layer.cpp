@@ -99,7 +99,8 @@ void input_layer<TensorDataType, T_layout, Dev>::fp_setup_outputs(El::Int mini_b
     auto& c = dynamic_cast<SGDExecutionContext&>(this->m_model->get_execution_context());
     auto mode = c.get_execution_mode();
     auto effective_mini_batch_size = mini_batch_size;
-    if (!(mode==execution_mode::inference)) {
+    // Samples placed with set_samples() already define the mini-batch
+    if (!(mode==execution_mode::inference) && !this->m_samples_loaded) {
       data_coordinator& dc = get_trainer().get_data_coordinator();
       // Determine model mini-batch size and effective mini-batch size
       // Note: If inter-model communication is activated, the effective
@@ -31,6 +31,7 @@
 #include "lbann/models/model.hpp"
 #include "lbann/utils/summary_impl.hpp"
 #include "lbann/utils/timer.hpp"
+#include "lbann/utils/tracer.hpp"
 
 #include <layers.pb.h>
 
@@ -102,6 +103,10 @@ Layer& Layer::operator=(const Layer& other) {
   return *this;
 }
 
+auto Layer::estimate_work() const -> work_estimate {
+  return work_estimate{};
+}
+
 description Layer::get_description() const {
 
   // Construct description object
@@ -228,6 +233,29 @@ void Layer::set_grid_tag(int tag) {
   m_grid_tag = tag;
 }
 
+void Layer::set_pipeline_parent_mode(int parent_index,
+                                     pipeline_parent_mode mode) {
+  if (parent_index < 0 || parent_index >= get_num_parents()) {
+    LBANN_ERROR("attempted to set pipeline mode of parent ", parent_index,
+                " of layer \"", get_name(), "\", ",
+                "which has ", get_num_parents(), " parents");
+  }
+  if (m_pipeline_parent_modes.size() <= size_t(parent_index)) {
+    m_pipeline_parent_modes.resize(parent_index + 1,
+                                   pipeline_parent_mode::LOCAL);
+  }
+  m_pipeline_parent_modes[parent_index] = mode;
+}
+
+auto Layer::get_pipeline_parent_mode(int parent_index) const
+  -> pipeline_parent_mode {
+  if (parent_index < 0
+      || size_t(parent_index) >= m_pipeline_parent_modes.size()) {
+    return pipeline_parent_mode::LOCAL;
+  }
+  return m_pipeline_parent_modes[parent_index];
+}
+
 bool Layer::update() {
   if (m_frozen) { return true; }
   // Apply any updates.
@@ -508,6 +536,7 @@ void Layer::check_setup() {
 }
 
 void Layer::back_prop() {
+  LBANN_TRACE_SCOPE("bp", get_name());
   allocate_new_gradients_();
   back_prop_impl_();
   propagate_error_signals_to_parents_();
@@ -160,6 +160,39 @@ base_convolution_layer<TensorDataType,Device>
 }
 #endif // LBANN_HAS_DNN_LIB
 
+template <typename TensorDataType, El::Device Device>
+auto base_convolution_layer<TensorDataType,Device>::estimate_work() const
+  -> work_estimate {
+
+  // Convolution applies the kernel at each output position and
+  // deconvolution applies it at each input position
+  const auto& input_dims = this->get_input_dims();
+  const auto& output_dims = this->get_output_dims();
+  const auto& spatial_dims = (this->get_type() == "deconvolution"
+                              ? input_dims
+                              : output_dims);
+  const auto& kernel_dims = get_kernel_dims();
+  const double num_positions = get_linear_size(spatial_dims.size() - 1,
+                                               spatial_dims.data() + 1);
+  const double kernel_size = get_linear_size(kernel_dims);
+  const double n = this->get_local_prev_activations().Width();
+  const double input_size = this->get_input_size();
+  const double output_size = this->get_output_size();
+  constexpr double word_size = sizeof(TensorDataType);
+
+  // Backprop computes gradients w.r.t. input and kernel
+  work_estimate work;
+  work.fp_flops = 2 * num_positions * kernel_size * n;
+  work.fp_bytes = (kernel_size + (input_size + output_size) * n) * word_size;
+  work.bp_flops = 2 * work.fp_flops;
+  work.bp_bytes = (2 * kernel_size + 2 * (input_size + output_size) * n) * word_size;
+  if (m_bias_scaling_factor != El::TypeTraits<ScalingType>::Zero()) {
+    work.fp_flops += output_size * n;
+    work.bp_flops += output_size * n;
+  }
+  return work;
+}
+
 template <typename TensorDataType, El::Device Device>
 description
 base_convolution_layer<TensorDataType,Device>::get_description() const {
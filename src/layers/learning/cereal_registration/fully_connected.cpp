@@ -39,7 +39,8 @@ fully_connected_layer<TensorDataType,Layout,Device>
   ar(::cereal::make_nvp("DataTypeLayer",
                         ::cereal::base_class<DataTypeLayer>(this)),
      CEREAL_NVP(m_bias_scaling_factor),
-     CEREAL_NVP(m_transpose));
+     CEREAL_NVP(m_transpose),
+     CEREAL_NVP(m_activation));
 }
 
 } // namespace lbann
@@ -32,11 +32,216 @@
 
 #include <layers.pb.h>
 
+#include <cmath>
+#include <limits>
 #include <string>
 #include <sstream>
 
 namespace lbann {
 
+namespace {
+
+/** Fused activation function. */
+template <fc_activation Act, typename TensorDataType>
+inline TensorDataType activation(TensorDataType const& z) noexcept
+{
+  auto const zero = El::TypeTraits<TensorDataType>::Zero();
+  auto const one = El::TypeTraits<TensorDataType>::One();
+  switch (Act) {
+  case fc_activation::RELU:
+    return z > zero ? z : zero;
+  case fc_activation::GELU:
+  {
+    const auto& x = El::To<double>(z);
+    return El::To<TensorDataType>(0.5 * x * (1. + std::erf(x * M_SQRT1_2)));
+  }
+  case fc_activation::SIGMOID:
+  {
+    // Matches the cutoff applied by the sigmoid operator
+    auto const eps = std::numeric_limits<TensorDataType>::epsilon();
+    const auto& y = one / (one + El::Exp(-z));
+    if (y <= eps) { return eps; }
+    if (y >= one - eps) { return one - eps; }
+    return y;
+  }
+  case fc_activation::TANH:
+    return El::Tanh(z);
+  case fc_activation::NONE:
+  default:
+    return z;
+  }
+}
+
+/** Derivative of fused activation function.
+ *
+ *  The argument is the pre-activation for GELU and the activation
+ *  output otherwise.
+ */
+template <fc_activation Act, typename TensorDataType>
+inline TensorDataType activation_derivative(TensorDataType const& x) noexcept
+{
+  auto const zero = El::TypeTraits<TensorDataType>::Zero();
+  auto const one = El::TypeTraits<TensorDataType>::One();
+  switch (Act) {
+  case fc_activation::RELU:
+    return x > zero ? one : zero;
+  case fc_activation::GELU:
+  {
+    const auto& z = El::To<double>(x);
+    const double cdf = 0.5 * (1. + std::erf(z * M_SQRT1_2));
+    const double pdf = std::exp(-0.5 * z * z) * (0.5 * M_2_SQRTPI * M_SQRT1_2);
+    return El::To<TensorDataType>(cdf + z * pdf);
+  }
+  case fc_activation::SIGMOID:
+  {
+    auto const eps = std::numeric_limits<TensorDataType>::epsilon();
+    if (x <= eps || x >= one - eps) { return zero; }
+    return x * (one - x);
+  }
+  case fc_activation::TANH:
+    return one - x * x;
+  case fc_activation::NONE:
+  default:
+    return one;
+  }
+}
+
+/** Apply bias and activation to the output of the linearity GEMM.
+ *
+ *  Each entry is only touched once. Pre-activations are saved in the
+ *  workspace if they are needed to compute the activation derivative.
+ */
+template <fc_activation Act, typename TensorDataType>
+void apply_bias_and_activation(El::AbstractMatrix<TensorDataType>& output,
+                               TensorDataType const* bias,
+                               TensorDataType const& bias_scale,
+                               El::Matrix<TensorDataType, El::Device::CPU>& workspace)
+{
+  const El::Int height = output.Height();
+  const El::Int width = output.Width();
+  const El::Int ldim = output.LDim();
+  auto* __restrict__ y = output.Buffer();
+  if (Act == fc_activation::GELU) {
+    workspace.Resize(height, width);
+  }
+  auto* __restrict__ z_buffer = workspace.Buffer();
+  const El::Int z_ldim = workspace.LDim();
+  LBANN_OMP_PARALLEL_FOR
+  for (El::Int col = 0; col < width; ++col) {
+    for (El::Int row = 0; row < height; ++row) {
+      auto& entry = y[row + col * ldim];
+      auto z = entry;
+      if (bias != nullptr) {
+        z += bias_scale * bias[row];
+      }
+      if (Act == fc_activation::GELU) {
+        z_buffer[row + col * z_ldim] = z;
+      }
+      entry = activation<Act>(z);
+    }
+  }
+}
+
+template <typename TensorDataType>
+void apply_bias_and_activation(fc_activation act,
+                               El::AbstractMatrix<TensorDataType>& output,
+                               TensorDataType const* bias,
+                               TensorDataType const& bias_scale,
+                               El::Matrix<TensorDataType, El::Device::CPU>& workspace)
+{
+  switch (act) {
+  case fc_activation::NONE:
+    apply_bias_and_activation<fc_activation::NONE>(output, bias, bias_scale, workspace);
+    break;
+  case fc_activation::RELU:
+    apply_bias_and_activation<fc_activation::RELU>(output, bias, bias_scale, workspace);
+    break;
+  case fc_activation::GELU:
+    apply_bias_and_activation<fc_activation::GELU>(output, bias, bias_scale, workspace);
+    break;
+  case fc_activation::SIGMOID:
+    apply_bias_and_activation<fc_activation::SIGMOID>(output, bias, bias_scale, workspace);
+    break;
+  case fc_activation::TANH:
+    apply_bias_and_activation<fc_activation::TANH>(output, bias, bias_scale, workspace);
+    break;
+  default:
+    LBANN_ERROR("invalid fused activation");
+  }
+}
+
+/** Compute gradient w.r.t. pre-activations.
+ *
+ *  The result is stored in the workspace. For GELU, the workspace is
+ *  expected to contain the pre-activations and is overwritten.
+ */
+template <fc_activation Act, typename TensorDataType>
+void apply_activation_derivative(El::AbstractMatrix<TensorDataType> const& output,
+                                 El::AbstractMatrix<TensorDataType> const& gradient_wrt_output,
+                                 El::Matrix<TensorDataType, El::Device::CPU>& workspace)
+{
+  const El::Int height = output.Height();
+  const El::Int width = output.Width();
+  const El::Int y_ldim = output.LDim();
+  const El::Int dy_ldim = gradient_wrt_output.LDim();
+  if (Act != fc_activation::GELU) {
+    workspace.Resize(height, width);
+  }
+  const auto* __restrict__ y = output.LockedBuffer();
+  const auto* __restrict__ dy = gradient_wrt_output.LockedBuffer();
+  auto* __restrict__ dz = workspace.Buffer();
+  const El::Int dz_ldim = workspace.LDim();
+  LBANN_OMP_PARALLEL_FOR
+  for (El::Int col = 0; col < width; ++col) {
+    for (El::Int row = 0; row < height; ++row) {
+      auto& entry = dz[row + col * dz_ldim];
+      const auto& x = (Act == fc_activation::GELU
+                       ? entry
+                       : y[row + col * y_ldim]);
+      entry = dy[row + col * dy_ldim] * activation_derivative<Act>(x);
+    }
+  }
+}
+
+template <typename TensorDataType>
+void apply_activation_derivative(fc_activation act,
+                                 El::AbstractMatrix<TensorDataType> const& output,
+                                 El::AbstractMatrix<TensorDataType> const& gradient_wrt_output,
+                                 El::Matrix<TensorDataType, El::Device::CPU>& workspace)
+{
+  switch (act) {
+  case fc_activation::RELU:
+    apply_activation_derivative<fc_activation::RELU>(output, gradient_wrt_output, workspace);
+    break;
+  case fc_activation::GELU:
+    apply_activation_derivative<fc_activation::GELU>(output, gradient_wrt_output, workspace);
+    break;
+  case fc_activation::SIGMOID:
+    apply_activation_derivative<fc_activation::SIGMOID>(output, gradient_wrt_output, workspace);
+    break;
+  case fc_activation::TANH:
+    apply_activation_derivative<fc_activation::TANH>(output, gradient_wrt_output, workspace);
+    break;
+  case fc_activation::NONE:
+  default:
+    LBANN_ERROR("invalid fused activation");
+  }
+}
+
+std::string fc_activation_to_string(fc_activation act)
+{
+  switch (act) {
+  case fc_activation::NONE:    return "none";
+  case fc_activation::RELU:    return "relu";
+  case fc_activation::GELU:    return "gelu";
+  case fc_activation::SIGMOID: return "sigmoid";
+  case fc_activation::TANH:    return "tanh";
+  default:                     return "invalid";
+  }
+}
+
+} // namespace <anon>
+
 template <typename TensorDataType, data_layout T_layout, El::Device Dev>
 fully_connected_layer<TensorDataType, T_layout, Dev>::fully_connected_layer(
   int output_size,
@@ -66,7 +271,8 @@ fully_connected_layer<TensorDataType, T_layout, Dev>::fully_connected_layer(
   const fully_connected_layer& other)
   : data_type_layer<TensorDataType>(other),
   m_bias_scaling_factor(other.m_bias_scaling_factor),
-  m_transpose(other.m_transpose) {
+  m_transpose(other.m_transpose),
+  m_activation(other.m_activation) {
 
   // Deep matrix copies
   m_bias_gradient = other.m_bias_gradient;
@@ -81,6 +287,7 @@ auto fully_connected_layer<TensorDataType, T_layout, Dev>::operator=(
   data_type_layer<TensorDataType>::operator=(other);
   m_bias_scaling_factor = other.m_bias_scaling_factor;
   m_transpose = other.m_transpose;
+  m_activation = other.m_activation;
 
   // Deep matrix copies
   deallocate_matrices();
@@ -105,14 +312,53 @@ fully_connected_layer<TensorDataType, T_layout, Dev>::get_description() const {
                           ? "disabled"
                           : "enabled");
   desc.add("Bias", bias_str);
+  if (m_activation != fc_activation::NONE) {
+    desc.add("Fused activation", fc_activation_to_string(m_activation));
+  }
   return desc;
 }
 
+template <typename TensorDataType, data_layout T_layout, El::Device Dev>
+auto fully_connected_layer<TensorDataType, T_layout, Dev>::estimate_work() const
+  -> work_estimate {
+  // GEMM with local linearity weights (m x k) and local mini-batch
+  // (n samples). Bias and activation are entry-wise on the output.
+  const auto& linearity = this->weights_values(0).LockedMatrix();
+  const double m = m_transpose ? linearity.Width() : linearity.Height();
+  const double k = m_transpose ? linearity.Height() : linearity.Width();
+  const double n = this->get_local_prev_activations().Width();
+  constexpr double word_size = sizeof(TensorDataType);
+  const bool has_bias = (m_bias_scaling_factor
+                         != El::TypeTraits<TensorDataType>::Zero());
+  const bool has_activation = (m_activation != fc_activation::NONE);
+  work_estimate work;
+  work.fp_flops = 2 * m * k * n + (has_bias ? m * n : 0.);
+  work.fp_bytes = (m * k + k * n + m * n) * word_size;
+  work.bp_flops = 4 * m * k * n + (has_bias ? m * n : 0.);
+  work.bp_bytes = (2 * m * k + 2 * k * n + 2 * m * n) * word_size;
+  if (has_activation) {
+    work.fp_flops += m * n;
+    work.bp_flops += 2 * m * n;
+    work.bp_bytes += m * n * word_size;
+  }
+  return work;
+}
+
 template <typename TensorDataType, data_layout T_layout, El::Device Dev>
 void fully_connected_layer<TensorDataType, T_layout, Dev>
 ::setup_data(size_t max_mini_batch_size) {
   data_type_layer<TensorDataType>::setup_data(max_mini_batch_size);
 
+  // Fused activations are only implemented for data-parallel CPU
+  if (m_activation != fc_activation::NONE
+      && (T_layout != data_layout::DATA_PARALLEL
+          || Dev != El::Device::CPU)) {
+    LBANN_ERROR(this->get_type(), " layer \"", this->get_name(), "\" ",
+                "has fused activation \"",
+                fc_activation_to_string(m_activation), "\", ",
+                "which is only supported with data-parallel layout on CPU");
+  }
+
   // Initialize default weights if none are provided
   if (this->num_weights() > 2) {
     LBANN_ERROR("attempted to setup ", this->get_name(), " with an invalid number of weights");
@@ -252,13 +498,10 @@ void fp_compute_impl(fully_connected_layer<TensorDataType, data_layout::MODEL_PA
   // Apply bias if needed
   if(l.m_bias_scaling_factor != El::TypeTraits<TensorDataType>::Zero()) {
     const auto& local_bias = l.weights_values(1).LockedMatrix();
-    auto& local_output = output.Matrix();
-    El::IndexDependentMap(local_output,
-                          (std::function<TensorDataType(El::Int,El::Int,const TensorDataType&)>)
-                          ([&l,&local_bias](El::Int r, El::Int c,const TensorDataType& z)
-                           ->TensorDataType {
-                            return z + l.m_bias_scaling_factor * local_bias(r, 0);
-                          }));
+    apply_bias_and_activation<fc_activation::NONE>(output.Matrix(),
+                                                   local_bias.LockedBuffer(),
+                                                   l.m_bias_scaling_factor,
+                                                   l.m_activation_workspace);
   }
 
 }
@@ -357,15 +600,18 @@ void fp_compute_impl(fully_connected_layer<TensorDataType, data_layout::DATA_PAR
            El::TypeTraits<TensorDataType>::One(), local_linearity, local_input,
            El::TypeTraits<TensorDataType>::Zero(), local_output);
 
-  // Apply bias if needed
+  // Apply bias and activation if needed
+  // Note: Both are applied in a single pass over the output.
+  const TensorDataType* bias = nullptr;
   if(l.m_bias_scaling_factor != El::TypeTraits<TensorDataType>::Zero()) {
-    const auto& local_bias = l.weights_values(1).LockedMatrix();
-    El::IndexDependentMap(local_output,
-                          (std::function<TensorDataType(El::Int,El::Int,const TensorDataType&)>)
-                          ([&l,&local_bias](El::Int r, El::Int c,const TensorDataType& z)
-                           ->TensorDataType {
-                            return z + l.m_bias_scaling_factor * local_bias(r, 0);
-                          }));
+    bias = l.weights_values(1).LockedMatrix().LockedBuffer();
+  }
+  if (bias != nullptr || l.m_activation != fc_activation::NONE) {
+    apply_bias_and_activation(l.m_activation,
+                              local_output,
+                              bias,
+                              l.m_bias_scaling_factor,
+                              l.m_activation_workspace);
   }
 
 }
@@ -374,10 +620,23 @@ void fp_compute_impl(fully_connected_layer<TensorDataType, data_layout::DATA_PAR
 template <typename TensorDataType>
 void bp_compute_impl(fully_connected_layer<TensorDataType, data_layout::DATA_PARALLEL, El::Device::CPU>& l) {
 
+  // Apply activation derivative if needed
+  // Note: The remaining computation only depends on the gradient
+  // w.r.t. the pre-activations.
+  const El::AbstractMatrix<TensorDataType>* gradient_wrt_preactivations
+    = &l.get_local_prev_error_signals();
+  if (l.m_activation != fc_activation::NONE) {
+    apply_activation_derivative(l.m_activation,
+                                l.get_local_activations(),
+                                *gradient_wrt_preactivations,
+                                l.m_activation_workspace);
+    gradient_wrt_preactivations = &l.m_activation_workspace;
+  }
+
   // Matrices
   const auto& local_linearity = l.weights_values(0).LockedMatrix();
   const auto& local_input = l.get_local_prev_activations();
-  const auto& local_gradient_wrt_output = l.get_local_prev_error_signals();
+  const auto& local_gradient_wrt_output = *gradient_wrt_preactivations;
   auto& local_gradient_wrt_input = l.get_local_error_signals();
 
   // Compute gradient w.r.t. bias if needed
@@ -718,8 +977,12 @@ void fully_connected_layer<T, L, D>::fill_onnx_node(
   if (has_bias)
     gemm->add_input(C_name);
 
-  gemm->add_output(layer_name + "_0");
-  gemm->set_name(layer_name + "_0");
+  // Output of GEMM is the pre-activation if an activation is fused
+  auto const gemm_name =
+    (m_activation == fc_activation::NONE ? layer_name + "_0"
+                                         : layer_name + "_gemm");
+  gemm->add_output(gemm_name);
+  gemm->set_name(gemm_name);
   gemm->set_op_type("Gemm");
   gemm->set_domain("");
   gemm->set_doc_string("Gemm node for Fully Connected Layer");
@@ -748,6 +1011,23 @@ void fully_connected_layer<T, L, D>::fill_onnx_node(
     transB->set_type(onnx::AttributeProto::INT);
     transB->set_i(1); // Should be 1 because ONNX will do x*W^T + b
   }
+
+  // Setup the activation node, if applicable.
+  if (m_activation != fc_activation::NONE) {
+    auto* act = graph.add_node();
+    act->add_input(gemm_name);
+    act->add_output(layer_name + "_0");
+    act->set_name(layer_name + "_0");
+    switch (m_activation) {
+    case fc_activation::RELU:    act->set_op_type("Relu");    break;
+    case fc_activation::GELU:    act->set_op_type("Gelu");    break;
+    case fc_activation::SIGMOID: act->set_op_type("Sigmoid"); break;
+    case fc_activation::TANH:    act->set_op_type("Tanh");    break;
+    default: LBANN_ERROR("invalid fused activation");
+    }
+    act->set_domain("");
+    act->set_doc_string("Fused activation for Fully Connected Layer");
+  }
 }
 #endif // LBANN_HAS_ONNX
 
@@ -757,11 +1037,32 @@ std::unique_ptr<Layer> build_fully_connected_layer_from_pbuf(
 {
   using LayerType = fully_connected_layer<TensorDataType, layout, device>;
   const auto& params = layer_msg.fully_connected();
-  return std::make_unique<LayerType>(
+  auto layer = std::make_unique<LayerType>(
     params.num_neurons(),
     params.transpose(),
     nullptr,
     params.has_bias());
+  const auto& activation_str = params.activation();
+  if (activation_str.empty() || activation_str == "none") {
+    layer->set_fused_activation(fc_activation::NONE);
+  }
+  else if (activation_str == "relu") {
+    layer->set_fused_activation(fc_activation::RELU);
+  }
+  else if (activation_str == "gelu") {
+    layer->set_fused_activation(fc_activation::GELU);
+  }
+  else if (activation_str == "sigmoid") {
+    layer->set_fused_activation(fc_activation::SIGMOID);
+  }
+  else if (activation_str == "tanh") {
+    layer->set_fused_activation(fc_activation::TANH);
+  }
+  else {
+    LBANN_ERROR("fully-connected layer \"", layer_msg.name(), "\" ",
+                "has invalid activation (\"", activation_str, "\")");
+  }
+  return layer;
 }
 
 #define PROTO_DEVICE(T, Device) \
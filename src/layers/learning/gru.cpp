@@ -32,9 +32,12 @@
 #include "lbann/proto/proto_common.hpp"
 #include "lbann/utils/dim_helpers.hpp"
 #include "lbann/utils/hash.hpp"
+#include "lbann/utils/omp_pragma.hpp"
 #include "lbann/utils/sync_info_helpers.hpp"
 #include <layers.pb.h>
 
+#include <algorithm>
+
 namespace lbann {
 
 // =========================================================
@@ -58,6 +61,8 @@ gru_layer<TensorDataType, Layout, Device>::gru_layer(const gru_layer& other)
     m_num_layers{other.m_num_layers} {
 #ifdef LBANN_GRU_LAYER_ONEDNN_CPU_SUPPORTED
   m_onednn_cpu_objects.reset();
+#else
+  m_native_cpu_workspace.reset();
 #endif // LBANN_GRU_LAYER_ONEDNN_CPU_SUPPORTED
 #ifdef LBANN_GRU_LAYER_CUDNN_SUPPORTED
   m_cudnn_objects.reset();
@@ -72,6 +77,8 @@ gru_layer<TensorDataType, Layout, Device>& gru_layer<TensorDataType, Layout, Dev
   m_num_layers = other.m_num_layers;
 #ifdef LBANN_GRU_LAYER_ONEDNN_CPU_SUPPORTED
   m_onednn_cpu_objects.reset();
+#else
+  m_native_cpu_workspace.reset();
 #endif // LBANN_GRU_LAYER_ONEDNN_CPU_SUPPORTED
 #ifdef LBANN_GRU_LAYER_CUDNN_SUPPORTED
   m_cudnn_objects.reset();
@@ -922,6 +929,396 @@ void bp_compute_impl(
 
 }
 
+#else
+
+// =========================================================
+// Native CPU implementation
+// =========================================================
+
+// Note: Uses the gate definitions in the LBANN weight layout,
+// ordered {reset, update, new}:
+//
+//   r_t = sigmoid(W_ir x_t + b_ir + W_hr h_{t-1} + b_hr)
+//   z_t = sigmoid(W_iz x_t + b_iz + W_hz h_{t-1} + b_hz)
+//   n_t = tanh(W_in x_t + b_in + r_t * (W_hn h_{t-1} + b_hn))
+//   h_t = (1 - z_t) * n_t + z_t * h_{t-1}
+//
+// Intermediate matrices have one column per (timestep, sample) pair
+// so that the input projections for the whole sequence can be
+// computed with a single GEMM.
+
+namespace {
+template <typename TensorDataType>
+inline TensorDataType sigmoid(const TensorDataType& x) {
+  const auto one = El::To<TensorDataType>(1);
+  return one / (one + El::Exp(-x));
+}
+} // namespace <anon>
+
+// ---------------------------------
+// Native CPU forward prop
+// ---------------------------------
+
+template <typename TensorDataType>
+void fp_compute_impl(
+  gru_layer<TensorDataType,data_layout::DATA_PARALLEL,El::Device::CPU>& l) {
+
+  // Matrices
+  using LocalMat = El::Matrix<TensorDataType, El::Device::CPU>;
+  const auto& input_sequence
+    = dynamic_cast<const LocalMat&>(l.get_local_prev_activations(0));
+  const auto& init_hidden
+    = dynamic_cast<const LocalMat&>(l.get_local_prev_activations(1));
+  auto& output_sequence
+    = dynamic_cast<LocalMat&>(l.get_local_activations());
+
+  // Dimensions
+  const El::Int local_mini_batch_size = input_sequence.Width();
+  const El::Int sequence_length = l.get_input_dims(0)[0];
+  const El::Int input_size = l.get_input_size(0) / sequence_length;
+  const El::Int hidden_size = l.m_hidden_size;
+  const El::Int num_layers = l.m_num_layers;
+  const El::Int num_columns = sequence_length * local_mini_batch_size;
+
+  // Return immediately if there is no local data.
+  if (local_mini_batch_size <= 0) {
+    return;
+  }
+
+  // Initialize workspace
+  using Workspace = typename gru_layer<
+    TensorDataType,data_layout::DATA_PARALLEL,El::Device::CPU>::NativeCpuWorkspace;
+  if (l.m_native_cpu_workspace == nullptr) {
+    l.m_native_cpu_workspace = std::make_unique<Workspace>();
+  }
+  auto& workspace = *l.m_native_cpu_workspace;
+  workspace.gates.resize(num_layers);
+  workspace.hh_new.resize(num_layers);
+  workspace.hidden.resize(num_layers);
+
+  // Reorder input sequence so that each column is one timestep of
+  // one sample
+  workspace.input_sequence.Resize(input_size, num_columns);
+  LBANN_OMP_PARALLEL_FOR
+  for (El::Int sample=0; sample<local_mini_batch_size; ++sample) {
+    for (El::Int step=0; step<sequence_length; ++step) {
+      std::copy_n(
+        input_sequence.LockedBuffer(step*input_size, sample),
+        input_size,
+        workspace.input_sequence.Buffer(
+          0, step*local_mini_batch_size+sample));
+    }
+  }
+
+  const auto zero = El::TypeTraits<TensorDataType>::Zero();
+  const auto one = El::TypeTraits<TensorDataType>::One();
+  LocalMat hh_proj(3*hidden_size, local_mini_batch_size);
+  for (El::Int layer_id=0; layer_id<num_layers; ++layer_id) {
+
+    // Matrices for current GRU cell
+    const auto& ih_matrix = dynamic_cast<const LocalMat&>(
+      l.weights_values(4*layer_id).LockedMatrix());
+    const auto& hh_matrix = dynamic_cast<const LocalMat&>(
+      l.weights_values(4*layer_id+1).LockedMatrix());
+    const auto& ih_bias = dynamic_cast<const LocalMat&>(
+      l.weights_values(4*layer_id+2).LockedMatrix());
+    const auto& hh_bias = dynamic_cast<const LocalMat&>(
+      l.weights_values(4*layer_id+3).LockedMatrix());
+    const auto& layer_input = (layer_id == 0
+                               ? workspace.input_sequence
+                               : workspace.hidden[layer_id-1]);
+    auto& gates = workspace.gates[layer_id];
+    auto& hh_new = workspace.hh_new[layer_id];
+    auto& hidden = workspace.hidden[layer_id];
+    gates.Resize(3*hidden_size, num_columns);
+    hh_new.Resize(hidden_size, num_columns);
+    hidden.Resize(hidden_size, num_columns);
+
+    // Input projections for entire sequence
+    El::Gemm(El::NORMAL, El::NORMAL,
+             one, ih_matrix, layer_input,
+             zero, gates);
+
+    // Iterate through sequence
+    const auto* __restrict__ ih_bias_buf = ih_bias.LockedBuffer();
+    const auto* __restrict__ hh_bias_buf = hh_bias.LockedBuffer();
+    for (El::Int step=0; step<sequence_length; ++step) {
+      const auto prev_hidden
+        = (step == 0
+           ? El::LockedView(init_hidden,
+                            El::IR(layer_id*hidden_size,
+                                   (layer_id+1)*hidden_size),
+                            El::ALL)
+           : El::LockedView(hidden,
+                            El::ALL,
+                            El::IR((step-1)*local_mini_batch_size,
+                                   step*local_mini_batch_size)));
+
+      // Hidden-hidden projections
+      El::Gemm(El::NORMAL, El::NORMAL,
+               one, hh_matrix, prev_hidden,
+               zero, hh_proj);
+
+      // Fused gate computation
+      LBANN_OMP_PARALLEL_FOR
+      for (El::Int sample=0; sample<local_mini_batch_size; ++sample) {
+        const El::Int col = step*local_mini_batch_size + sample;
+        auto* __restrict__ g = gates.Buffer(0, col);
+        auto* __restrict__ hn = hh_new.Buffer(0, col);
+        auto* __restrict__ h = hidden.Buffer(0, col);
+        const auto* __restrict__ hp = prev_hidden.LockedBuffer(0, sample);
+        const auto* __restrict__ p = hh_proj.LockedBuffer(0, sample);
+        for (El::Int i=0; i<hidden_size; ++i) {
+          const El::Int ir = i;
+          const El::Int iz = hidden_size + i;
+          const El::Int in = 2*hidden_size + i;
+          const auto r = sigmoid(g[ir] + ih_bias_buf[ir]
+                                 + p[ir] + hh_bias_buf[ir]);
+          const auto z = sigmoid(g[iz] + ih_bias_buf[iz]
+                                 + p[iz] + hh_bias_buf[iz]);
+          const auto hh_n = p[in] + hh_bias_buf[in];
+          const auto n = El::Tanh(g[in] + ih_bias_buf[in] + r * hh_n);
+          g[ir] = r;
+          g[iz] = z;
+          g[in] = n;
+          hn[i] = hh_n;
+          h[i] = (one - z) * n + z * hp[i];
+        }
+      }
+
+    }
+
+  }
+
+  // Copy output sequence from last GRU cell
+  const auto& hidden = workspace.hidden.back();
+  LBANN_OMP_PARALLEL_FOR
+  for (El::Int sample=0; sample<local_mini_batch_size; ++sample) {
+    for (El::Int step=0; step<sequence_length; ++step) {
+      std::copy_n(
+        hidden.LockedBuffer(0, step*local_mini_batch_size+sample),
+        hidden_size,
+        output_sequence.Buffer(step*hidden_size, sample));
+    }
+  }
+
+}
+
+// ---------------------------------
+// Native CPU back prop
+// ---------------------------------
+
+template <typename TensorDataType>
+void bp_compute_impl(
+  gru_layer<TensorDataType,data_layout::DATA_PARALLEL,El::Device::CPU>& l) {
+
+  // Matrices
+  using LocalMat = El::Matrix<TensorDataType, El::Device::CPU>;
+  const auto& init_hidden
+    = dynamic_cast<const LocalMat&>(l.get_local_prev_activations(1));
+  const auto& output_sequence_grad
+    = dynamic_cast<const LocalMat&>(l.get_local_prev_error_signals());
+  auto& input_sequence_grad
+    = dynamic_cast<LocalMat&>(l.get_local_error_signals(0));
+  auto& init_hidden_grad
+    = dynamic_cast<LocalMat&>(l.get_local_error_signals(1));
+
+  // Dimensions
+  const El::Int local_mini_batch_size = output_sequence_grad.Width();
+  const El::Int sequence_length = l.get_input_dims(0)[0];
+  const El::Int input_size = l.get_input_size(0) / sequence_length;
+  const El::Int hidden_size = l.m_hidden_size;
+  const El::Int num_layers = l.m_num_layers;
+  const El::Int num_columns = sequence_length * local_mini_batch_size;
+
+  // Define closure to send weight gradients to optimizers
+  std::vector<LocalMat> weights_grad_list(4*num_layers);
+  for (El::Int i=0; i<num_layers; ++i) {
+    weights_grad_list[4*i].Resize(3*hidden_size,
+                                  i == 0 ? input_size : hidden_size);
+    weights_grad_list[4*i+1].Resize(3*hidden_size, hidden_size);
+    weights_grad_list[4*i+2].Resize(3*hidden_size, 1);
+    weights_grad_list[4*i+3].Resize(3*hidden_size, 1);
+  }
+  auto send_weight_grads_to_optimizers = [&] () {
+    TensorDataType buf_scale, in_scale;
+    for (El::Int i=0; i<4*num_layers; ++i) {
+      auto&& opt = l.get_weights(i).get_optimizer();
+      if (opt != nullptr) {
+        auto& buf = opt->get_gradient_buffer(buf_scale, in_scale, true);
+        El::Scale(buf_scale, buf);
+        El::Axpy(in_scale, weights_grad_list[i], buf.Matrix());
+      }
+    }
+  };
+
+  // Return immediately if there is no local data
+  if (local_mini_batch_size <= 0) {
+    for (auto& dw : weights_grad_list) {
+      El::Zero(dw);
+    }
+    send_weight_grads_to_optimizers();
+    return;
+  }
+
+  // Workspace from forward prop
+  if (l.m_native_cpu_workspace == nullptr) {
+    LBANN_ERROR(
+      l.get_type()," layer \"",l.get_name(),"\" ",
+      "attempted to perform backward prop with native CPU implementation ",
+      "before forward prop");
+  }
+  const auto& workspace = *l.m_native_cpu_workspace;
+
+  // Reorder output sequence grad so that each column is one
+  // timestep of one sample
+  LocalMat hidden_grad(hidden_size, num_columns);
+  LBANN_OMP_PARALLEL_FOR
+  for (El::Int sample=0; sample<local_mini_batch_size; ++sample) {
+    for (El::Int step=0; step<sequence_length; ++step) {
+      std::copy_n(
+        output_sequence_grad.LockedBuffer(step*hidden_size, sample),
+        hidden_size,
+        hidden_grad.Buffer(0, step*local_mini_batch_size+sample));
+    }
+  }
+
+  const auto zero = El::TypeTraits<TensorDataType>::Zero();
+  const auto one = El::TypeTraits<TensorDataType>::One();
+  LocalMat gates_grad(3*hidden_size, num_columns);
+  LocalMat hh_proj_grad(3*hidden_size, num_columns);
+  LocalMat prev_hidden(hidden_size, num_columns);
+  LocalMat step_grad(hidden_size, local_mini_batch_size);
+  LocalMat input_grad(input_size, num_columns);
+  LocalMat ones(num_columns, 1);
+  El::Fill(ones, one);
+  for (El::Int layer_id=num_layers-1; layer_id>=0; --layer_id) {
+
+    // Matrices for current GRU cell
+    const auto& ih_matrix = dynamic_cast<const LocalMat&>(
+      l.weights_values(4*layer_id).LockedMatrix());
+    const auto& hh_matrix = dynamic_cast<const LocalMat&>(
+      l.weights_values(4*layer_id+1).LockedMatrix());
+    const auto& layer_input = (layer_id == 0
+                               ? workspace.input_sequence
+                               : workspace.hidden[layer_id-1]);
+    const auto& gates = workspace.gates[layer_id];
+    const auto& hh_new = workspace.hh_new[layer_id];
+    const auto& hidden = workspace.hidden[layer_id];
+
+    // Hidden state before each timestep
+    {
+      auto dst_init = El::View(prev_hidden,
+                               El::ALL,
+                               El::IR(0, local_mini_batch_size));
+      auto dst_rest = El::View(prev_hidden,
+                               El::ALL,
+                               El::IR(local_mini_batch_size, num_columns));
+      El::Copy(El::LockedView(init_hidden,
+                              El::IR(layer_id*hidden_size,
+                                     (layer_id+1)*hidden_size),
+                              El::ALL),
+               dst_init);
+      El::Copy(El::LockedView(hidden,
+                              El::ALL,
+                              El::IR(0, num_columns-local_mini_batch_size)),
+               dst_rest);
+    }
+
+    // Iterate backward through sequence
+    El::Zero(step_grad);
+    for (El::Int step=sequence_length-1; step>=0; --step) {
+
+      // Fused gate backprop
+      LBANN_OMP_PARALLEL_FOR
+      for (El::Int sample=0; sample<local_mini_batch_size; ++sample) {
+        const El::Int col = step*local_mini_batch_size + sample;
+        const auto* __restrict__ g = gates.LockedBuffer(0, col);
+        const auto* __restrict__ hn = hh_new.LockedBuffer(0, col);
+        const auto* __restrict__ hp = prev_hidden.LockedBuffer(0, col);
+        const auto* __restrict__ dy = hidden_grad.LockedBuffer(0, col);
+        auto* __restrict__ dg = gates_grad.Buffer(0, col);
+        auto* __restrict__ dp = hh_proj_grad.Buffer(0, col);
+        auto* __restrict__ dh_next = step_grad.Buffer(0, sample);
+        for (El::Int i=0; i<hidden_size; ++i) {
+          const El::Int ir = i;
+          const El::Int iz = hidden_size + i;
+          const El::Int in = 2*hidden_size + i;
+          const auto& r = g[ir];
+          const auto& z = g[iz];
+          const auto& n = g[in];
+          const auto dh = dy[i] + dh_next[i];
+          const auto dn = dh * (one - z) * (one - n * n);
+          const auto dr = dn * hn[i] * r * (one - r);
+          const auto dz = dh * (hp[i] - n) * z * (one - z);
+          dg[ir] = dr;
+          dg[iz] = dz;
+          dg[in] = dn;
+          dp[ir] = dr;
+          dp[iz] = dz;
+          dp[in] = dn * r;
+          dh_next[i] = dh * z;
+        }
+      }
+
+      // Backprop through hidden-hidden projections
+      const auto hh_proj_grad_step
+        = El::LockedView(hh_proj_grad,
+                         El::ALL,
+                         El::IR(step*local_mini_batch_size,
+                                (step+1)*local_mini_batch_size));
+      El::Gemm(El::TRANSPOSE, El::NORMAL,
+               one, hh_matrix, hh_proj_grad_step,
+               one, step_grad);
+
+    }
+
+    // Gradient w.r.t. initial hidden state
+    {
+      auto dst = El::View(init_hidden_grad,
+                          El::IR(layer_id*hidden_size,
+                                 (layer_id+1)*hidden_size),
+                          El::ALL);
+      El::Copy(step_grad, dst);
+    }
+
+    // Weight gradients for entire sequence
+    El::Gemm(El::NORMAL, El::TRANSPOSE,
+             one, gates_grad, layer_input,
+             zero, weights_grad_list[4*layer_id]);
+    El::Gemm(El::NORMAL, El::TRANSPOSE,
+             one, hh_proj_grad, prev_hidden,
+             zero, weights_grad_list[4*layer_id+1]);
+    El::Gemv(El::NORMAL,
+             one, gates_grad, ones,
+             zero, weights_grad_list[4*layer_id+2]);
+    El::Gemv(El::NORMAL,
+             one, hh_proj_grad, ones,
+             zero, weights_grad_list[4*layer_id+3]);
+
+    // Gradient w.r.t. input sequence for entire sequence
+    El::Gemm(El::TRANSPOSE, El::NORMAL,
+             one, ih_matrix, gates_grad,
+             zero, layer_id == 0 ? input_grad : hidden_grad);
+
+  }
+
+  // Reorder input sequence grad
+  LBANN_OMP_PARALLEL_FOR
+  for (El::Int sample=0; sample<local_mini_batch_size; ++sample) {
+    for (El::Int step=0; step<sequence_length; ++step) {
+      std::copy_n(
+        input_grad.LockedBuffer(0, step*local_mini_batch_size+sample),
+        input_size,
+        input_sequence_grad.Buffer(step*input_size, sample));
+    }
+  }
+
+  // Send gradients to optimizers
+  send_weight_grads_to_optimizers();
+
+}
+
 #endif // LBANN_GRU_LAYER_ONEDNN_CPU_SUPPORTED
 
 // =========================================================
@@ -1644,19 +2041,10 @@ struct Builder<TensorDataType,data_layout::DATA_PARALLEL,El::Device::CPU>
   template <typename... Args>
   static std::unique_ptr<Layer> Build(Args&&... args)
   {
-    constexpr auto Layout = data_layout::DATA_PARALLEL;
-    constexpr auto Device = El::Device::CPU;
-#ifdef LBANN_GRU_LAYER_ONEDNN_CPU_SUPPORTED
-    using LayerType = gru_layer<TensorDataType,Layout,Device>;
+    using LayerType = gru_layer<TensorDataType,
+                                data_layout::DATA_PARALLEL,
+                                El::Device::CPU>;
     return std::make_unique<LayerType>(std::forward<Args>(args)...);
-#else
-    LBANN_ERROR(
-      "CPU gru_layer requires oneDNN "
-      "(TensorDataType=",TypeName<TensorDataType>(),", ",
-      "Layout=",to_string(Layout),", ",
-      "Device=",to_string(Device),")");
-    return nullptr;
-#endif // LBANN_GRU_LAYER_ONEDNN_CPU_SUPPORTED
   }
 };
 
@@ -1703,14 +2091,12 @@ std::unique_ptr<Layer> build_gru_layer_from_pbuf(
 // Explicit template instantiation
 // =========================================================
 
-#ifdef LBANN_GRU_LAYER_ONEDNN_CPU_SUPPORTED
 #define PROTO(T)                                                        \
   template class gru_layer<                                             \
     T, data_layout::DATA_PARALLEL, El::Device::CPU>;
 #define LBANN_INSTANTIATE_CPU_HALF
 #include "lbann/macros/instantiate.hpp"
 #undef PROTO
-#endif // LBANN_GRU_LAYER_ONEDNN_CPU_SUPPORTED
 #ifdef LBANN_GRU_LAYER_CUDNN_SUPPORTED
 #define PROTO(T)                                                        \
   template class gru_layer<                                             \
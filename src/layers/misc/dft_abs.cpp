@@ -25,7 +25,9 @@
 ////////////////////////////////////////////////////////////////////////////////
 
 #include <lbann/layers/misc/dft_abs.hpp>
+#include <lbann/utils/argument_parser.hpp>
 #include <lbann/utils/memory.hpp>
+#include <lbann/utils/options.hpp>
 
 // This file is only compiled if LBANN has FFTW support, so we don't
 // need to check for it here.
@@ -293,6 +295,13 @@ void dft_abs_layer<T,D>::setup_dims(DataReaderMetaData& dr_metadata)
   data_type_layer<T>::setup_dims(dr_metadata);
   this->set_output_dims(this->get_input_dims());
   pimpl_ = std::make_unique<dft_abs_impl<T, D>>(this->get_input_dims());
+
+  // Reuse FFTW plans from previous runs, if requested
+  if constexpr (D == El::Device::CPU) {
+    auto const& arg_parser = global_argument_parser();
+    fftw::PlanCache<T>::instance().set_wisdom_file(
+      arg_parser.get<std::string>(LBANN_OPTION_FFTW_WISDOM));
+  }
 }
 
 template <typename T, El::Device D>
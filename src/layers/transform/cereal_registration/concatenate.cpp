@@ -41,6 +41,7 @@ concatenate_layer<TensorDataType,Layout,Device>
   // Members that aren't serialized:
   //   m_workspace
   //   m_workspace_event
+  //   m_parent_output_views
 }
 
 } // namespace lbann
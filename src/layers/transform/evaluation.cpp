@@ -41,10 +41,8 @@ namespace {
 
 /** CPU implementation of evaluation layer forward prop. */
 template <typename TensorDataType, typename EvalDataType>
-void fp_cpu(lbann_comm& comm,
-            const El::AbstractDistMatrix<TensorDataType>& input,
-            EvalDataType& value,
-            Al::request& req) {
+void fp_cpu(const El::AbstractDistMatrix<TensorDataType>& input,
+            EvalDataType& value) {
   const auto& local_input = input.LockedMatrix();
   const auto& local_height = local_input.Height();
   const auto& local_width = local_input.Width();
@@ -57,25 +55,20 @@ void fp_cpu(lbann_comm& comm,
     }
   }
   value = value / mini_batch_size;
-  comm.nb_allreduce(&value, 1, input.DistComm(), req);
 }
 
 #ifdef LBANN_HAS_HALF
 template <typename EvalDataType>
-void fp_cpu(lbann_comm& comm,
-            const El::AbstractDistMatrix<cpu_fp16>& input,
-            EvalDataType& value,
-            Al::request& req) {
+void fp_cpu(const El::AbstractDistMatrix<cpu_fp16>& input,
+            EvalDataType& value) {
     LBANN_ERROR("This function is not supported in FP16 on CPUs");
 }
 #endif // LBANN_HAS_HALF
 
 #ifdef LBANN_HAS_GPU_FP16
 template <typename EvalDataType>
-void fp_cpu(lbann_comm& comm,
-            const El::AbstractDistMatrix<fp16>& input,
-            EvalDataType& value,
-            Al::request& req) {
+void fp_cpu(const El::AbstractDistMatrix<fp16>& input,
+            EvalDataType& value) {
     LBANN_ERROR("This function is not supported in FP16 on CPUs");
 }
 #endif // LBANN_HAS_GPU_HALF
@@ -83,8 +76,7 @@ void fp_cpu(lbann_comm& comm,
 #ifdef LBANN_HAS_GPU
 /** GPU implementation of evaluation layer forward prop. */
 template <typename TensorDataType, typename EvalDataType>
-void fp_gpu(lbann_comm& comm,
-            const El::AbstractDistMatrix<TensorDataType>& input,
+void fp_gpu(const El::AbstractDistMatrix<TensorDataType>& input,
             EvalDataType& value,
             gpu_lib::event_wrapper& copy_event) {
   const EvalDataType zero = El::TypeTraits<EvalDataType>::Zero();
@@ -160,16 +152,13 @@ void fp_gpu(lbann_comm& comm,
 
   // Compute average value across mini-batch
   El::Scale(one / El::To<EvalDataType>(mini_batch_size), sum_d);
-  comm.allreduce(
-    static_cast<El::AbstractMatrix<EvalDataType>&>(sum_d), input.DistComm());
   hydrogen::gpu::Copy1DToHost(sum_d.LockedBuffer(), &value, 1, sync_info);
   copy_event.record(sync_info.Stream());
 }
 
 #ifdef LBANN_HAS_GPU_FP16
 template <typename EvalDataType>
-void fp_gpu(lbann_comm& comm,
-            const El::AbstractDistMatrix<cpu_fp16>& input,
+void fp_gpu(const El::AbstractDistMatrix<cpu_fp16>& input,
             EvalDataType& value,
             gpu_lib::event_wrapper& copy_event) {
   LBANN_ERROR("This function is not supported with "
@@ -185,15 +174,10 @@ void fp_gpu(lbann_comm& comm,
 
 template <typename TensorDataType>
 EvalType abstract_evaluation_layer<TensorDataType>::get_value(bool scaled) {
-  switch (this->get_device_allocation()) {
-  case El::Device::CPU: this->get_comm()->wait(m_allreduce_req); break;
-#ifdef LBANN_HAS_GPU
-  case El::Device::GPU: this->m_copy_event.synchronize(); break;
-#endif // LBANN_HAS_GPU
-  default: LBANN_ERROR("invalid device");
-  }
-  if (scaled) { return El::To<EvalDataType>(m_scale) * El::To<EvalDataType>(m_value(0,0)); }
-  else        { return m_value(0,0); }
+  const auto value = El::To<EvalDataType>(
+    this->m_model->get_scalar_reductions().get(m_reduction_slot));
+  if (scaled) { return El::To<EvalDataType>(m_scale) * value; }
+  else        { return value; }
 }
 
 template <typename TensorDataType>
@@ -226,24 +210,29 @@ void abstract_evaluation_layer<TensorDataType>::setup_data(size_t max_mini_batch
   m_value.SetMemoryMode(1); // Use pinned memory on host
 #endif // LBANN_HAS_GPU
   El::Zeros(m_value, 1, 1);
+
+  // Register with model's coalesced scalar reductions
+  auto& reductions = this->m_model->get_scalar_reductions();
+  m_reduction_slot =
+    reductions.add_slot(this->get_prev_activations().DistComm());
 }
 
 template <typename TensorDataType>
 void abstract_evaluation_layer<TensorDataType>::fp_compute() {
+  auto& reductions = this->m_model->get_scalar_reductions();
   switch (this->get_device_allocation()) {
   case El::Device::CPU:
-    this->get_comm()->wait(m_allreduce_req);
-    fp_cpu(*this->get_comm(),
-           this->get_prev_activations(),
-           m_value(0, 0),
-           m_allreduce_req);
+    fp_cpu(this->get_prev_activations(), m_value(0, 0));
+    reductions.contribute(m_reduction_slot, El::To<EvalType>(m_value(0, 0)));
     break;
 #ifdef LBANN_HAS_GPU
   case El::Device::GPU:
-    fp_gpu(*this->get_comm(),
-           this->get_prev_activations(),
-           m_value(0, 0),
-           m_copy_event);
+    fp_gpu(this->get_prev_activations(), m_value(0, 0), m_copy_event);
+    // Wait for device-to-host copy when the reduction starts
+    reductions.contribute(m_reduction_slot, [this]() {
+      m_copy_event.synchronize();
+      return El::To<EvalType>(m_value(0, 0));
+    });
     break;
 #endif // LBANN_HAS_GPU
   default: LBANN_ERROR("invalid device");
@@ -0,0 +1,244 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2022, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+#include <catch2/catch.hpp>
+
+#include "TestHelpers.hpp"
+#include "MPITestHelpers.hpp"
+
+#include <lbann/base.hpp>
+#include <lbann/execution_algorithms/sgd_execution_context.hpp>
+#include <lbann/layers/data_type_layer.hpp>
+#include <lbann/layers/io/input_layer.hpp>
+#include <lbann/models/model.hpp>
+#include <lbann/objective_functions/objective_function.hpp>
+#include <lbann/proto/factories.hpp>
+#include <lbann/trainers/trainer.hpp>
+#include <lbann/utils/lbann_library.hpp>
+
+#include <lbann.pb.h>
+#include <google/protobuf/text_format.h>
+
+#include <cmath>
+
+namespace pb = ::google::protobuf;
+
+namespace {
+
+using DataType = lbann::DataType;
+using StarMatType =
+  El::DistMatrix<DataType, El::STAR, El::STAR, El::ELEMENT, El::Device::CPU>;
+
+constexpr size_t mbs = 3;
+constexpr auto mode = lbann::execution_mode::training;
+const std::vector<int> input_dims = {6, 2};
+
+/** Input sliced in two, with a squared L2 norm on each output. */
+std::string make_prototext(int axis, std::vector<int> const& slice_points)
+{
+  std::string points;
+  for (auto const& p : slice_points) {
+    points += " slice_points: " + std::to_string(p);
+  }
+  return R"ptext(
+model {
+  objective_function {
+    layer_term {
+      scale_factor: 1.0
+      layer: "a"
+    }
+    layer_term {
+      scale_factor: 1.0
+      layer: "b"
+    }
+  }
+  layer {
+    name: "x"
+    children: "slice"
+    input {
+      data_field: "samples"
+    }
+  }
+  layer {
+    name: "slice"
+    parents: "x"
+    children: "a"
+    children: "b"
+    slice {
+      axis: )ptext" + std::to_string(axis) + points + R"ptext(
+    }
+  }
+  layer {
+    name: "a"
+    parents: "slice"
+    l2_norm2 {}
+  }
+  layer {
+    name: "b"
+    parents: "slice"
+    l2_norm2 {}
+  }
+}
+optimizer {
+  sgd {
+    learn_rate: 0.1
+  }
+}
+)ptext";
+}
+
+auto make_model(lbann::lbann_comm& comm, std::string const& prototext)
+{
+  lbann_data::LbannPB my_proto;
+  if (!pb::TextFormat::ParseFromString(prototext, &my_proto))
+    throw "Parsing protobuf failed.";
+  lbann::construct_trainer(&comm, my_proto.mutable_trainer(), my_proto);
+  lbann::DataReaderMetaData md;
+  md.data_dims[lbann::data_reader_target_mode::INPUT] = input_dims;
+  auto my_model = lbann::proto::construct_model(&comm,
+                                                -1,
+                                                my_proto.optimizer(),
+                                                my_proto.trainer(),
+                                                my_proto.model());
+  my_model->setup(mbs, md, lbann::get_trainer().get_grids());
+  lbann::SGDExecutionContext c(mode, mbs);
+  my_model->reset_mode(c, mode);
+  return my_model;
+}
+
+lbann::data_type_layer<DataType>& get_layer(lbann::model& m,
+                                            std::string const& name)
+{
+  for (int l = 0; l < m.get_num_layers(); ++l) {
+    if (m.get_layer(l).get_name() == name) {
+      return dynamic_cast<lbann::data_type_layer<DataType>&>(m.get_layer(l));
+    }
+  }
+  throw "Layer not found.";
+}
+
+/** Set deterministic samples, then run forward and backward prop. */
+void run_step(lbann::model& m)
+{
+  auto& input = dynamic_cast<lbann::input_layer<DataType>&>(get_layer(m, "x"));
+  StarMatType samples(input_dims[0] * input_dims[1],
+                      mbs,
+                      input.get_activations().Grid());
+  for (El::Int jl = 0; jl < samples.LocalWidth(); ++jl)
+    for (El::Int il = 0; il < samples.LocalHeight(); ++il) {
+      const auto i = samples.GlobalRow(il);
+      const auto j = samples.GlobalCol(jl);
+      samples.SetLocal(il, jl, DataType(std::cos(0.3 * i + 1.1 * j)));
+    }
+  input.set_samples(samples);
+
+  auto& obj = *m.get_objective_function();
+  m.clear_gradients();
+  m.forward_prop(mode);
+  obj.start_evaluation(mode, mbs);
+  obj.differentiate();
+  m.backward_prop();
+  obj.finish_evaluation(mode, mbs);
+}
+
+/** Check slice outputs against the input and the input gradient
+ *  against the gradient of the squared L2 norms. The objective
+ *  function averages over the mini-batch, so this is 2x/mbs. */
+void check_values(lbann::model& m,
+                  int axis,
+                  std::vector<int> const& slice_points)
+{
+  auto& slice = get_layer(m, "slice");
+  StarMatType input(get_layer(m, "x").get_activations());
+  StarMatType input_grad(slice.get_error_signals());
+  const El::Int width = input.Width();
+  for (int k = 0; k < 2; ++k) {
+    StarMatType output(slice.get_activations(k));
+    const int begin = slice_points[k];
+    const int end = slice_points[k + 1];
+    const El::Int num_cols = (axis == 0 ? input_dims[1] : end - begin);
+    REQUIRE(output.Height() == (axis == 0 ? end - begin : input_dims[0])
+                                 * num_cols);
+    REQUIRE(output.Width() == width);
+    for (El::Int j = 0; j < width; ++j) {
+      for (El::Int i = 0; i < output.Height(); ++i) {
+        const El::Int row = (axis == 0 ? begin + i / num_cols : i / num_cols);
+        const El::Int col = (axis == 0 ? i % num_cols : begin + i % num_cols);
+        const El::Int input_index = row * input_dims[1] + col;
+        INFO("Output " << k << ", entry (" << i << "," << j << ")");
+        CHECK(output.Get(i, j) == input.Get(input_index, j));
+      }
+    }
+  }
+  for (El::Int j = 0; j < width; ++j) {
+    for (El::Int i = 0; i < input.Height(); ++i) {
+      INFO("Input gradient entry (" << i << "," << j << ")");
+      CHECK(input_grad.Get(i, j) == Approx(2 * input.Get(i, j) / DataType(mbs)));
+    }
+  }
+}
+
+} // namespace <anon>
+
+TEST_CASE("Slice layer along the outermost dimension views its input",
+          "[mpi][layer][transform]")
+{
+  auto& comm = unit_test::utilities::current_world_comm();
+  const std::vector<int> slice_points = {0, 2, 6};
+  auto model = make_model(comm, make_prototext(0, slice_points));
+  run_step(*model);
+
+  // Outputs are row blocks of the input buffer
+  auto& slice = get_layer(*model, "slice");
+  const auto& input = get_layer(*model, "x").get_activations();
+  El::Int offset = 0;
+  for (int k = 0; k < 2; ++k) {
+    const auto& output = slice.get_activations(k);
+    CHECK(output.Viewing());
+    if (output.LocalHeight() > 0 && output.LocalWidth() > 0) {
+      CHECK(output.LockedBuffer() == input.LockedBuffer(offset, 0));
+    }
+    offset += output.Height();
+  }
+
+  check_values(*model, 0, slice_points);
+}
+
+TEST_CASE("Slice layer along an inner dimension copies its input",
+          "[mpi][layer][transform]")
+{
+  auto& comm = unit_test::utilities::current_world_comm();
+  const std::vector<int> slice_points = {0, 1, 2};
+  auto model = make_model(comm, make_prototext(1, slice_points));
+  run_step(*model);
+
+  // Outputs own their buffers
+  auto& slice = get_layer(*model, "slice");
+  for (int k = 0; k < 2; ++k) {
+    CHECK_FALSE(slice.get_activations(k).Viewing());
+  }
+
+  check_values(*model, 1, slice_points);
+}
@@ -33,19 +33,26 @@
 #include "lbann/comm_impl.hpp"
 #include "lbann/data_store/data_store_conduit.hpp"
 #include "lbann/io/persist.hpp"
+#include "lbann/layers/activations/relu.hpp"
 #include "lbann/layers/io/input_layer.hpp"
+#include "lbann/layers/learning/fully_connected.hpp"
+#include "lbann/layers/operator_layer.hpp"
 #include "lbann/layers/transform/dummy.hpp"
 #include "lbann/layers/transform/evaluation.hpp"
 #include "lbann/layers/transform/split.hpp"
 #include "lbann/metrics/layer_metric.hpp"
 #include "lbann/objective_functions/layer_term.hpp"
 #include "lbann/trainers/trainer.hpp"
+#include "lbann/utils/argument_parser.hpp"
 #include "lbann/utils/description.hpp"
 #include "lbann/utils/distconv.hpp"
 #include "lbann/utils/graph.hpp"
 #include "lbann/utils/omp_diagnostics.hpp"
+#include "lbann/utils/options.hpp"
 #include "lbann/utils/serialize.hpp"
+#include "lbann/utils/serialization/elastic_checkpoint.hpp"
 #include "lbann/utils/summary_impl.hpp"
+#include "lbann/utils/timer_map.hpp"
 #include "lbann/utils/onnx_utils.hpp"
 
 #include <model.pb.h>
@@ -74,6 +81,9 @@ model::model(lbann_comm* comm,
 {
 
   m_objective_function = std::move(obj_fn);
+  if (m_comm != nullptr) {
+    m_scalar_reductions = std::make_unique<scalar_reduction_buffer>(*m_comm);
+  }
   // Default model name
   static El::Int num_models = 0;
   m_name = "model" + std::to_string(num_models);
@@ -88,6 +98,10 @@ model::model(const model& other)
     m_name(other.m_name),
     m_model_is_setup(false)
 {
+  m_scalar_reductions =
+    (other.m_scalar_reductions
+       ? std::make_unique<scalar_reduction_buffer>(*other.m_scalar_reductions)
+       : nullptr);
 
   // Deep copies
   m_default_optimizer_msg =
@@ -153,6 +167,10 @@ model& model::operator=(const model& other)
 
   // Deep copies
   m_execution_context = other.m_execution_context;
+  m_scalar_reductions =
+    (other.m_scalar_reductions
+       ? std::make_unique<scalar_reduction_buffer>(*other.m_scalar_reductions)
+       : nullptr);
   m_objective_function =
     (other.m_objective_function
        ? std::make_unique<objective_function>(*other.m_objective_function)
@@ -184,6 +202,8 @@ model& model::operator=(const model& other)
 
   // Copy weights
   std::unordered_map<weights*, ViewingWeightsPtr> weights_map;
+  m_gradient_buckets.reset();
+  m_pipeline.reset();
   m_weights.clear();
   m_weights.reserve(other.m_weights.size());
   for (const auto& other_weights : other.m_weights) {
@@ -328,6 +348,14 @@ description model::get_description() const
   return desc;
 }
 
+scalar_reduction_buffer& model::get_scalar_reductions()
+{
+  if (m_scalar_reductions == nullptr) {
+    LBANN_ERROR("model \"", get_name(), "\" has no scalar reduction buffer");
+  }
+  return *m_scalar_reductions;
+}
+
 std::vector<metric*> model::get_metrics()
 {
   std::vector<metric*> ptrs;
@@ -712,49 +740,88 @@ void model::setup(size_t max_mini_batch_size,
     return;
   }
 
-  for (const auto& cb : m_callbacks) {
-    if (dynamic_cast<callback::checkpoint const*>(cb.get()))
-      cb->setup(this);
+  // Time each phase of setup
+  TimerMap setup_timer(build_string("model::setup (", get_name(), ")"));
+  setup_timer.timer().start();
+
+  {
+    ScopeTimer _(setup_timer, "checkpoint callbacks");
+    for (const auto& cb : m_callbacks) {
+      if (dynamic_cast<callback::checkpoint const*>(cb.get()))
+        cb->setup(this);
+    }
   }
 
   check_subgraph_parallelism();
 
   // Setup layers
-
-  setup_layer_topology();
-  setup_layer_execution_order();
-  if (this->is_subgraph_parallelism_enabled()) {
-    setup_subgrids();
+  {
+    ScopeTimer _(setup_timer, "layer topology");
+    setup_layer_topology();
+    setup_layer_execution_order();
+    if (this->is_subgraph_parallelism_enabled()) {
+      setup_subgrids();
+    }
   }
 
-  setup_layers(max_mini_batch_size, dr_metadata, grids_);
+  setup_scalar_reductions();
+  {
+    ScopeTimer _(setup_timer, "layers");
+    setup_layers(max_mini_batch_size, dr_metadata, grids_);
+  }
 
   // Setup weights
-  setup_weights();
-
-  // Setup objective function
-  m_objective_function->setup(*this);
+  {
+    ScopeTimer _(setup_timer, "weights");
+    setup_weights();
+  }
+  {
+    ScopeTimer _(setup_timer, "gradient buckets");
+    setup_gradient_buckets();
+  }
 
-  // Setup metrics
-  for (const auto& m : m_metrics) {
-    m->setup(*this);
+  // Setup objective function and metrics
+  {
+    ScopeTimer _(setup_timer, "objective function and metrics");
+    m_objective_function->setup(*this);
+    for (const auto& m : m_metrics) {
+      m->setup(*this);
+    }
+  }
+  {
+    ScopeTimer _(setup_timer, "pipeline");
+    setup_pipeline();
   }
 
   // Set up callbacks
-  for (const auto& cb : m_callbacks) {
-    if (!dynamic_cast<callback::checkpoint const*>(cb.get()))
-      cb->setup(this);
+  {
+    ScopeTimer _(setup_timer, "callbacks");
+    for (const auto& cb : m_callbacks) {
+      if (!dynamic_cast<callback::checkpoint const*>(cb.get()))
+        cb->setup(this);
+    }
   }
 
 #ifdef LBANN_HAS_DISTCONV
-  m_max_mini_batch_size_distconv = max_mini_batch_size;
-  setup_distconv();
+  {
+    ScopeTimer _(setup_timer, "distconv");
+    m_max_mini_batch_size_distconv = max_mini_batch_size;
+    setup_distconv();
+  }
 #endif
 
   // Callback hooks at end of setup
   do_setup_end_cbs();
 
   m_model_is_setup = true;
+
+  // Report setup times
+  setup_timer.timer().stop();
+  const auto& arg_parser = global_argument_parser();
+  if (arg_parser.get<bool>(LBANN_OPTION_PRINT_SETUP_TIMES)
+      && m_comm->am_trainer_master()) {
+    setup_timer.print(std::cout);
+  }
 }
 
 void model::setup_layer_topology()
@@ -818,6 +885,9 @@ void model::setup_layer_topology()
     }
   }
 
+  // Fold activation layers into fully-connected layers
+  fuse_fc_activation_layers(layer_set, layer_names);
+
   // Add utility layers
   add_evaluation_layers(layer_set, layer_names);
   add_dummy_layers(layer_names);
@@ -1689,6 +1759,57 @@ void model::setup_weights()
   }
 }
 
+void model::setup_scalar_reductions()
+{
+  auto& arg_parser = global_argument_parser();
+  if (m_scalar_reductions == nullptr) {
+    m_scalar_reductions = std::make_unique<scalar_reduction_buffer>(*m_comm);
+  }
+  m_scalar_reductions->clear_slots();
+  m_scalar_reductions->set_interval(
+    arg_parser.get<size_t>(LBANN_OPTION_METRIC_REDUCTION_INTERVAL));
+}
+
+void model::setup_gradient_buckets()
+{
+  auto& arg_parser = global_argument_parser();
+  const auto bucket_size =
+    arg_parser.get<size_t>(LBANN_OPTION_GRADIENT_BUCKET_SIZE);
+  if (bucket_size > 0) {
+    m_gradient_buckets =
+      std::make_unique<gradient_bucket_manager>(*m_comm, bucket_size);
+  }
+  else {
+    m_gradient_buckets.reset();
+  }
+  for (auto&& w : m_weights) {
+    auto* opt = w->get_optimizer();
+    if (opt != nullptr) {
+      opt->set_gradient_bucket_manager(m_gradient_buckets.get());
+    }
+  }
+}
+
+void model::setup_pipeline()
+{
+  auto& arg_parser = global_argument_parser();
+  const auto num_micro_batches =
+    arg_parser.get<size_t>(LBANN_OPTION_PIPELINE_MICRO_BATCHES);
+  if (num_micro_batches == 0) {
+    m_pipeline.reset();
+    return;
+  }
+  if (m_gradient_buckets != nullptr) {
+    LBANN_ERROR("gradient bucketing is not supported with "
+                "pipeline-parallel training");
+  }
+  const auto schedule = pipeline_schedule_type_from_string(
+    arg_parser.get<std::string>(LBANN_OPTION_PIPELINE_SCHEDULE));
+  m_pipeline =
+    std::make_unique<pipeline_executor>(*this, schedule, num_micro_batches);
+  m_pipeline->setup();
+}
+
 void model::add_evaluation_layers(std::unordered_set<Layer*>& layer_set,
                                   std::unordered_set<std::string>& layer_names)
 {
@@ -1948,6 +2069,132 @@ void model::add_split_layers(std::unordered_set<std::string>& layer_names)
   }
 }
 
+namespace {
+
+/** @brief Activation that a layer can be folded into.
+ *
+ *  Returns @c fc_activation::NONE if the layer can't be folded into a
+ *  fully-connected layer.
+ */
+fc_activation get_foldable_activation(const Layer& l)
+{
+  using ReLULayer =
+    relu_layer<DataType, data_layout::DATA_PARALLEL, El::Device::CPU>;
+  using CPUOperatorLayer = OperatorLayer<DataType,
+                                         DataType,
+                                         data_layout::DATA_PARALLEL,
+                                         El::Device::CPU>;
+  if (dynamic_cast<const ReLULayer*>(&l) != nullptr) {
+    return fc_activation::RELU;
+  }
+  if (const auto* op_layer = dynamic_cast<const CPUOperatorLayer*>(&l)) {
+    if (op_layer->num_operators() == 1) {
+      const auto op_type = op_layer->get_operator(0).get_type();
+      if (op_type == "sigmoid") {
+        return fc_activation::SIGMOID;
+      }
+      if (op_type == "hyperbolic tangent") {
+        return fc_activation::TANH;
+      }
+    }
+  }
+  return fc_activation::NONE;
+}
+
+} // namespace
+
+void model::fuse_fc_activation_layers(
+  std::unordered_set<Layer*>& layer_set,
+  std::unordered_set<std::string>& layer_names)
+{
+  if (!global_argument_parser().get<bool>(LBANN_OPTION_FUSE_FC_ACTIVATION)) {
+    return;
+  }
+  using FCLayer =
+    fully_connected_layer<DataType, data_layout::DATA_PARALLEL, El::Device::CPU>;
+
+  // Layers that are referenced by objective function terms or metrics
+  std::unordered_set<const Layer*> referenced_layers;
+  for (auto* t : m_objective_function->get_terms()) {
+    if (auto* term = dynamic_cast<layer_term*>(t)) {
+      referenced_layers.insert(&term->get_layer());
+    }
+  }
+  for (auto& ptr : m_metrics) {
+    if (auto* met = dynamic_cast<layer_metric*>(ptr.get())) {
+      referenced_layers.insert(&met->get_layer());
+    }
+  }
+
+  // Layers that callbacks look up by name
+  std::unordered_set<std::string> referenced_names;
+  for (const auto& cb : m_callbacks) {
+    for (auto&& name : cb->get_layer_names()) {
+      referenced_names.insert(std::move(name));
+    }
+  }
+
+  // Number of pointers to each layer from other layers
+  std::unordered_map<const Layer*, int> num_references;
+  for (auto& l : m_layers) {
+    for (const auto& ptr : l->get_layer_pointers()) {
+      if (const auto* raw_ptr = ptr.lock().get()) {
+        ++num_references[raw_ptr];
+      }
+    }
+  }
+
+  // Fold activation layers into parent fully-connected layers
+  std::unordered_set<const Layer*> folded_layers;
+  for (auto& l : m_layers) {
+    auto* fc = dynamic_cast<FCLayer*>(l.get());
+    if (fc == nullptr || fc->get_num_children() != 1 ||
+        fc->get_fused_activation() != fc_activation::NONE) {
+      continue;
+    }
+    auto& act = const_cast<Layer&>(fc->get_child_layer(0));
+    const auto activation = get_foldable_activation(act);
+    // Note: The activation layer is referenced once by its parent
+    // and once by each child. Any other reference (e.g. as a hint
+    // layer) would be left dangling.
+    if (activation == fc_activation::NONE || act.get_num_parents() != 1 ||
+        act.get_grid_tag() != fc->get_grid_tag() ||
+        referenced_layers.count(&act) > 0 ||
+        referenced_names.count(act.get_name()) > 0 ||
+        num_references[&act] != 1 + act.get_num_children()) {
+      continue;
+    }
+
+    // Connect fully-connected layer to children of activation layer
+    fc->clear_child_layers();
+    for (int i = 0; i < act.get_num_children(); ++i) {
+      auto& child = const_cast<Layer&>(act.get_child_layer(i));
+      child.replace_parent_layer(act.get_parent_layer_pointer(0),
+                                 child.find_parent_layer_index(act));
+      fc->add_child_layer(act.get_child_layer_pointer(i));
+    }
+    fc->set_fused_activation(activation);
+    folded_layers.insert(&act);
+  }
+
+  // Remove folded layers from model
+  if (folded_layers.empty()) {
+    return;
+  }
+  for (const auto* l : folded_layers) {
+    layer_set.erase(const_cast<Layer*>(l));
+    layer_names.erase(l->get_name());
+  }
+  m_layers.erase(std::remove_if(m_layers.begin(),
+                                m_layers.end(),
+                                [&folded_layers](const OwningLayerPtr& l) {
+                                  return folded_layers.count(l.get()) > 0;
+                                }),
+                 m_layers.end());
+  LBANN_MSG("model \"", get_name(), "\" folded ", folded_layers.size(),
+            " activation layer(s) into fully-connected layers");
+}
+
 void model::insert_layer(OwningLayerPtr&& new_layer,
                          std::string const& preceding_layer_name)
 {
@@ -2176,6 +2423,11 @@ void model::clear_gradients()
 void model::forward_prop(execution_mode mode)
 {
   do_model_forward_prop_begin_cbs(mode);
+  if (m_scalar_reductions != nullptr) {
+    const size_t step =
+      has_valid_execution_context() ? get_execution_context().get_step() : 0;
+    m_scalar_reductions->begin_step(mode, step);
+  }
 
   for (El::Int i = 0; i < get_num_layers(); ++i) {
     auto& l = get_layer(i);
@@ -2200,10 +2452,12 @@ void model::forward_prop(execution_mode mode)
   do_model_forward_prop_end_cbs(mode);
 }
 
-void model::backward_prop()
+void model::backward_prop(bool end_of_step)
 {
 
-  do_model_backward_prop_begin_cbs();
+  if (end_of_step) {
+    do_model_backward_prop_begin_cbs();
+  }
 
   for (El::Int i = get_num_layers() - 1; i >= 0; --i) {
 
@@ -2250,13 +2504,26 @@ void model::backward_prop()
     }
   }
 
-  do_model_backward_prop_end_cbs();
+  // Launch allreduces on partially filled gradient buckets
+  if (m_gradient_buckets != nullptr) {
+    m_gradient_buckets->flush();
+  }
+
+  if (end_of_step) {
+    do_model_backward_prop_end_cbs();
+  }
 }
 
 void model::update_weights()
 {
   do_model_optimize_begin_cbs();
 
+  // Launch allreduces on gradient buckets that were filled after
+  // backprop (e.g. by weight regularization terms)
+  if (m_gradient_buckets != nullptr) {
+    m_gradient_buckets->flush();
+  }
+
   // Apply optimization step to weights
   // Note: Heuristically, forward prop consumes weights in the same
   // order as m_weights and backprop computes weights gradients in
@@ -2268,6 +2535,12 @@ void model::update_weights()
     auto& w = **rit;
     auto&& opt = w.get_optimizer();
 
+    // With pipeline parallelism, weights on other stages are skipped
+    if (m_pipeline != nullptr
+        && !w.get_matrix_distribution().grid->InGrid()) {
+      continue;
+    }
+
     if (opt != nullptr) {
       do_weight_optimize_begin_cbs(&w);
       opt->step();
@@ -2508,6 +2781,43 @@ void model::summarize_stats(lbann_summary& summarizer)
   summarizer.reduce_scalar("metric_evaluation_time",
                            total_metric_time,
                            c.get_step());
+  if (m_gradient_buckets != nullptr) {
+    const auto& stats = m_gradient_buckets->get_statistics();
+    const double overlap_fraction =
+      (stats.num_buckets > 0
+         ? static_cast<double>(stats.num_overlapped) / stats.num_buckets
+         : 0.);
+    summarizer.reduce_scalar("gradient_bucket_count",
+                             static_cast<EvalType>(stats.num_buckets),
+                             c.get_step());
+    summarizer.reduce_scalar("gradient_bucket_wait_time",
+                             stats.wait_time,
+                             c.get_step());
+    summarizer.reduce_scalar("gradient_bucket_overlap_time",
+                             stats.overlap_time,
+                             c.get_step());
+    summarizer.reduce_scalar("gradient_bucket_overlap_fraction",
+                             overlap_fraction,
+                             c.get_step());
+    m_gradient_buckets->reset_statistics();
+  }
+  gradient_compression_statistics compression_stats;
+  for (auto&& w : m_weights) {
+    auto* opt = w->get_optimizer();
+    if (opt != nullptr) {
+      compression_stats += opt->get_gradient_compression_statistics();
+      opt->reset_gradient_compression_statistics();
+    }
+  }
+  if (compression_stats.num_allreduces > 0) {
+    summarizer.reduce_scalar("gradient_compression_ratio",
+                             compression_stats.ratio(),
+                             c.get_step());
+    summarizer.reduce_scalar(
+      "gradient_compressed_bytes",
+      static_cast<EvalType>(compression_stats.compressed_bytes),
+      c.get_step());
+  }
 }
 
 void model::summarize_matrices(lbann_summary& summarizer)
@@ -2596,9 +2906,18 @@ bool model::save_to_checkpoint_distributed(persist& p)
 
 #ifdef LBANN_HAS_CEREAL_BINARY_ARCHIVES
   {
-    std::ofstream ofs(file::join_path(p.get_checkpoint_dir(), "model.bin"));
+    // Record how each local matrix maps into its global matrix so
+    // the checkpoint can be restarted on a different number of ranks
+    utils::dist_matrix_layout_recorder layouts;
+    {
+      std::ofstream ofs(file::join_path(p.get_checkpoint_dir(), "model.bin"));
+      cereal::BinaryOutputArchive ar(ofs);
+      ar(*this);
+    }
+    std::ofstream ofs(
+      file::join_path(p.get_checkpoint_dir(), "model_layout.bin"));
     cereal::BinaryOutputArchive ar(ofs);
-    ar(*this);
+    ar(m_comm->get_procs_per_trainer(), layouts.get_layouts());
   }
 #endif // LBANN_HAS_CEREAL_BINARY_ARCHIVES
 
@@ -2620,11 +2939,30 @@ bool model::load_from_checkpoint_distributed(persist& p)
   p.open_restart(file::join_path(trainer_dir, get_name()));
 
 #ifdef LBANN_HAS_CEREAL_BINARY_ARCHIVES
+  if (auto* elastic = utils::get_elastic_restart_context()) {
+    auto const filename =
+      file::join_path(p.get_checkpoint_dir(), "model_layout.bin");
+    std::ifstream ifs(filename);
+    if (!ifs.good()) {
+      LBANN_ERROR("restarting on a different number of ranks requires ",
+                  filename);
+    }
+    int old_num_procs;
+    std::vector<utils::dist_matrix_layout> layouts;
+    cereal::BinaryInputArchive ar(ifs);
+    ar(old_num_procs, layouts);
+    elastic->set_layouts(old_num_procs, std::move(layouts));
+  }
   {
     std::ifstream ifs(file::join_path(p.get_checkpoint_dir(), "model.bin"));
     cereal::BinaryInputArchive ar(ifs);
     ar(*this);
   }
+#else
+  if (utils::get_elastic_restart_context() != nullptr) {
+    LBANN_ERROR("restarting on a different number of ranks "
+                "requires binary archives");
+  }
 #endif // LBANN_HAS_CEREAL_BINARY_ARCHIVES
 
   m_model_is_setup = false;
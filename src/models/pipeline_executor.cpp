@@ -0,0 +1,556 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2022, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+#include "lbann/models/pipeline_executor.hpp"
+
+#include "lbann/comm_impl.hpp"
+#include "lbann/data_coordinator/data_coordinator.hpp"
+#include "lbann/execution_algorithms/sgd_execution_context.hpp"
+#include "lbann/layers/layer.hpp"
+#include "lbann/metrics/metric.hpp"
+#include "lbann/models/model.hpp"
+#include "lbann/objective_functions/layer_term.hpp"
+#include "lbann/optimizers/optimizer.hpp"
+#include "lbann/trainers/trainer.hpp"
+#include "lbann/utils/exception.hpp"
+#include "lbann/weights/weights.hpp"
+
+#include <limits>
+#include <string>
+#include <unordered_set>
+
+namespace lbann {
+
+namespace {
+
+bool is_input_layer(const Layer& l) { return l.get_type() == "input"; }
+
+/** Whether a layer's forward pass depends on more than its inputs,
+ *  i.e. draws random numbers or updates batch statistics, so it
+ *  cannot be recomputed. */
+bool is_stateful_in_training(const Layer& l)
+{
+  static const std::unordered_set<std::string> types = {
+    "dropout",
+    "selu dropout",
+    "batch normalization",
+    "entry-wise batch normalization",
+    "Gaussian",
+    "uniform",
+    "Bernoulli",
+    "categorical random",
+    "discrete random",
+  };
+  return types.count(l.get_type()) > 0;
+}
+
+} // namespace
+
+pipeline_executor::pipeline_executor(model& m,
+                                     pipeline_schedule_type schedule,
+                                     size_t num_micro_batches)
+  : m_model{&m},
+    m_schedule{schedule},
+    m_num_micro_batches{num_micro_batches}
+{
+  if (m_num_micro_batches == 0) {
+    LBANN_ERROR("pipeline-parallel training requires at least one micro-batch");
+  }
+  El::mpi::Dup(m.get_comm()->get_trainer_comm(), m_comm);
+}
+
+pipeline_executor::~pipeline_executor()
+{
+  El::mpi::Free(m_comm);
+}
+
+void pipeline_executor::setup()
+{
+  auto& m = *m_model;
+  auto& comm = *m.get_comm();
+  const auto grids = get_trainer().get_grids();
+  if (m.is_subgraph_parallelism_enabled()) {
+    LBANN_ERROR("model \"", m.get_name(), "\" uses subgraph parallelism, "
+                "which is not supported with pipeline-parallel training");
+  }
+
+  // Forward passes are recomputed when there are several
+  // micro-batches, which would resample random numbers and update
+  // batch statistics twice
+  if (m_num_micro_batches > 1) {
+    for (El::Int i = 0; i < m.get_num_layers(); ++i) {
+      const auto& l = m.get_layer(i);
+      if (is_stateful_in_training(l)) {
+        LBANN_ERROR("pipeline-parallel training with ",
+                    m_num_micro_batches, " micro-batches recomputes "
+                    "forward passes, which is not supported for ",
+                    l.get_type(), " layer \"", l.get_name(), "\"");
+      }
+    }
+  }
+
+  // Stages are ordered by first appearance of their grid tags
+  std::unordered_map<int, size_t> tag_stages;
+  std::vector<int> stage_tags;
+  for (El::Int i = 0; i < m.get_num_layers(); ++i) {
+    const auto& l = m.get_layer(i);
+    const int tag = l.get_grid_tag();
+    if (tag <= 0) {
+      LBANN_ERROR("pipeline-parallel training requires every layer to be on "
+                  "a sub-grid, but ", l.get_type(), " layer \"", l.get_name(),
+                  "\" is on grid ", tag);
+    }
+    if (!is_input_layer(l) && tag_stages.count(tag) == 0) {
+      tag_stages[tag] = stage_tags.size();
+      stage_tags.push_back(tag);
+    }
+  }
+  m_num_stages = stage_tags.size();
+  std::unordered_map<const Layer*, size_t> layer_stages;
+  for (El::Int i = 0; i < m.get_num_layers(); ++i) {
+    const auto& l = m.get_layer(i);
+    const auto it = tag_stages.find(l.get_grid_tag());
+    if (it == tag_stages.end()) {
+      LBANN_ERROR("input layer \"", l.get_name(), "\" is on grid ",
+                  l.get_grid_tag(), ", which has no other layers");
+    }
+    layer_stages[&l] = it->second;
+  }
+
+  // Find stage of this process
+  bool found_stage = false;
+  for (size_t stage = 0; stage < m_num_stages; ++stage) {
+    const auto& grid = *grids[stage_tags[stage]];
+    if (grid.Size() != grids[stage_tags[0]]->Size()) {
+      LBANN_ERROR("pipeline stages have different numbers of processes (",
+                  grids[stage_tags[0]]->Size(), " on grid ", stage_tags[0],
+                  ", ", grid.Size(), " on grid ", stage_tags[stage], ")");
+    }
+    if (grid.InGrid()) {
+      if (found_stage) {
+        LBANN_ERROR("process ", comm.get_rank_in_trainer(),
+                    " is in more than one pipeline stage "
+                    "(grids ", stage_tags[m_stage], " and ",
+                    stage_tags[stage], ")");
+      }
+      found_stage = true;
+      m_stage = stage;
+      m_stage_rank = grid.VCRank();
+    }
+  }
+  if (!found_stage) {
+    LBANN_ERROR("process ", comm.get_rank_in_trainer(),
+                " is not in any pipeline stage");
+  }
+
+  // Match corresponding processes in stages
+  const auto num_procs = comm.get_procs_per_trainer();
+  std::vector<int> proc_stages(num_procs), proc_stage_ranks(num_procs);
+  comm.trainer_all_gather(static_cast<int>(m_stage), proc_stages);
+  comm.trainer_all_gather(m_stage_rank, proc_stage_ranks);
+  m_stage_ranks.assign(
+    m_num_stages,
+    std::vector<int>(grids[stage_tags[0]]->Size(), -1));
+  for (int rank = 0; rank < num_procs; ++rank) {
+    m_stage_ranks[proc_stages[rank]][proc_stage_ranks[rank]] = rank;
+  }
+
+  // Classify layer connections
+  m_input_layers.clear();
+  m_stage_layers.clear();
+  m_boundaries.clear();
+  m_incoming.clear();
+  m_outgoing.clear();
+  for (El::Int i = 0; i < m.get_num_layers(); ++i) {
+    auto& l = m.get_layer(i);
+    const size_t stage = layer_stages[&l];
+    if (is_input_layer(l)) {
+      m_input_layers.push_back(&l);
+      continue;
+    }
+    if (stage == m_stage) {
+      m_stage_layers.push_back(&l);
+    }
+    const auto parents = l.get_parent_layers();
+    for (int j = 0; j < l.get_num_parents(); ++j) {
+      const auto& parent = *parents[j];
+      const size_t parent_stage = layer_stages[&parent];
+      if (is_input_layer(parent)) {
+        if (parent_stage != stage) {
+          LBANN_ERROR("input layer \"", parent.get_name(), "\" and its "
+                      "child \"", l.get_name(), "\" are on different "
+                      "pipeline stages");
+        }
+        l.set_pipeline_parent_mode(j, Layer::pipeline_parent_mode::MINI_BATCH);
+      }
+      else if (parent_stage == stage) {
+        l.set_pipeline_parent_mode(j, Layer::pipeline_parent_mode::LOCAL);
+      }
+      else if (parent_stage + 1 == stage) {
+        const auto& act = parent.get_activations(l);
+        const auto& grad = l.get_error_signals(parent);
+        if (act.DistData().colDist != grad.DistData().colDist
+            || act.DistData().rowDist != grad.DistData().rowDist
+            || act.Grid().Height() != grad.Grid().Height()
+            || act.Grid().Width() != grad.Grid().Width()) {
+          LBANN_ERROR("layer \"", parent.get_name(), "\" and its child \"",
+                      l.get_name(), "\" are on consecutive pipeline stages, "
+                      "but their tensors have different distributions");
+        }
+        l.set_pipeline_parent_mode(j, Layer::pipeline_parent_mode::REMOTE);
+        const auto index = m_boundaries.size();
+        m_boundaries.push_back({const_cast<Layer*>(&parent),
+                                &l,
+                                j,
+                                static_cast<int>(2 * index)});
+        m_outgoing[&parent].push_back(index);
+        m_incoming[&l].push_back(index);
+      }
+      else {
+        LBANN_ERROR("layer \"", parent.get_name(), "\" (pipeline stage ",
+                    parent_stage, ") and its child \"", l.get_name(),
+                    "\" (pipeline stage ", stage, ") are not on the same "
+                    "or consecutive pipeline stages");
+      }
+    }
+  }
+
+  // Find optimizers on this stage
+  std::unordered_map<const weights*, size_t> weights_stages;
+  for (El::Int i = 0; i < m.get_num_layers(); ++i) {
+    auto& l = m.get_layer(i);
+    const size_t stage = layer_stages[&l];
+    for (size_t j = 0; j < l.num_weights(); ++j) {
+      const auto& w = l.get_weights(j);
+      const auto it = weights_stages.find(&w);
+      if (it == weights_stages.end()) {
+        weights_stages[&w] = stage;
+      }
+      else if (it->second != stage) {
+        LBANN_ERROR("weights \"", w.get_name(), "\" are shared between "
+                    "pipeline stages ", it->second, " and ", stage);
+      }
+    }
+  }
+  m_stage_optimizers.clear();
+  for (auto* w : m.get_weights()) {
+    const auto it = weights_stages.find(w);
+    auto* opt = w->get_optimizer();
+    if (it != weights_stages.end() && it->second == m_stage && opt != nullptr) {
+      m_stage_optimizers.push_back(opt);
+    }
+  }
+
+  // Objective function and metrics are evaluated on last stage
+  for (auto* term : m.get_objective_function()->get_terms()) {
+    auto* layer_term_ptr = dynamic_cast<layer_term*>(term);
+    if (layer_term_ptr == nullptr) {
+      LBANN_ERROR("pipeline-parallel training only supports layer terms in "
+                  "the objective function, but found a ", term->name(),
+                  " term");
+    }
+    const auto& l = layer_term_ptr->get_layer();
+    if (layer_stages[&l] + 1 != m_num_stages) {
+      LBANN_ERROR("objective function term from layer \"", l.get_name(),
+                  "\" is not on the last pipeline stage");
+    }
+  }
+  for (const auto* met : m.get_metrics()) {
+    for (const auto& ptr : met->get_layer_pointers()) {
+      const auto& l = *ptr.lock();
+      if (layer_stages[&l] + 1 != m_num_stages) {
+        LBANN_ERROR("metric \"", met->name(), "\" depends on layer \"",
+                    l.get_name(), "\", which is not on the last "
+                    "pipeline stage");
+      }
+    }
+  }
+
+  // Allocate communication resources
+  size_t num_stage_boundaries = 0;
+  for (const auto& b : m_boundaries) {
+    const auto parent_stage = layer_stages[b.parent];
+    if (parent_stage == m_stage || parent_stage + 1 == m_stage) {
+      ++num_stage_boundaries;
+    }
+  }
+  m_send_buffers.resize(num_stage_boundaries * m_num_micro_batches);
+  m_send_requests.resize(num_stage_boundaries * m_num_micro_batches);
+  m_num_sends = 0;
+}
+
+bool pipeline_executor::train_mini_batch(SGDExecutionContext& c,
+                                         data_coordinator& dc)
+{
+  auto& m = *m_model;
+  begin_step(c);
+
+  // Check if the data coordinator has finished the epoch and kickoff
+  // background I/O
+  const bool finished = dc.epoch_complete(execution_mode::training);
+
+  run_schedule(c);
+
+  // Update step
+  m.update_weights();
+  m.update_layers();
+  return finished;
+}
+
+void pipeline_executor::compute_gradients(SGDExecutionContext& c)
+{
+  begin_step(c);
+  run_schedule(c);
+}
+
+void pipeline_executor::begin_step(SGDExecutionContext& c)
+{
+  auto& m = *m_model;
+  const auto mode = execution_mode::training;
+  m.clear_gradients();
+  m.do_model_forward_prop_begin_cbs(mode);
+
+  // Input layers are run on the full mini-batch on every process
+  c.clear_micro_batch();
+  m.get_scalar_reductions().begin_step(mode, c.get_step());
+  for (auto* l : m_input_layers) {
+    m.do_layer_forward_prop_begin_cbs(mode, l);
+    l->forward_prop();
+    m.do_layer_forward_prop_end_cbs(mode, l);
+  }
+}
+
+void pipeline_executor::run_schedule(SGDExecutionContext& c)
+{
+  auto& m = *m_model;
+  const auto mode = execution_mode::training;
+
+  // Split mini-batch into micro-batches
+  const size_t mini_batch_size = c.get_current_mini_batch_size();
+  const auto offsets = get_micro_batch_offsets(mini_batch_size,
+                                               m_num_micro_batches);
+  const size_t num_micro_batches = offsets.size() - 1;
+  const auto ops = make_pipeline_schedule(m_schedule,
+                                          m_num_stages,
+                                          m_stage,
+                                          num_micro_batches);
+  m_evaluations.assign(num_micro_batches * (m.get_metrics().size() + 1),
+                       EvalType(0));
+
+  // Accumulate gradients until the last backward pass
+  for (auto* opt : m_stage_optimizers) {
+    opt->set_gradient_allreduce_deferred(true);
+  }
+
+  // Run schedule
+  constexpr auto no_micro_batch = std::numeric_limits<size_t>::max();
+  size_t current_micro_batch = no_micro_batch;
+  size_t num_backward = 0;
+  for (const auto& op : ops) {
+    const auto j = op.micro_batch;
+    c.set_micro_batch(j, offsets[j]);
+    c.set_current_mini_batch_size(offsets[j + 1] - offsets[j]);
+    switch (op.type) {
+    case pipeline_op::op_type::FORWARD:
+      forward_stage(c, j, false);
+      current_micro_batch = j;
+      break;
+    case pipeline_op::op_type::BACKWARD:
+      if (current_micro_batch != j) {
+        forward_stage(c, j, true);
+        current_micro_batch = j;
+      }
+      if (++num_backward == num_micro_batches) {
+        // Launch gradient allreduces during the last backward pass
+        for (auto* opt : m_stage_optimizers) {
+          opt->set_gradient_allreduce_deferred(false);
+        }
+      }
+      backward_stage();
+      break;
+    }
+  }
+  c.clear_micro_batch();
+  c.set_current_mini_batch_size(mini_batch_size);
+  wait_sends();
+  m.do_model_forward_prop_end_cbs(mode);
+  m.do_model_backward_prop_begin_cbs();
+  m.do_model_backward_prop_end_cbs();
+
+  // Objective function and metric values are known on last stage
+  share_evaluations(offsets);
+}
+
+void pipeline_executor::forward_stage(SGDExecutionContext& c,
+                                      size_t micro_batch,
+                                      bool recompute)
+{
+  auto& m = *m_model;
+  const auto mode = execution_mode::training;
+  const El::Int micro_batch_size = c.get_current_mini_batch_size();
+  m.get_scalar_reductions().begin_step(mode, c.get_step());
+  for (auto* l : m_stage_layers) {
+    if (recompute) {
+      // Inputs from previous stage are already stored
+      l->forward_prop();
+      continue;
+    }
+    for (const auto& index : m_incoming[l]) {
+      const auto& b = m_boundaries[index];
+      receive(get_peer(m_stage - 1), b.tag);
+      l->unpack_pipeline_input(b.parent_index,
+                               micro_batch,
+                               micro_batch_size,
+                               m_recv_buffer);
+    }
+    m.do_layer_forward_prop_begin_cbs(mode, l);
+    l->forward_prop();
+    m.do_layer_forward_prop_end_cbs(mode, l);
+    for (const auto& index : m_outgoing[l]) {
+      const auto& b = m_boundaries[index];
+      l->pack_pipeline_activations(*b.child, get_send_buffer());
+      send(get_peer(m_stage + 1), b.tag);
+    }
+  }
+  if (!recompute && m_stage + 1 == m_num_stages) {
+    evaluate_micro_batch(micro_batch, micro_batch_size);
+  }
+}
+
+void pipeline_executor::backward_stage()
+{
+  auto& m = *m_model;
+  for (auto it = m_stage_layers.rbegin(); it != m_stage_layers.rend(); ++it) {
+    auto* l = *it;
+    for (const auto& index : m_outgoing[l]) {
+      const auto& b = m_boundaries[index];
+      receive(get_peer(m_stage + 1), b.tag + 1);
+      l->unpack_pipeline_prev_error_signals(*b.child, m_recv_buffer);
+    }
+    m.do_layer_backward_prop_begin_cbs(l);
+    l->back_prop();
+    m.do_layer_backward_prop_end_cbs(l);
+    for (const auto& index : m_incoming[l]) {
+      const auto& b = m_boundaries[index];
+      l->pack_pipeline_error_signals(b.parent_index, get_send_buffer());
+      send(get_peer(m_stage - 1), b.tag + 1);
+    }
+  }
+}
+
+void pipeline_executor::evaluate_micro_batch(size_t micro_batch,
+                                             int micro_batch_size)
+{
+  auto& m = *m_model;
+  const auto mode = execution_mode::training;
+  const auto metrics = m.get_metrics();
+  auto* values = &m_evaluations[micro_batch * (metrics.size() + 1)];
+  auto&& obj = m.get_objective_function();
+  obj->start_evaluation(mode, micro_batch_size);
+  values[0] = obj->finish_evaluation(mode, micro_batch_size);
+  for (size_t i = 0; i < metrics.size(); ++i) {
+    values[i + 1] = metrics[i]->evaluate(mode, micro_batch_size);
+  }
+  obj->differentiate();
+}
+
+void pipeline_executor::share_evaluations(const std::vector<size_t>& offsets)
+{
+  auto& m = *m_model;
+  const auto mode = execution_mode::training;
+  const int root = m_stage_ranks.back().front();
+  m.get_comm()->trainer_broadcast(root,
+                                  m_evaluations.data(),
+                                  m_evaluations.size());
+  if (m_stage + 1 == m_num_stages) {
+    return;
+  }
+  const auto metrics = m.get_metrics();
+  auto&& obj = m.get_objective_function();
+  for (size_t j = 0; j + 1 < offsets.size(); ++j) {
+    const int micro_batch_size = offsets[j + 1] - offsets[j];
+    const auto* values = &m_evaluations[j * (metrics.size() + 1)];
+    obj->add_to_statistics(mode, values[0], micro_batch_size);
+    for (size_t i = 0; i < metrics.size(); ++i) {
+      metrics[i]->add_to_statistics(mode, values[i + 1], micro_batch_size);
+    }
+  }
+}
+
+int pipeline_executor::get_peer(size_t stage) const
+{
+  return m_stage_ranks[stage][m_stage_rank];
+}
+
+std::vector<El::byte>& pipeline_executor::get_send_buffer()
+{
+  if (m_num_sends == m_send_buffers.size()) {
+    m_send_buffers.emplace_back();
+    m_send_requests.emplace_back();
+  }
+  return m_send_buffers[m_num_sends];
+}
+
+void pipeline_executor::send(int rank, int tag)
+{
+  const auto& buffer = m_send_buffers[m_num_sends];
+  auto& req = m_send_requests[m_num_sends];
+  ++m_num_sends;
+  m_model->get_comm()->nb_tagged_send<El::byte>(buffer.data(),
+                                                buffer.size(),
+                                                rank,
+                                                tag,
+                                                req,
+                                                m_comm);
+}
+
+void pipeline_executor::receive(int rank, int tag)
+{
+  // Message size depends on micro-batch size and data distribution
+  MPI_Status status;
+  MPI_Probe(rank, tag, m_comm.GetMPIComm(), &status);
+  m_recv_buffer.resize(El::mpi::GetCount<El::byte>(status));
+  El::mpi::Request<El::byte> req;
+  auto& comm = *m_model->get_comm();
+  comm.nb_tagged_recv<El::byte>(m_recv_buffer.data(),
+                                m_recv_buffer.size(),
+                                rank,
+                                tag,
+                                req,
+                                m_comm);
+  comm.wait(req);
+}
+
+void pipeline_executor::wait_sends()
+{
+  auto& comm = *m_model->get_comm();
+  for (size_t i = 0; i < m_num_sends; ++i) {
+    comm.wait(m_send_requests[i]);
+  }
+  m_num_sends = 0;
+}
+
+} // namespace lbann
@@ -0,0 +1,121 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2022, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+#include "lbann/models/pipeline_schedule.hpp"
+#include "lbann/utils/exception.hpp"
+
+#include <algorithm>
+
+namespace lbann {
+
+std::string to_string(pipeline_schedule_type schedule)
+{
+  switch (schedule) {
+  case pipeline_schedule_type::GPIPE:
+    return "gpipe";
+  case pipeline_schedule_type::ONE_F_ONE_B:
+    return "1f1b";
+  default:
+    LBANN_ERROR("invalid pipeline schedule");
+  }
+  return "";
+}
+
+pipeline_schedule_type pipeline_schedule_type_from_string(const std::string& str)
+{
+  if (str == "gpipe") {
+    return pipeline_schedule_type::GPIPE;
+  }
+  if (str == "1f1b") {
+    return pipeline_schedule_type::ONE_F_ONE_B;
+  }
+  LBANN_ERROR("invalid pipeline schedule \"", str, "\" "
+              "(expected \"gpipe\" or \"1f1b\")");
+  return pipeline_schedule_type::GPIPE;
+}
+
+std::vector<pipeline_op>
+make_pipeline_schedule(pipeline_schedule_type schedule,
+                       size_t num_stages,
+                       size_t stage,
+                       size_t num_micro_batches)
+{
+  if (stage >= num_stages) {
+    LBANN_ERROR("invalid pipeline stage ", stage, " ",
+                "(", num_stages, " stages)");
+  }
+  using op_type = pipeline_op::op_type;
+  std::vector<pipeline_op> ops;
+  ops.reserve(2 * num_micro_batches);
+  switch (schedule) {
+  case pipeline_schedule_type::GPIPE:
+    for (size_t i = 0; i < num_micro_batches; ++i) {
+      ops.push_back({op_type::FORWARD, i});
+    }
+    for (size_t i = num_micro_batches; i > 0; --i) {
+      ops.push_back({op_type::BACKWARD, i - 1});
+    }
+    break;
+  case pipeline_schedule_type::ONE_F_ONE_B:
+    {
+      const size_t num_warmup = std::min(num_stages - stage - 1,
+                                         num_micro_batches);
+      for (size_t i = 0; i < num_warmup; ++i) {
+        ops.push_back({op_type::FORWARD, i});
+      }
+      for (size_t i = 0; i < num_micro_batches - num_warmup; ++i) {
+        ops.push_back({op_type::FORWARD, num_warmup + i});
+        ops.push_back({op_type::BACKWARD, i});
+      }
+      for (size_t i = num_micro_batches - num_warmup;
+           i < num_micro_batches;
+           ++i) {
+        ops.push_back({op_type::BACKWARD, i});
+      }
+    }
+    break;
+  default:
+    LBANN_ERROR("invalid pipeline schedule");
+  }
+  return ops;
+}
+
+std::vector<size_t> get_micro_batch_offsets(size_t mini_batch_size,
+                                            size_t num_micro_batches)
+{
+  const size_t num = std::max<size_t>(std::min(num_micro_batches,
+                                               mini_batch_size),
+                                      1);
+  std::vector<size_t> offsets(num + 1, 0);
+  for (size_t i = 0; i < num; ++i) {
+    const size_t size = (mini_batch_size / num
+                         + (i < mini_batch_size % num ? 1 : 0));
+    offsets[i + 1] = offsets[i] + size;
+  }
+  return offsets;
+}
+
+} // namespace lbann
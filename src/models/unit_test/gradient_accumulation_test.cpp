@@ -0,0 +1,220 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2022, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+#include <catch2/catch.hpp>
+
+#include "TestHelpers.hpp"
+#include "MPITestHelpers.hpp"
+
+#include <lbann/base.hpp>
+#include <lbann/callbacks/callback.hpp>
+#include <lbann/execution_algorithms/sgd_execution_context.hpp>
+#include <lbann/layers/io/input_layer.hpp>
+#include <lbann/models/model.hpp>
+#include <lbann/objective_functions/objective_function.hpp>
+#include <lbann/optimizers/data_type_optimizer.hpp>
+#include <lbann/proto/factories.hpp>
+#include <lbann/utils/lbann_library.hpp>
+
+#include <lbann.pb.h>
+#include <google/protobuf/text_format.h>
+
+namespace pb = ::google::protobuf;
+
+namespace {
+
+using DataType = lbann::DataType;
+using StarMatType =
+  El::DistMatrix<DataType, El::STAR, El::STAR, El::ELEMENT, El::Device::CPU>;
+
+// Fully-connected layer followed by a squared L2 norm, so the
+// gradient depends on the input samples
+std::string const model_prototext = R"ptext(
+model {
+  objective_function {
+    layer_term {
+      scale_factor: 1.0
+      layer: "loss"
+    }
+  }
+  layer {
+    name: "x"
+    children: "fc"
+    input {
+      data_field: "samples"
+    }
+  }
+  layer {
+    name: "fc"
+    parents: "x"
+    children: "loss"
+    weights: "w"
+    fully_connected {
+      num_neurons: 2
+      has_bias: false
+    }
+  }
+  layer {
+    name: "loss"
+    parents: "fc"
+    l2_norm2 {
+    }
+  }
+  weights {
+    name: "w"
+    initializer {
+      constant_initializer {
+        value: 0.5
+      }
+    }
+  }
+}
+optimizer {
+  sgd {
+    learn_rate: 0.1
+  }
+}
+)ptext";
+
+constexpr int input_size = 3;
+
+auto make_model(lbann::lbann_comm& comm, size_t mbs)
+{
+  lbann_data::LbannPB my_proto;
+  if (!pb::TextFormat::ParseFromString(model_prototext, &my_proto))
+    throw "Parsing protobuf failed.";
+  lbann::construct_trainer(&comm, my_proto.mutable_trainer(), my_proto);
+  lbann::DataReaderMetaData md;
+  md.data_dims[lbann::data_reader_target_mode::INPUT] = {1, 1, input_size};
+  auto my_model = lbann::proto::construct_model(&comm,
+                                                -1,
+                                                my_proto.optimizer(),
+                                                my_proto.trainer(),
+                                                my_proto.model());
+  my_model->setup(mbs, md, {&comm.get_trainer_grid()});
+  return my_model;
+}
+
+/** Records the gradient of the first weights whenever model-level
+ *  backprop callbacks run. */
+class gradient_probe : public lbann::callback_base
+{
+public:
+  using callback_base::on_backward_prop_end;
+  gradient_probe* copy() const override { return new gradient_probe(*this); }
+  std::string name() const override { return "gradient probe"; }
+  void on_backward_prop_end(lbann::model* m) override
+  {
+    ++num_calls;
+    auto& opt = dynamic_cast<lbann::data_type_optimizer<DataType>&>(
+      *m->get_weights().front()->get_optimizer());
+    StarMatType grad(opt.get_gradient());
+    El::Copy(grad.LockedMatrix(), gradient);
+  }
+  int num_calls = 0;
+  El::Matrix<DataType, El::Device::CPU> gradient;
+};
+
+/** Forward and backward prop on one mini-batch, as the SGD training
+ *  algorithm does for each mini-batch of an accumulated step. */
+void backprop_mini_batch(lbann::model& m,
+                         StarMatType const& samples,
+                         bool end_of_step)
+{
+  constexpr auto mode = lbann::execution_mode::training;
+  for (auto* w : m.get_weights()) {
+    if (auto* opt = w->get_optimizer()) {
+      opt->set_gradient_allreduce_deferred(!end_of_step);
+    }
+  }
+  for (int i = 0; i < m.get_num_layers(); ++i) {
+    auto& l = m.get_layer(i);
+    if (l.get_type() == "input") {
+      dynamic_cast<lbann::input_layer<DataType>&>(l).set_samples(samples);
+    }
+  }
+  m.forward_prop(mode);
+  auto& obj = *m.get_objective_function();
+  obj.start_evaluation(mode, samples.Width());
+  obj.differentiate();
+  m.backward_prop(end_of_step);
+  obj.finish_evaluation(mode, samples.Width());
+}
+
+} // namespace <anon>
+
+TEST_CASE("Backprop callbacks with gradient accumulation",
+          "[mpi][model][gradient_accumulation]")
+{
+  constexpr size_t mbs = 4;
+  constexpr size_t num_mini_batches = 3;
+
+  auto& comm = unit_test::utilities::current_world_comm();
+  auto const& g = comm.get_trainer_grid();
+  auto model = make_model(comm, mbs);
+  auto probe = std::make_shared<gradient_probe>();
+  model->add_callback(probe);
+  lbann::SGDExecutionContext c(lbann::execution_mode::training, mbs);
+  model->reset_mode(c, lbann::execution_mode::training);
+
+  std::vector<StarMatType> samples;
+  for (size_t k = 0; k < num_mini_batches; ++k) {
+    samples.emplace_back(input_size, mbs, g);
+    for (El::Int j = 0; j < El::Int(mbs); ++j)
+      for (El::Int i = 0; i < input_size; ++i)
+        samples.back().SetLocal(i, j, DataType(0.25 * (i + 1) - 0.5 * j + k));
+  }
+
+  // Reference: sum of the gradients of each mini-batch on its own
+  El::Matrix<DataType, El::Device::CPU> expected;
+  for (size_t k = 0; k < num_mini_batches; ++k) {
+    model->clear_gradients();
+    backprop_mini_batch(*model, samples[k], true);
+    if (k == 0) {
+      El::Copy(probe->gradient, expected);
+    }
+    else {
+      El::Axpy(DataType(1), probe->gradient, expected);
+    }
+  }
+  REQUIRE(probe->num_calls == int(num_mini_batches));
+
+  // Accumulated step: callbacks that read gradients only run once,
+  // after the last mini-batch, and see the summed gradient
+  probe->num_calls = 0;
+  model->clear_gradients();
+  for (size_t k = 0; k < num_mini_batches; ++k) {
+    backprop_mini_batch(*model, samples[k], k + 1 == num_mini_batches);
+    CHECK(probe->num_calls == (k + 1 == num_mini_batches ? 1 : 0));
+  }
+  REQUIRE(probe->gradient.Height() == expected.Height());
+  REQUIRE(probe->gradient.Width() == expected.Width());
+  for (El::Int j = 0; j < expected.Width(); ++j)
+    for (El::Int i = 0; i < expected.Height(); ++i)
+    {
+      INFO("(Row,Col) = (" << i << "," << j << ")");
+      CHECK(probe->gradient(i, j) == Approx(expected(i, j)));
+    }
+}
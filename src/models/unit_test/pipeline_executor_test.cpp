@@ -0,0 +1,352 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2022, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+#include <catch2/catch.hpp>
+
+#include "TestHelpers.hpp"
+#include "MPITestHelpers.hpp"
+
+#include <lbann/base.hpp>
+#include <lbann/execution_algorithms/sgd_execution_context.hpp>
+#include <lbann/layers/io/input_layer.hpp>
+#include <lbann/models/model.hpp>
+#include <lbann/models/pipeline_executor.hpp>
+#include <lbann/objective_functions/objective_function.hpp>
+#include <lbann/optimizers/data_type_optimizer.hpp>
+#include <lbann/proto/factories.hpp>
+#include <lbann/trainers/trainer.hpp>
+#include <lbann/utils/lbann_library.hpp>
+#include <lbann/utils/options.hpp>
+
+#include <lbann.pb.h>
+#include <google/protobuf/text_format.h>
+
+#include <numeric>
+
+namespace pb = ::google::protobuf;
+
+namespace {
+
+using DataType = lbann::DataType;
+using StarMatType =
+  El::DistMatrix<DataType, El::STAR, El::STAR, El::ELEMENT, El::Device::CPU>;
+
+constexpr int input_size = 3;
+
+/** Two fully-connected layers followed by a squared L2 norm. When
+ *  pipelined, the first layer is on sub-grid 1 and the rest on
+ *  sub-grid 2. */
+std::string make_prototext(bool pipelined, bool with_dropout)
+{
+  auto tag = [pipelined](int t) {
+    return (pipelined
+            ? "    parallel_strategy { grid_tag { value: "
+                + std::to_string(t) + " } }\n"
+            : std::string());
+  };
+  const std::string fc2_child = with_dropout ? "drop" : "loss";
+  std::string dropout_layer;
+  if (with_dropout) {
+    dropout_layer = R"ptext(
+  layer {
+    name: "drop"
+    parents: "fc2"
+    children: "loss"
+    dropout {
+      keep_prob: 0.5
+    }
+)ptext" + tag(2) + "  }\n";
+  }
+  return R"ptext(
+model {
+  objective_function {
+    layer_term {
+      scale_factor: 1.0
+      layer: "loss"
+    }
+  }
+  layer {
+    name: "x"
+    children: "fc1"
+    input {
+      data_field: "samples"
+    }
+)ptext" + tag(1) + R"ptext(  }
+  layer {
+    name: "fc1"
+    parents: "x"
+    children: "fc2"
+    weights: "w1"
+    fully_connected {
+      num_neurons: 4
+      has_bias: false
+    }
+)ptext" + tag(1) + R"ptext(  }
+  layer {
+    name: "fc2"
+    parents: "fc1"
+    children: ")ptext" + fc2_child + R"ptext("
+    weights: "w2"
+    fully_connected {
+      num_neurons: 2
+      has_bias: false
+    }
+)ptext" + tag(2) + "  }\n" + dropout_layer + R"ptext(
+  layer {
+    name: "loss"
+    parents: ")ptext" + (with_dropout ? "drop" : "fc2") + R"ptext("
+    l2_norm2 {
+    }
+)ptext" + tag(2) + R"ptext(  }
+  weights {
+    name: "w1"
+    initializer {
+      constant_initializer {
+        value: 0.25
+      }
+    }
+  }
+  weights {
+    name: "w2"
+    initializer {
+      constant_initializer {
+        value: -0.5
+      }
+    }
+  }
+}
+optimizer {
+  sgd {
+    learn_rate: 0.1
+  }
+}
+)ptext";
+}
+
+/** Divide the trainer into sub-grids in block order, as done for
+ *  --num-subgrids-block-order. */
+void add_block_subgrids(lbann::lbann_comm& comm, int num_subgrids)
+{
+  const int trainer_size = comm.get_procs_per_trainer();
+  const int subgrid_size = trainer_size / num_subgrids;
+  std::vector<int> trainer_ranks(subgrid_size);
+  for (int root_rank = 0; root_rank < trainer_size;
+       root_rank += subgrid_size) {
+    std::iota(trainer_ranks.begin(), trainer_ranks.end(), root_rank);
+    El::mpi::Comm trainer_comm;
+    El::mpi::Group trainer_group, subgrid_group;
+    El::mpi::Dup(comm.get_trainer_comm(), trainer_comm);
+    El::mpi::CommGroup(trainer_comm, trainer_group);
+    El::mpi::Incl(trainer_group,
+                  trainer_ranks.size(),
+                  trainer_ranks.data(),
+                  subgrid_group);
+    lbann::get_trainer().add_grid(
+      std::make_unique<El::Grid>(std::move(trainer_comm),
+                                 subgrid_group,
+                                 subgrid_size,
+                                 El::COLUMN_MAJOR));
+    El::mpi::Free(trainer_group);
+  }
+}
+
+auto make_model(lbann::lbann_comm& comm,
+                size_t mbs,
+                bool pipelined,
+                bool with_dropout = false)
+{
+  lbann_data::LbannPB my_proto;
+  if (!pb::TextFormat::ParseFromString(make_prototext(pipelined, with_dropout),
+                                       &my_proto))
+    throw "Parsing protobuf failed.";
+  lbann::construct_trainer(&comm, my_proto.mutable_trainer(), my_proto);
+  if (pipelined) {
+    add_block_subgrids(comm, 2);
+  }
+  lbann::DataReaderMetaData md;
+  md.data_dims[lbann::data_reader_target_mode::INPUT] = {1, 1, input_size};
+  auto my_model = lbann::proto::construct_model(&comm,
+                                                -1,
+                                                my_proto.optimizer(),
+                                                my_proto.trainer(),
+                                                my_proto.model());
+  my_model->setup(mbs, md, lbann::get_trainer().get_grids());
+  return my_model;
+}
+
+/** Place the same deterministic samples in the model's input layer,
+ *  on whichever grid it is on. */
+void set_samples(lbann::model& m, size_t mbs)
+{
+  for (int l = 0; l < m.get_num_layers(); ++l) {
+    auto& layer = m.get_layer(l);
+    if (layer.get_type() != "input") {
+      continue;
+    }
+    auto& input = dynamic_cast<lbann::input_layer<DataType>&>(layer);
+    StarMatType samples(input_size, mbs, input.get_activations().Grid());
+    for (El::Int jl = 0; jl < samples.LocalWidth(); ++jl)
+      for (El::Int il = 0; il < samples.LocalHeight(); ++il) {
+        const auto i = samples.GlobalRow(il);
+        const auto j = samples.GlobalCol(jl);
+        samples.SetLocal(il, jl, DataType(0.25 * (i + 1) - 0.5 * j));
+      }
+    input.set_samples(samples);
+  }
+}
+
+/** Gradient of the named weights, replicated over the grid they are
+ *  on. Empty on processes outside that grid. */
+El::Matrix<DataType, El::Device::CPU> get_gradient(lbann::model& m,
+                                                   std::string const& name)
+{
+  for (auto* w : m.get_weights()) {
+    if (w->get_name() != name) {
+      continue;
+    }
+    auto& opt = dynamic_cast<lbann::data_type_optimizer<DataType>&>(
+      *w->get_optimizer());
+    StarMatType grad(opt.get_gradient());
+    El::Matrix<DataType, El::Device::CPU> out;
+    if (grad.Participating()) {
+      El::Copy(grad.LockedMatrix(), out);
+    }
+    return out;
+  }
+  throw "Weights not found.";
+}
+
+/** Restores the default command-line options on scope exit. */
+struct argument_parser_guard
+{
+  ~argument_parser_guard()
+  {
+    unit_test::utilities::reset_global_argument_parser();
+  }
+};
+
+void set_pipeline_options(std::string const& micro_batches,
+                          std::string const& schedule)
+{
+  auto& arg_parser = unit_test::utilities::reset_global_argument_parser();
+  char const* argv[] = {"pipeline_executor_test",
+                        "--pipeline_micro_batches",
+                        micro_batches.c_str(),
+                        "--pipeline_schedule",
+                        schedule.c_str()};
+  int const argc = sizeof(argv) / sizeof(argv[0]);
+  arg_parser.parse(argc, argv);
+}
+
+} // namespace <anon>
+
+TEST_CASE("Pipeline-parallel gradients match sequential training",
+          "[mpi][model][pipeline]")
+{
+  constexpr size_t mbs = 5;
+  constexpr auto mode = lbann::execution_mode::training;
+
+  auto& comm = unit_test::utilities::current_world_comm();
+  if (comm.get_procs_per_trainer() % 2 != 0) {
+    WARN("pipeline test needs an even number of processes per trainer");
+    return;
+  }
+  argument_parser_guard guard;
+
+  // Reference: whole mini-batch on the trainer grid
+  std::vector<El::Matrix<DataType, El::Device::CPU>> expected;
+  {
+    unit_test::utilities::reset_global_argument_parser();
+    auto model = make_model(comm, mbs, false);
+    lbann::SGDExecutionContext c(mode, mbs);
+    model->reset_mode(c, mode);
+    model->clear_gradients();
+    set_samples(*model, mbs);
+    model->forward_prop(mode);
+    auto& obj = *model->get_objective_function();
+    obj.start_evaluation(mode, mbs);
+    obj.differentiate();
+    model->backward_prop();
+    obj.finish_evaluation(mode, mbs);
+    expected.push_back(get_gradient(*model, "w1"));
+    expected.push_back(get_gradient(*model, "w2"));
+  }
+
+  // Two stages and uneven micro-batches, so every stage recomputes
+  // forward passes with either schedule
+  for (std::string const schedule : {"gpipe", "1f1b"}) {
+    INFO("Schedule " << schedule);
+    set_pipeline_options("2", schedule);
+    auto model = make_model(comm, mbs, true);
+    auto* pipeline = model->get_pipeline();
+    REQUIRE(pipeline != nullptr);
+    REQUIRE(pipeline->get_num_stages() == 2);
+    lbann::SGDExecutionContext c(mode, mbs);
+    model->reset_mode(c, mode);
+    set_samples(*model, mbs);
+    pipeline->compute_gradients(c);
+
+    std::vector<std::string> const names = {"w1", "w2"};
+    for (size_t k = 0; k < names.size(); ++k) {
+      const auto result = get_gradient(*model, names[k]);
+      if (result.Height() == 0) {
+        continue; // Weights are on the other stage
+      }
+      INFO("Weights " << names[k]);
+      REQUIRE(result.Height() == expected[k].Height());
+      REQUIRE(result.Width() == expected[k].Width());
+      for (El::Int j = 0; j < result.Width(); ++j)
+        for (El::Int i = 0; i < result.Height(); ++i)
+        {
+          INFO("(Row,Col) = (" << i << "," << j << ")");
+          CHECK(result(i, j) == Approx(expected[k](i, j)));
+        }
+    }
+  }
+}
+
+TEST_CASE("Pipeline-parallel training rejects layers that cannot be "
+          "recomputed",
+          "[mpi][model][pipeline]")
+{
+  constexpr size_t mbs = 4;
+  auto& comm = unit_test::utilities::current_world_comm();
+  if (comm.get_procs_per_trainer() % 2 != 0) {
+    WARN("pipeline test needs an even number of processes per trainer");
+    return;
+  }
+  argument_parser_guard guard;
+
+  SECTION("Several micro-batches")
+  {
+    set_pipeline_options("2", "1f1b");
+    REQUIRE_THROWS(make_model(comm, mbs, true, true));
+  }
+  SECTION("One micro-batch is never recomputed")
+  {
+    set_pipeline_options("1", "1f1b");
+    REQUIRE_NOTHROW(make_model(comm, mbs, true, true));
+  }
+}
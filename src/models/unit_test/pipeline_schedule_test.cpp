@@ -0,0 +1,174 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2022, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+#include <catch2/catch.hpp>
+
+#include <lbann/models/pipeline_schedule.hpp>
+
+#include <algorithm>
+#include <set>
+#include <vector>
+
+namespace {
+
+using op_type = lbann::pipeline_op::op_type;
+
+/** Execute the schedules of all stages, respecting the dependencies
+ *  between neighboring stages. Returns whether all stages finish.
+ */
+bool simulate_pipeline(lbann::pipeline_schedule_type schedule,
+                       size_t num_stages,
+                       size_t num_micro_batches)
+{
+  std::vector<std::vector<lbann::pipeline_op>> ops;
+  for (size_t s = 0; s < num_stages; ++s) {
+    ops.push_back(lbann::make_pipeline_schedule(schedule,
+                                                num_stages,
+                                                s,
+                                                num_micro_batches));
+  }
+  std::vector<std::set<size_t>> forward_done(num_stages);
+  std::vector<std::set<size_t>> backward_done(num_stages);
+  std::vector<size_t> next(num_stages, 0);
+  bool progress = true;
+  while (progress) {
+    progress = false;
+    for (size_t s = 0; s < num_stages; ++s) {
+      if (next[s] >= ops[s].size()) { continue; }
+      const auto& op = ops[s][next[s]];
+      bool ready = false;
+      if (op.type == op_type::FORWARD) {
+        ready = (s == 0 || forward_done[s-1].count(op.micro_batch) > 0);
+        if (ready) { forward_done[s].insert(op.micro_batch); }
+      }
+      else {
+        ready = (forward_done[s].count(op.micro_batch) > 0
+                 && (s == num_stages - 1
+                     || backward_done[s+1].count(op.micro_batch) > 0));
+        if (ready) { backward_done[s].insert(op.micro_batch); }
+      }
+      if (ready) {
+        ++next[s];
+        progress = true;
+      }
+    }
+  }
+  for (size_t s = 0; s < num_stages; ++s) {
+    if (next[s] != ops[s].size()) { return false; }
+  }
+  return true;
+}
+
+} // namespace <anon>
+
+TEST_CASE("Pipeline schedules", "[pipeline][seq]")
+{
+  const auto schedule = GENERATE(lbann::pipeline_schedule_type::GPIPE,
+                                 lbann::pipeline_schedule_type::ONE_F_ONE_B);
+  const size_t num_stages = GENERATE(1, 2, 4);
+  const size_t num_micro_batches = GENERATE(1, 3, 8);
+
+  SECTION("Each micro-batch has one forward and one backward pass")
+  {
+    for (size_t s = 0; s < num_stages; ++s) {
+      const auto ops = lbann::make_pipeline_schedule(schedule,
+                                                     num_stages,
+                                                     s,
+                                                     num_micro_batches);
+      REQUIRE(ops.size() == 2 * num_micro_batches);
+      std::set<size_t> forward, backward;
+      size_t in_flight = 0, max_in_flight = 0;
+      size_t next_forward = 0;
+      for (const auto& op : ops) {
+        REQUIRE(op.micro_batch < num_micro_batches);
+        if (op.type == op_type::FORWARD) {
+          CHECK(forward.insert(op.micro_batch).second);
+          CHECK(op.micro_batch == next_forward++);
+          max_in_flight = std::max(max_in_flight, ++in_flight);
+        }
+        else {
+          CHECK(forward.count(op.micro_batch) == 1);
+          CHECK(backward.insert(op.micro_batch).second);
+          --in_flight;
+        }
+      }
+      CHECK(backward.size() == num_micro_batches);
+      if (schedule == lbann::pipeline_schedule_type::ONE_F_ONE_B) {
+        CHECK(max_in_flight <= std::min(num_stages - s, num_micro_batches));
+      }
+      else {
+        CHECK(max_in_flight == num_micro_batches);
+      }
+    }
+  }
+
+  SECTION("Stages agree on backward order")
+  {
+    std::vector<size_t> reference;
+    for (size_t s = 0; s < num_stages; ++s) {
+      std::vector<size_t> order;
+      for (const auto& op : lbann::make_pipeline_schedule(schedule,
+                                                          num_stages,
+                                                          s,
+                                                          num_micro_batches)) {
+        if (op.type == op_type::BACKWARD) {
+          order.push_back(op.micro_batch);
+        }
+      }
+      if (s == 0) { reference = order; }
+      CHECK(order == reference);
+    }
+  }
+
+  SECTION("Pipeline does not deadlock")
+  {
+    CHECK(simulate_pipeline(schedule, num_stages, num_micro_batches));
+  }
+}
+
+TEST_CASE("Pipeline schedule names", "[pipeline][seq]")
+{
+  using lbann::pipeline_schedule_type;
+  for (const auto schedule : {pipeline_schedule_type::GPIPE,
+                              pipeline_schedule_type::ONE_F_ONE_B}) {
+    CHECK(lbann::pipeline_schedule_type_from_string(to_string(schedule))
+          == schedule);
+  }
+  CHECK_THROWS(lbann::pipeline_schedule_type_from_string("interleaved"));
+  CHECK_THROWS(lbann::make_pipeline_schedule(pipeline_schedule_type::GPIPE,
+                                             2, 2, 4));
+}
+
+TEST_CASE("Micro-batch offsets", "[pipeline][seq]")
+{
+  CHECK(lbann::get_micro_batch_offsets(8, 4)
+        == std::vector<size_t>{0, 2, 4, 6, 8});
+  CHECK(lbann::get_micro_batch_offsets(10, 4)
+        == std::vector<size_t>{0, 3, 6, 8, 10});
+  CHECK(lbann::get_micro_batch_offsets(3, 4)
+        == std::vector<size_t>{0, 1, 2, 3});
+  CHECK(lbann::get_micro_batch_offsets(5, 1)
+        == std::vector<size_t>{0, 5});
+}
@@ -25,6 +25,8 @@
 ////////////////////////////////////////////////////////////////////////////////
 
 #include "lbann/objective_functions/objective_function.hpp"
+#include "lbann/models/model.hpp"
+#include "lbann/utils/scalar_reduction_buffer.hpp"
 #include "lbann/utils/timer.hpp"
 #include "lbann/utils/profiling.hpp"
 #include "lbann/utils/serialize.hpp"
@@ -77,6 +79,7 @@ void objective_function::setup(model& m) {
     }
     term->setup(m);
   }
+  m_scalar_reductions = &m.get_scalar_reductions();
 }
 
 void objective_function::start_evaluation(execution_mode mode,
@@ -88,6 +91,10 @@ void objective_function::start_evaluation(execution_mode mode,
     term->start_evaluation();
     prof_region_end(("obj-start-eval-" + term->name()).c_str(), false);
   }
+  if (m_scalar_reductions != nullptr) {
+    // Reduce values of all terms, evaluation layers, and metrics
+    m_scalar_reductions->start();
+  }
   prof_region_end("obj-start-eval", false);
   m_evaluation_time += get_time() - start_time;
 }
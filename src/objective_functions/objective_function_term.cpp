@@ -46,6 +46,7 @@ objective_function_term::serialize( Archive & ar ) {
 
 void objective_function_term::setup(model& m) {
   m_comm = m.get_comm();
+  m_scalar_reductions = &m.get_scalar_reductions();
 }
 
 std::vector<ViewingLayerPtr> objective_function_term::get_layer_pointers() const {
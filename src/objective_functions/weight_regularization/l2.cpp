@@ -98,6 +98,8 @@ void l2_weight_regularization::setup(model& m) {
       m_contributions[device].SetMemoryMode(1); // Pinned memory
 #endif // LBANN_HAS_GPU
       m_contributions[device].Resize(1, 1);
+      m_reduction_slots[device] =
+        m_scalar_reductions->add_slot(get_comm().get_trainer_comm());
     }
   }
 
@@ -122,9 +124,8 @@ void l2_weight_regularization::start_evaluation() {
           contribution);
       }
     }
-    get_comm().nb_allreduce(static_cast<El::AbstractMatrix<AccumulateDataType>&>(contribution),
-                            get_comm().get_trainer_comm(),
-                            m_allreduce_req);
+    m_scalar_reductions->contribute(m_reduction_slots[El::Device::CPU],
+                                    El::To<EvalType>(contribution(0, 0)));
   }
 
 #ifdef LBANN_HAS_GPU
@@ -147,13 +148,17 @@ void l2_weight_regularization::start_evaluation() {
           contribution);
       }
     }
-    get_comm().allreduce(static_cast<El::AbstractMatrix<AccumulateDataType>&>(contribution),
-                         get_comm().get_trainer_comm());
     ::hydrogen::gpu::Copy1DToHost(contribution.LockedBuffer(),
                                   m_contributions[El::Device::GPU].Buffer(),
                                   1,
                                   sync_info);
     m_copy_event.record(sync_info.Stream());
+    m_scalar_reductions->contribute(
+      m_reduction_slots[El::Device::GPU],
+      [this]() {
+        m_copy_event.synchronize();
+        return El::To<EvalType>(m_contributions[El::Device::GPU](0, 0));
+      });
   }
 #endif // LBANN_HAS_GPU
 
@@ -162,16 +167,9 @@ void l2_weight_regularization::start_evaluation() {
 EvalType l2_weight_regularization::finish_evaluation() {
   if (m_scale_factor == EvalType(0)) { return EvalType(0); }
   EvalType sqsum = 0;
-  if (m_contributions.count(El::Device::CPU) > 0) {
-    get_comm().wait(m_allreduce_req);
-    sqsum += m_contributions[El::Device::CPU](0, 0);
+  for (const auto& slot : m_reduction_slots) {
+    sqsum += m_scalar_reductions->get(slot.second);
   }
-#ifdef LBANN_HAS_GPU
-  if (m_contributions.count(El::Device::GPU) > 0) {
-    m_copy_event.synchronize();
-    sqsum += m_contributions[El::Device::GPU](0, 0);
-  }
-#endif // LBANN_HAS_GPU
   return m_scale_factor * sqsum / 2;
 }
 
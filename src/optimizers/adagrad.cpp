@@ -58,7 +58,7 @@ description adagrad<TensorDataType>::get_description() const {
 template <typename TensorDataType>
 void adagrad<TensorDataType>::setup(WeightsType* w) {
   OptimizerType::setup(w);
-  const auto& gradient = this->get_gradient();
+  const auto& gradient = this->get_step_gradient();
   m_cache.reset(AbsDistMatrixType::Instantiate(gradient.DistData()));
   El::Zeros(*m_cache, gradient.Height(), gradient.Width());
 }
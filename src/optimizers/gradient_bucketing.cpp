@@ -0,0 +1,295 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2022, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+#include "lbann/optimizers/gradient_bucketing.hpp"
+#include "lbann/utils/exception.hpp"
+#include "lbann/utils/timer.hpp"
+
+#include <utility>
+#include <vector>
+
+namespace lbann {
+
+namespace {
+
+/** @brief Gradient bucket with a flat buffer on one device. */
+template <typename TensorDataType, El::Device Device>
+class gradient_bucket_impl final : public gradient_bucket {
+public:
+  using MatType = El::Matrix<TensorDataType, Device>;
+
+  gradient_bucket_impl(lbann_comm& comm,
+                       const El::mpi::Comm& redundant_comm,
+                       size_t capacity,
+                       const El::SyncInfo<Device>& sync_info,
+                       gradient_bucket_manager::statistics& stats)
+    : m_comm(comm), m_redundant_comm(redundant_comm), m_stats(stats)
+  {
+    El::SetSyncInfo(m_buffer, sync_info);
+    m_buffer.Resize(capacity, 1);
+  }
+
+  ~gradient_bucket_impl() override
+  {
+    // Make sure no communication is pending on the buffer
+    if (m_launched && !m_unpacked) {
+      m_comm.wait(m_req);
+    }
+  }
+
+  /** @brief Whether there is space for @c size more entries. */
+  bool fits(size_t size) const noexcept
+  {
+    return m_size + size <= static_cast<size_t>(m_buffer.Height());
+  }
+
+  /** @brief Copy a gradient's local data into the buffer. */
+  void pack(El::AbstractMatrix<TensorDataType>& local)
+  {
+    auto& grad = static_cast<MatType&>(local);
+    MatType view;
+    El::SetSyncInfo(view, El::SyncInfoFromMatrix(m_buffer));
+    view.Attach(grad.Height(),
+                grad.Width(),
+                m_buffer.Buffer() + m_size,
+                grad.Height());
+    El::Copy(grad, view);
+    m_gradients.push_back(&grad);
+    m_offsets.push_back(m_size);
+    m_size += grad.Height() * grad.Width();
+  }
+
+protected:
+
+  void wait() override
+  {
+    if (m_unpacked) {
+      return;
+    }
+
+    // Record whether the allreduce overlapped with other work
+    const auto start = get_time();
+    m_stats.overlap_time += start - m_launch_time;
+    if (m_comm.test(m_req)) {
+      ++m_stats.num_overlapped;
+    }
+    m_comm.wait(m_req);
+    m_stats.wait_time += get_time() - start;
+
+    // Copy results back into gradients
+    for (size_t i = 0; i < m_gradients.size(); ++i) {
+      auto& grad = *m_gradients[i];
+      MatType view;
+      El::SetSyncInfo(view, El::SyncInfoFromMatrix(m_buffer));
+      view.LockedAttach(grad.Height(),
+                        grad.Width(),
+                        m_buffer.LockedBuffer() + m_offsets[i],
+                        grad.Height());
+      El::Copy(view, grad);
+    }
+    m_unpacked = true;
+
+  }
+
+  void launch() override
+  {
+    if (m_launched) {
+      return;
+    }
+    MatType used;
+    El::View(used, m_buffer, El::IR(0, m_size), El::ALL);
+    m_comm.nb_allreduce(used, m_redundant_comm, m_req);
+    m_launch_time = get_time();
+    m_launched = true;
+  }
+
+  bool is_launched() const noexcept override { return m_launched; }
+
+  size_t size_bytes() const noexcept override
+  {
+    return m_size * sizeof(TensorDataType);
+  }
+
+private:
+
+  lbann_comm& m_comm;
+  const El::mpi::Comm& m_redundant_comm;
+  gradient_bucket_manager::statistics& m_stats;
+
+  /** @brief Packed gradient data. */
+  MatType m_buffer;
+  /** @brief Number of entries in buffer that are in use. */
+  size_t m_size = 0;
+  /** @brief Local matrices of gradients in bucket. */
+  std::vector<MatType*> m_gradients;
+  /** @brief Position of each gradient in buffer. */
+  std::vector<size_t> m_offsets;
+
+  Al::request m_req;
+  bool m_launched = false;
+  bool m_unpacked = false;
+  double m_launch_time = 0.;
+
+};
+
+template <typename TensorDataType, El::Device Device>
+std::shared_ptr<gradient_bucket>
+add_to_bucket(std::shared_ptr<gradient_bucket>& open_bucket,
+              El::AbstractDistMatrix<TensorDataType>& gradient,
+              lbann_comm& comm,
+              size_t capacity,
+              gradient_bucket_manager::statistics& stats,
+              std::shared_ptr<gradient_bucket>& full_bucket)
+{
+  using BucketType = gradient_bucket_impl<TensorDataType, Device>;
+  auto& local = gradient.Matrix();
+  const size_t size = local.Height() * local.Width();
+  if (open_bucket != nullptr
+      && !static_cast<BucketType&>(*open_bucket).fits(size)) {
+    full_bucket = std::move(open_bucket);
+  }
+  if (open_bucket == nullptr) {
+    const auto& local_mat =
+      static_cast<const El::Matrix<TensorDataType, Device>&>(local);
+    open_bucket = std::make_shared<BucketType>(
+      comm,
+      gradient.RedundantComm(),
+      capacity,
+      El::SyncInfoFromMatrix(local_mat),
+      stats);
+  }
+  auto bucket = open_bucket;
+  auto& bucket_impl = static_cast<BucketType&>(*bucket);
+  bucket_impl.pack(local);
+  if (!bucket_impl.fits(1)) {
+    full_bucket = std::move(open_bucket);
+  }
+  return bucket;
+}
+
+} // namespace <anon>
+
+gradient_bucket_manager::gradient_bucket_manager(lbann_comm& comm,
+                                                 size_t bucket_size)
+  : m_comm(comm), m_bucket_size(bucket_size)
+{
+  if (m_bucket_size == 0) {
+    LBANN_ERROR("gradient buckets must have a positive size");
+  }
+}
+
+template <typename TensorDataType>
+std::shared_ptr<gradient_bucket>
+gradient_bucket_manager::add(El::AbstractDistMatrix<TensorDataType>& gradient)
+{
+
+  // Large gradients and gradients that don't need communication are
+  // handled directly
+  const auto& local = gradient.LockedMatrix();
+  const size_t size = local.Height() * local.Width();
+  const size_t capacity = m_bucket_size / sizeof(TensorDataType);
+  if (size == 0 || size >= capacity
+      || El::mpi::Size(gradient.RedundantComm()) == 1) {
+    return nullptr;
+  }
+
+  // Pack gradient into bucket
+  bucket_key key(&gradient.RedundantComm(),
+                 std::type_index(typeid(TensorDataType)),
+                 local.GetDevice());
+  auto& open_bucket = m_open_buckets[key];
+  std::shared_ptr<gradient_bucket> full_bucket, bucket;
+  switch (local.GetDevice()) {
+  case El::Device::CPU:
+    bucket = add_to_bucket<TensorDataType, El::Device::CPU>(open_bucket,
+                                                            gradient,
+                                                            m_comm,
+                                                            capacity,
+                                                            m_stats,
+                                                            full_bucket);
+    break;
+#ifdef LBANN_HAS_GPU
+  case El::Device::GPU:
+    bucket = add_to_bucket<TensorDataType, El::Device::GPU>(open_bucket,
+                                                            gradient,
+                                                            m_comm,
+                                                            capacity,
+                                                            m_stats,
+                                                            full_bucket);
+    break;
+#endif // LBANN_HAS_GPU
+  default:
+    LBANN_ERROR("invalid device");
+  }
+  ++m_stats.num_gradients;
+
+  // Launch allreduce on bucket that has filled up
+  if (full_bucket != nullptr) {
+    launch(*full_bucket);
+  }
+  return bucket;
+
+}
+
+void gradient_bucket_manager::wait(gradient_bucket& bucket)
+{
+  if (!bucket.is_launched()) {
+    for (auto& b : m_open_buckets) {
+      if (b.second.get() == &bucket) {
+        b.second.reset();
+      }
+    }
+    launch(bucket);
+  }
+  bucket.wait();
+}
+
+void gradient_bucket_manager::flush()
+{
+  for (auto& b : m_open_buckets) {
+    if (b.second != nullptr) {
+      launch(*b.second);
+      b.second.reset();
+    }
+  }
+}
+
+void gradient_bucket_manager::launch(gradient_bucket& bucket)
+{
+  bucket.launch();
+  ++m_stats.num_buckets;
+  m_stats.num_bytes += bucket.size_bytes();
+}
+
+#define PROTO(T)                                                \
+  template std::shared_ptr<gradient_bucket>                     \
+  gradient_bucket_manager::add<T>(El::AbstractDistMatrix<T>&)
+
+#define LBANN_INSTANTIATE_CPU_HALF
+#define LBANN_INSTANTIATE_GPU_HALF
+#include "lbann/macros/instantiate.hpp"
+
+} // namespace lbann
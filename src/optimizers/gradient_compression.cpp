@@ -0,0 +1,548 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2022, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+#include "lbann/optimizers/gradient_compression.hpp"
+#include "lbann/comm_impl.hpp"
+#include "lbann/utils/exception.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <numeric>
+#include <random>
+#include <type_traits>
+#include <vector>
+
+namespace lbann {
+
+std::string to_string(gradient_compression_type type)
+{
+  switch (type) {
+  case gradient_compression_type::NONE:
+    return "none";
+  case gradient_compression_type::FP16:
+    return "fp16";
+  case gradient_compression_type::BF16:
+    return "bf16";
+  case gradient_compression_type::TOP_K:
+    return "top-k";
+  case gradient_compression_type::POWER_SGD:
+    return "PowerSGD";
+  default:
+    return "unknown";
+  }
+}
+
+namespace {
+
+// ---------------------------------------------
+// Half-precision encodings
+// ---------------------------------------------
+
+uint32_t float_bits(float x)
+{
+  uint32_t bits;
+  std::memcpy(&bits, &x, sizeof(bits));
+  return bits;
+}
+
+float bits_to_float(uint32_t bits)
+{
+  float x;
+  std::memcpy(&x, &bits, sizeof(x));
+  return x;
+}
+
+/** @brief Round to nearest IEEE half (ties to even). */
+uint16_t encode_fp16(float x)
+{
+  uint32_t bits = float_bits(x);
+  const auto sign = static_cast<uint16_t>((bits >> 16) & 0x8000u);
+  bits &= 0x7FFFFFFFu;
+  if (bits >= 0x7F800000u) {
+    // Infinity or NaN
+    return sign | 0x7C00u | (bits > 0x7F800000u ? 0x0200u : 0u);
+  }
+  if (bits >= 0x477FF000u) {
+    // Rounds past largest finite half
+    return sign | 0x7C00u;
+  }
+  if (bits < 0x38800000u) {
+    // Subnormal half: multiples of 2^-24
+    const float scaled = bits_to_float(bits) * 16777216.f;
+    return sign | static_cast<uint16_t>(std::nearbyint(scaled));
+  }
+  const uint32_t mantissa = bits & 0x7FFFFFu;
+  const uint32_t exponent = (bits >> 23) - 127 + 15;
+  uint32_t half = (exponent << 10) | (mantissa >> 13);
+  const uint32_t remainder = mantissa & 0x1FFFu;
+  if (remainder > 0x1000u || (remainder == 0x1000u && (half & 1u))) {
+    ++half;
+  }
+  return sign | static_cast<uint16_t>(half);
+}
+
+float decode_fp16(uint16_t h)
+{
+  const uint32_t sign = static_cast<uint32_t>(h & 0x8000u) << 16;
+  const uint32_t exponent = (h >> 10) & 0x1Fu;
+  const uint32_t mantissa = h & 0x3FFu;
+  if (exponent == 0) {
+    const float x = std::ldexp(static_cast<float>(mantissa), -24);
+    return sign ? -x : x;
+  }
+  if (exponent == 0x1Fu) {
+    return bits_to_float(sign | 0x7F800000u | (mantissa << 13));
+  }
+  return bits_to_float(sign | ((exponent - 15 + 127) << 23) | (mantissa << 13));
+}
+
+/** @brief Round to nearest bfloat16 (ties to even). */
+uint16_t encode_bf16(float x)
+{
+  const uint32_t bits = float_bits(x);
+  if ((bits & 0x7FFFFFFFu) > 0x7F800000u) {
+    // Keep NaNs quiet
+    return static_cast<uint16_t>((bits >> 16) | 0x0040u);
+  }
+  const uint32_t rounding = 0x7FFFu + ((bits >> 16) & 1u);
+  return static_cast<uint16_t>((bits + rounding) >> 16);
+}
+
+float decode_bf16(uint16_t h)
+{
+  return bits_to_float(static_cast<uint32_t>(h) << 16);
+}
+
+template <bool BF16>
+uint16_t encode_half(float x)
+{
+  return BF16 ? encode_bf16(x) : encode_fp16(x);
+}
+
+template <bool BF16>
+float decode_half(uint16_t h)
+{
+  return BF16 ? decode_bf16(h) : decode_fp16(h);
+}
+
+/** @brief MPI reduction that sums encoded half-precision values. */
+template <bool BF16>
+void half_sum(void* in, void* inout, int* len, MPI_Datatype*)
+{
+  const auto* in_buf = static_cast<const uint16_t*>(in);
+  auto* inout_buf = static_cast<uint16_t*>(inout);
+  for (int i = 0; i < *len; ++i) {
+    inout_buf[i] = encode_half<BF16>(decode_half<BF16>(in_buf[i])
+                                     + decode_half<BF16>(inout_buf[i]));
+  }
+}
+
+template <bool BF16>
+MPI_Op get_half_sum_op()
+{
+  static const MPI_Op op = [] {
+    MPI_Op new_op;
+    if (MPI_Op_create(&half_sum<BF16>, 1, &new_op) != MPI_SUCCESS) {
+      LBANN_ERROR("failed to create MPI reduction for half precision");
+    }
+    return new_op;
+  }();
+  return op;
+}
+
+// ---------------------------------------------
+// Compressors
+// ---------------------------------------------
+
+/** @brief Compressor that works on a contiguous host copy of the
+ *  local gradient. */
+template <typename TensorDataType>
+class host_gradient_compressor : public gradient_compressor<TensorDataType> {
+public:
+  using CPUMatType = El::Matrix<TensorDataType, El::Device::CPU>;
+
+  void allreduce(El::AbstractDistMatrix<TensorDataType>& gradient,
+                 lbann_comm& comm) final
+  {
+    auto& local = gradient.Matrix();
+    const auto& c = gradient.RedundantComm();
+    if (local.Height() == 0 || local.Width() == 0
+        || El::mpi::Size(c) == 1) {
+      return;
+    }
+    CPUMatType host;
+    const bool staged = (local.GetDevice() != El::Device::CPU
+                         || local.LDim() != local.Height());
+    if (staged) {
+      host.Resize(local.Height(), local.Width());
+      El::Copy(local, host);
+    }
+    else {
+      El::View(host, static_cast<CPUMatType&>(local));
+    }
+    compressed_allreduce(host, c, comm);
+    if (staged) {
+      El::Copy(host, local);
+    }
+  }
+
+protected:
+  /** @brief Sum local data over a communicator with more than one
+   *  process.
+   *  @param local Contiguous, non-empty host matrix.
+   */
+  virtual void compressed_allreduce(CPUMatType& local,
+                                    const El::mpi::Comm& c,
+                                    lbann_comm& comm) = 0;
+};
+
+/** @brief Sum in 16-bit floating point. */
+template <typename TensorDataType, bool BF16>
+class half_precision_compressor final
+  : public host_gradient_compressor<TensorDataType> {
+public:
+  using CPUMatType =
+    typename host_gradient_compressor<TensorDataType>::CPUMatType;
+
+protected:
+  void compressed_allreduce(CPUMatType& local,
+                            const El::mpi::Comm& c,
+                            lbann_comm&) override
+  {
+    const size_t size = local.Height() * local.Width();
+    auto* buf = local.Buffer();
+    m_buffer.resize(size);
+    for (size_t i = 0; i < size; ++i) {
+      m_buffer[i] = encode_half<BF16>(static_cast<float>(buf[i]));
+    }
+    if (MPI_Allreduce(MPI_IN_PLACE,
+                      m_buffer.data(),
+                      static_cast<int>(size),
+                      MPI_UINT16_T,
+                      get_half_sum_op<BF16>(),
+                      c.GetMPIComm()) != MPI_SUCCESS) {
+      LBANN_ERROR("half-precision gradient allreduce failed");
+    }
+    for (size_t i = 0; i < size; ++i) {
+      buf[i] = static_cast<TensorDataType>(decode_half<BF16>(m_buffer[i]));
+    }
+    this->record(size * sizeof(TensorDataType), size * sizeof(uint16_t));
+  }
+
+private:
+  std::vector<uint16_t> m_buffer;
+};
+
+/** @brief Exchange the largest-magnitude entries.
+ *
+ *  Each process selects its @f$ k @f$ largest entries (after adding
+ *  the residual from previous steps) and allgathers their indices and
+ *  values. Unselected entries become the new residual.
+ */
+template <typename TensorDataType>
+class top_k_compressor final
+  : public host_gradient_compressor<TensorDataType> {
+public:
+  using CPUMatType =
+    typename host_gradient_compressor<TensorDataType>::CPUMatType;
+
+  top_k_compressor(double ratio) : m_ratio{ratio}
+  {
+    if (!(ratio > 0. && ratio <= 1.)) {
+      LBANN_ERROR("top-k gradient compression ratio must be in (0,1], "
+                  "but got ",
+                  ratio);
+    }
+  }
+
+protected:
+  void compressed_allreduce(CPUMatType& local,
+                            const El::mpi::Comm& c,
+                            lbann_comm& comm) override
+  {
+    const El::Int size = local.Height() * local.Width();
+    const El::Int k =
+      std::min(std::max(static_cast<El::Int>(std::ceil(m_ratio * size)),
+                        El::Int(1)),
+               size);
+    auto* buf = local.Buffer();
+    const size_t dense_bytes = size * sizeof(TensorDataType);
+    const size_t sparse_bytes = k * (sizeof(int) + sizeof(TensorDataType));
+
+    // Add residual from previous steps
+    if (m_residual.size() != static_cast<size_t>(size)) {
+      m_residual.assign(size, TensorDataType(0));
+    }
+    for (El::Int i = 0; i < size; ++i) {
+      m_residual[i] += buf[i];
+    }
+
+    // Sparse format doesn't help, so send everything
+    if (sparse_bytes >= dense_bytes) {
+      std::copy(m_residual.begin(), m_residual.end(), buf);
+      std::fill(m_residual.begin(), m_residual.end(), TensorDataType(0));
+      comm.allreduce(buf, static_cast<int>(size), c);
+      this->record(dense_bytes, dense_bytes);
+      return;
+    }
+
+    // Select largest entries and keep the rest as residual
+    m_indices.resize(size);
+    std::iota(m_indices.begin(), m_indices.end(), 0);
+    const auto& acc = m_residual;
+    std::nth_element(m_indices.begin(),
+                     m_indices.begin() + k,
+                     m_indices.end(),
+                     [&acc](int a, int b) {
+                       return std::abs(acc[a]) > std::abs(acc[b]);
+                     });
+    m_indices.resize(k);
+    std::sort(m_indices.begin(), m_indices.end());
+    m_values.resize(k);
+    for (El::Int i = 0; i < k; ++i) {
+      m_values[i] = m_residual[m_indices[i]];
+      m_residual[m_indices[i]] = TensorDataType(0);
+    }
+
+    // Exchange selected entries and sum them
+    const int num_procs = El::mpi::Size(c);
+    m_all_indices.resize(k * num_procs);
+    m_all_values.resize(k * num_procs);
+    comm.all_gather(m_indices.data(),
+                    static_cast<int>(k),
+                    m_all_indices.data(),
+                    static_cast<int>(k),
+                    c);
+    comm.all_gather(m_values.data(),
+                    static_cast<int>(k),
+                    m_all_values.data(),
+                    static_cast<int>(k),
+                    c);
+    std::fill(buf, buf + size, TensorDataType(0));
+    for (size_t i = 0; i < m_all_indices.size(); ++i) {
+      buf[m_all_indices[i]] += m_all_values[i];
+    }
+    this->record(dense_bytes, sparse_bytes);
+  }
+
+private:
+  double m_ratio;
+  /** @brief Entries that haven't been exchanged yet. */
+  std::vector<TensorDataType> m_residual;
+  std::vector<int> m_indices;
+  std::vector<TensorDataType> m_values;
+  std::vector<int> m_all_indices;
+  std::vector<TensorDataType> m_all_values;
+};
+
+/** @brief Low-rank compression with one step of power iteration.
+ *
+ *  See Vogels et al., "PowerSGD: Practical Low-Rank Gradient
+ *  Compression for Distributed Optimization", NeurIPS 2019. With
+ *  @f$ M @f$ the local gradient plus the error from previous steps
+ *  and @f$ Q @f$ the result from the previous step:
+ *  @f[
+ *    P = \text{orth}\left(\sum M Q\right), \quad
+ *    Q = \sum M^T P, \quad
+ *    \text{gradient} = P Q^T
+ *  @f]
+ *  Only @f$ P @f$ and @f$ Q @f$ are communicated.
+ */
+template <typename TensorDataType>
+class power_sgd_compressor final
+  : public host_gradient_compressor<TensorDataType> {
+public:
+  using CPUMatType =
+    typename host_gradient_compressor<TensorDataType>::CPUMatType;
+
+  power_sgd_compressor(El::Int rank) : m_rank{rank}
+  {
+    if (rank < 1) {
+      LBANN_ERROR("PowerSGD rank must be positive, but got ", rank);
+    }
+  }
+
+protected:
+  void compressed_allreduce(CPUMatType& local,
+                            const El::mpi::Comm& c,
+                            lbann_comm& comm) override
+  {
+    const TensorDataType zero(0), one(1);
+    const El::Int height = local.Height();
+    const El::Int width = local.Width();
+    const El::Int rank = std::min({m_rank, height, width});
+    const size_t dense_bytes = height * width * sizeof(TensorDataType);
+    const size_t low_rank_bytes =
+      (height + width) * rank * sizeof(TensorDataType);
+
+    // Low-rank format doesn't help (e.g. for bias vectors)
+    if (low_rank_bytes >= dense_bytes) {
+      comm.allreduce(static_cast<El::AbstractMatrix<TensorDataType>&>(local),
+                     c);
+      this->record(dense_bytes, dense_bytes);
+      return;
+    }
+
+    // Add error from previous steps
+    if (m_error.Height() != height || m_error.Width() != width) {
+      El::Zeros(m_error, height, width);
+    }
+    El::Axpy(one, m_error, local);
+
+    // Initialize Q with the same values on every process
+    if (m_q.Height() != width || m_q.Width() != rank) {
+      m_q.Resize(width, rank);
+      std::mt19937 gen(20190531u);
+      std::normal_distribution<double> dist(0., 1.);
+      for (El::Int j = 0; j < rank; ++j) {
+        for (El::Int i = 0; i < width; ++i) {
+          m_q(i, j) = static_cast<TensorDataType>(dist(gen));
+        }
+      }
+    }
+
+    // P = orth(sum M Q)
+    m_p.Resize(height, rank);
+    El::Gemm(El::NORMAL, El::NORMAL, one, local, m_q, zero, m_p);
+    comm.allreduce(static_cast<El::AbstractMatrix<TensorDataType>&>(m_p), c);
+    orthonormalize_columns(m_p);
+
+    // Q = M^T P, error = M - P Q^T, Q = sum Q
+    El::Gemm(El::TRANSPOSE, El::NORMAL, one, local, m_p, zero, m_q);
+    El::Copy(local, m_error);
+    El::Gemm(El::NORMAL, El::TRANSPOSE, -one, m_p, m_q, one, m_error);
+    comm.allreduce(static_cast<El::AbstractMatrix<TensorDataType>&>(m_q), c);
+
+    // Decompress
+    El::Gemm(El::NORMAL, El::TRANSPOSE, one, m_p, m_q, zero, local);
+    this->record(dense_bytes, low_rank_bytes);
+  }
+
+private:
+  /** @brief Modified Gram-Schmidt with reorthogonalization.
+   *
+   *  Columns that are numerically dependent on previous ones are
+   *  zeroed out. A second projection pass is needed since a single
+   *  pass loses orthogonality when columns are nearly parallel, which
+   *  is common for gradients with lower rank than the approximation.
+   */
+  static void orthonormalize_columns(CPUMatType& mat)
+  {
+    const El::Int height = mat.Height();
+    const El::Int width = mat.Width();
+    const El::Int ldim = mat.LDim();
+    auto* buf = mat.Buffer();
+    for (El::Int j = 0; j < width; ++j) {
+      auto* col = buf + j * ldim;
+      TensorDataType orig_norm(0);
+      for (El::Int i = 0; i < height; ++i) {
+        orig_norm += col[i] * col[i];
+      }
+      orig_norm = std::sqrt(orig_norm);
+      for (int pass = 0; pass < 2; ++pass) {
+        for (El::Int k = 0; k < j; ++k) {
+          const auto* prev = buf + k * ldim;
+          TensorDataType dot(0);
+          for (El::Int i = 0; i < height; ++i) {
+            dot += prev[i] * col[i];
+          }
+          for (El::Int i = 0; i < height; ++i) {
+            col[i] -= dot * prev[i];
+          }
+        }
+      }
+      TensorDataType norm(0);
+      for (El::Int i = 0; i < height; ++i) {
+        norm += col[i] * col[i];
+      }
+      norm = std::sqrt(norm);
+      const auto tol =
+        std::sqrt(TensorDataType(height))
+        * std::numeric_limits<TensorDataType>::epsilon() * orig_norm;
+      const TensorDataType scale =
+        (norm > tol && norm > TensorDataType(0)
+           ? TensorDataType(1) / norm
+           : TensorDataType(0));
+      for (El::Int i = 0; i < height; ++i) {
+        col[i] *= scale;
+      }
+    }
+  }
+
+  El::Int m_rank;
+  CPUMatType m_p;
+  /** @brief Warm start for power iteration. */
+  CPUMatType m_q;
+  /** @brief Part of the gradient that hasn't been exchanged yet. */
+  CPUMatType m_error;
+};
+
+} // namespace <anon>
+
+template <typename TensorDataType>
+std::unique_ptr<gradient_compressor<TensorDataType>>
+make_gradient_compressor(const gradient_compression_config& config)
+{
+  if (config.type == gradient_compression_type::NONE) {
+    return nullptr;
+  }
+  if constexpr (std::is_same<TensorDataType, float>::value
+                || std::is_same<TensorDataType, double>::value) {
+    switch (config.type) {
+    case gradient_compression_type::FP16:
+      return std::make_unique<
+        half_precision_compressor<TensorDataType, false>>();
+    case gradient_compression_type::BF16:
+      return std::make_unique<
+        half_precision_compressor<TensorDataType, true>>();
+    case gradient_compression_type::TOP_K:
+      return std::make_unique<top_k_compressor<TensorDataType>>(
+        config.top_k_ratio);
+    case gradient_compression_type::POWER_SGD:
+      return std::make_unique<power_sgd_compressor<TensorDataType>>(
+        config.power_sgd_rank);
+    default:
+      LBANN_ERROR("invalid gradient compression type");
+    }
+  }
+  LBANN_ERROR(to_string(config.type),
+              " gradient compression is only supported "
+              "for float and double gradients");
+  return nullptr;
+}
+
+#define PROTO(T)                                                        \
+  template std::unique_ptr<gradient_compressor<T>>                      \
+  make_gradient_compressor<T>(const gradient_compression_config&)
+
+#define LBANN_INSTANTIATE_CPU_HALF
+#define LBANN_INSTANTIATE_GPU_HALF
+#include "lbann/macros/instantiate.hpp"
+
+} // namespace lbann
@@ -0,0 +1,196 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2022, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+#include "lbann/optimizers/gradient_sharding.hpp"
+#include "lbann/utils/exception.hpp"
+
+#include <algorithm>
+
+namespace lbann {
+
+namespace {
+
+template <typename TensorDataType, El::Device Device>
+void copy_to_shard_impl(const El::Matrix<TensorDataType, Device>& full,
+                        El::Matrix<TensorDataType, Device>& shard,
+                        const gradient_shard_layout& layout)
+{
+  const auto count = layout.counts[layout.rank];
+  if (count == 0) {
+    return;
+  }
+  El::Matrix<TensorDataType, Device> full_chunk, shard_chunk;
+  El::SetSyncInfo(full_chunk, El::SyncInfoFromMatrix(full));
+  El::SetSyncInfo(shard_chunk, El::SyncInfoFromMatrix(shard));
+  full_chunk.LockedAttach(count,
+                          1,
+                          full.LockedBuffer() + layout.offsets[layout.rank],
+                          count);
+  shard_chunk.Attach(count, 1, shard.Buffer(), count);
+  El::Copy(full_chunk, shard_chunk);
+}
+
+template <typename TensorDataType, El::Device Device>
+void gather_from_shard_impl(const El::Matrix<TensorDataType, Device>& shard,
+                            El::Matrix<TensorDataType, Device>& full,
+                            const gradient_shard_layout& layout)
+{
+  El::mpi::AllGather(shard.LockedBuffer(),
+                     layout.counts[layout.rank],
+                     full.Buffer(),
+                     layout.counts.data(),
+                     layout.offsets.data(),
+                     *layout.comm,
+                     El::SyncInfoFromMatrix(full));
+}
+
+template <typename TensorDataType>
+void check_local_matrices(const El::AbstractMatrix<TensorDataType>& full,
+                          const El::AbstractMatrix<TensorDataType>& shard,
+                          const gradient_shard_layout& layout)
+{
+  const El::Int size = layout.offsets.back() + layout.counts.back();
+  if (full.Height() * full.Width() != size
+      || (full.Width() > 1 && full.LDim() != full.Height())) {
+    LBANN_ERROR("expected contiguous matrix with ", size, " entries");
+  }
+  if (shard.Height() * shard.Width() < layout.counts[layout.rank]) {
+    LBANN_ERROR("shard matrix is too small");
+  }
+  if (full.GetDevice() != shard.GetDevice()) {
+    LBANN_ERROR("shard and full matrices are on different devices");
+  }
+}
+
+} // namespace <anon>
+
+template <typename TensorDataType>
+std::shared_ptr<const gradient_shard_layout>
+make_gradient_shard_layout(const El::AbstractDistMatrix<TensorDataType>& values)
+{
+  if (values.ColDist() != El::STAR || values.RowDist() != El::STAR
+      || values.Wrap() != El::ELEMENT || !values.Participating()) {
+    return nullptr;
+  }
+  const auto& comm = values.Grid().VCComm();
+  const int num_procs = El::mpi::Size(comm);
+  const El::Int size = values.LocalHeight() * values.LocalWidth();
+  if (num_procs == 1 || size < num_procs
+      || (values.LocalWidth() > 1 && values.LDim() != values.LocalHeight())) {
+    return nullptr;
+  }
+
+  // Split local entries as evenly as possible
+  auto layout = std::make_shared<gradient_shard_layout>();
+  layout->comm = &comm;
+  layout->rank = El::mpi::Rank(comm);
+  const El::Int chunk_size = (size + num_procs - 1) / num_procs;
+  layout->counts.resize(num_procs);
+  layout->offsets.resize(num_procs);
+  for (int i = 0; i < num_procs; ++i) {
+    const auto begin = std::min(i * chunk_size, size);
+    const auto end = std::min(begin + chunk_size, size);
+    layout->offsets[i] = static_cast<int>(begin);
+    layout->counts[i] = static_cast<int>(end - begin);
+  }
+
+  // Each process holds one chunk of a VC,STAR column vector
+  layout->dist = values.DistData();
+  layout->dist.colDist = El::VC;
+  layout->dist.rowDist = El::STAR;
+  layout->dist.colAlign = 0;
+  layout->dist.rowAlign = 0;
+  layout->height = chunk_size * num_procs;
+  return layout;
+}
+
+template <typename TensorDataType>
+void copy_to_shard(const El::AbstractMatrix<TensorDataType>& full,
+                   El::AbstractMatrix<TensorDataType>& shard,
+                   const gradient_shard_layout& layout)
+{
+  check_local_matrices(full, shard, layout);
+  switch (full.GetDevice()) {
+  case El::Device::CPU:
+    copy_to_shard_impl(
+      static_cast<const El::Matrix<TensorDataType, El::Device::CPU>&>(full),
+      static_cast<El::Matrix<TensorDataType, El::Device::CPU>&>(shard),
+      layout);
+    break;
+#ifdef LBANN_HAS_GPU
+  case El::Device::GPU:
+    copy_to_shard_impl(
+      static_cast<const El::Matrix<TensorDataType, El::Device::GPU>&>(full),
+      static_cast<El::Matrix<TensorDataType, El::Device::GPU>&>(shard),
+      layout);
+    break;
+#endif // LBANN_HAS_GPU
+  default:
+    LBANN_ERROR("invalid device");
+  }
+}
+
+template <typename TensorDataType>
+void gather_from_shard(const El::AbstractMatrix<TensorDataType>& shard,
+                       El::AbstractMatrix<TensorDataType>& full,
+                       const gradient_shard_layout& layout)
+{
+  check_local_matrices(full, shard, layout);
+  switch (full.GetDevice()) {
+  case El::Device::CPU:
+    gather_from_shard_impl(
+      static_cast<const El::Matrix<TensorDataType, El::Device::CPU>&>(shard),
+      static_cast<El::Matrix<TensorDataType, El::Device::CPU>&>(full),
+      layout);
+    break;
+#ifdef LBANN_HAS_GPU
+  case El::Device::GPU:
+    gather_from_shard_impl(
+      static_cast<const El::Matrix<TensorDataType, El::Device::GPU>&>(shard),
+      static_cast<El::Matrix<TensorDataType, El::Device::GPU>&>(full),
+      layout);
+    break;
+#endif // LBANN_HAS_GPU
+  default:
+    LBANN_ERROR("invalid device");
+  }
+}
+
+#define PROTO(T)                                                        \
+  template std::shared_ptr<const gradient_shard_layout>                 \
+  make_gradient_shard_layout<T>(const El::AbstractDistMatrix<T>&);      \
+  template void copy_to_shard<T>(const El::AbstractMatrix<T>&,          \
+                                 El::AbstractMatrix<T>&,                \
+                                 const gradient_shard_layout&);         \
+  template void gather_from_shard<T>(const El::AbstractMatrix<T>&,      \
+                                     El::AbstractMatrix<T>&,            \
+                                     const gradient_shard_layout&)
+
+#define LBANN_INSTANTIATE_CPU_HALF
+#define LBANN_INSTANTIATE_GPU_HALF
+#include "lbann/macros/instantiate.hpp"
+
+} // namespace lbann
@@ -90,7 +90,7 @@ description hypergradient_adam<TensorDataType>::get_description() const {
 template <typename TensorDataType>
 void hypergradient_adam<TensorDataType>::setup(WeightsType* w) {
   OptimizerType::setup(w);
-  const auto& gradient = this->get_gradient();
+  const auto& gradient = this->get_step_gradient();
   m_moment1.reset(AbsDistMatrixType::Instantiate(gradient.DistData()));
   m_moment2.reset(AbsDistMatrixType::Instantiate(gradient.DistData()));
   m_old_gradient.reset(AbsDistMatrixType::Instantiate(gradient.DistData()));
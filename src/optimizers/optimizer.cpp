@@ -53,7 +53,9 @@ optimizer::optimizer(const optimizer& other)
   : m_comm(other.m_comm),
     m_gradient_sources(other.m_gradient_sources),
     m_gradient_status(other.m_gradient_status),
-    m_step_time(other.m_step_time) {
+    m_step_time(other.m_step_time),
+    m_shard_layout(other.m_shard_layout),
+    m_gradient_compression(other.m_gradient_compression) {
   if (m_gradient_status == optimizer_gradient_status::allreduce_started) {
     LBANN_ERROR("attempted to copy optimizer while a "
                 "gradient allreduce is in progress");
@@ -65,6 +67,8 @@ optimizer& optimizer::operator=(const optimizer& other) {
   m_gradient_sources = other.m_gradient_sources;
   m_gradient_status = other.m_gradient_status;
   m_step_time = other.m_step_time;
+  m_shard_layout = other.m_shard_layout;
+  m_gradient_compression = other.m_gradient_compression;
   if (m_gradient_status == optimizer_gradient_status::allreduce_started) {
     LBANN_ERROR("attempted to copy optimizer while a "
                 "gradient allreduce is in progress");
@@ -79,9 +83,28 @@ void optimizer::serialize(Archive & ar) {
 
 description optimizer::get_description() const {
   description desc(get_type() + " optimizer");
+  if (m_gradient_compression.type != gradient_compression_type::NONE) {
+    desc.add("Gradient compression",
+             to_string(m_gradient_compression.type));
+  }
   return desc;
 }
 
+gradient_compression_statistics
+optimizer::get_gradient_compression_statistics() const {
+  gradient_compression_statistics stats;
+  for (const auto& g : gradients_) {
+    stats += g.second->compression_statistics();
+  }
+  return stats;
+}
+
+void optimizer::reset_gradient_compression_statistics() {
+  for (auto& g : gradients_) {
+    g.second->reset_compression_statistics();
+  }
+}
+
 El::Int optimizer::get_num_gradient_sources() const {
   return m_gradient_sources.size();
 }
@@ -95,7 +118,14 @@ void optimizer::add_gradient_source(const void* source) {
 void optimizer::remove_gradient_source(const void* source) {
   m_gradient_sources.erase(nullptr);
   m_gradient_sources.erase(source);
-  if (get_gradient_sources().empty()) {
+  if (get_gradient_sources().empty() && !m_defer_gradient_allreduce) {
+    start_gradient_allreduce();
+  }
+}
+
+void optimizer::set_gradient_allreduce_deferred(bool defer) {
+  m_defer_gradient_allreduce = defer;
+  if (!defer && get_gradient_sources().empty()) {
     start_gradient_allreduce();
   }
 }
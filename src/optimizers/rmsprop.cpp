@@ -65,7 +65,7 @@ description rmsprop<TensorDataType>::get_description() const {
 template <typename TensorDataType>
 void rmsprop<TensorDataType>::setup(WeightsType* w) {
   OptimizerType::setup(w);
-  const auto& gradient = this->get_gradient();
+  const auto& gradient = this->get_step_gradient();
   m_cache.reset(AbsDistMatrixType::Instantiate(gradient.DistData()));
   El::Zeros(*m_cache, gradient.Height(), gradient.Width());
 }
@@ -82,7 +82,7 @@ auto sgd<TensorDataType>::get_velocity() -> AbsDistMatrixType& {
 template <typename TensorDataType>
 void sgd<TensorDataType>::setup(WeightsType* w) {
   OptimizerType::setup(w);
-  const auto& gradient = this->get_gradient();
+  const auto& gradient = this->get_step_gradient();
   m_velocity.reset(AbsDistMatrixType::Instantiate(gradient.DistData()));
 #ifdef LBANN_HAS_GPU
   if (m_velocity->GetLocalDevice() == El::Device::GPU) {
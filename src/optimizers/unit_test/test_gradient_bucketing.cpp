@@ -0,0 +1,108 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2022, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+#include <catch2/catch.hpp>
+
+#include "MPITestHelpers.hpp"
+
+// File being tested
+#include <lbann/optimizers/gradient_bucketing.hpp>
+
+#include <lbann/base.hpp>
+#include <lbann/comm_impl.hpp>
+
+#include <memory>
+#include <utility>
+#include <vector>
+
+TEST_CASE("Gradient bucketing", "[mpi][optimizer][bucketing]")
+{
+  using MatType = El::DistMatrix<float, El::STAR, El::STAR>;
+
+  auto& comm = unit_test::utilities::current_world_comm();
+  auto const& grid = comm.get_trainer_grid();
+  const int rank = El::mpi::Rank(grid.Comm());
+  const int num_procs = El::mpi::Size(grid.Comm());
+
+  // Buckets with 16 entries. The fourth gradient overflows the first
+  // bucket, the fifth fills the second bucket exactly, and the last
+  // gradient is too large for a bucket.
+  lbann::gradient_bucket_manager buckets(comm, 16 * sizeof(float));
+  const std::vector<std::pair<El::Int, El::Int>> dims = {
+    {3, 2}, {5, 1}, {4, 1}, {4, 3}, {2, 2}, {1, 1}, {20, 1}};
+  std::vector<std::unique_ptr<MatType>> grads;
+  std::vector<std::shared_ptr<lbann::gradient_bucket>> grad_buckets;
+  for (size_t i = 0; i < dims.size(); ++i) {
+    grads.emplace_back(std::make_unique<MatType>(grid));
+    auto& grad = *grads.back();
+    grad.Resize(dims[i].first, dims[i].second);
+    El::Fill(grad, static_cast<float>((rank + 1) * (i + 1)));
+    grad_buckets.emplace_back(buckets.add(grad));
+  }
+  buckets.flush();
+
+  if (num_procs == 1) {
+    // No communication is needed
+    for (const auto& b : grad_buckets) {
+      CHECK(b == nullptr);
+    }
+    return;
+  }
+
+  CHECK(grad_buckets[0] != nullptr);
+  CHECK(grad_buckets[0] == grad_buckets[1]);
+  CHECK(grad_buckets[0] == grad_buckets[2]);
+  CHECK(grad_buckets[3] != nullptr);
+  CHECK(grad_buckets[0] != grad_buckets[3]);
+  CHECK(grad_buckets[3] == grad_buckets[4]);
+  CHECK(grad_buckets[5] != nullptr);
+  CHECK(grad_buckets[4] != grad_buckets[5]);
+  CHECK(grad_buckets[6] == nullptr);
+
+  // Wait on buckets in reverse order, like model::update_weights
+  for (size_t i = grad_buckets.size(); i > 0; --i) {
+    if (grad_buckets[i - 1] != nullptr) {
+      buckets.wait(*grad_buckets[i - 1]);
+    }
+  }
+
+  // Gradients in buckets are summed over ranks
+  const float rank_sum = num_procs * (num_procs + 1) / 2.f;
+  for (size_t i = 0; i + 1 < grads.size(); ++i) {
+    const auto& local = grads[i]->LockedMatrix();
+    for (El::Int col = 0; col < local.Width(); ++col) {
+      for (El::Int row = 0; row < local.Height(); ++row) {
+        CHECK(local(row, col) == rank_sum * (i + 1));
+      }
+    }
+  }
+
+  const auto& stats = buckets.get_statistics();
+  CHECK(stats.num_buckets == 3);
+  CHECK(stats.num_gradients == 6);
+  CHECK(stats.num_bytes == 32 * sizeof(float));
+  buckets.reset_statistics();
+  CHECK(buckets.get_statistics().num_buckets == 0);
+}
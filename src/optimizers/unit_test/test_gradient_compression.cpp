@@ -0,0 +1,213 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2022, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+#include <catch2/catch.hpp>
+
+#include "MPITestHelpers.hpp"
+
+// File being tested
+#include <lbann/optimizers/gradient_compression.hpp>
+
+#include <lbann/base.hpp>
+#include <lbann/comm_impl.hpp>
+#include <lbann/optimizers/sgd.hpp>
+#include <lbann/weights/data_type_weights.hpp>
+#include <lbann/weights/initializer.hpp>
+
+#include <memory>
+
+namespace {
+
+using MatType = El::DistMatrix<float, El::STAR, El::STAR>;
+
+/** @brief Rank-one contribution scaled by process rank. */
+void fill_rank_one(MatType& mat, int rank)
+{
+  for (El::Int col = 0; col < mat.LocalWidth(); ++col) {
+    for (El::Int row = 0; row < mat.LocalHeight(); ++row) {
+      mat.SetLocal(row, col, (rank + 1) * (row + 1.f) * (col - 2.5f));
+    }
+  }
+}
+
+/** @brief Sum of rank-one contributions over all processes. */
+float rank_one_sum(El::Int row, El::Int col, int num_procs)
+{
+  return num_procs * (num_procs + 1) / 2 * (row + 1.f) * (col - 2.5f);
+}
+
+} // namespace <anon>
+
+TEST_CASE("Gradient compression", "[mpi][optimizer][compression]")
+{
+  auto& comm = unit_test::utilities::current_world_comm();
+  auto const& grid = comm.get_trainer_grid();
+  const int rank = El::mpi::Rank(grid.Comm());
+  const int num_procs = El::mpi::Size(grid.Comm());
+  lbann::gradient_compression_config config;
+
+  SECTION("Disabled")
+  {
+    CHECK(lbann::make_gradient_compressor<float>(config) == nullptr);
+  }
+
+  SECTION("Half precision")
+  {
+    for (const auto type : {lbann::gradient_compression_type::FP16,
+                            lbann::gradient_compression_type::BF16}) {
+      config.type = type;
+      auto compressor = lbann::make_gradient_compressor<float>(config);
+      REQUIRE(compressor != nullptr);
+      MatType grad(grid);
+      grad.Resize(8, 6);
+      fill_rank_one(grad, rank);
+      compressor->allreduce(grad, comm);
+      const float tol =
+        (type == lbann::gradient_compression_type::FP16 ? 4e-3f : 3e-2f);
+      for (El::Int col = 0; col < grad.LocalWidth(); ++col) {
+        for (El::Int row = 0; row < grad.LocalHeight(); ++row) {
+          const float ref = rank_one_sum(row, col, num_procs);
+          CHECK(grad.GetLocal(row, col)
+                == Approx(ref).epsilon(tol).margin(1e-6));
+        }
+      }
+      const auto& stats = compressor->get_statistics();
+      if (num_procs > 1) {
+        CHECK(stats.num_allreduces == 1);
+        CHECK(stats.ratio() == Approx(2.));
+      }
+    }
+  }
+
+  SECTION("Top-k with error feedback")
+  {
+    // One entry is exchanged per step, so every entry has been
+    // exchanged after as many steps as there are entries
+    config.type = lbann::gradient_compression_type::TOP_K;
+    config.top_k_ratio = 0.05;
+    auto compressor = lbann::make_gradient_compressor<float>(config);
+    REQUIRE(compressor != nullptr);
+    constexpr El::Int height = 20;
+    MatType grad(grid), total(grid);
+    El::Zeros(total, height, 1);
+    for (El::Int step = 0; step < height; ++step) {
+      El::Zeros(grad, height, 1);
+      if (step == 0) {
+        for (El::Int row = 0; row < height; ++row) {
+          grad.SetLocal(row, 0, (rank + 1) * (row % 7 - 3.f));
+        }
+      }
+      compressor->allreduce(grad, comm);
+      El::Axpy(1.f, grad, total);
+    }
+    for (El::Int row = 0; row < height; ++row) {
+      const float ref = num_procs * (num_procs + 1) / 2 * (row % 7 - 3.f);
+      CHECK(total.GetLocal(row, 0) == Approx(ref).margin(1e-5));
+    }
+    if (num_procs > 1) {
+      CHECK(compressor->get_statistics().ratio() == Approx(10.));
+    }
+  }
+
+  SECTION("PowerSGD")
+  {
+    // Rank-one gradients are recovered exactly, and vectors are
+    // allreduced without compression. Compressors keep per-matrix
+    // state, so each matrix gets its own, as in the optimizer.
+    config.type = lbann::gradient_compression_type::POWER_SGD;
+    config.power_sgd_rank = 2;
+    auto grad_compressor = lbann::make_gradient_compressor<float>(config);
+    auto bias_compressor = lbann::make_gradient_compressor<float>(config);
+    REQUIRE(grad_compressor != nullptr);
+    REQUIRE(bias_compressor != nullptr);
+    MatType grad(grid), bias(grid);
+    grad.Resize(8, 6);
+    bias.Resize(5, 1);
+    for (int step = 0; step < 2; ++step) {
+      fill_rank_one(grad, rank);
+      fill_rank_one(bias, rank);
+      grad_compressor->allreduce(grad, comm);
+      bias_compressor->allreduce(bias, comm);
+      for (El::Int col = 0; col < grad.LocalWidth(); ++col) {
+        for (El::Int row = 0; row < grad.LocalHeight(); ++row) {
+          CHECK(grad.GetLocal(row, col)
+                == Approx(rank_one_sum(row, col, num_procs)).margin(1e-3));
+        }
+      }
+      for (El::Int row = 0; row < bias.LocalHeight(); ++row) {
+        CHECK(bias.GetLocal(row, 0)
+              == Approx(rank_one_sum(row, 0, num_procs)));
+      }
+    }
+    if (num_procs > 1) {
+      const auto& grad_stats = grad_compressor->get_statistics();
+      CHECK(grad_stats.num_allreduces == 2);
+      CHECK(grad_stats.ratio() > 1.);
+      const auto& bias_stats = bias_compressor->get_statistics();
+      CHECK(bias_stats.num_allreduces == 2);
+      CHECK(bias_stats.ratio() == Approx(1.));
+    }
+  }
+}
+
+TEST_CASE("Optimizer with gradient compression",
+          "[mpi][optimizer][compression]")
+{
+  auto& comm = unit_test::utilities::current_world_comm();
+  auto const& grid = comm.get_trainer_grid();
+  const int rank = El::mpi::Rank(grid.Comm());
+  const int num_procs = El::mpi::Size(grid.Comm());
+
+  lbann::gradient_compression_config config;
+  config.type = lbann::gradient_compression_type::POWER_SGD;
+  config.power_sgd_rank = 1;
+  lbann::data_type_weights<float> w(comm);
+  w.set_dims({8}, {6});
+  w.set_initializer(std::make_unique<lbann::constant_initializer<float>>(0.f));
+  auto opt = std::make_unique<lbann::sgd<float>>(1.f);
+  opt->set_gradient_compression(config);
+  w.set_optimizer(std::move(opt));
+  w.setup();
+  auto& sgd = *w.get_optimizer();
+
+  MatType contrib(grid);
+  contrib.Resize(8, 6);
+  fill_rank_one(contrib, rank);
+  sgd.clear_gradient();
+  sgd.add_to_gradient(contrib, 1.f, true);
+  sgd.step();
+
+  const auto& values = w.get_values().LockedMatrix();
+  for (El::Int col = 0; col < values.Width(); ++col) {
+    for (El::Int row = 0; row < values.Height(); ++row) {
+      CHECK(values(row, col)
+            == Approx(-rank_one_sum(row, col, num_procs)).margin(1e-3));
+    }
+  }
+  const auto stats = sgd.get_gradient_compression_statistics();
+  CHECK(stats.num_allreduces == (num_procs > 1 ? 1u : 0u));
+  sgd.reset_gradient_compression_statistics();
+  CHECK(sgd.get_gradient_compression_statistics().num_allreduces == 0);
+}
@@ -0,0 +1,112 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2022, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+#include <catch2/catch.hpp>
+
+#include "MPITestHelpers.hpp"
+
+// File being tested
+#include <lbann/optimizers/adam.hpp>
+
+#include <lbann/base.hpp>
+#include <lbann/weights/data_type_weights.hpp>
+#include <lbann/weights/initializer.hpp>
+
+#include <memory>
+
+namespace {
+
+auto make_adam_weights(lbann::lbann_comm& comm,
+                       size_t height,
+                       size_t width,
+                       bool shard)
+{
+  auto w = std::make_unique<lbann::data_type_weights<float>>(comm);
+  w->set_dims({height}, {width});
+  w->set_initializer(
+    std::make_unique<lbann::constant_initializer<float>>(0.5f));
+  auto opt = std::make_unique<lbann::adam<float>>(0.1f);
+  opt->set_state_sharding(shard);
+  w->set_optimizer(std::move(opt));
+  w->setup();
+  return w;
+}
+
+} // namespace <anon>
+
+TEST_CASE("Sharded optimizer state", "[mpi][optimizer][sharding]")
+{
+  using MatType = El::DistMatrix<float, El::STAR, El::STAR>;
+
+  auto& comm = unit_test::utilities::current_world_comm();
+  auto const& grid = comm.get_trainer_grid();
+  const int rank = El::mpi::Rank(grid.Comm());
+  const int num_procs = El::mpi::Size(grid.Comm());
+
+  // Weights size is not divisible by most process counts
+  constexpr size_t height = 7, width = 3;
+  auto ref = make_adam_weights(comm, height, width, false);
+  auto sharded = make_adam_weights(comm, height, width, true);
+  auto& ref_opt = *ref->get_optimizer();
+  auto& sharded_opt = *sharded->get_optimizer();
+  CHECK_FALSE(ref_opt.is_state_sharded());
+  CHECK(sharded_opt.is_state_sharded() == (num_procs > 1));
+
+  // Gradient contributions differ across processes and are summed
+  MatType contrib(grid);
+  contrib.Resize(height, width);
+  for (int step = 0; step < 3; ++step) {
+    for (El::Int col = 0; col < contrib.LocalWidth(); ++col) {
+      for (El::Int row = 0; row < contrib.LocalHeight(); ++row) {
+        contrib.SetLocal(row, col, 0.1f * (rank + 1) * (row - col + step));
+      }
+    }
+    for (auto* opt : {&ref_opt, &sharded_opt}) {
+      opt->clear_gradient();
+      opt->add_to_gradient(contrib, 1.f, true);
+      opt->step();
+    }
+  }
+
+  // Updated weights match on every process
+  const auto& ref_values = ref->get_values().LockedMatrix();
+  const auto& sharded_values = sharded->get_values().LockedMatrix();
+  for (El::Int col = 0; col < ref_values.Width(); ++col) {
+    for (El::Int row = 0; row < ref_values.Height(); ++row) {
+      CHECK(sharded_values(row, col)
+            == Approx(ref_values(row, col)).margin(1e-6));
+    }
+  }
+
+  // Full gradient is still available
+  const auto& ref_grad = ref_opt.get_gradient().LockedMatrix();
+  const auto& sharded_grad = sharded_opt.get_gradient().LockedMatrix();
+  for (El::Int col = 0; col < ref_grad.Width(); ++col) {
+    for (El::Int row = 0; row < ref_grad.Height(); ++row) {
+      CHECK(sharded_grad(row, col)
+            == Approx(ref_grad(row, col)).margin(1e-6));
+    }
+  }
+}
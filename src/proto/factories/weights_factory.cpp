@@ -110,6 +110,30 @@ construct_initializer(const lbann_data::Weights& proto_weights) {
   return factory.create_object(msg.GetDescriptor()->name(), msg);
 }
 
+/* Construct gradient compression settings specified with prototext. */
+lbann::gradient_compression_config
+construct_gradient_compression(const lbann_data::GradientCompression& msg) {
+  lbann::gradient_compression_config config;
+  if (msg.has_half_precision()) {
+    config.type = (msg.half_precision().bfloat16()
+                   ? lbann::gradient_compression_type::BF16
+                   : lbann::gradient_compression_type::FP16);
+  }
+  else if (msg.has_top_k()) {
+    config.type = lbann::gradient_compression_type::TOP_K;
+    if (msg.top_k().ratio() != 0.) {
+      config.top_k_ratio = msg.top_k().ratio();
+    }
+  }
+  else if (msg.has_power_sgd()) {
+    config.type = lbann::gradient_compression_type::POWER_SGD;
+    if (msg.power_sgd().rank() != 0) {
+      config.power_sgd_rank = msg.power_sgd().rank();
+    }
+  }
+  return config;
+}
+
 } // namespace
 
 std::unique_ptr<lbann::weights> lbann::proto::construct_weights(
@@ -169,6 +193,10 @@ std::unique_ptr<lbann::weights> lbann::proto::construct_weights(
   }
 
   // Set weights initializer and optimizer
+  if (opt != nullptr && proto_weights.has_gradient_compression()) {
+    opt->set_gradient_compression(
+      construct_gradient_compression(proto_weights.gradient_compression()));
+  }
   w->set_initializer(std::move(init));
   w->set_optimizer(std::move(opt));
 
@@ -38,6 +38,7 @@
 #include "lbann/utils/description.hpp"
 #include "lbann/utils/memory.hpp"
 #include "lbann/utils/serialize.hpp"
+#include "lbann/utils/serialization/elastic_checkpoint.hpp"
 
 // LBANN proto
 #include <lbann.pb.h>
@@ -257,7 +258,8 @@ void trainer::train(observer_ptr<model> model,
   // checkpoint/restart mechanisms. This needs to be refactored to be
   // agnostic to the training algorithm. At this time, only SGD is
   // properly C/R-able.
-  if (m_training_alg->get_type() == "sgd") {
+  if (m_training_alg->get_type() == "sgd"
+      || m_training_alg->get_type() == "local_sgd") {
     auto key = check_and_build_execution_context(*m_training_alg,
                                                  model,
                                                  execution_mode::training);
@@ -417,6 +419,19 @@ bool trainer::save_to_checkpoint_distributed()
 
 bool trainer::load_from_checkpoint_distributed(persist& p)
 {
+  // Restarting on a different number of ranks: the trainer state
+  // isn't sharded, so restore it once from the old trainer master
+  if (auto const* elastic = utils::get_elastic_restart_context()) {
+    if (!elastic->is_last_pass()) {
+      return true;
+    }
+    p.close_restart();
+    p.open_restart(elastic->get_primary_dir());
+    bool const success = load_from_checkpoint_shared(p);
+    p.close_restart();
+    p.open_restart(elastic->get_source_dir());
+    return success;
+  }
   read_cereal_archive(*this,
                       p,
 #ifdef LBANN_HAS_CEREAL_XML_ARCHIVES
@@ -430,6 +445,23 @@ bool trainer::load_from_checkpoint_distributed(persist& p)
 
 bool trainer::load_from_checkpoint_distributed(model& m, ExecutionContext& c)
 {
+  // Restarting on a different number of ranks: execution contexts
+  // and data reader positions are restored once from the old trainer
+  // master and broadcast, as for a shared checkpoint. RNG states are
+  // still read from the source rank's files.
+  if (auto const* elastic = utils::get_elastic_restart_context()) {
+    if (!elastic->is_last_pass()) {
+      return true;
+    }
+    auto& p = get_persist_obj();
+    p.close_restart();
+    p.open_restart(elastic->get_primary_dir());
+    bool const success = load_from_checkpoint_shared(m, c);
+    p.close_restart();
+    p.open_restart(elastic->get_source_dir());
+    return success;
+  }
+
   load_rng_from_checkpoint(get_persist_obj(), m_comm);
 
   execution_mode current_mode = c.get_execution_mode();
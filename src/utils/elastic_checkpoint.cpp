@@ -0,0 +1,121 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2022, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+#include "lbann/utils/serialization/elastic_checkpoint.hpp"
+
+namespace lbann
+{
+namespace utils
+{
+namespace
+{
+dist_matrix_layout_recorder* current_recorder_ = nullptr;
+elastic_restart_context* current_elastic_context_ = nullptr;
+}// namespace <anon>
+
+dist_matrix_layout_recorder::dist_matrix_layout_recorder()
+  : m_parent{current_recorder_}
+{
+  current_recorder_ = this;
+}
+
+dist_matrix_layout_recorder::~dist_matrix_layout_recorder()
+{
+  current_recorder_ = m_parent;
+}
+
+dist_matrix_layout_recorder* get_dist_matrix_layout_recorder() noexcept
+{
+  return current_recorder_;
+}
+
+int get_elastic_restart_num_passes(int old_num_procs, int num_procs) noexcept
+{
+  return (old_num_procs + num_procs - 1) / num_procs;
+}
+
+elastic_restart_source get_elastic_restart_source(int pass,
+                                                  int rank,
+                                                  int num_procs,
+                                                  int old_num_procs) noexcept
+{
+  elastic_restart_source source;
+  source.rank = pass * num_procs + rank;
+  source.contribute = (source.rank < old_num_procs);
+  if (!source.contribute) {
+    source.rank = rank % old_num_procs;
+  }
+  return source;
+}
+
+elastic_restart_context::elastic_restart_context(int old_num_procs,
+                                                 std::string primary_dir)
+  : m_old_num_procs{old_num_procs},
+    m_primary_dir{std::move(primary_dir)}
+{
+  if (current_elastic_context_ != nullptr)
+    LBANN_ERROR("elastic restart contexts cannot be nested");
+  current_elastic_context_ = this;
+}
+
+elastic_restart_context::~elastic_restart_context()
+{
+  current_elastic_context_ = nullptr;
+}
+
+void elastic_restart_context::begin_pass(int source_rank,
+                                         std::string source_dir,
+                                         bool contribute,
+                                         bool last_pass)
+{
+  m_source_rank = source_rank;
+  m_source_dir = std::move(source_dir);
+  m_contribute = contribute;
+  m_last_pass = last_pass;
+  m_layouts.clear();
+  m_num_loaded = 0;
+}
+
+void elastic_restart_context::set_layouts(
+  int old_num_procs,
+  std::vector<dist_matrix_layout> layouts)
+{
+  if (old_num_procs != m_old_num_procs) {
+    LBANN_ERROR("checkpoint in ", m_source_dir, " was written by ",
+                old_num_procs, " ranks per trainer, but ",
+                m_old_num_procs, " were expected");
+  }
+  m_layouts = std::move(layouts);
+  m_num_loaded = 0;
+}
+
+elastic_restart_context* get_elastic_restart_context() noexcept
+{
+  return current_elastic_context_;
+}
+
+}// namespace utils
+}// namespace lbann
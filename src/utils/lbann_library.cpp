@@ -34,6 +34,7 @@
 #include "lbann/proto/factories.hpp"
 #include "lbann/utils/omp_diagnostics.hpp"
 #include "lbann/utils/threads/thread_utils.hpp"
+#include "lbann/utils/timer_map.hpp"
 #include "lbann/callbacks/callback.hpp"
 #include "lbann/callbacks/checkpoint.hpp"
 #include "lbann/callbacks/dump_weights.hpp"
@@ -106,6 +107,9 @@ int allocate_trainer_resources(lbann_comm *comm) {
     comm->split_trainer_grid(trainer_primary_grid_size, trainer_create_two_models);
   }
 
+  comm->set_hierarchical_allreduce(
+    arg_parser.get<bool>(LBANN_OPTION_HIERARCHICAL_ALLREDUCE));
+
   return procs_per_trainer;
 }
 
@@ -141,6 +145,10 @@ trainer& construct_trainer(lbann_comm* comm,
   }
   auto const& arg_parser = global_argument_parser();
 
+  // Time each phase of trainer construction
+  TimerMap startup_timer("construct_trainer");
+  startup_timer.timer().start();
+
   // Adjust the number of parallel readers; this may be adjusted
   // after calling split_trainers()
   // set_num_parallel_readers(*comm, pb);
@@ -153,8 +161,11 @@ trainer& construct_trainer(lbann_comm* comm,
   }
 
   // Initalize a per-trainer I/O thread pool
-  std::unique_ptr<thread_pool> io_thread_pool =
-    construct_io_thread_pool(comm, serialized_io);
+  std::unique_ptr<thread_pool> io_thread_pool;
+  {
+    ScopeTimer _(startup_timer, "I/O thread pool");
+    io_thread_pool = construct_io_thread_pool(comm, serialized_io);
+  }
 
   // Setup I/O threads
   auto const io_threads_per_process = io_thread_pool->get_num_threads();
@@ -174,7 +185,10 @@ trainer& construct_trainer(lbann_comm* comm,
   //    print_parameters(comm, pb);
 
   // Initalize trainer
-  global_trainer_ = proto::construct_trainer(comm, *pb_trainer);
+  {
+    ScopeTimer _(startup_timer, "trainer construction");
+    global_trainer_ = proto::construct_trainer(comm, *pb_trainer);
+  }
 
   // FIXME (trb 04/09/21): This ensures that the trainer is destroyed
   // before the Hydrogen threadpools come destruction time. This is a
@@ -287,9 +301,15 @@ trainer& construct_trainer(lbann_comm* comm,
   // Initialize data readers
   //@todo: code not in place for correctly handling image preprocessing
   std::map<execution_mode, generic_data_reader*> data_readers;
-  init_data_readers(comm, pb, data_readers);
+  {
+    ScopeTimer _(startup_timer, "data readers");
+    init_data_readers(comm, pb, data_readers);
+  }
 
-  global_trainer_->setup(std::move(io_thread_pool), data_readers);
+  {
+    ScopeTimer _(startup_timer, "trainer setup");
+    global_trainer_->setup(std::move(io_thread_pool), data_readers);
+  }
 
   if (arg_parser.get<bool>(LBANN_OPTION_DISABLE_BACKGROUND_IO_ACTIVITY)) {
     global_trainer_->allow_background_io_activity(false);
@@ -346,6 +366,13 @@ trainer& construct_trainer(lbann_comm* comm,
                      data_seq_random_seeds);
   }
 
+  // Report construction times
+  startup_timer.timer().stop();
+  if (arg_parser.get<bool>(LBANN_OPTION_PRINT_SETUP_TIMES)
+      && comm->am_trainer_master()) {
+    startup_timer.print(std::cout);
+  }
+
   return *global_trainer_;
 }
 
@@ -393,9 +420,16 @@ std::unique_ptr<model> build_model_from_prototext(
 
   std::ostringstream err;
 
+  // Time each phase of model construction
+  TimerMap startup_timer("build_model_from_prototext");
+  startup_timer.timer().start();
+
   // Save info to file; this includes the complete prototext (with any over-rides
   // from the cmd line) and various other info
-  save_session(*comm, argc, argv, pb);
+  {
+    ScopeTimer _(startup_timer, "save session");
+    save_session(*comm, argc, argv, pb);
+  }
 
   // Display how the OpenMP threads are provisioned
   auto& arg_parser = global_argument_parser();
@@ -404,11 +438,15 @@ std::unique_ptr<model> build_model_from_prototext(
   }
 
   // Initalize model
-  std::unique_ptr<model> ret_model = proto::construct_model(comm,
-                                                            training_dr_linearized_data_size,
-                                                            pb.optimizer(),
-                                                            pb.trainer(),
-                                                            pb.model());
+  std::unique_ptr<model> ret_model;
+  {
+    ScopeTimer _(startup_timer, "model construction");
+    ret_model = proto::construct_model(comm,
+                                       training_dr_linearized_data_size,
+                                       pb.optimizer(),
+                                       pb.trainer(),
+                                       pb.model());
+  }
 
   // Add the trainer's callbacks to the model
   for (auto&& c : shared_callbacks) {
@@ -491,6 +529,13 @@ std::unique_ptr<model> build_model_from_prototext(
   //@todo
   //model->restartShared();
 
+  // Report construction times
+  startup_timer.timer().stop();
+  if (arg_parser.get<bool>(LBANN_OPTION_PRINT_SETUP_TIMES)
+      && comm->am_trainer_master()) {
+    startup_timer.print(std::cout);
+  }
+
   return ret_model;
 }
 
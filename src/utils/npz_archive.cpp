@@ -0,0 +1,638 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2022, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+#include "lbann/utils/npz_archive.hpp"
+#include "lbann/utils/exception.hpp"
+
+#include <zlib.h>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cctype>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <numeric>
+#include <sstream>
+
+namespace lbann {
+
+namespace {
+
+/** @brief Size of decompressed chunks in cache. */
+constexpr size_t chunk_size = 1ul << 20;
+/** @brief Minimum spacing between inflate access points.
+ *
+ *  Each access point stores a 32 KB window, so the index takes
+ *  roughly 0.4% of the uncompressed size.
+ */
+constexpr size_t access_point_span = 8ul << 20;
+/** @brief Size of deflate history window. */
+constexpr size_t window_size = 32768;
+/** @brief Maximum number of bytes passed to zlib at once. */
+constexpr size_t max_inflate_input = 1ul << 30;
+
+constexpr uint32_t local_header_signature = 0x04034b50;
+constexpr uint32_t central_header_signature = 0x02014b50;
+constexpr uint32_t eocd_signature = 0x06054b50;
+constexpr uint32_t zip64_eocd_signature = 0x06064b50;
+constexpr uint32_t zip64_eocd_locator_signature = 0x07064b50;
+constexpr uint16_t zip64_extra_field_id = 0x0001;
+
+// Zip files are little-endian
+uint16_t read_u16(const unsigned char* p) {
+  return static_cast<uint16_t>(p[0] | (p[1] << 8));
+}
+uint32_t read_u32(const unsigned char* p) {
+  return (static_cast<uint32_t>(p[0])
+          | (static_cast<uint32_t>(p[1]) << 8)
+          | (static_cast<uint32_t>(p[2]) << 16)
+          | (static_cast<uint32_t>(p[3]) << 24));
+}
+uint64_t read_u64(const unsigned char* p) {
+  return (static_cast<uint64_t>(read_u32(p))
+          | (static_cast<uint64_t>(read_u32(p+4)) << 32));
+}
+
+} // namespace <anon>
+
+// =========================================================
+// npz_array
+// =========================================================
+
+npz_array::npz_array(const npz_archive& archive, std::string name)
+  : m_archive(&archive), m_name(std::move(name)) {}
+
+size_t npz_array::num_vals() const noexcept {
+  return std::accumulate(m_shape.begin(), m_shape.end(),
+                         size_t{1}, std::multiplies<size_t>());
+}
+
+size_t npz_array::num_rows() const noexcept {
+  return m_shape.empty() ? 1 : m_shape.front();
+}
+
+size_t npz_array::row_size() const noexcept {
+  if (m_shape.empty()) { return m_word_size; }
+  return std::accumulate(m_shape.begin()+1, m_shape.end(),
+                         m_word_size, std::multiplies<size_t>());
+}
+
+const void* npz_array::row_ptr(size_t row) const {
+  if (row >= num_rows()) {
+    LBANN_ERROR("attempted to access row ",row," of array \"",m_name,"\" ",
+                "in ",m_archive->filename(),", ",
+                "which only has ",num_rows()," rows");
+  }
+  if (m_compressed) { return nullptr; }
+  return (m_archive->m_file_data + m_file_offset
+          + m_data_offset + row * row_size());
+}
+
+void npz_array::read_rows(size_t first_row, size_t num_rows, void* dst) const {
+  if (first_row + num_rows > this->num_rows()) {
+    LBANN_ERROR("attempted to read rows ",first_row," to ",
+                first_row+num_rows," of array \"",m_name,"\" ",
+                "in ",m_archive->filename(),", ",
+                "which only has ",this->num_rows()," rows");
+  }
+  read_bytes(m_data_offset + first_row * row_size(),
+             num_rows * row_size(),
+             dst);
+}
+
+void npz_array::read_bytes(size_t offset, size_t size, void* dst) const {
+  if (size == 0) { return; }
+  if (m_compressed) {
+    m_archive->read_member(*this, offset, size, dst);
+  }
+  else {
+    std::memcpy(dst, m_archive->m_file_data + m_file_offset + offset, size);
+  }
+}
+
+// =========================================================
+// npz_archive
+// =========================================================
+
+npz_archive::npz_archive(std::string filename, size_t cache_size)
+  : m_filename(std::move(filename)), m_cache_size(cache_size) {
+
+  // Memory-map archive file
+  const int fd = ::open(m_filename.c_str(), O_RDONLY);
+  if (fd < 0) {
+    LBANN_ERROR("could not open NPZ file (",m_filename,")");
+  }
+  struct stat file_stat;
+  if (::fstat(fd, &file_stat) != 0) {
+    ::close(fd);
+    LBANN_ERROR("could not stat NPZ file (",m_filename,")");
+  }
+  m_file_size = file_stat.st_size;
+  if (m_file_size > 0) {
+    void* ptr = ::mmap(nullptr, m_file_size, PROT_READ, MAP_SHARED, fd, 0);
+    if (ptr == MAP_FAILED) {
+      ::close(fd);
+      LBANN_ERROR("could not memory-map NPZ file (",m_filename,")");
+    }
+    m_file_data = static_cast<const unsigned char*>(ptr);
+  }
+  ::close(fd);
+
+  // Parse archive metadata
+  try {
+    parse_central_directory();
+  }
+  catch (...) {
+    if (m_file_data != nullptr) {
+      ::munmap(const_cast<unsigned char*>(m_file_data), m_file_size);
+    }
+    throw;
+  }
+
+}
+
+npz_archive::~npz_archive() {
+  if (m_file_data != nullptr) {
+    ::munmap(const_cast<unsigned char*>(m_file_data), m_file_size);
+  }
+}
+
+bool npz_archive::has_array(const std::string& name) const {
+  return m_arrays.count(name) > 0;
+}
+
+const npz_array& npz_archive::get_array(const std::string& name) const {
+  auto it = m_arrays.find(name);
+  if (it == m_arrays.end()) {
+    LBANN_ERROR("could not find array \"",name,"\" in ",m_filename);
+  }
+  return *it->second;
+}
+
+std::vector<std::string> npz_archive::get_array_names() const {
+  std::vector<std::string> names;
+  for (const auto& a : m_arrays) {
+    names.push_back(a.first);
+  }
+  return names;
+}
+
+void npz_archive::parse_central_directory() {
+
+  // Find end of central directory record
+  // Note: Record is 22 bytes, followed by a comment of at most 64 KB.
+  constexpr size_t eocd_size = 22;
+  if (m_file_size < eocd_size) {
+    LBANN_ERROR(m_filename," is too small to be an NPZ file");
+  }
+  const size_t search_end = m_file_size - eocd_size;
+  const size_t search_begin = (search_end > 65535 ? search_end - 65535 : 0);
+  size_t eocd = m_file_size;
+  for (size_t pos = search_end+1; pos-- > search_begin;) {
+    if (read_u32(m_file_data + pos) == eocd_signature) {
+      eocd = pos;
+      break;
+    }
+  }
+  if (eocd == m_file_size) {
+    LBANN_ERROR("could not find zip central directory in ",m_filename);
+  }
+  size_t num_entries = read_u16(m_file_data + eocd + 10);
+  size_t cd_size = read_u32(m_file_data + eocd + 12);
+  size_t cd_offset = read_u32(m_file_data + eocd + 16);
+
+  // Get central directory from Zip64 record if needed
+  if (num_entries == 0xFFFF
+      || cd_size == 0xFFFFFFFF
+      || cd_offset == 0xFFFFFFFF) {
+    if (eocd < 20
+        || read_u32(m_file_data + eocd - 20) != zip64_eocd_locator_signature) {
+      LBANN_ERROR("could not find Zip64 end of central directory locator ",
+                  "in ",m_filename);
+    }
+    const size_t zip64_eocd = read_u64(m_file_data + eocd - 20 + 8);
+    if (zip64_eocd + 56 > m_file_size
+        || read_u32(m_file_data + zip64_eocd) != zip64_eocd_signature) {
+      LBANN_ERROR("invalid Zip64 end of central directory record ",
+                  "in ",m_filename);
+    }
+    num_entries = read_u64(m_file_data + zip64_eocd + 32);
+    cd_size = read_u64(m_file_data + zip64_eocd + 40);
+    cd_offset = read_u64(m_file_data + zip64_eocd + 48);
+  }
+  if (cd_offset + cd_size > m_file_size) {
+    LBANN_ERROR("invalid zip central directory in ",m_filename);
+  }
+
+  // Iterate through central directory entries
+  size_t pos = cd_offset;
+  for (size_t i = 0; i < num_entries; ++i) {
+    constexpr size_t header_size = 46;
+    if (pos + header_size > cd_offset + cd_size
+        || read_u32(m_file_data + pos) != central_header_signature) {
+      LBANN_ERROR("invalid zip central directory entry in ",m_filename);
+    }
+    const auto* header = m_file_data + pos;
+    const uint16_t method = read_u16(header + 10);
+    size_t compressed_size = read_u32(header + 20);
+    size_t uncompressed_size = read_u32(header + 24);
+    const size_t name_length = read_u16(header + 28);
+    const size_t extra_length = read_u16(header + 30);
+    const size_t comment_length = read_u16(header + 32);
+    size_t local_header_offset = read_u32(header + 42);
+    std::string name(reinterpret_cast<const char*>(header + header_size),
+                     name_length);
+    pos += header_size + name_length + extra_length + comment_length;
+    if (pos > cd_offset + cd_size) {
+      LBANN_ERROR("invalid zip central directory entry in ",m_filename);
+    }
+
+    // Get sizes and offset from Zip64 extra field if needed
+    const auto* extra = header + header_size + name_length;
+    const auto* extra_end = extra + extra_length;
+    while (extra + 4 <= extra_end) {
+      const uint16_t field_id = read_u16(extra);
+      const uint16_t field_size = read_u16(extra + 2);
+      const auto* field = extra + 4;
+      const auto* field_end = std::min(field + field_size, extra_end);
+      if (field_id == zip64_extra_field_id) {
+        if (uncompressed_size == 0xFFFFFFFF && field + 8 <= field_end) {
+          uncompressed_size = read_u64(field);
+          field += 8;
+        }
+        if (compressed_size == 0xFFFFFFFF && field + 8 <= field_end) {
+          compressed_size = read_u64(field);
+          field += 8;
+        }
+        if (local_header_offset == 0xFFFFFFFF && field + 8 <= field_end) {
+          local_header_offset = read_u64(field);
+          field += 8;
+        }
+      }
+      extra += 4 + field_size;
+    }
+
+    // Find member data after local file header
+    if (local_header_offset + 30 > m_file_size
+        || (read_u32(m_file_data + local_header_offset)
+            != local_header_signature)) {
+      LBANN_ERROR("invalid zip local file header for \"",name,"\" ",
+                  "in ",m_filename);
+    }
+    const auto* local_header = m_file_data + local_header_offset;
+    const size_t file_offset = (local_header_offset + 30
+                                + read_u16(local_header + 26)
+                                + read_u16(local_header + 28));
+    if (file_offset + compressed_size > m_file_size) {
+      LBANN_ERROR("zip member \"",name,"\" in ",m_filename," ",
+                  "extends past end of file");
+    }
+    if (method != 0 && method != Z_DEFLATED) {
+      LBANN_ERROR("zip member \"",name,"\" in ",m_filename," ",
+                  "uses unsupported compression method ",method);
+    }
+    if (method == 0 && compressed_size != uncompressed_size) {
+      LBANN_ERROR("uncompressed zip member \"",name,"\" in ",m_filename," ",
+                  "has inconsistent sizes");
+    }
+
+    // Construct array
+    const std::string suffix = ".npy";
+    if (name.size() > suffix.size()
+        && name.compare(name.size()-suffix.size(), suffix.size(), suffix) == 0) {
+      name.resize(name.size()-suffix.size());
+    }
+    std::unique_ptr<npz_array> array(new npz_array(*this, name));
+    array->m_compressed = (method == Z_DEFLATED);
+    array->m_file_offset = file_offset;
+    array->m_compressed_size = compressed_size;
+    array->m_uncompressed_size = uncompressed_size;
+    if (array->m_compressed) {
+      // First access point is at beginning of deflate stream
+      array->m_member_index = m_indices.size();
+      m_indices.emplace_back();
+      m_indices.back().points.emplace_back();
+    }
+    parse_npy_header(*array);
+    m_arrays[name] = std::move(array);
+
+  }
+
+}
+
+void npz_archive::parse_npy_header(npz_array& array) const {
+
+  // Read magic string, version, and header length
+  constexpr size_t max_preamble_size = 12;
+  unsigned char preamble[max_preamble_size];
+  const size_t preamble_size = std::min(max_preamble_size,
+                                        array.m_uncompressed_size);
+  if (preamble_size < 10) {
+    LBANN_ERROR("array \"",array.m_name,"\" in ",m_filename," ",
+                "is too small to be an NPY file");
+  }
+  array.read_bytes(0, preamble_size, preamble);
+  if (std::memcmp(preamble, "\x93NUMPY", 6) != 0) {
+    LBANN_ERROR("array \"",array.m_name,"\" in ",m_filename," ",
+                "is not an NPY file");
+  }
+  size_t header_begin, header_size;
+  switch (preamble[6]) {
+  case 1:
+    header_begin = 10;
+    header_size = read_u16(preamble + 8);
+    break;
+  case 2:
+  case 3:
+    if (preamble_size < 12) {
+      LBANN_ERROR("array \"",array.m_name,"\" in ",m_filename," ",
+                  "has a truncated NPY header");
+    }
+    header_begin = 12;
+    header_size = read_u32(preamble + 8);
+    break;
+  default:
+    LBANN_ERROR("array \"",array.m_name,"\" in ",m_filename," ",
+                "has unsupported NPY version ",int(preamble[6]));
+  }
+  if (header_begin + header_size > array.m_uncompressed_size) {
+    LBANN_ERROR("array \"",array.m_name,"\" in ",m_filename," ",
+                "has a truncated NPY header");
+  }
+  std::string header(header_size, '\0');
+  array.read_bytes(header_begin, header_size, &header[0]);
+  array.m_data_offset = header_begin + header_size;
+
+  // Header is a Python dict literal, e.g.
+  // {'descr': '<f4', 'fortran_order': False, 'shape': (3, 4), }
+  auto find_value = [&](const std::string& key) -> size_t {
+    auto pos = header.find("'" + key + "'");
+    if (pos != std::string::npos) { pos = header.find(':', pos); }
+    if (pos == std::string::npos) {
+      LBANN_ERROR("could not find \"",key,"\" in NPY header of ",
+                  "array \"",array.m_name,"\" in ",m_filename);
+    }
+    return header.find_first_not_of(' ', pos+1);
+  };
+
+  // Data type
+  {
+    const auto begin = find_value("descr");
+    const auto end = (begin == std::string::npos
+                      ? std::string::npos
+                      : header.find(header[begin], begin+1));
+    const auto descr = (end == std::string::npos
+                        ? std::string()
+                        : header.substr(begin+1, end-begin-1));
+    if (descr.size() < 3 || !std::isdigit(descr[2])) {
+      LBANN_ERROR("array \"",array.m_name,"\" in ",m_filename," ",
+                  "has unsupported data type (",descr,")");
+    }
+    array.m_type_kind = descr[1];
+    array.m_word_size = std::stoul(descr.substr(2));
+    if (array.m_type_kind == 'U') {
+      // Unicode strings are stored as UCS-4
+      array.m_word_size *= 4;
+    }
+    if (descr[0] == '>' && array.m_word_size > 1) {
+      LBANN_ERROR("array \"",array.m_name,"\" in ",m_filename," ",
+                  "is big-endian, which is not supported");
+    }
+  }
+
+  // Storage order
+  array.m_fortran_order = (header.compare(find_value("fortran_order"),
+                                          4, "True") == 0);
+
+  // Shape
+  {
+    const auto begin = header.find('(', find_value("shape"));
+    const auto end = header.find(')', begin);
+    if (begin == std::string::npos || end == std::string::npos) {
+      LBANN_ERROR("could not parse shape in NPY header of ",
+                  "array \"",array.m_name,"\" in ",m_filename);
+    }
+    array.m_shape.clear();
+    std::istringstream ss(header.substr(begin+1, end-begin-1));
+    std::string dim;
+    while (std::getline(ss, dim, ',')) {
+      if (dim.find_first_of("0123456789") != std::string::npos) {
+        array.m_shape.push_back(std::stoul(dim));
+      }
+    }
+  }
+  if (array.m_fortran_order && array.m_shape.size() > 1) {
+    LBANN_ERROR("array \"",array.m_name,"\" in ",m_filename," ",
+                "is stored in Fortran order, which is only supported "
+                "for 1D arrays");
+  }
+  if (array.m_data_offset + array.num_vals() * array.m_word_size
+      > array.m_uncompressed_size) {
+    LBANN_ERROR("array \"",array.m_name,"\" in ",m_filename," ",
+                "is truncated");
+  }
+
+}
+
+void npz_archive::read_member(const npz_array& array,
+                              size_t offset,
+                              size_t size,
+                              void* dst) const {
+  auto* out = static_cast<unsigned char*>(dst);
+  while (size > 0) {
+    const size_t chunk_index = offset / chunk_size;
+    const size_t chunk_offset = offset % chunk_size;
+    const size_t count = std::min(size, chunk_size - chunk_offset);
+    if (m_cache_size < chunk_size) {
+      // Bypass cache if it can't hold a chunk
+      inflate_range(array, offset, offset + count, out);
+    }
+    else {
+      const auto chunk = get_chunk(array, chunk_index);
+      std::memcpy(out, chunk->data() + chunk_offset, count);
+    }
+    out += count;
+    offset += count;
+    size -= count;
+  }
+}
+
+std::shared_ptr<const std::vector<unsigned char>>
+npz_archive::get_chunk(const npz_array& array, size_t chunk_index) const {
+  const auto key = std::make_pair(array.m_member_index, chunk_index);
+
+  // Return cached chunk if available
+  {
+    std::lock_guard<std::mutex> lock(m_cache_mutex);
+    auto it = m_cache_map.find(key);
+    if (it != m_cache_map.end()) {
+      m_cache.splice(m_cache.begin(), m_cache, it->second);
+      return it->second->second;
+    }
+  }
+
+  // Inflate chunk
+  // Note: Other threads may access the cache in the meantime.
+  const size_t begin = chunk_index * chunk_size;
+  const size_t end = std::min(begin + chunk_size, array.m_uncompressed_size);
+  auto chunk = std::make_shared<std::vector<unsigned char>>(end - begin);
+  inflate_range(array, begin, end, chunk->data());
+
+  // Add chunk to cache and evict least-recently-used chunks
+  std::lock_guard<std::mutex> lock(m_cache_mutex);
+  if (m_cache_map.count(key) == 0) {
+    m_cache.emplace_front(key, chunk);
+    m_cache_map[key] = m_cache.begin();
+    m_cache_used += chunk->size();
+    while (m_cache_used > m_cache_size && m_cache.size() > 1) {
+      const auto& lru = m_cache.back();
+      m_cache_used -= lru.second->size();
+      m_cache_map.erase(lru.first);
+      m_cache.pop_back();
+    }
+  }
+  return chunk;
+
+}
+
+void npz_archive::inflate_range(const npz_array& array,
+                                size_t begin,
+                                size_t end,
+                                unsigned char* dst) const {
+  const unsigned char* in_data = m_file_data + array.m_file_offset;
+  const size_t in_size = array.m_compressed_size;
+
+  // Find closest access point before requested range
+  access_point start;
+  size_t last_point_out;
+  {
+    std::lock_guard<std::mutex> lock(m_cache_mutex);
+    const auto& index = m_indices[array.m_member_index];
+    auto it = std::upper_bound(
+      index.points.begin(), index.points.end(), begin,
+      [](size_t offset, const access_point& p) { return offset < p.out; });
+    start = *std::prev(it);
+    last_point_out = std::max(index.points.back().out, start.out);
+  }
+
+  // Initialize raw inflate at access point
+  z_stream strm;
+  std::memset(&strm, 0, sizeof(strm));
+  if (inflateInit2(&strm, -MAX_WBITS) != Z_OK) {
+    LBANN_ERROR("could not initialize zlib inflate stream");
+  }
+  if (start.bits > 0) {
+    inflatePrime(&strm, start.bits,
+                 in_data[start.in-1] >> (8 - start.bits));
+  }
+  if (!start.window.empty()) {
+    inflateSetDictionary(&strm, start.window.data(), start.window.size());
+  }
+
+  // Inflate until end of requested range
+  // Note: Output is written into a circular window buffer so that
+  // access points can record the last 32 KB of uncompressed data.
+  std::vector<unsigned char> window(window_size);
+  std::vector<access_point> new_points;
+  size_t in_pos = start.in;
+  size_t out_pos = start.out;
+  int ret = Z_OK;
+  while (out_pos < end && ret != Z_STREAM_END) {
+    if (strm.avail_in == 0) {
+      if (in_pos >= in_size) { break; }
+      strm.next_in = const_cast<unsigned char*>(in_data + in_pos);
+      strm.avail_in = static_cast<uInt>(std::min(in_size - in_pos,
+                                                 max_inflate_input));
+    }
+    if (strm.avail_out == 0) {
+      strm.next_out = window.data();
+      strm.avail_out = window_size;
+    }
+    const unsigned char* out_begin = strm.next_out;
+    const uInt avail_in = strm.avail_in;
+    ret = inflate(&strm, Z_BLOCK);
+    if (ret != Z_OK && ret != Z_STREAM_END && ret != Z_BUF_ERROR) {
+      inflateEnd(&strm);
+      LBANN_ERROR("zlib error (",ret,") while inflating ",
+                  "array \"",array.m_name,"\" in ",m_filename);
+    }
+    in_pos += avail_in - strm.avail_in;
+    const size_t produced = strm.next_out - out_begin;
+
+    // Copy output that overlaps with requested range
+    const size_t copy_begin = std::max(out_pos, begin);
+    const size_t copy_end = std::min(out_pos + produced, end);
+    if (copy_begin < copy_end) {
+      std::memcpy(dst + (copy_begin - begin),
+                  out_begin + (copy_begin - out_pos),
+                  copy_end - copy_begin);
+    }
+    out_pos += produced;
+
+    // Record access point at deflate block boundaries
+    const bool at_block_boundary = ((strm.data_type & 128)
+                                    && !(strm.data_type & 64));
+    if (ret == Z_OK
+        && at_block_boundary
+        && out_pos >= last_point_out + access_point_span) {
+      access_point p;
+      p.out = out_pos;
+      p.in = in_pos;
+      p.bits = strm.data_type & 7;
+      p.window.resize(window_size);
+      const size_t left = strm.avail_out;
+      std::memcpy(p.window.data(), window.data() + window_size - left, left);
+      std::memcpy(p.window.data() + left, window.data(), window_size - left);
+      new_points.emplace_back(std::move(p));
+      last_point_out = out_pos;
+    }
+
+  }
+  inflateEnd(&strm);
+  if (out_pos < end) {
+    LBANN_ERROR("compressed array \"",array.m_name,"\" in ",m_filename," ",
+                "is truncated");
+  }
+
+  // Add new access points to index
+  if (!new_points.empty()) {
+    std::lock_guard<std::mutex> lock(m_cache_mutex);
+    auto& points = m_indices[array.m_member_index].points;
+    for (auto& p : new_points) {
+      if (p.out >= points.back().out + access_point_span) {
+        points.emplace_back(std::move(p));
+      }
+    }
+  }
+
+}
+
+} // namespace lbann
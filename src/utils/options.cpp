@@ -49,10 +49,24 @@ void construct_std_options()
   arg_parser.add_flag(LBANN_OPTION_EXIT_AFTER_SETUP,
                       {"--exit_after_setup"},
                       "[STD] Forces exit after model setup");
+  arg_parser.add_flag(
+    LBANN_OPTION_FUSE_FC_ACTIVATION,
+    {"--fuse_fc_activation"},
+    utils::ENV("LBANN_FUSE_FC_ACTIVATION"),
+    "[STD] Fold ReLU, sigmoid, and tanh layers into the data-parallel "
+    "CPU fully-connected layers that feed them. Folded activation "
+    "layers are removed from the model.");
   arg_parser.add_flag(LBANN_OPTION_GENERATE_MULTI_PROTO,
                       {"--generate_multi_proto"},
                       "[STD] Enables loading of multiple prototext files for "
                       "model, datareader, optimizer, etc. input options");
+  arg_parser.add_flag(
+    LBANN_OPTION_HIERARCHICAL_ALLREDUCE,
+    {"--hierarchical_allreduce"},
+    utils::ENV("LBANN_HIERARCHICAL_ALLREDUCE"),
+    "[STD] Allreduce CPU matrices within each compute node through "
+    "shared memory and only communicate across nodes among one "
+    "process per node");
   arg_parser.add_flag(
     LBANN_OPTION_LOAD_MODEL_WEIGHTS_DIR_IS_COMPLETE,
     {"--load_model_weights_dir_is_complete"},
@@ -91,10 +105,23 @@ void construct_std_options()
     LBANN_OPTION_PRINT_AFFINITY,
     {"--print_affinity"},
     "[STD] display information on how OpenMP threads are provisioned");
+  arg_parser.add_flag(
+    LBANN_OPTION_PRINT_SETUP_TIMES,
+    {"--print_setup_times"},
+    utils::ENV("LBANN_PRINT_SETUP_TIMES"),
+    "[STD] display the time spent in each phase of trainer and model "
+    "construction and setup");
   arg_parser.add_flag(
     LBANN_OPTION_SERIALIZE_IO,
     {"--serialize_io"},
     "[STD] force data readers to use a single threaded for I/O");
+  arg_parser.add_flag(
+    LBANN_OPTION_SHARD_OPTIMIZER_STATE,
+    {"--shard_optimizer_state"},
+    utils::ENV("LBANN_SHARD_OPTIMIZER_STATE"),
+    "[STD] Partition optimizer state for data-parallel weights across "
+    "the processes in a trainer. Gradients are reduce-scattered and "
+    "each process only updates its partition of the weights.");
   arg_parser.add_flag(LBANN_OPTION_ST_ON,
                       {"--st_on"},
                       "[STD] Enable stack profiler tracing");
@@ -146,6 +173,28 @@ void construct_std_options()
     "Additionally, sets the output directory for dumping weights.\n"
     "Modifies callbacks: checkpoint, save_model, dump_weights\n",
     "");
+  arg_parser.add_option(
+    LBANN_OPTION_FFTW_WISDOM,
+    {"--fftw_wisdom"},
+    utils::ENV("LBANN_FFTW_WISDOM"),
+    "[STD] FFTW wisdom file. Wisdom is imported from this file when "
+    "it exists and is saved to it whenever a new FFTW plan is built.",
+    "");
+  arg_parser.add_option(
+    LBANN_OPTION_GRADIENT_ACCUMULATION_STEPS,
+    {"--gradient_accumulation_steps"},
+    utils::ENV("LBANN_GRADIENT_ACCUMULATION_STEPS"),
+    "[STD] Accumulate gradients over this many mini-batches before "
+    "each gradient allreduce and optimization step. Training steps "
+    "(e.g. for --num_batches) count optimization steps.",
+    1UL);
+  arg_parser.add_option(
+    LBANN_OPTION_GRADIENT_BUCKET_SIZE,
+    {"--gradient_bucket_size"},
+    utils::ENV("LBANN_GRADIENT_BUCKET_SIZE"),
+    "[STD] Fuse gradient allreduces into buckets of up to this many "
+    "bytes, launched as they fill during back prop (0 to disable)",
+    0UL);
   arg_parser.add_option(LBANN_OPTION_HYDROGEN_BLOCK_SIZE,
                         {"--hydrogen_block_size"},
                         "[STD] Block size for Hydrogen",
@@ -168,6 +217,14 @@ void construct_std_options()
                         {"--metadata"},
                         "[STD] Metadata input file",
                         "");
+  arg_parser.add_option(
+    LBANN_OPTION_METRIC_REDUCTION_INTERVAL,
+    {"--metric_reduction_interval"},
+    utils::ENV("LBANN_METRIC_REDUCTION_INTERVAL"),
+    "[STD] Only reduce training metrics and objective function values "
+    "over processes every this many steps. Other steps report the "
+    "most recently reduced values.",
+    1UL);
   arg_parser.add_option(LBANN_OPTION_MINI_BATCH_SIZE,
                         {"--mini_batch_size"},
                         "[STD] Size of mini batches",
@@ -194,6 +251,22 @@ void construct_std_options()
                         {"--optimizer"},
                         "[STD] Optimizer input file",
                         "");
+  arg_parser.add_option(
+    LBANN_OPTION_PIPELINE_MICRO_BATCHES,
+    {"--pipeline_micro_batches"},
+    utils::ENV("LBANN_PIPELINE_MICRO_BATCHES"),
+    "[STD] Train with pipeline parallelism over sub-grids, splitting "
+    "each mini-batch into this many micro-batches (0 to disable). "
+    "Each sub-grid is a pipeline stage. With more than one "
+    "micro-batch, dropout, batch normalization and random layers are "
+    "not supported.",
+    0UL);
+  arg_parser.add_option(
+    LBANN_OPTION_PIPELINE_SCHEDULE,
+    {"--pipeline_schedule"},
+    utils::ENV("LBANN_PIPELINE_SCHEDULE"),
+    "[STD] Pipeline-parallel schedule (gpipe or 1f1b)",
+    "1f1b");
   arg_parser.add_option(LBANN_OPTION_PROCS_PER_TRAINER,
                         {"--procs_per_trainer"},
                         utils::ENV("LBANN_PROCS_PER_TRAINER"),
@@ -404,6 +477,13 @@ void construct_datareader_options()
                         "[DATAREADER] Sets the filename for normalization data "
                         "with RAS lipid datareader",
                         "");
+  arg_parser.add_option(LBANN_OPTION_NPZ_CACHE_SIZE,
+                        {"--npz_cache_size"},
+                        utils::ENV("LBANN_NPZ_CACHE_SIZE"),
+                        "[DATAREADER] Maximum size in bytes of the cache of "
+                        "decompressed data for each NPZ file opened by the "
+                        "NumPy NPZ datareaders",
+                        256 * 1024 * 1024UL);
   arg_parser.add_option(LBANN_OPTION_PILOT2_READ_FILE_SIZES,
                         {"--pilot2_read_file_sizes"},
                         "[DATAREADER] Sets the filename for loading number of "
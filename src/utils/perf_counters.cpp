@@ -0,0 +1,155 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2022, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+#include "lbann/utils/perf_counters.hpp"
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif // __linux__
+
+#include <cstring>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif // _OPENMP
+
+namespace lbann {
+
+namespace {
+
+#ifdef __linux__
+int open_counter(uint64_t config)
+{
+  perf_event_attr attr;
+  std::memset(&attr, 0, sizeof(attr));
+  attr.size = sizeof(attr);
+  attr.type = PERF_TYPE_HARDWARE;
+  attr.config = config;
+  attr.inherit = 1;
+  attr.exclude_kernel = 1;
+  attr.exclude_hv = 1;
+  return static_cast<int>(
+    syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+}
+#endif // __linux__
+
+} // namespace
+
+perf_counters::perf_counters()
+{
+  // A counter only sees the thread that opens it (and threads that
+  // thread creates later), so open one set on each pool thread.
+  // Note: Assumes the pool is not resized after construction.
+#ifdef _OPENMP
+  m_fds.resize(omp_get_max_threads());
+#else
+  m_fds.resize(1);
+#endif // _OPENMP
+  for (auto& fds : m_fds) {
+    fds.fill(-1);
+  }
+#ifdef __linux__
+#ifdef _OPENMP
+  #pragma omp parallel
+#endif // _OPENMP
+  {
+#ifdef _OPENMP
+    auto& fds = m_fds[omp_get_thread_num()];
+#else
+    auto& fds = m_fds.front();
+#endif // _OPENMP
+    fds[CYCLES] = open_counter(PERF_COUNT_HW_CPU_CYCLES);
+    fds[INSTRUCTIONS] = open_counter(PERF_COUNT_HW_INSTRUCTIONS);
+    fds[CACHE_MISSES] = open_counter(PERF_COUNT_HW_CACHE_MISSES);
+  }
+#endif // __linux__
+}
+
+perf_counters::~perf_counters()
+{
+#ifdef __linux__
+  for (const auto& fds : m_fds) {
+    for (const auto& fd : fds) {
+      if (fd >= 0) {
+        ::close(fd);
+      }
+    }
+  }
+#endif // __linux__
+}
+
+bool perf_counters::is_available(counter c) const noexcept
+{
+  for (const auto& fds : m_fds) {
+    if (fds[c] >= 0) {
+      return true;
+    }
+  }
+  return false;
+}
+
+bool perf_counters::is_available() const noexcept
+{
+  for (size_t i = 0; i < NUM_COUNTERS; ++i) {
+    if (is_available(static_cast<counter>(i))) {
+      return true;
+    }
+  }
+  return false;
+}
+
+auto perf_counters::read() const -> values_type
+{
+  values_type values;
+  values.fill(0);
+#ifdef __linux__
+  for (const auto& fds : m_fds) {
+    for (size_t i = 0; i < NUM_COUNTERS; ++i) {
+      if (fds[i] >= 0) {
+        uint64_t value = 0;
+        if (::read(fds[i], &value, sizeof(value)) == sizeof(value)) {
+          values[i] += value;
+        }
+      }
+    }
+  }
+#endif // __linux__
+  return values;
+}
+
+std::string perf_counters::get_name(counter c)
+{
+  switch (c) {
+  case CYCLES:       return "cycles";
+  case INSTRUCTIONS: return "instructions";
+  case CACHE_MISSES: return "cache misses";
+  default:           return "unknown";
+  }
+}
+
+} // namespace lbann
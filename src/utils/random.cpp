@@ -29,6 +29,7 @@
 #include "lbann/utils/random.hpp"
 #include "lbann/io/file_io.hpp"
 #include "lbann/utils/hash.hpp"
+#include "lbann/utils/serialization/elastic_checkpoint.hpp"
 #include <thread>
 
 
@@ -58,6 +59,15 @@ bool save_rng_to_checkpoint(persist& p, lbann_comm* comm, bool is_distributed) {
     rng_seq << get_data_seq_generator();
     rng_seq.close();
 
+    rng_name = dirname + "/rng_counter_state";
+    std::ofstream rng_counter(rng_name);
+    if(!rng_counter) { LBANN_ERROR("Failed to open ", rng_name); }
+    rng_counter << get_counter_rng_seed() << " " << get_counter_rng_stream();
+    for (const auto& key_count : get_counter_rng_key_counts()) {
+      rng_counter << "\n" << key_count.first << " " << key_count.second;
+    }
+    rng_counter.close();
+
     rng_name = dirname + "/EL_generator";
     std::ofstream rng_EL(rng_name);
     if(!rng_EL) { LBANN_ERROR("Failed to open ", rng_name); }
@@ -143,19 +153,43 @@ bool load_rng_from_checkpoint(persist& p, const lbann_comm* comm) {
   std::string dirname = std::string(p.m_checkpoint_dir) + "/rng_state";
   std::string rng_name;
 
+  // Restarting on a different number of ranks: take the per-rank
+  // states of the old rank whose files this rank read last
+  auto const* elastic = utils::get_elastic_restart_context();
+  if (elastic != nullptr) {
+    dirname = elastic->get_source_dir() + "/rng_state";
+  }
+
   /// @todo - Note that the RNG with thread local data is not correct
   rng_name = dirname + "/rng_seq_generator";
   std::ifstream rng_seq(rng_name);
   if(!rng_seq) { LBANN_ERROR("Failed to open ", rng_name); }
   rng_seq >> get_data_seq_generator();
 
+  // Older checkpoints do not include the counter-based RNG state
+  rng_name = dirname + "/rng_counter_state";
+  std::ifstream rng_counter(rng_name);
+  if(rng_counter) {
+    uint64_t seed, stream;
+    rng_counter >> seed >> stream;
+    set_counter_rng_state(seed, stream);
+    std::vector<std::pair<uint64_t,uint64_t>> key_counts;
+    uint64_t key, count;
+    while (rng_counter >> key >> count) {
+      key_counts.emplace_back(key, count);
+    }
+    set_counter_rng_key_counts(key_counts);
+  }
+
   rng_name = dirname + "/EL_generator";
   std::ifstream rng_EL(rng_name);
   if(!rng_EL) { LBANN_ERROR("Failed to open ", rng_name); }
   rng_EL >> El::Generator();
 
   std::string rank_in_trainer;
-  if (comm == nullptr) {
+  if (elastic != nullptr) {
+    rank_in_trainer = std::to_string(elastic->get_source_rank());
+  } else if (comm == nullptr) {
     rank_in_trainer = std::to_string(El::mpi::Rank(El::mpi::COMM_WORLD));
   } else {
     rank_in_trainer = std::to_string(comm->get_rank_in_trainer());
@@ -217,150 +251,43 @@ bool load_rng_from_checkpoint(persist& p, const lbann_comm* comm) {
   return true;
 }
 
-template <typename TensorDataType>
-void gaussian_fill(
-  El::AbstractDistMatrix<TensorDataType>& mat,
-  El::Int m,
-  El::Int n,
-  TensorDataType mean,
-  TensorDataType stddev) {
-#ifdef LBANN_DETERMINISTIC
-  gaussian_fill_procdet(mat, m, n, mean, stddev);
-#else
-  gaussian_fill_parallel(mat, m, n, mean, stddev);
-#endif // LBANN_DETERMINISTIC
-}
-
-template <typename TensorDataType>
-void bernoulli_fill(El::AbstractDistMatrix<TensorDataType>& mat, El::Int m, El::Int n, double p) {
-#ifndef LBANN_DETERMINISTIC
-  El::Bernoulli(mat, m, n, p);
-#else
-  bernoulli_fill_procdet(mat, m, n, p);
-#endif  // LBANN_DETERMINISTIC
-}
-
-template <typename TensorDataType>
-void uniform_fill(El::AbstractDistMatrix<TensorDataType>& mat, El::Int m, El::Int n,
-                  TensorDataType center, TensorDataType radius) {
-#ifndef LBANN_DETERMINISTIC
-  El::Uniform(mat, m, n, center, radius);
-#else
-  uniform_fill_procdet(mat, m, n, center, radius);
-#endif  // LBANN_DETERMINISTIC
-}
-
-template <typename TensorDataType>
-void gaussian_fill_procdet(El::AbstractDistMatrix<TensorDataType>& mat, El::Int m, El::Int n,
-                           TensorDataType mean, TensorDataType stddev) {
-#if defined(LBANN_HAS_GPU_FP16) && defined(LBANN_HAS_HALF)
-  using RandDataType = typename std::conditional<
-    El::Or<std::is_same<TensorDataType,cpu_fp16>,
-           std::is_same<TensorDataType,fp16>>::value,
-    float, TensorDataType>::type;
-#elif defined(LBANN_HAS_GPU_FP16)
-  using RandDataType = typename std::conditional<
-    std::is_same<TensorDataType,fp16>::value,
-    float, TensorDataType>::type;
-#elif defined(LBANN_HAS_HALF)
-  using RandDataType = typename std::conditional<
-    std::is_same<TensorDataType,cpu_fp16>::value,
-    float, TensorDataType>::type;
-#else
-  using RandDataType = TensorDataType;
-#endif // LBANN_HAS_GPU_FP16
-
-  using CircMatType = El::DistMatrix<
-    RandDataType, El::CIRC, El::CIRC, El::ELEMENT, El::Device::CPU>;
-  CircMatType vals(m, n, mat.Grid(), 0);
-  if (vals.Participating()) {
-    auto* __restrict__ buffer = vals.Buffer(); // Should be contiguous
-    const size_t size = vals.LocalHeight() * vals.LocalWidth();
-    std::normal_distribution<RandDataType> dist(mean, stddev);
-    auto& gen = get_generator();
-    for (size_t i=0; i<size; ++i) {
-      buffer[i] = dist(gen);
-    }
-  }
-  El::Copy(vals, mat);
-}
-
-template <typename TensorDataType>
-void bernoulli_fill_procdet(El::AbstractDistMatrix<TensorDataType>& mat, El::Int m, El::Int n, double p) {
-  CircMatDT<TensorDataType, El::Device::CPU> vals(m, n, mat.Grid(), 0);
-  if (vals.Participating()) {
-    auto& local_vals = vals.Matrix();
-    auto& gen = get_generator();
-    std::bernoulli_distribution dist(p);
-    for (El::Int col = 0; col < local_vals.Width(); ++col) {
-      for (El::Int row = 0; row < local_vals.Height(); ++row) {
-        local_vals(row, col) = El::To<TensorDataType>(dist(gen));
-      }
-    }
-  }
-  El::Copy(vals, mat);
-}
+namespace {
 
+/** @brief Random data type used to populate a tensor data type.
+ *
+ *  The STL distributions do not support half-precision types.
+ */
 template <typename TensorDataType>
-void uniform_fill_procdet(El::AbstractDistMatrix<TensorDataType>& mat, El::Int m, El::Int n,
-                          TensorDataType center, TensorDataType radius) {
+using rand_data_type =
 #if defined(LBANN_HAS_GPU_FP16) && defined(LBANN_HAS_HALF)
-  using RandDataType = typename std::conditional<
+  typename std::conditional<
     El::Or<std::is_same<TensorDataType,cpu_fp16>,
            std::is_same<TensorDataType,fp16>>::value,
     float, TensorDataType>::type;
 #elif defined(LBANN_HAS_GPU_FP16)
-  using RandDataType = typename std::conditional<
+  typename std::conditional<
     std::is_same<TensorDataType,fp16>::value,
     float, TensorDataType>::type;
 #elif defined(LBANN_HAS_HALF)
-  using RandDataType = typename std::conditional<
+  typename std::conditional<
     std::is_same<TensorDataType,cpu_fp16>::value,
     float, TensorDataType>::type;
 #else
-  using RandDataType = TensorDataType;
+  TensorDataType;
 #endif // LBANN_HAS_GPU_FP16
 
-  CircMatDT<RandDataType, El::Device::CPU> vals(m, n, mat.Grid(), 0);
-  if (vals.Participating()) {
-    auto& local_vals = vals.Matrix();
-    auto& gen = get_generator();
-    std::uniform_real_distribution<RandDataType> dist(center - radius,
-                                                      center + radius);
-    for (El::Int col = 0; col < local_vals.Width(); ++col) {
-      for (El::Int row = 0; row < local_vals.Height(); ++row) {
-        local_vals(row, col) = dist(gen);
-      }
-    }
-  }
-  El::Copy(vals, mat);
-}
-
-template <typename TensorDataType>
-void gaussian_fill_parallel(
+/** @brief Populate matrix with random values, using OpenMP threads.
+ *
+ *  Each thread draws from its own generator, so there are no
+ *  guarantees of thread/process independence.
+ */
+template <typename TensorDataType, typename DistType>
+void fill_parallel_impl(
   El::AbstractDistMatrix<TensorDataType>& mat,
   El::Int m,
   El::Int n,
-  TensorDataType mean,
-  TensorDataType stddev) {
-
-  // Type for generating random variables
-#if defined(LBANN_HAS_GPU_FP16) && defined(LBANN_HAS_HALF)
-  using RandDataType = typename std::conditional<
-    El::Or<std::is_same<TensorDataType,cpu_fp16>,
-           std::is_same<TensorDataType,fp16>>::value,
-    float, TensorDataType>::type;
-#elif defined(LBANN_HAS_GPU_FP16)
-  using RandDataType = typename std::conditional<
-    std::is_same<TensorDataType,fp16>::value,
-    float, TensorDataType>::type;
-#elif defined(LBANN_HAS_HALF)
-  using RandDataType = typename std::conditional<
-    std::is_same<TensorDataType,cpu_fp16>::value,
-    float, TensorDataType>::type;
-#else
-  using RandDataType = TensorDataType;
-#endif // LBANN_HAS_GPU_FP16
+  DistType dist) {
+  using RandDataType = typename DistType::result_type;
 
   // Resize matrix
   mat.Resize(m, n);
@@ -389,7 +316,6 @@ void gaussian_fill_parallel(
     // Populate local buffer with random variables
     // Note: Need to duplicate distribution on each thread since GCC
     // STL uses stateful Marsaglia polar method
-    std::normal_distribution<RandDataType> dist(mean, stddev);
     if (local_vals.Contiguous()) {
       auto* __restrict__ buffer = local_vals.Buffer();
       const size_t size = local_vals.Height() * local_vals.Width();
@@ -426,6 +352,166 @@ void gaussian_fill_parallel(
 
 }
 
+/** @brief Populate matrix with counter-based random values.
+ *
+ *  Each process generates its local entries, using OpenMP threads.
+ *  An entry's value only depends on its global index, so the result
+ *  is independent of the matrix distribution and thread count. No
+ *  communication is required.
+ *
+ *  @param generate Function that maps a counter-based RNG and an
+ *                  entry's global index to a random value.
+ */
+template <typename TensorDataType, typename RandDataType, typename Generator>
+void fill_counter_impl(
+  El::AbstractDistMatrix<TensorDataType>& mat,
+  El::Int m,
+  El::Int n,
+  Generator generate) {
+
+  // Every process must draw the stream, even without local data
+  const auto rng = make_counter_rng();
+
+  // Resize matrix
+  mat.Resize(m, n);
+
+  // Nothing to be done if there is no local data
+  if (mat.LockedMatrix().IsEmpty()) {
+    return;
+  }
+
+  // Local buffer to hold random variables
+  using LocalMatType = El::Matrix<RandDataType, El::Device::CPU>;
+  LocalMatType local_vals;
+  if constexpr (std::is_same<TensorDataType,RandDataType>::value) {
+    if (mat.GetLocalDevice() == El::Device::CPU) {
+      El::View(local_vals, mat.Matrix());
+    }
+  }
+  if (!local_vals.Viewing()) {
+    local_vals.Resize(mat.LocalHeight(), mat.LocalWidth());
+  }
+
+  // Populate local buffer with random variables
+  auto* __restrict__ buffer = local_vals.Buffer();
+  const El::Int local_height = local_vals.Height();
+  const El::Int local_width = local_vals.Width();
+  const El::Int ldim = local_vals.LDim();
+  LBANN_OMP_PARALLEL_FOR_COLLAPSE2
+  for (El::Int col=0; col<local_width; ++col) {
+    for (El::Int row=0; row<local_height; ++row) {
+      const uint64_t index = (static_cast<uint64_t>(mat.GlobalRow(row))
+                              + static_cast<uint64_t>(mat.GlobalCol(col)) * m);
+      buffer[row+col*ldim] = generate(rng, index);
+    }
+  }
+
+  // Copy to output matrix if needed
+  if (!local_vals.Viewing()) {
+    El::Copy(local_vals, mat.Matrix());
+  }
+
+}
+
+} // namespace <anon>
+
+template <typename TensorDataType>
+void gaussian_fill(
+  El::AbstractDistMatrix<TensorDataType>& mat,
+  El::Int m,
+  El::Int n,
+  TensorDataType mean,
+  TensorDataType stddev) {
+#ifdef LBANN_DETERMINISTIC
+  gaussian_fill_procdet(mat, m, n, mean, stddev);
+#else
+  gaussian_fill_parallel(mat, m, n, mean, stddev);
+#endif // LBANN_DETERMINISTIC
+}
+
+template <typename TensorDataType>
+void bernoulli_fill(El::AbstractDistMatrix<TensorDataType>& mat, El::Int m, El::Int n, double p) {
+#ifndef LBANN_DETERMINISTIC
+  El::Bernoulli(mat, m, n, p);
+#else
+  bernoulli_fill_procdet(mat, m, n, p);
+#endif  // LBANN_DETERMINISTIC
+}
+
+template <typename TensorDataType>
+void uniform_fill(El::AbstractDistMatrix<TensorDataType>& mat, El::Int m, El::Int n,
+                  TensorDataType center, TensorDataType radius) {
+#ifndef LBANN_DETERMINISTIC
+  uniform_fill_parallel(mat, m, n, center, radius);
+#else
+  uniform_fill_procdet(mat, m, n, center, radius);
+#endif  // LBANN_DETERMINISTIC
+}
+
+template <typename TensorDataType>
+void gaussian_fill_procdet(El::AbstractDistMatrix<TensorDataType>& mat, El::Int m, El::Int n,
+                           TensorDataType mean, TensorDataType stddev) {
+  using RandDataType = rand_data_type<TensorDataType>;
+  const auto mean_ = static_cast<RandDataType>(mean);
+  const auto stddev_ = static_cast<RandDataType>(stddev);
+  fill_counter_impl<TensorDataType, RandDataType>(
+    mat, m, n,
+    [mean_, stddev_](const counter_rng& rng, uint64_t index) {
+      return mean_ + stddev_ * rng.normal<RandDataType>(index);
+    });
+}
+
+template <typename TensorDataType>
+void bernoulli_fill_procdet(El::AbstractDistMatrix<TensorDataType>& mat, El::Int m, El::Int n, double p) {
+  using RandDataType = rand_data_type<TensorDataType>;
+  fill_counter_impl<TensorDataType, RandDataType>(
+    mat, m, n,
+    [p](const counter_rng& rng, uint64_t index) {
+      return rng.bernoulli(index, p) ? RandDataType(1) : RandDataType(0);
+    });
+}
+
+template <typename TensorDataType>
+void uniform_fill_procdet(El::AbstractDistMatrix<TensorDataType>& mat, El::Int m, El::Int n,
+                          TensorDataType center, TensorDataType radius) {
+  using RandDataType = rand_data_type<TensorDataType>;
+  const auto min = static_cast<RandDataType>(center) - static_cast<RandDataType>(radius);
+  const auto width = 2 * static_cast<RandDataType>(radius);
+  fill_counter_impl<TensorDataType, RandDataType>(
+    mat, m, n,
+    [min, width](const counter_rng& rng, uint64_t index) {
+      return min + width * rng.uniform<RandDataType>(index);
+    });
+}
+
+template <typename TensorDataType>
+void gaussian_fill_parallel(
+  El::AbstractDistMatrix<TensorDataType>& mat,
+  El::Int m,
+  El::Int n,
+  TensorDataType mean,
+  TensorDataType stddev) {
+  using RandDataType = rand_data_type<TensorDataType>;
+  fill_parallel_impl(
+    mat, m, n,
+    std::normal_distribution<RandDataType>(mean, stddev));
+}
+
+template <typename TensorDataType>
+void uniform_fill_parallel(
+  El::AbstractDistMatrix<TensorDataType>& mat,
+  El::Int m,
+  El::Int n,
+  TensorDataType center,
+  TensorDataType radius) {
+  using RandDataType = rand_data_type<TensorDataType>;
+  const RandDataType min = RandDataType(center) - RandDataType(radius);
+  const RandDataType max = RandDataType(center) + RandDataType(radius);
+  fill_parallel_impl(
+    mat, m, n,
+    std::uniform_real_distribution<RandDataType>(min, max));
+}
+
 #define PROTO(T)                                                                                                  \
   template void gaussian_fill<T>(El::AbstractDistMatrix<T>& mat, El::Int m, El::Int n, T mean, T stddev);         \
   template void bernoulli_fill<T>(El::AbstractDistMatrix<T>& mat, El::Int m, El::Int n, double p);                \
@@ -433,7 +519,8 @@ void gaussian_fill_parallel(
   template void gaussian_fill_procdet<T>(El::AbstractDistMatrix<T>& mat, El::Int m, El::Int n, T mean, T stddev); \
   template void bernoulli_fill_procdet<T>(El::AbstractDistMatrix<T>& mat, El::Int m, El::Int n, double p);        \
   template void uniform_fill_procdet<T>(El::AbstractDistMatrix<T>& mat, El::Int m, El::Int n, T center, T radius); \
-  template void gaussian_fill_parallel<T>(El::AbstractDistMatrix<T>& mat, El::Int m, El::Int n, T mean, T stddev)
+  template void gaussian_fill_parallel<T>(El::AbstractDistMatrix<T>& mat, El::Int m, El::Int n, T mean, T stddev); \
+  template void uniform_fill_parallel<T>(El::AbstractDistMatrix<T>& mat, El::Int m, El::Int n, T center, T radius)
 
 #define LBANN_INSTANTIATE_CPU_HALF
 #define LBANN_INSTANTIATE_GPU_HALF
@@ -26,10 +26,14 @@
 
 #include <omp.h>
 #include "lbann/utils/random_number_generators.hpp"
+#include "lbann/comm_impl.hpp"
 #include "lbann/utils/hash.hpp"
 #include "lbann/utils/exception.hpp"
 #include <lbann/utils/memory.hpp>
+#include <algorithm>
+#include <mutex>
 #include <thread>
+#include <unordered_map>
 
 namespace {
 #ifdef __ICC
@@ -71,6 +75,13 @@ bool data_seq_generator_seed_inited = false;
 thread_local size_t local_io_generators_index = 0;
 std::vector<lbann::io_rng_t> io_generators;
 bool io_generators_inited = false;
+
+// Counter-based RNG state
+uint64_t counter_rng_seed = 0;
+std::atomic<uint64_t> counter_rng_stream{0};
+std::mutex counter_rng_key_mutex;
+std::unordered_map<uint64_t,uint64_t> counter_rng_key_counts;
+thread_local const uint64_t* counter_rng_key = nullptr;
 }
 
 namespace lbann {
@@ -127,20 +138,91 @@ fast_rng_gen& get_fast_io_generator() {
   return io_rng.fast_generator;
 }
 
+uint64_t get_counter_rng_seed() {
+  return ::counter_rng_seed;
+}
+
+uint64_t get_counter_rng_stream() {
+  return ::counter_rng_stream.load();
+}
+
+void set_counter_rng_state(uint64_t seed, uint64_t stream) {
+  ::counter_rng_seed = seed;
+  ::counter_rng_stream = stream;
+  std::lock_guard<std::mutex> lock(::counter_rng_key_mutex);
+  ::counter_rng_key_counts.clear();
+}
+
+std::vector<std::pair<uint64_t,uint64_t>> get_counter_rng_key_counts() {
+  std::lock_guard<std::mutex> lock(::counter_rng_key_mutex);
+  std::vector<std::pair<uint64_t,uint64_t>> counts(
+    ::counter_rng_key_counts.begin(), ::counter_rng_key_counts.end());
+  std::sort(counts.begin(), counts.end());
+  return counts;
+}
+
+void set_counter_rng_key_counts(
+  const std::vector<std::pair<uint64_t,uint64_t>>& counts) {
+  std::lock_guard<std::mutex> lock(::counter_rng_key_mutex);
+  ::counter_rng_key_counts.clear();
+  ::counter_rng_key_counts.insert(counts.begin(), counts.end());
+}
+
+counter_rng make_counter_rng(uint64_t key) {
+  uint64_t count;
+  {
+    std::lock_guard<std::mutex> lock(::counter_rng_key_mutex);
+    count = ::counter_rng_key_counts[key]++;
+  }
+  return counter_rng(::counter_rng_seed, hash_combine(key, count));
+}
+
+counter_rng make_counter_rng() {
+  if (::counter_rng_key != nullptr) {
+    return make_counter_rng(*::counter_rng_key);
+  }
+  return counter_rng(::counter_rng_seed, ::counter_rng_stream++);
+}
+
+counter_rng_key_scope::counter_rng_key_scope(uint64_t key)
+  : m_prev_key(::counter_rng_key), m_key(key) {
+  ::counter_rng_key = &m_key;
+}
+
+counter_rng_key_scope::counter_rng_key_scope(const std::string& name)
+  : counter_rng_key_scope(static_cast<uint64_t>(std::hash<std::string>{}(name))) {}
+
+counter_rng_key_scope::~counter_rng_key_scope() {
+  ::counter_rng_key = m_prev_key;
+}
+
 void init_random(int seed, int num_io_RNGs, lbann_comm *comm) {
   generator_inited = true;
   fast_generator_inited = true;
 
   // Use different seed on each rank in trainer
+  // Note: The counter-based RNG is seeded consistently within the
+  // trainer, or across all ranks if there is no communicator.
   if (seed == -1) {
     std::random_device rd;
     seed = rd();
+    int counter_seed = seed;
+    if (comm != nullptr) {
+      comm->trainer_broadcast(comm->get_trainer_master(), counter_seed);
+    }
+    else if (El::mpi::Initialized()) {
+      MPI_Bcast(&counter_seed, 1, MPI_INT, 0, MPI_COMM_WORLD);
+    }
+    set_counter_rng_state(counter_seed, 0);
   }
-  else if (comm != nullptr) {
-    seed = hash_combine(seed, comm->get_rank_in_trainer());
-  }
-  else if (El::mpi::Initialized()) {
-    seed = hash_combine(seed, El::mpi::Rank(El::mpi::COMM_WORLD));
+  else {
+    set_counter_rng_state(seed, 0);
+    if (comm != nullptr) {
+      seed = hash_combine(seed, comm->get_rank_in_trainer());
+    }
+    else if (El::mpi::Initialized()) {
+      seed = hash_combine(seed, El::mpi::Rank(El::mpi::COMM_WORLD));
+    }
   }
 
   // Seed every OpenMP thread, if present.
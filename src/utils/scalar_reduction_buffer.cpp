@@ -0,0 +1,218 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2022, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+#include "lbann/utils/scalar_reduction_buffer.hpp"
+#include "lbann/comm_impl.hpp"
+#include "lbann/utils/exception.hpp"
+
+#include <algorithm>
+
+namespace lbann {
+
+scalar_reduction_buffer::scalar_reduction_buffer(lbann_comm& comm,
+                                                 size_t interval)
+  : m_comm(&comm), m_interval(interval)
+{
+  set_interval(interval);
+}
+
+scalar_reduction_buffer::scalar_reduction_buffer(
+  const scalar_reduction_buffer& other)
+  : m_comm(other.m_comm),
+    m_interval(other.m_interval)
+{
+  *this = other;
+}
+
+scalar_reduction_buffer& scalar_reduction_buffer::operator=(
+  const scalar_reduction_buffer& other)
+{
+  if (this == &other) {
+    return *this;
+  }
+  finish();
+  m_comm = other.m_comm;
+  m_interval = other.m_interval;
+  m_slots.clear();
+  m_groups.clear();
+  for (const auto& s : other.m_slots) {
+    m_slots.push_back({s.group, s.index, false, nullptr});
+  }
+  for (const auto& g : other.m_groups) {
+    m_groups.emplace_back();
+    m_groups.back().comm = g.comm;
+    m_groups.back().local.assign(g.local.size(), EvalType(0));
+    m_groups.back().reduced = g.reduced;
+  }
+  m_reduce_step = true;
+  m_started = false;
+  m_num_allreduces = 0;
+  return *this;
+}
+
+scalar_reduction_buffer::~scalar_reduction_buffer()
+{
+  try {
+    finish();
+  }
+  catch (...) {
+  }
+}
+
+size_t scalar_reduction_buffer::add_slot(const El::mpi::Comm& comm)
+{
+  finish();
+
+  // Find group with same communicator
+  size_t group = 0;
+  for (; group < m_groups.size(); ++group) {
+    if (m_groups[group].comm->GetMPIComm() == comm.GetMPIComm()) {
+      break;
+    }
+  }
+  if (group == m_groups.size()) {
+    m_groups.emplace_back();
+    m_groups.back().comm = &comm;
+  }
+  auto& g = m_groups[group];
+  m_slots.push_back({group, g.local.size(), false, nullptr});
+  g.local.push_back(EvalType(0));
+  g.reduced.push_back(EvalType(0));
+  return m_slots.size() - 1;
+}
+
+void scalar_reduction_buffer::clear_slots()
+{
+  finish();
+  m_slots.clear();
+  m_groups.clear();
+  m_started = false;
+}
+
+void scalar_reduction_buffer::set_interval(size_t interval)
+{
+  if (interval == 0) {
+    LBANN_ERROR("scalar reduction interval must be positive");
+  }
+  m_interval = interval;
+}
+
+void scalar_reduction_buffer::begin_step(execution_mode mode, size_t step)
+{
+  finish();
+  for (auto& s : m_slots) {
+    s.contributed = false;
+    s.deferred = nullptr;
+  }
+  for (auto& g : m_groups) {
+    std::fill(g.local.begin(), g.local.end(), EvalType(0));
+  }
+  m_reduce_step = (mode != execution_mode::training
+                   || step % m_interval == 0);
+  m_started = false;
+}
+
+void scalar_reduction_buffer::contribute(size_t slot, EvalType local_value)
+{
+  if (slot >= m_slots.size()) {
+    LBANN_ERROR("invalid scalar reduction slot (", slot, ")");
+  }
+  if (m_started) {
+    LBANN_ERROR("attempted to contribute to a scalar reduction "
+                "after it has been started");
+  }
+  auto& s = m_slots[slot];
+  m_groups[s.group].local[s.index] = local_value;
+  s.contributed = true;
+  s.deferred = nullptr;
+}
+
+void scalar_reduction_buffer::contribute(size_t slot,
+                                         value_function local_value)
+{
+  contribute(slot, EvalType(0));
+  m_slots[slot].deferred = std::move(local_value);
+}
+
+void scalar_reduction_buffer::start()
+{
+  if (m_started) {
+    return;
+  }
+  m_started = true;
+
+  // Evaluate deferred values
+  std::vector<bool> group_contributed(m_groups.size(), false);
+  for (auto& s : m_slots) {
+    if (s.contributed) {
+      if (s.deferred) {
+        m_groups[s.group].local[s.index] = s.deferred();
+        s.deferred = nullptr;
+      }
+      group_contributed[s.group] = true;
+    }
+  }
+  if (!m_reduce_step) {
+    return;
+  }
+
+  // Launch one allreduce per communicator
+  for (size_t i = 0; i < m_groups.size(); ++i) {
+    auto& g = m_groups[i];
+    if (group_contributed[i]) {
+      m_comm->nb_allreduce(g.local.data(),
+                           static_cast<int>(g.local.size()),
+                           *g.comm,
+                           g.req);
+      g.started = true;
+      ++m_num_allreduces;
+    }
+  }
+}
+
+void scalar_reduction_buffer::finish()
+{
+  for (auto& g : m_groups) {
+    if (g.started) {
+      m_comm->wait(g.req);
+      g.reduced = g.local;
+      g.started = false;
+    }
+  }
+}
+
+EvalType scalar_reduction_buffer::get(size_t slot)
+{
+  if (slot >= m_slots.size()) {
+    LBANN_ERROR("invalid scalar reduction slot (", slot, ")");
+  }
+  start();
+  finish();
+  const auto& s = m_slots[slot];
+  return m_groups[s.group].reduced[s.index];
+}
+
+} // namespace lbann
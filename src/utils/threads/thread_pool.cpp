@@ -27,6 +27,7 @@
 #include "lbann/utils/argument_parser.hpp"
 #include "lbann/utils/lbann_library.hpp"
 #include "lbann/utils/threads/thread_topology.hpp"
+#include "lbann/utils/tracer.hpp"
 
 #if defined(LBANN_TOPO_AWARE)
 #include <hwloc.h>
@@ -203,6 +204,7 @@ void thread_pool::relaunch_pinned_threads(size_type num_threads) {
 
 void thread_pool::do_thread_work_()
 {
+  trace::tracer::instance().set_thread_name("thread pool worker");
   while (not all_work_done_)
   {
     auto task = global_work_queue_.wait_and_pop();
@@ -234,6 +236,8 @@ void thread_pool::do_thread_work_pinned_thread_(int tid, hwloc_topology_t topo,
     std::thread::id this_id = std::this_thread::get_id();
     m_thread_id_to_local_id_map[this_id] = tid;
   }
+  trace::tracer::instance().set_thread_name(
+    "thread pool worker " + std::to_string(tid));
   while (not all_work_done_)
   {
     auto task = global_work_queue_.wait_and_pop();
@@ -0,0 +1,256 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2022, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+#include "lbann/utils/tracer.hpp"
+#include "lbann/utils/exception.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+
+namespace lbann {
+namespace trace {
+
+namespace {
+
+/** @brief Copy string into fixed-size event name. */
+void copy_name(char* dst, const char* src) noexcept
+{
+  constexpr size_t size = sizeof(event::name);
+  size_t i = 0;
+  if (src != nullptr) {
+    for (; i < size - 1 && src[i] != '\0'; ++i) {
+      dst[i] = src[i];
+    }
+  }
+  dst[i] = '\0';
+}
+
+/** @brief Write string as JSON string literal. */
+void write_json_string(std::ostream& os, const char* str)
+{
+  os << '"';
+  for (; *str != '\0'; ++str) {
+    const auto c = static_cast<unsigned char>(*str);
+    switch (c) {
+    case '"': os << "\\\""; break;
+    case '\\': os << "\\\\"; break;
+    case '\n': os << "\\n"; break;
+    case '\t': os << "\\t"; break;
+    default:
+      if (c < 0x20) {
+        os << "\\u" << std::hex << std::setw(4) << std::setfill('0')
+           << static_cast<int>(c) << std::dec << std::setfill(' ');
+      }
+      else {
+        os << *str;
+      }
+    }
+  }
+  os << '"';
+}
+
+/** @brief Convert ns to us, the time unit in Chrome traces. */
+double to_us(int64_t ns) { return static_cast<double>(ns) / 1e3; }
+
+} // namespace
+
+struct tracer::thread_buffer {
+  thread_buffer(size_t size, int tid_, std::string name)
+    : events(size), tid(tid_), thread_name(std::move(name))
+  {}
+  std::vector<event> events;
+  /** @brief Number of events recorded, including overwritten ones.
+   *  Only modified by owning thread.
+   */
+  std::atomic<uint64_t> count{0};
+  int tid;
+  std::string thread_name;
+};
+
+tracer& tracer::instance()
+{
+  static tracer instance_;
+  return instance_;
+}
+
+int64_t tracer::now() noexcept
+{
+  using namespace std::chrono;
+  return duration_cast<nanoseconds>(
+           steady_clock::now().time_since_epoch()).count();
+}
+
+void tracer::enable(size_t buffer_size)
+{
+  if (buffer_size == 0) {
+    LBANN_ERROR("tracer requires a nonzero ring buffer size");
+  }
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_buffer_size = buffer_size;
+    m_buffers.clear();
+    // Threads reallocate their buffers when they see a new generation
+    m_generation.fetch_add(1, std::memory_order_release);
+  }
+  m_enabled.store(true, std::memory_order_release);
+}
+
+void tracer::disable() noexcept
+{
+  m_enabled.store(false, std::memory_order_release);
+}
+
+tracer::thread_state& tracer::get_thread_state()
+{
+  thread_local thread_state state;
+  return state;
+}
+
+tracer::thread_buffer& tracer::get_thread_buffer()
+{
+  auto& state = get_thread_state();
+  const auto generation = m_generation.load(std::memory_order_acquire);
+  if (state.buffer == nullptr || state.generation != generation) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    std::string name;
+    auto it = m_thread_names.find(std::this_thread::get_id());
+    if (it != m_thread_names.end()) {
+      name = it->second;
+    }
+    auto buffer = std::make_shared<thread_buffer>(
+      m_buffer_size, static_cast<int>(m_buffers.size()), std::move(name));
+    m_buffers.push_back(buffer);
+    state.buffer = std::move(buffer);
+    state.generation = m_generation.load(std::memory_order_relaxed);
+  }
+  return *state.buffer;
+}
+
+void tracer::record(const char* category,
+                    const char* name,
+                    int64_t start,
+                    int64_t end)
+{
+  if (!is_enabled()) {
+    return;
+  }
+  auto& buffer = get_thread_buffer();
+  const auto i = buffer.count.load(std::memory_order_relaxed);
+  auto& e = buffer.events[i % buffer.events.size()];
+  e.start = start;
+  e.duration = end - start;
+  e.category = category;
+  copy_name(e.name, name);
+  buffer.count.store(i + 1, std::memory_order_release);
+}
+
+void tracer::set_thread_name(std::string name)
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  auto& state = get_thread_state();
+  if (state.buffer != nullptr
+      && state.generation == m_generation.load(std::memory_order_relaxed)) {
+    state.buffer->thread_name = name;
+  }
+  m_thread_names[std::this_thread::get_id()] = std::move(name);
+}
+
+size_t tracer::get_num_events() const
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  size_t num_events = 0;
+  for (const auto& buffer : m_buffers) {
+    const auto count = buffer->count.load(std::memory_order_acquire);
+    num_events += std::min<uint64_t>(count, buffer->events.size());
+  }
+  return num_events;
+}
+
+void tracer::write_chrome_trace(const std::string& path,
+                                int pid,
+                                int64_t clock_offset) const
+{
+  std::ofstream ofs(path);
+  if (!ofs) {
+    LBANN_ERROR("failed to open trace file (", path, ")");
+  }
+  ofs << std::fixed << std::setprecision(3);
+  ofs << "{\"displayTimeUnit\":\"ms\",\n"
+      << "\"otherData\":{\"pid\":" << pid
+      << ",\"clock_offset_us\":" << to_us(clock_offset) << "},\n"
+      << "\"traceEvents\":[\n";
+  ofs << "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":" << pid
+      << ",\"tid\":0,\"args\":{\"name\":\"rank " << pid << "\"}}";
+
+  std::lock_guard<std::mutex> lock(m_mutex);
+  for (const auto& buffer : m_buffers) {
+    if (!buffer->thread_name.empty()) {
+      ofs << ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":" << pid
+          << ",\"tid\":" << buffer->tid << ",\"args\":{\"name\":";
+      write_json_string(ofs, buffer->thread_name.c_str());
+      ofs << "}}";
+    }
+    const uint64_t count = buffer->count.load(std::memory_order_acquire);
+    const uint64_t size = buffer->events.size();
+    const uint64_t first = count > size ? count - size : 0;
+    for (uint64_t i = first; i < count; ++i) {
+      const auto& e = buffer->events[i % size];
+      ofs << ",\n{\"name\":";
+      write_json_string(ofs, e.name);
+      ofs << ",\"cat\":";
+      write_json_string(ofs, e.category != nullptr ? e.category : "");
+      ofs << ",\"ph\":\"X\",\"ts\":" << to_us(e.start)
+          << ",\"dur\":" << to_us(e.duration)
+          << ",\"pid\":" << pid << ",\"tid\":" << buffer->tid << "}";
+    }
+  }
+  ofs << "\n]}\n";
+  if (!ofs) {
+    LBANN_ERROR("failed to write trace file (", path, ")");
+  }
+}
+
+scope::scope(const char* category, const char* name) noexcept
+  : m_category(category)
+{
+  if (tracer::instance().is_enabled()) {
+    copy_name(m_name, name);
+    m_start = tracer::now();
+  }
+}
+
+scope::~scope()
+{
+  if (m_start >= 0) {
+    tracer::instance().record(m_category, m_name, m_start, tracer::now());
+  }
+}
+
+} // namespace trace
+} // namespace lbann
@@ -0,0 +1,91 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2022, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+// MUST include this
+#include <catch2/catch.hpp>
+
+// File being tested
+#include <lbann/utils/alias_table.hpp>
+
+#include <vector>
+
+namespace {
+
+// Probability of each outcome, measured by sampling a fine uniform
+// grid over [0,1)
+std::vector<double> grid_distribution(const lbann::alias_table& table)
+{
+  const size_t grid_size = 10000 * table.size();
+  std::vector<double> dist(table.size(), 0.);
+  for (size_t i = 0; i < grid_size; ++i) {
+    dist[table.sample((i + 0.5) / grid_size)] += 1. / grid_size;
+  }
+  return dist;
+}
+
+} // namespace
+
+TEST_CASE("Alias table sampling", "[random][utilities]")
+{
+  SECTION("Non-uniform weights")
+  {
+    const std::vector<double> weights = {1., 0., 3., 0.5, 2.5, 1.};
+    lbann::alias_table table(weights);
+    REQUIRE(table.size() == weights.size());
+    const auto dist = grid_distribution(table);
+    for (size_t i = 0; i < weights.size(); ++i) {
+      CHECK(dist[i] == Approx(weights[i] / 8.).margin(1e-6));
+    }
+  }
+
+  SECTION("Uniform weights")
+  {
+    lbann::alias_table table(std::vector<double>(7, 2.));
+    const auto dist = grid_distribution(table);
+    for (const auto& p : dist) {
+      CHECK(p == Approx(1. / 7.).margin(1e-6));
+    }
+  }
+
+  SECTION("Single outcome")
+  {
+    lbann::alias_table table(std::vector<double>{0.25});
+    CHECK(table.sample(0.) == 0);
+    CHECK(table.sample(0.999999) == 0);
+  }
+
+  SECTION("Edge of the unit interval")
+  {
+    lbann::alias_table table(std::vector<double>{1., 1., 1.});
+    CHECK(table.sample(1.) < table.size());
+  }
+
+  SECTION("Invalid weights")
+  {
+    CHECK_THROWS(lbann::alias_table(std::vector<double>{}));
+    CHECK_THROWS(lbann::alias_table(std::vector<double>{0., 0.}));
+    CHECK_THROWS(lbann::alias_table(std::vector<double>{1., -1.}));
+  }
+}
@@ -0,0 +1,125 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2022, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+// MUST include this
+#include <catch2/catch.hpp>
+
+// File being tested
+#include <lbann/utils/counter_rng.hpp>
+
+#include <cmath>
+#include <cstdint>
+#include <set>
+
+TEST_CASE("Philox4x32-10 known-answer tests", "[random][utilities]")
+{
+  using philox = lbann::philox4x32;
+  using counter_type = philox::counter_type;
+
+  // Known-answer vectors from Random123
+  SECTION("Zeros")
+  {
+    const auto out = philox::generate({0, 0, 0, 0}, {0, 0});
+    CHECK(out == counter_type{0x6627e8d5, 0xe169c58d, 0xbc57ac4c, 0x9b00dbd8});
+  }
+  SECTION("Ones")
+  {
+    const auto out =
+      philox::generate({0xffffffff, 0xffffffff, 0xffffffff, 0xffffffff},
+                       {0xffffffff, 0xffffffff});
+    CHECK(out == counter_type{0x408f276d, 0x41c83b0e, 0xa20bc7c6, 0x6d5451fd});
+  }
+  SECTION("Digits of pi")
+  {
+    const auto out =
+      philox::generate({0x243f6a88, 0x85a308d3, 0x13198a2e, 0x03707344},
+                       {0xa4093822, 0x299f31d0});
+    CHECK(out == counter_type{0xd16cfe09, 0x94fdcceb, 0x5001e420, 0x24126ea1});
+  }
+}
+
+TEST_CASE("Testing counter_rng", "[random][utilities]")
+{
+  constexpr uint64_t num_samples = 100000;
+  const lbann::counter_rng rng(12345, 6);
+
+  SECTION("Values only depend on seed, stream, and index")
+  {
+    const lbann::counter_rng same(12345, 6);
+    const lbann::counter_rng other_stream(12345, 7);
+    const lbann::counter_rng other_seed(12346, 6);
+    for (uint64_t i = 0; i < 100; ++i) {
+      CHECK(rng.block(i) == same.block(i));
+      CHECK(rng.block(i) != other_stream.block(i));
+      CHECK(rng.block(i) != other_seed.block(i));
+    }
+    CHECK(rng.block(5) == rng.block(5));
+    CHECK(rng.block(5) != rng.block(6));
+  }
+
+  SECTION("Uniform values are in [0,1) with correct moments")
+  {
+    double sum = 0., sqsum = 0.;
+    for (uint64_t i = 0; i < num_samples; ++i) {
+      const auto x = rng.uniform<double>(i);
+      REQUIRE(x >= 0.);
+      REQUIRE(x < 1.);
+      REQUIRE(rng.uniform<float>(i) < 1.f);
+      sum += x;
+      sqsum += x * x;
+    }
+    const double mean = sum / num_samples;
+    const double var = sqsum / num_samples - mean * mean;
+    CHECK(mean == Approx(0.5).margin(0.01));
+    CHECK(var == Approx(1. / 12).margin(0.01));
+  }
+
+  SECTION("Normal values have correct moments")
+  {
+    double sum = 0., sqsum = 0.;
+    for (uint64_t i = 0; i < num_samples; ++i) {
+      const auto x = rng.normal<double>(i);
+      REQUIRE(std::isfinite(x));
+      sum += x;
+      sqsum += x * x;
+    }
+    const double mean = sum / num_samples;
+    const double var = sqsum / num_samples - mean * mean;
+    CHECK(mean == Approx(0.).margin(0.02));
+    CHECK(var == Approx(1.).margin(0.02));
+  }
+
+  SECTION("Bernoulli values have correct probability")
+  {
+    const double p = 0.3;
+    uint64_t count = 0;
+    for (uint64_t i = 0; i < num_samples; ++i) {
+      count += rng.bernoulli(i, p);
+    }
+    CHECK(double(count) / num_samples == Approx(p).margin(0.01));
+    CHECK_FALSE(rng.bernoulli(0, 0.));
+    CHECK(rng.bernoulli(0, 1.));
+  }
+}
@@ -415,3 +415,50 @@ TEMPLATE_TEST_CASE("Testing FFTW wrapper (C2C-InPlace)",
     }
   }
 }
+
+TEMPLATE_TEST_CASE("Testing FFTW plan cache",
+                   "[fft][fftw][utilities]",
+                   float, double)
+{
+  using RealT = TestType;
+  using DataT = El::Complex<RealT>;
+  auto& cache = lbann::fftw::PlanCache<RealT>::instance();
+
+  // Use a shape no other test uses
+  std::vector<int> const dims = {3, 10};
+  auto const height = lbann::get_linear_size(dims);
+
+  El::Matrix<DataT, El::Device::CPU> mat(height, get_num_samples());
+  lbann::fftw::FFTWWrapper<DataT> fftw;
+  REQUIRE_NOTHROW(fftw.setup_forward(mat, dims));
+  REQUIRE_NOTHROW(fftw.setup_backward(mat, dims));
+  auto const num_plans = cache.size();
+
+  SECTION("Plans are shared between wrappers")
+  {
+    lbann::fftw::FFTWWrapper<DataT> other;
+    REQUIRE_NOTHROW(other.setup_forward(mat, dims));
+    REQUIRE_NOTHROW(other.setup_backward(mat, dims));
+    CHECK(cache.size() == num_plans);
+    El::Fill(mat, DataT(1.f));
+    REQUIRE_NOTHROW(other.compute_forward(mat));
+    CHECK(RealPart(mat.CRef(0, 0)) == Approx(RealT(10.)));
+  }
+
+  SECTION("Plans survive changes in the number of samples")
+  {
+    El::Matrix<DataT, El::Device::CPU> small(height, 2);
+    REQUIRE_NOTHROW(fftw.setup_forward(small, dims));
+    CHECK(cache.size() == num_plans + 1);
+    REQUIRE_NOTHROW(fftw.setup_forward(mat, dims));
+    CHECK(cache.size() == num_plans + 1);
+    REQUIRE_NOTHROW(fftw.compute_forward(mat));
+    REQUIRE_NOTHROW(fftw.compute_forward(small));
+  }
+
+  SECTION("Unplanned shapes are rejected")
+  {
+    El::Matrix<DataT, El::Device::CPU> wide(height, 2*get_num_samples()+1);
+    CHECK_THROWS(fftw.compute_forward(wide));
+  }
+}
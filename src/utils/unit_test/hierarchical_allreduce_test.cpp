@@ -0,0 +1,129 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2022, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+#include <catch2/catch.hpp>
+
+#include "MPITestHelpers.hpp"
+
+#include <lbann/base.hpp>
+#include <lbann/comm_impl.hpp>
+
+TEST_CASE("Hierarchical allreduce", "[mpi][comm][reduction]")
+{
+  auto& comm = unit_test::utilities::current_world_comm();
+  const auto& trainer_comm = comm.get_trainer_comm();
+  const int rank = El::mpi::Rank(trainer_comm);
+  const int num_procs = El::mpi::Size(trainer_comm);
+  comm.set_hierarchical_allreduce(true);
+
+  // Sizes span partial and multiple shared-memory chunks
+  for (const El::Int height : {El::Int(1), El::Int(7), El::Int(600001)}) {
+    SECTION("Sum of " + std::to_string(height) + " entries")
+    {
+      El::Matrix<float, El::Device::CPU> x(height, 1);
+      for (El::Int i = 0; i < height; ++i) {
+        x(i, 0) = float((rank + 1) * (i % 7));
+      }
+      comm.allreduce(x, trainer_comm, El::mpi::SUM);
+      bool correct = true;
+      for (El::Int i = 0; i < height; ++i) {
+        correct = correct
+          && x(i, 0) == float(num_procs * (num_procs + 1) / 2 * (i % 7));
+      }
+      CHECK(correct);
+    }
+  }
+
+  SECTION("Non-blocking max")
+  {
+    El::Matrix<double, El::Device::CPU> x(300000, 2);
+    for (El::Int j = 0; j < x.Width(); ++j) {
+      for (El::Int i = 0; i < x.Height(); ++i) {
+        x(i, j) = double(rank * 1000 + (i + j) % 13);
+      }
+    }
+    lbann::Al::request req;
+    comm.nb_allreduce(x, trainer_comm, req, El::mpi::MAX);
+    comm.wait(req);
+    bool correct = true;
+    for (El::Int j = 0; j < x.Width(); ++j) {
+      for (El::Int i = 0; i < x.Height(); ++i) {
+        correct = correct
+          && x(i, j) == double((num_procs - 1) * 1000 + (i + j) % 13);
+      }
+    }
+    CHECK(correct);
+  }
+
+  SECTION("Contiguous and strided matrices on different ranks")
+  {
+    // Odd ranks reduce a view into a taller matrix. All ranks must
+    // still take the same path through the collective.
+    El::Matrix<float, El::Device::CPU> buf(rank % 2 == 0 ? 4 : 9, 3);
+    El::Fill(buf, -1.f);
+    auto x = El::View(buf, El::IR(0, 4), El::ALL);
+    for (El::Int j = 0; j < x.Width(); ++j) {
+      for (El::Int i = 0; i < x.Height(); ++i) {
+        x(i, j) = float((rank + 1) * (i + 4 * j));
+      }
+    }
+    comm.allreduce(x, trainer_comm, El::mpi::SUM);
+    bool correct = true;
+    for (El::Int j = 0; j < x.Width(); ++j) {
+      for (El::Int i = 0; i < x.Height(); ++i) {
+        correct = correct
+          && x(i, j) == float(num_procs * (num_procs + 1) / 2 * (i + 4 * j));
+      }
+    }
+    for (El::Int j = 0; j < buf.Width(); ++j) {
+      for (El::Int i = x.Height(); i < buf.Height(); ++i) {
+        correct = correct && buf(i, j) == -1.f;
+      }
+    }
+    CHECK(correct);
+  }
+
+  SECTION("Communicators freed and created again")
+  {
+    // MPI may reuse a freed communicator's handle, so cached state
+    // must not be looked up by handle
+    for (int iter = 0; iter < 3; ++iter) {
+      El::mpi::Comm sub_comm;
+      El::mpi::Split(trainer_comm, iter == 1 ? rank % 2 : 0, rank, sub_comm);
+      const int sub_size = El::mpi::Size(sub_comm);
+      El::Matrix<float, El::Device::CPU> x(5, 1);
+      El::Fill(x, 1.f);
+      comm.allreduce(x, sub_comm, El::mpi::SUM);
+      bool correct = true;
+      for (El::Int i = 0; i < x.Height(); ++i) {
+        correct = correct && x(i, 0) == float(sub_size);
+      }
+      CHECK(correct);
+      El::mpi::Free(sub_comm);
+    }
+  }
+
+  comm.set_hierarchical_allreduce(false);
+}
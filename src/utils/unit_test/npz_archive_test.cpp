@@ -0,0 +1,226 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2022, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+#include <catch2/catch.hpp>
+
+// File being tested
+#include <lbann/utils/npz_archive.hpp>
+
+#include <zlib.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <tuple>
+#include <vector>
+
+namespace {
+
+void append_u16(std::string& s, uint16_t x) {
+  s.push_back(static_cast<char>(x & 0xFF));
+  s.push_back(static_cast<char>(x >> 8));
+}
+void append_u32(std::string& s, uint32_t x) {
+  append_u16(s, static_cast<uint16_t>(x & 0xFFFF));
+  append_u16(s, static_cast<uint16_t>(x >> 16));
+}
+
+/** Construct an NPY file with a 2D float32 array. */
+std::string make_npy(const std::vector<float>& data, size_t rows, size_t cols) {
+  std::string header = ("{'descr': '<f4', 'fortran_order': False, 'shape': ("
+                        + std::to_string(rows) + ", "
+                        + std::to_string(cols) + "), }");
+  while ((10 + header.size() + 1) % 64 != 0) { header.push_back(' '); }
+  header.push_back('\n');
+  std::string npy("\x93NUMPY\x01\x00", 8);
+  append_u16(npy, static_cast<uint16_t>(header.size()));
+  npy += header;
+  npy.append(reinterpret_cast<const char*>(data.data()),
+             data.size() * sizeof(float));
+  return npy;
+}
+
+/** Raw deflate, as used in zip files. */
+std::string deflate_raw(const std::string& in) {
+  z_stream strm{};
+  deflateInit2(&strm, Z_BEST_SPEED, Z_DEFLATED, -MAX_WBITS, 8,
+               Z_DEFAULT_STRATEGY);
+  std::string out(deflateBound(&strm, in.size()), '\0');
+  strm.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(in.data()));
+  strm.avail_in = in.size();
+  strm.next_out = reinterpret_cast<Bytef*>(&out[0]);
+  strm.avail_out = out.size();
+  deflate(&strm, Z_FINISH);
+  out.resize(strm.total_out);
+  deflateEnd(&strm);
+  return out;
+}
+
+/** Construct a zip file with the given (name, contents, compress)
+ *  members. */
+std::string make_zip(
+  const std::vector<std::tuple<std::string, std::string, bool>>& members) {
+  std::string zip, cd;
+  for (const auto& m : members) {
+    const auto& name = std::get<0>(m);
+    const auto& contents = std::get<1>(m);
+    const bool compress = std::get<2>(m);
+    const auto data = compress ? deflate_raw(contents) : contents;
+    const uint32_t crc = crc32(0L,
+                               reinterpret_cast<const Bytef*>(contents.data()),
+                               contents.size());
+    const uint32_t offset = zip.size();
+    std::string common;
+    append_u16(common, 20);                 // Version needed
+    append_u16(common, 0);                  // Flags
+    append_u16(common, compress ? 8 : 0);   // Compression method
+    append_u32(common, 0);                  // Modification time
+    append_u32(common, crc);
+    append_u32(common, data.size());
+    append_u32(common, contents.size());
+    append_u16(common, name.size());
+    append_u16(common, 0);                  // Extra field length
+    append_u32(zip, 0x04034b50);
+    zip += common + name + data;
+    append_u32(cd, 0x02014b50);
+    append_u16(cd, 20);                     // Version made by
+    cd += common;
+    append_u16(cd, 0);                      // Comment length
+    append_u16(cd, 0);                      // Disk number
+    append_u16(cd, 0);                      // Internal attributes
+    append_u32(cd, 0);                      // External attributes
+    append_u32(cd, offset);
+    cd += name;
+  }
+  const uint32_t cd_offset = zip.size();
+  zip += cd;
+  append_u32(zip, 0x06054b50);
+  append_u16(zip, 0);
+  append_u16(zip, 0);
+  append_u16(zip, members.size());
+  append_u16(zip, members.size());
+  append_u32(zip, cd.size());
+  append_u32(zip, cd_offset);
+  append_u16(zip, 0);
+  return zip;
+}
+
+} // namespace <anon>
+
+TEST_CASE("NPZ archive", "[seq][file][utilities]")
+{
+  // Construct array with 3000 rows (more than one decompression chunk)
+  constexpr size_t rows = 3000, cols = 100;
+  std::vector<float> data(rows * cols);
+  for (size_t i = 0; i < data.size(); ++i) {
+    data[i] = static_cast<float>(i % 977) * 0.5f;
+  }
+  const auto npy = make_npy(data, rows, cols);
+
+  // Write NPZ file
+  const std::string filename = ("/tmp/npz_archive_test_"
+                                + std::to_string(getpid()) + ".npz");
+  {
+    std::ofstream ofs(filename, std::ios::binary);
+    ofs << make_zip({std::make_tuple("stored.npy", npy, false),
+                     std::make_tuple("deflated.npy", npy, true)});
+  }
+
+  for (const size_t cache_size : {size_t{0},
+                                  lbann::npz_archive::default_cache_size}) {
+    lbann::npz_archive npz(filename, cache_size);
+    REQUIRE(npz.has_array("stored"));
+    REQUIRE(npz.has_array("deflated"));
+    REQUIRE_FALSE(npz.has_array("missing"));
+    CHECK_THROWS(npz.get_array("missing"));
+    REQUIRE(npz.get_array_names().size() == 2);
+
+    for (const std::string name : {"stored", "deflated"}) {
+      INFO("array " << name << ", cache size " << cache_size);
+      const auto& a = npz.get_array(name);
+
+      // Metadata
+      {
+        CHECK(a.shape() == std::vector<size_t>{rows, cols});
+        CHECK(a.word_size() == sizeof(float));
+        CHECK(a.type_kind() == 'f');
+        CHECK_FALSE(a.fortran_order());
+        CHECK(a.num_vals() == rows * cols);
+        CHECK(a.num_rows() == rows);
+        CHECK(a.row_size() == cols * sizeof(float));
+        CHECK(a.is_compressed() == (name == "deflated"));
+        CHECK_THROWS(a.row_ptr(rows));
+      }
+
+      // Read all rows
+      {
+        std::vector<float> buffer(rows * cols);
+        a.read_all(buffer.data());
+        CHECK(buffer == data);
+      }
+
+      // Read rows in reverse order
+      {
+        std::vector<float> row(2 * cols);
+        for (size_t i = rows - 1; i > 0; i -= 13) {
+          a.read_rows(i - 1, 2, row.data());
+          CHECK(std::equal(row.begin(), row.end(),
+                           data.begin() + (i - 1) * cols));
+          if (i < 13) { break; }
+        }
+        CHECK_THROWS(a.read_rows(rows - 1, 2, row.data()));
+      }
+    }
+
+    // Uncompressed arrays are accessed in place
+    {
+      const auto* ptr = static_cast<const float*>(
+        npz.get_array("stored").row_ptr(5));
+      REQUIRE(ptr != nullptr);
+      CHECK(std::equal(ptr, ptr + cols, data.begin() + 5 * cols));
+      CHECK(npz.get_array("deflated").row_ptr(5) == nullptr);
+    }
+  }
+
+  std::remove(filename.c_str());
+}
+
+TEST_CASE("NPZ archive errors", "[seq][file][utilities]")
+{
+  CHECK_THROWS(lbann::npz_archive("/tmp/npz_archive_test_does_not_exist.npz"));
+
+  const std::string filename = ("/tmp/npz_archive_test_bad_"
+                                + std::to_string(getpid()) + ".npz");
+  {
+    std::ofstream ofs(filename, std::ios::binary);
+    ofs << make_zip({std::make_tuple("bad.npy", std::string("not npy data"),
+                                     false)});
+  }
+  CHECK_THROWS(lbann::npz_archive(filename));
+  std::remove(filename.c_str());
+}
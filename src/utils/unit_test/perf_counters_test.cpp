@@ -0,0 +1,56 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2022, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+#include <catch2/catch.hpp>
+
+// File being tested
+#include <lbann/utils/perf_counters.hpp>
+
+TEST_CASE("Hardware performance counters", "[seq][utilities]")
+{
+  lbann::perf_counters counters;
+  using counter = lbann::perf_counters::counter;
+
+  // Do some work between reads
+  const auto start = counters.read();
+  volatile double sum = 0.;
+  for (int i = 0; i < 100000; ++i) {
+    sum += static_cast<double>(i);
+  }
+  const auto end = counters.read();
+
+  for (size_t i = 0; i < lbann::perf_counters::NUM_COUNTERS; ++i) {
+    const auto c = static_cast<counter>(i);
+    INFO("counter " << lbann::perf_counters::get_name(c));
+    CHECK(end[i] >= start[i]);
+    if (!counters.is_available(c)) {
+      CHECK(start[i] == 0);
+      CHECK(end[i] == 0);
+    }
+  }
+  if (counters.is_available(counter::INSTRUCTIONS)) {
+    CHECK(end[counter::INSTRUCTIONS] > start[counter::INSTRUCTIONS]);
+  }
+}
@@ -311,7 +311,7 @@ TEMPLATE_LIST_TEST_CASE(
 
   }
 
-  SECTION("Contiguous matrix (serial implementation)")
+  SECTION("Contiguous matrix (counter-based implementation)")
   {
 
     // Attempt Anderson-Darling test several times
@@ -355,7 +355,7 @@ TEMPLATE_LIST_TEST_CASE(
 
   }
 
-  SECTION("Non-contiguous matrix (serial implementation)")
+  SECTION("Non-contiguous matrix (counter-based implementation)")
   {
 
     // Attempt Anderson-Darling test several times
@@ -413,3 +413,128 @@ TEMPLATE_LIST_TEST_CASE(
   }
 
 }
+
+TEMPLATE_LIST_TEST_CASE(
+  "Counter-based fills are independent of distribution",
+  "[random][utilities][mpi]",
+  AllDistMatrixTypes)
+{
+
+  // Typedefs
+  using DistMatType = TestType;
+  using DataType = TensorDataType<DistMatType>;
+  using StarMatType = El::DistMatrix<DataType, El::STAR, El::STAR, El::ELEMENT, El::Device::CPU>;
+
+  // Parameters
+  const El::Int height = 23;
+  const El::Int width = 17;
+  const uint64_t seed = 20221019;
+
+  // Initialization
+  auto& comm = ::unit_test::utilities::current_world_comm();
+  const auto& grid = comm.get_trainer_grid();
+
+  // Fill reference matrix on every process
+  StarMatType ref(grid);
+  lbann::set_counter_rng_state(seed, 3);
+  lbann::uniform_fill_procdet(ref, height, width, DataType(1.f), DataType(2.f));
+
+  // Fill distributed matrix with same RNG state
+  DistMatType mat(grid);
+  lbann::set_counter_rng_state(seed, 3);
+  lbann::uniform_fill_procdet(mat, height, width, DataType(1.f), DataType(2.f));
+  CHECK(lbann::get_counter_rng_stream() == 4);
+
+  // Check that values match
+  StarMatType mat_copy(grid);
+  El::Copy(mat, mat_copy);
+  for (El::Int col = 0; col < width; ++col) {
+    for (El::Int row = 0; row < height; ++row) {
+      CHECK(mat_copy.Get(row, col) == ref.Get(row, col));
+      CHECK(ref.Get(row, col) >= DataType(-1.f));
+      CHECK(ref.Get(row, col) < DataType(3.f));
+    }
+  }
+
+}
+
+TEMPLATE_LIST_TEST_CASE(
+  "Keyed counter-based fills are independent of call order",
+  "[random][utilities][mpi]",
+  AllDistMatrixTypes)
+{
+
+  // Typedefs
+  using DistMatType = TestType;
+  using DataType = TensorDataType<DistMatType>;
+  using StarMatType = El::DistMatrix<DataType, El::STAR, El::STAR, El::ELEMENT, El::Device::CPU>;
+
+  // Parameters
+  const El::Int height = 11;
+  const El::Int width = 7;
+  const uint64_t seed = 20221019;
+
+  // Initialization
+  auto& comm = ::unit_test::utilities::current_world_comm();
+  const auto& grid = comm.get_trainer_grid();
+
+  // Fill with key "a" only
+  DistMatType ref(grid), ref_next(grid);
+  lbann::set_counter_rng_state(seed, 0);
+  {
+    lbann::counter_rng_key_scope key_scope(std::string("a"));
+    lbann::uniform_fill_procdet(ref, height, width, DataType(0.f), DataType(1.f));
+    lbann::uniform_fill_procdet(ref_next, height, width, DataType(0.f), DataType(1.f));
+  }
+  CHECK(lbann::get_counter_rng_stream() == 0);
+
+  // Fill with key "b" and unkeyed streams before key "a"
+  DistMatType other(grid), unkeyed(grid), mat(grid);
+  lbann::set_counter_rng_state(seed, 0);
+  lbann::uniform_fill_procdet(unkeyed, height, width, DataType(0.f), DataType(1.f));
+  {
+    lbann::counter_rng_key_scope key_scope(std::string("b"));
+    lbann::uniform_fill_procdet(other, height, width, DataType(0.f), DataType(1.f));
+  }
+  {
+    lbann::counter_rng_key_scope key_scope(std::string("a"));
+    lbann::uniform_fill_procdet(mat, height, width, DataType(0.f), DataType(1.f));
+  }
+  CHECK(lbann::get_counter_rng_stream() == 1);
+
+  // Same key gives same values, later draws with a key differ
+  StarMatType ref_copy(grid), ref_next_copy(grid), mat_copy(grid);
+  El::Copy(ref, ref_copy);
+  El::Copy(ref_next, ref_next_copy);
+  El::Copy(mat, mat_copy);
+  bool all_equal_next = true;
+  for (El::Int col = 0; col < width; ++col) {
+    for (El::Int row = 0; row < height; ++row) {
+      CHECK(mat_copy.Get(row, col) == ref_copy.Get(row, col));
+      if (ref_next_copy.Get(row, col) != ref_copy.Get(row, col)) {
+        all_equal_next = false;
+      }
+    }
+  }
+  CHECK_FALSE(all_equal_next);
+
+  // Per-key counts are restored from checkpoint state
+  const auto key_counts = lbann::get_counter_rng_key_counts();
+  REQUIRE(key_counts.size() == 2);
+  DistMatType restored(grid);
+  lbann::set_counter_rng_state(seed, 0);
+  lbann::set_counter_rng_key_counts({{key_counts[0].first, 1},
+                                     {key_counts[1].first, 1}});
+  {
+    lbann::counter_rng_key_scope key_scope(std::string("a"));
+    lbann::uniform_fill_procdet(restored, height, width, DataType(0.f), DataType(1.f));
+  }
+  StarMatType restored_copy(grid);
+  El::Copy(restored, restored_copy);
+  for (El::Int col = 0; col < width; ++col) {
+    for (El::Int row = 0; row < height; ++row) {
+      CHECK(restored_copy.Get(row, col) == ref_next_copy.Get(row, col));
+    }
+  }
+
+}
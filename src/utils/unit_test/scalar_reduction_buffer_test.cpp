@@ -0,0 +1,83 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2022, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+#include <catch2/catch.hpp>
+
+#include "MPITestHelpers.hpp"
+
+// File being tested
+#include <lbann/utils/scalar_reduction_buffer.hpp>
+
+#include <lbann/base.hpp>
+
+using lbann::EvalType;
+
+TEST_CASE("Scalar reduction buffer", "[mpi][utilities][reduction]")
+{
+  auto& comm = unit_test::utilities::current_world_comm();
+  const auto& trainer_comm = comm.get_trainer_comm();
+  const int rank = El::mpi::Rank(trainer_comm);
+  const int num_procs = El::mpi::Size(trainer_comm);
+  const EvalType rank_sum = num_procs * (num_procs + 1) / 2.;
+
+  lbann::scalar_reduction_buffer buffer(comm, 3);
+  const auto slot0 = buffer.add_slot(trainer_comm);
+  const auto slot1 = buffer.add_slot(trainer_comm);
+  const auto slot2 = buffer.add_slot(trainer_comm);
+  REQUIRE(buffer.get_num_slots() == 3);
+
+  // All slots on the same communicator are reduced together
+  buffer.begin_step(lbann::execution_mode::training, 0);
+  buffer.contribute(slot0, EvalType(rank + 1));
+  buffer.contribute(slot1, []() { return EvalType(2); });
+  buffer.start();
+  CHECK(buffer.get(slot0) == rank_sum);
+  CHECK(buffer.get(slot1) == 2 * num_procs);
+  CHECK(buffer.get(slot2) == EvalType(0));
+  CHECK(buffer.get_num_allreduces() == 1);
+  CHECK_THROWS(buffer.contribute(slot0, EvalType(1)));
+
+  // Training steps between reduction intervals report stale values
+  buffer.begin_step(lbann::execution_mode::training, 1);
+  buffer.contribute(slot0, EvalType(100));
+  CHECK(buffer.get(slot0) == rank_sum);
+  CHECK(buffer.get_num_allreduces() == 1);
+
+  // Other execution modes are always reduced
+  buffer.begin_step(lbann::execution_mode::validation, 1);
+  buffer.contribute(slot0, EvalType(rank));
+  CHECK(buffer.get(slot0) == rank_sum - num_procs);
+  CHECK(buffer.get_num_allreduces() == 2);
+
+  // Copies have the same slots
+  lbann::scalar_reduction_buffer copy(buffer);
+  REQUIRE(copy.get_num_slots() == 3);
+  copy.begin_step(lbann::execution_mode::training, 3);
+  copy.contribute(slot2, EvalType(1));
+  CHECK(copy.get(slot2) == num_procs);
+
+  CHECK_THROWS(buffer.get(3));
+  CHECK_THROWS(buffer.set_interval(0));
+}
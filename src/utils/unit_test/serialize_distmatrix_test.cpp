@@ -27,10 +27,15 @@
 #include <lbann/base.hpp>
 
 #include <lbann/utils/serialize.hpp>
+#include <lbann/utils/serialization/elastic_checkpoint.hpp>
 #include <h2/patterns/multimethods/SwitchDispatcher.hpp>
 
 #include "MPITestHelpers.hpp"
 
+#include <algorithm>
+#include <numeric>
+#include <sstream>
+
 // Enumerate all DistMatrix types. Start by getting all the
 // distributions.
 template <typename T, El::Device D>
@@ -129,6 +134,268 @@ TEMPLATE_LIST_TEST_CASE("DistMatrix serialization",
 #endif // LBANN_HAS_CEREAL_BINARY_ARCHIVES
 }
 
+#ifdef LBANN_HAS_CEREAL_BINARY_ARCHIVES
+template <typename DistMatT>
+struct DistMatrixDataTypeT;
+
+template <typename T, El::Dist C, El::Dist R, El::DistWrap W, El::Device D>
+struct DistMatrixDataTypeT<El::DistMatrix<T, C, R, W, D>>
+{
+  using type = T;
+};
+
+TEMPLATE_LIST_TEST_CASE("DistMatrix elastic restart",
+                        "[serialize][utils][distmatrix][mpi][elastic]",
+                        AllDistMatrixTypes)
+{
+  using DistMatType = TestType;
+  using DataType = typename DistMatrixDataTypeT<DistMatType>::type;
+  using StarMatType =
+    El::DistMatrix<DataType, El::STAR, El::STAR, El::ELEMENT, El::Device::CPU>;
+
+  auto& comm = ::unit_test::utilities::current_world_comm();
+  lbann::utils::grid_manager mgr(comm.get_trainer_grid());
+  auto const& g = lbann::utils::get_current_grid();
+
+  // Save the local matrices and their layouts, then reassemble them
+  // in a different distribution. Each rank reads its own archive in a
+  // single pass.
+  auto save_and_redistribute = [&comm](auto const& src, auto& tgt) {
+    std::stringstream ss;
+    std::vector<lbann::utils::dist_matrix_layout> layouts;
+    {
+      lbann::utils::dist_matrix_layout_recorder recorder;
+      cereal::BinaryOutputArchive oarchive(ss);
+      oarchive(src);
+      layouts = recorder.get_layouts();
+    }
+    REQUIRE(layouts.size() == 1UL);
+
+    lbann::utils::elastic_restart_context elastic(
+      comm.get_procs_per_trainer(), "");
+    elastic.begin_pass(comm.get_rank_in_trainer(), "", true, true);
+    elastic.set_layouts(comm.get_procs_per_trainer(), std::move(layouts));
+    cereal::BinaryInputArchive iarchive(ss);
+    REQUIRE_NOTHROW(iarchive(tgt));
+  };
+
+  SECTION("Distributed to redundant")
+  {
+    DistMatType mat(12, 16, g);
+    El::MakeUniform(mat);
+    StarMatType expected(mat), mat_restore(g);
+    save_and_redistribute(mat, mat_restore);
+
+    REQUIRE(mat_restore.Height() == 12);
+    REQUIRE(mat_restore.Width() == 16);
+    for (El::Int col = 0; col < 16; ++col)
+      for (El::Int row = 0; row < 12; ++row)
+      {
+        INFO("(Row,Col) = (" << row << "," << col << ")");
+        CHECK(expected.GetLocal(row, col) == mat_restore.GetLocal(row, col));
+      }
+  }
+
+  SECTION("Redundant to distributed")
+  {
+    StarMatType mat(12, 16, g);
+    for (El::Int col = 0; col < 16; ++col)
+      for (El::Int row = 0; row < 12; ++row)
+        mat.SetLocal(row, col, DataType(row + 12 * col));
+    DistMatType mat_restore(g);
+    save_and_redistribute(mat, mat_restore);
+
+    REQUIRE(mat_restore.Height() == 12);
+    REQUIRE(mat_restore.Width() == 16);
+    StarMatType restored(mat_restore);
+    for (El::Int col = 0; col < 16; ++col)
+      for (El::Int row = 0; row < 12; ++row)
+      {
+        INFO("(Row,Col) = (" << row << "," << col << ")");
+        CHECK(mat.GetLocal(row, col) == restored.GetLocal(row, col));
+      }
+  }
+}
+
+namespace
+{
+
+/** Grid over the first @c size ranks of the trainer. Every rank in
+ *  the trainer must call this. */
+std::unique_ptr<El::Grid> make_leading_grid(lbann::lbann_comm& comm,
+                                            int size)
+{
+  std::vector<int> ranks(size);
+  std::iota(ranks.begin(), ranks.end(), 0);
+  El::mpi::Comm trainer_comm;
+  El::mpi::Group trainer_group, subgrid_group;
+  El::mpi::Dup(comm.get_trainer_comm(), trainer_comm);
+  El::mpi::CommGroup(trainer_comm, trainer_group);
+  El::mpi::Incl(trainer_group, size, ranks.data(), subgrid_group);
+  auto grid = std::make_unique<El::Grid>(std::move(trainer_comm),
+                                         subgrid_group,
+                                         size,
+                                         El::COLUMN_MAJOR);
+  El::mpi::Free(trainer_group);
+  return grid;
+}
+
+/** Share every rank's string with all ranks in the trainer. */
+std::vector<std::string> allgather_strings(lbann::lbann_comm& comm,
+                                           std::string const& str)
+{
+  auto const mpi_comm = comm.get_trainer_comm().GetMPIComm();
+  int const num_procs = comm.get_procs_per_trainer();
+  int const size = static_cast<int>(str.size());
+  std::vector<int> sizes(num_procs), displs(num_procs, 0);
+  MPI_Allgather(&size, 1, MPI_INT, sizes.data(), 1, MPI_INT, mpi_comm);
+  std::partial_sum(sizes.begin(), sizes.end() - 1, displs.begin() + 1);
+  std::vector<char> buffer(displs.back() + sizes.back());
+  MPI_Allgatherv(str.data(), size, MPI_CHAR,
+                 buffer.data(), sizes.data(), displs.data(), MPI_CHAR,
+                 mpi_comm);
+  std::vector<std::string> out;
+  for (int r = 0; r < num_procs; ++r) {
+    out.emplace_back(buffer.data() + displs[r], sizes[r]);
+  }
+  return out;
+}
+
+/** Distinct value for each entry of each matrix. */
+float elastic_test_value(int mat, El::Int row, El::Int col)
+{
+  return static_cast<float>(1000 * mat + row + 100 * col);
+}
+
+} // namespace <anon>
+
+TEST_CASE("DistMatrix elastic restart over several passes",
+          "[serialize][utils][distmatrix][mpi][elastic]")
+{
+  using StarMatType =
+    El::DistMatrix<float, El::STAR, El::STAR, El::ELEMENT, El::Device::CPU>;
+  using MCMRMatType =
+    El::DistMatrix<float, El::MC, El::MR, El::ELEMENT, El::Device::CPU>;
+  using MCStarMatType =
+    El::DistMatrix<float, El::MC, El::STAR, El::ELEMENT, El::Device::CPU>;
+  using VCStarMatType =
+    El::DistMatrix<float, El::VC, El::STAR, El::ELEMENT, El::Device::CPU>;
+
+  auto& comm = ::unit_test::utilities::current_world_comm();
+  int const num_procs = comm.get_procs_per_trainer();
+  int const rank = comm.get_rank_in_trainer();
+
+  // Write a checkpoint with a leading subset of the ranks. Each
+  // writer's "file" holds its layouts followed by its local matrices:
+  // a distributed matrix, a fully redundant one, and one that is
+  // redundant across grid columns.
+  int const old_num_procs = std::max(num_procs - 1, 1);
+  std::string file;
+  {
+    auto const old_grid = make_leading_grid(comm, old_num_procs);
+    if (old_grid->InGrid()) {
+      MCMRMatType a(12, 16, *old_grid);
+      StarMatType b(7, 5, *old_grid);
+      MCStarMatType c(9, 4, *old_grid);
+      auto fill = [](auto& mat, int id) {
+        for (El::Int jl = 0; jl < mat.LocalWidth(); ++jl)
+          for (El::Int il = 0; il < mat.LocalHeight(); ++il)
+            mat.SetLocal(il, jl, elastic_test_value(id,
+                                                    mat.GlobalRow(il),
+                                                    mat.GlobalCol(jl)));
+      };
+      fill(a, 0);
+      fill(b, 1);
+      fill(c, 2);
+      std::stringstream data;
+      std::vector<lbann::utils::dist_matrix_layout> layouts;
+      {
+        lbann::utils::dist_matrix_layout_recorder recorder;
+        cereal::BinaryOutputArchive oarchive(data);
+        oarchive(a, b, c);
+        layouts = recorder.get_layouts();
+      }
+      REQUIRE(layouts.size() == 3UL);
+      std::stringstream ss;
+      {
+        cereal::BinaryOutputArchive oarchive(ss);
+        oarchive(old_num_procs, layouts);
+      }
+      file = ss.str() + data.str();
+    }
+  }
+  auto const files = allgather_strings(comm, file);
+
+  // Restart on the leading new_num_procs ranks, mirroring the pass
+  // loop of the checkpoint callback
+  auto restart = [&](int new_num_procs) {
+    auto const new_grid = make_leading_grid(comm, new_num_procs);
+    if (!new_grid->InGrid()) {
+      return;
+    }
+    VCStarMatType a(*new_grid);
+    MCMRMatType b(*new_grid);
+    StarMatType c(*new_grid);
+    int const num_passes =
+      lbann::utils::get_elastic_restart_num_passes(old_num_procs,
+                                                   new_num_procs);
+    CHECK(num_passes == (old_num_procs + new_num_procs - 1) / new_num_procs);
+    lbann::utils::elastic_restart_context elastic(old_num_procs, "");
+    for (int pass = 0; pass < num_passes; ++pass) {
+      auto const source = lbann::utils::get_elastic_restart_source(
+        pass, rank, new_num_procs, old_num_procs);
+      REQUIRE(source.rank >= 0);
+      REQUIRE(source.rank < old_num_procs);
+      CHECK(source.contribute == (pass * new_num_procs + rank
+                                  < old_num_procs));
+      elastic.begin_pass(source.rank, "", source.contribute,
+                         pass == num_passes - 1);
+      std::stringstream ss(files[source.rank]);
+      cereal::BinaryInputArchive iarchive(ss);
+      int num_writers;
+      std::vector<lbann::utils::dist_matrix_layout> layouts;
+      iarchive(num_writers, layouts);
+      elastic.set_layouts(num_writers, std::move(layouts));
+      REQUIRE_NOTHROW(iarchive(a, b, c));
+    }
+
+    // Each entry must be contributed exactly once over all passes
+    auto check = [](auto const& mat, int id, El::Int height, El::Int width) {
+      REQUIRE(mat.Height() == height);
+      REQUIRE(mat.Width() == width);
+      StarMatType restored(mat);
+      for (El::Int col = 0; col < width; ++col)
+        for (El::Int row = 0; row < height; ++row)
+        {
+          INFO("Matrix " << id << ", (Row,Col) = (" << row << "," << col << ")");
+          CHECK(restored.GetLocal(row, col)
+                == elastic_test_value(id, row, col));
+        }
+    };
+    check(a, 0, 12, 16);
+    check(b, 1, 7, 5);
+    check(c, 2, 9, 4);
+  };
+
+  SECTION("Restart on more ranks")
+  {
+    // One pass; ranks past the old count re-read without contributing
+    restart(num_procs);
+  }
+
+  SECTION("Restart on fewer ranks")
+  {
+    // Several passes reusing the accumulators; in the last pass, some
+    // ranks may have no old rank left and re-read without contributing
+    if (old_num_procs < 2) {
+      WARN("restarting on fewer ranks needs at least 3 processes");
+      return;
+    }
+    restart((old_num_procs + 1) / 2);
+  }
+}
+#endif // LBANN_HAS_CEREAL_BINARY_ARCHIVES
+
 // Just a bit of sugar to make the output clearer when testing for
 // null pointers.
 using check_valid_ptr = bool;
@@ -0,0 +1,101 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2022, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+#include <catch2/catch.hpp>
+
+// File being tested
+#include <lbann/utils/tracer.hpp>
+
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <unistd.h>
+
+TEST_CASE("Event tracer", "[seq][utilities]")
+{
+  auto& tracer = lbann::trace::tracer::instance();
+
+  SECTION("Nothing is recorded while disabled")
+  {
+    tracer.enable(8);
+    tracer.disable();
+    {
+      LBANN_TRACE_SCOPE("test", "disabled");
+    }
+    CHECK(tracer.get_num_events() == 0);
+  }
+
+  SECTION("Events are recorded per thread")
+  {
+    tracer.enable(8);
+    {
+      LBANN_TRACE_SCOPE("test", "main");
+    }
+    std::thread worker([&tracer] {
+      tracer.set_thread_name("worker");
+      LBANN_TRACE_SCOPE("test", std::string("worker"));
+    });
+    worker.join();
+    tracer.disable();
+    CHECK(tracer.get_num_events() == 2);
+  }
+
+  SECTION("Ring buffer keeps newest events")
+  {
+    tracer.enable(4);
+    for (int i = 0; i < 10; ++i) {
+      tracer.record("test", std::to_string(i).c_str(), i, i + 1);
+    }
+    tracer.disable();
+    CHECK(tracer.get_num_events() == 4);
+
+    const std::string path =
+      "tracer_test." + std::to_string(::getpid()) + ".json";
+    tracer.write_chrome_trace(path, 3, 1000);
+    std::ifstream ifs(path);
+    std::stringstream ss;
+    ss << ifs.rdbuf();
+    const auto trace = ss.str();
+    std::remove(path.c_str());
+    CHECK(trace.find("\"traceEvents\"") != std::string::npos);
+    CHECK(trace.find("\"clock_offset_us\":1.000") != std::string::npos);
+    CHECK(trace.find("\"name\":\"5\"") == std::string::npos);
+    CHECK(trace.find("\"name\":\"6\"") != std::string::npos);
+    CHECK(trace.find("\"name\":\"9\"") != std::string::npos);
+  }
+
+  SECTION("Long names are truncated")
+  {
+    tracer.enable(4);
+    const std::string name(200, 'x');
+    {
+      LBANN_TRACE_SCOPE("test", name);
+    }
+    tracer.disable();
+    CHECK(tracer.get_num_events() == 1);
+  }
+}
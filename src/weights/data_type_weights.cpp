@@ -34,6 +34,7 @@
 #include "lbann/utils/exception.hpp"
 #include "lbann/utils/options.hpp"
 #include "lbann/utils/onnx_utils.hpp"
+#include "lbann/utils/random_number_generators.hpp"
 
 #include <layers.pb.h>
 
@@ -245,7 +246,10 @@ void data_type_weights<TensorDataType>::do_setup_() {
   m_values->Resize(this->get_matrix_height(), this->get_matrix_width());
 
   // Initialize values
+  // Note: Counter-based fills are keyed by the weights name, so
+  // values do not depend on the order in which weights are set up.
   if (m_initializer != nullptr) {
+    counter_rng_key_scope key_scope(this->get_name());
     m_initializer->fill(*m_values);
   } else {
     El::Zero(*m_values);